@@ -8,6 +8,8 @@ static const char *const TAG = "adalight_light_effect";
 
 static const uint32_t ADALIGHT_ACK_INTERVAL = 1000;
 static const uint32_t ADALIGHT_RECEIVE_TIMEOUT = 1000;
+// LEDs converted at once before they are written to the light
+static const int WRITE_CHUNK = 64;
 
 AdalightLightEffect::AdalightLightEffect(const std::string &name) : AddressableLightEffect(name) {}
 
@@ -128,10 +130,16 @@ AdalightLightEffect::Frame AdalightLightEffect::parse_frame_(light::AddressableL
   auto accepted_led_count = std::min<int>(led_count, it.size());
   uint8_t *led_data = &frame_[6];
 
-  for (int led = 0; led < accepted_led_count; led++, led_data += 3) {
-    auto white = std::min(std::min(led_data[0], led_data[1]), led_data[2]);
+  Color colors[WRITE_CHUNK];
+  for (int led = 0; led < accepted_led_count;) {
+    int chunk = std::min(accepted_led_count - led, WRITE_CHUNK);
+    for (int i = 0; i < chunk; i++, led_data += 3) {
+      auto white = std::min(std::min(led_data[0], led_data[1]), led_data[2]);
 
-    it[led].set(Color(led_data[0], led_data[1], led_data[2], white));
+      colors[i] = Color(led_data[0], led_data[1], led_data[2], white);
+    }
+    it.write_colors(led, colors, chunk);
+    led += chunk;
   }
 
   it.schedule_show();
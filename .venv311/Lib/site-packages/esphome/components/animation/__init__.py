@@ -100,7 +100,9 @@ async def to_code(config):
         frame_count,
         image_type,
         trans_value,
+        espImage.get_compression_enum(config[espImage.CONF_COMPRESSION]),
     )
+    espImage.setup_image_options(var, config)
     if loop_config := config.get(CONF_LOOP):
         start = loop_config[CONF_START_FRAME]
         end = loop_config.get(CONF_END_FRAME, frame_count)
@@ -6,8 +6,8 @@ namespace esphome {
 namespace animation {
 
 Animation::Animation(const uint8_t *data_start, int width, int height, uint32_t animation_frame_count,
-                     image::ImageType type, image::Transparency transparent)
-    : Image(data_start, width, height, type, transparent),
+                     image::ImageType type, image::Transparency transparent, image::ImageCompression compression)
+    : Image(data_start, width, height, type, transparent, compression),
       animation_data_start_(data_start),
       current_frame_(0),
       animation_frame_count_(animation_frame_count),
@@ -62,6 +62,13 @@ void Animation::set_frame(int frame) {
 }
 
 void Animation::update_data_start_() {
+#ifdef USE_IMAGE_COMPRESSION
+  if (this->compression_ != image::IMAGE_COMPRESSION_NONE) {
+    // Every frame has its own row offset table, stored back to back; rows identical to another frame are shared
+    this->data_start_ = this->animation_data_start_ + sizeof(uint32_t) * this->height_ * this->current_frame_;
+    return;
+  }
+#endif
   const uint32_t image_size = this->get_width_stride() * this->height_;
   this->data_start_ = this->animation_data_start_ + image_size * this->current_frame_;
 }
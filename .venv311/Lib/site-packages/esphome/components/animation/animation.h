@@ -9,7 +9,7 @@ namespace animation {
 class Animation : public image::Image {
  public:
   Animation(const uint8_t *data_start, int width, int height, uint32_t animation_frame_count, image::ImageType type,
-            image::Transparency transparent);
+            image::Transparency transparent, image::ImageCompression compression = image::IMAGE_COMPRESSION_NONE);
 
   uint32_t get_animation_frame_count() const;
   int get_current_frame() const;
@@ -68,11 +68,9 @@ class BLEPresenceDevice : public binary_sensor::BinarySensorInitiallyOff,
         }
         break;
       case MATCH_BY_SERVICE_UUID:
-        for (auto uuid : device.get_service_uuids()) {
-          if (this->uuid_ == uuid) {
-            this->set_found_(true);
-            return true;
-          }
+        if (device.has_service_uuid(this->uuid_)) {
+          this->set_found_(true);
+          return true;
         }
         break;
       case MATCH_BY_IBEACON_UUID:
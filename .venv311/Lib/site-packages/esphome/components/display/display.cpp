@@ -1,7 +1,9 @@
 #include "display.h"
+#include <algorithm>
 #include <utility>
 #include <numbers>
 #include "display_color_utils.h"
+#include "pixel_convert.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
@@ -55,33 +57,16 @@ void Display::line_at_angle(int x, int y, int angle, int start_radius, int stop_
 void Display::draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorOrder order,
                              ColorBitness bitness, bool big_endian, int x_offset, int y_offset, int x_pad) {
   size_t line_stride = x_offset + w + x_pad;  // length of each source line in pixels
-  uint32_t color_value;
+  size_t pixel_size = bytes_per_pixel(bitness);
+  // Convert a chunk of a line at a time, then draw it
+  Color colors[32];
   for (int y = 0; y != h; y++) {
-    size_t source_idx = (y_offset + y) * line_stride + x_offset;
-    size_t source_idx_mod;
-    for (int x = 0; x != w; x++, source_idx++) {
-      switch (bitness) {
-        default:
-          color_value = ptr[source_idx];
-          break;
-        case COLOR_BITNESS_565:
-          source_idx_mod = source_idx * 2;
-          if (big_endian) {
-            color_value = (ptr[source_idx_mod] << 8) + ptr[source_idx_mod + 1];
-          } else {
-            color_value = ptr[source_idx_mod] + (ptr[source_idx_mod + 1] << 8);
-          }
-          break;
-        case COLOR_BITNESS_888:
-          source_idx_mod = source_idx * 3;
-          if (big_endian) {
-            color_value = (ptr[source_idx_mod + 0] << 16) + (ptr[source_idx_mod + 1] << 8) + ptr[source_idx_mod + 2];
-          } else {
-            color_value = ptr[source_idx_mod + 0] + (ptr[source_idx_mod + 1] << 8) + (ptr[source_idx_mod + 2] << 16);
-          }
-          break;
-      }
-      this->draw_pixel_at(x + x_start, y + y_start, ColorUtil::to_color(color_value, order, bitness));
+    const uint8_t *line = ptr + ((y_offset + y) * line_stride + x_offset) * pixel_size;
+    for (int x = 0; x < w; x += 32) {
+      int count = std::min(w - x, 32);
+      pixels_to_colors(line + x * pixel_size, colors, count, order, bitness, big_endian);
+      for (int i = 0; i != count; i++)
+        this->draw_pixel_at(x_start + x + i, y_start + y, colors[i]);
     }
   }
 }
@@ -256,6 +256,43 @@ class Display : public PollingComponent {
     this->draw_pixels_at(x_start, y_start, w, h, ptr, order, bitness, big_endian, 0, 0, 0);
   }
 
+  /** Copy a block of pixels that is already in the display's native buffer format.
+   * Displays that keep a buffer in a fixed format can override this to copy rows straight into it. The data is either
+   * unrotated, or pre-rotated for a display rotation; a display may accept either or both, rotating unrotated data
+   * itself.
+   *
+   * \param x_start The starting destination x position
+   * \param y_start The starting destination y position
+   * \param w the width of the pixel block, before rotation
+   * \param h the height of the pixel block, before rotation
+   * \param ptr A pointer to the packed pixel data
+   * \param bitness Defines the number of bits and their format for each pixel
+   * \param big_endian True if 16 bit values are stored big-endian
+   * \param rotation The display rotation the data was rotated for, DISPLAY_ROTATION_0_DEGREES for unrotated data
+   * \return false if the data doesn't match the native format, the caller then has to draw the pixels itself.
+   */
+  virtual bool draw_native_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorBitness bitness,
+                                     bool big_endian, DisplayRotation rotation) {
+    return false;
+  }
+
+  /** Hand the display's own pixel buffer to a renderer that draws into it in the native format, e.g. LVGL.
+   * The renderer then owns the buffer contents and sends them with draw_pixels_at(); the display stops drawing into
+   * the buffer itself.
+   *
+   * \param bitness The pixel format the renderer draws in
+   * \param big_endian True if 16 bit values are stored big-endian
+   * \param min_pixels The smallest buffer the renderer can use
+   * \param pixels Set to the size of the buffer in pixels
+   * \return the buffer, or nullptr if the display has none in that format and size.
+   */
+  virtual uint8_t *lend_buffer(ColorBitness bitness, bool big_endian, size_t min_pixels, size_t &pixels) {
+    return nullptr;
+  }
+
+  /// Take back a buffer from lend_buffer() that the renderer could not use, so the display draws into it again.
+  virtual void return_buffer() {}
+
   /// Draw a straight line from the point [x1,y1] to [x2,y2] with the given color.
   void line(int x1, int y1, int x2, int y2, Color color = COLOR_ON);
 
@@ -0,0 +1,139 @@
+#include "pixel_convert.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace display {
+
+// All supported targets are little endian: a 32 bit load puts the first byte in the lowest bits.
+static inline uint32_t load32(const uint8_t *ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+static inline void store32(uint8_t *ptr, uint32_t value) { memcpy(ptr, &value, sizeof(value)); }
+
+// Swap the bytes of both 16 bit halves of a word
+static inline uint32_t swap_halves(uint32_t value) { return ((value & 0x00FF00FF) << 8) | ((value >> 8) & 0x00FF00FF); }
+
+static inline uint16_t rgb332_to_565(uint8_t c) { return ((c & 0xE0) << 8) | ((c & 0x1C) << 6) | ((c & 0x03) << 3); }
+
+// Same values as esp_scale(i, max) = 255 * i / max, to match ColorUtil::to_color()
+template<uint8_t BITS> struct ScaleTable {
+  uint8_t values[1 << BITS];
+  constexpr ScaleTable() : values() {
+    for (int i = 0; i != (1 << BITS); i++)
+      this->values[i] = 255 * i / ((1 << BITS) - 1);
+  }
+};
+static constexpr ScaleTable<2> SCALE_2{};
+static constexpr ScaleTable<3> SCALE_3{};
+static constexpr ScaleTable<5> SCALE_5{};
+static constexpr ScaleTable<6> SCALE_6{};
+
+void rgb565_to_rgb666(const uint8_t *src, uint8_t *dst, size_t count, bool big_endian) {
+  size_t i = 0;
+  // Four pixels in two words become three output words
+  for (; i + 4 <= count; i += 4, src += 8, dst += 12) {
+    uint32_t w0 = load32(src);
+    uint32_t w1 = load32(src + 4);
+    if (big_endian) {
+      w0 = swap_halves(w0);
+      w1 = swap_halves(w1);
+    }
+    // Each mask leaves one channel of both pixels in the low byte of each half
+    uint32_t a0 = (w0 >> 8) & 0x00F800F8;
+    uint32_t b0 = (w0 >> 3) & 0x00FC00FC;
+    uint32_t c0 = (w0 << 3) & 0x00F800F8;
+    uint32_t a1 = (w1 >> 8) & 0x00F800F8;
+    uint32_t b1 = (w1 >> 3) & 0x00FC00FC;
+    uint32_t c1 = (w1 << 3) & 0x00F800F8;
+    store32(dst, (a0 & 0xFF) | (b0 & 0xFF) << 8 | (c0 & 0xFF) << 16 | (a0 >> 16) << 24);
+    store32(dst + 4, (b0 >> 16) | (c0 >> 16) << 8 | (a1 & 0xFF) << 16 | (b1 & 0xFF) << 24);
+    store32(dst + 8, (c1 & 0xFF) | (a1 >> 16) << 8 | (b1 >> 16) << 16 | (c1 >> 16) << 24);
+  }
+  for (; i != count; i++, src += 2) {
+    uint16_t value = big_endian ? (src[0] << 8) | src[1] : src[0] | (src[1] << 8);
+    *dst++ = (value >> 8) & 0xF8;
+    *dst++ = (value >> 3) & 0xFC;
+    *dst++ = value << 3;
+  }
+}
+
+void rgb332_to_rgb565(const uint8_t *src, uint8_t *dst, size_t count, bool big_endian) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2, src += 2, dst += 4) {
+    uint32_t value = rgb332_to_565(src[0]) | rgb332_to_565(src[1]) << 16;
+    store32(dst, big_endian ? swap_halves(value) : value);
+  }
+  if (i != count) {
+    uint16_t value = rgb332_to_565(*src);
+    dst[0] = big_endian ? value >> 8 : value;
+    dst[1] = big_endian ? value : value >> 8;
+  }
+}
+
+void rgb332_to_rgb666(const uint8_t *src, uint8_t *dst, size_t count) {
+  for (size_t i = 0; i != count; i++) {
+    uint8_t value = *src++;
+    *dst++ = value << 6;           // Blue
+    *dst++ = (value & 0x1C) << 3;  // Green
+    *dst++ = value & 0xE0;         // Red
+  }
+}
+
+void swap_bytes_16(const uint8_t *src, uint8_t *dst, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2, src += 4, dst += 4)
+    store32(dst, swap_halves(load32(src)));
+  if (i != count) {
+    uint8_t first = src[0];
+    dst[0] = src[1];
+    dst[1] = first;
+  }
+}
+
+void pixels_to_colors(const uint8_t *src, Color *dst, size_t count, ColorOrder order, ColorBitness bitness,
+                      bool big_endian) {
+  for (size_t i = 0; i != count; i++) {
+    uint8_t first, second, third;
+    switch (bitness) {
+      case COLOR_BITNESS_888:
+        first = big_endian ? src[0] : src[2];
+        second = src[1];
+        third = big_endian ? src[2] : src[0];
+        src += 3;
+        break;
+      case COLOR_BITNESS_565: {
+        uint16_t value = big_endian ? (src[0] << 8) | src[1] : src[0] | (src[1] << 8);
+        first = SCALE_5.values[value >> 11];
+        second = SCALE_6.values[(value >> 5) & 0x3F];
+        third = SCALE_5.values[value & 0x1F];
+        src += 2;
+        break;
+      }
+      default: {
+        uint8_t value = *src++;
+        first = SCALE_3.values[value >> 5];
+        second = SCALE_3.values[(value >> 2) & 0x07];
+        third = SCALE_2.values[value & 0x03];
+        break;
+      }
+    }
+    Color &color = dst[i];
+    switch (order) {
+      case COLOR_ORDER_BGR:
+        color = Color(third, second, first);
+        break;
+      case COLOR_ORDER_GRB:
+        color = Color(second, first, third);
+        break;
+      default:
+        color = Color(first, second, third);
+        break;
+    }
+  }
+}
+
+}  // namespace display
+}  // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esphome/core/color.h"
+#include "display_color_utils.h"
+
+namespace esphome {
+namespace display {
+
+/*
+ * Bulk pixel format conversions shared by the display drivers.
+ *
+ * All counts are in pixels, and source and destination must not overlap. The kernels load and store 32 bits at a
+ * time where the format allows it and fall back to single pixels for the remainder, so they don't need any
+ * particular alignment.
+ */
+
+/**
+ * Convert RGB565 to 18 bit (3 bytes per pixel, each channel in the upper bits of its byte), as sent to
+ * 18 bit panels. The channels keep their order; the byte for the upper 5 bits of the 565 value comes first.
+ *
+ * @param big_endian Byte order of the source pixels.
+ */
+void rgb565_to_rgb666(const uint8_t *src, uint8_t *dst, size_t count, bool big_endian);
+
+/// Expand RGB332 to RGB565 by placing the bits in the upper bits of each channel.
+void rgb332_to_rgb565(const uint8_t *src, uint8_t *dst, size_t count, bool big_endian);
+
+/// Expand RGB332 to 18 bit, bytes in the order blue, green, red.
+void rgb332_to_rgb666(const uint8_t *src, uint8_t *dst, size_t count);
+
+/// Swap the bytes of each 16 bit pixel, e.g. to convert little endian RGB565 to big endian.
+void swap_bytes_16(const uint8_t *src, uint8_t *dst, size_t count);
+
+/**
+ * Decode packed pixels into colors, with the same result as ColorUtil::to_color() for each pixel but without
+ * the per-channel divisions.
+ *
+ * @param bitness Source format, 1 (332), 2 (565) or 3 (888) bytes per pixel.
+ * @param big_endian Byte order of 565 and 888 source pixels.
+ */
+void pixels_to_colors(const uint8_t *src, Color *dst, size_t count, ColorOrder order, ColorBitness bitness,
+                      bool big_endian);
+
+/// Number of bytes a pixel of the given bitness takes in a source buffer.
+inline size_t bytes_per_pixel(ColorBitness bitness) {
+  switch (bitness) {
+    case COLOR_BITNESS_888:
+      return 3;
+    case COLOR_BITNESS_565:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+}  // namespace display
+}  // namespace esphome
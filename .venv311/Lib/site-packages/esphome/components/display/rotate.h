@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include "display.h"
+
+namespace esphome {
+namespace display {
+
+/// Rectangles of at least this many bytes are rotated in tiles, about the size of the ESP32 PSRAM data cache.
+static constexpr size_t ROTATE_TILED_MIN_BYTES = 64 * 1024;
+
+/**
+ * Copy a rectangle of pixels, rotating it clockwise by the given angle.
+ *
+ * The source pixel at row r, column c of a width x height rectangle ends up at
+ *  - 90°:  row c, column height - 1 - r
+ *  - 180°: row height - 1 - r, column width - 1 - c
+ *  - 270°: row width - 1 - c, column r
+ * so for 90° and 270° the destination is height pixels wide and width pixels high.
+ *
+ * A plain per-pixel transpose writes with a stride of a whole line for every pixel, which misses the cache on nearly
+ * every access once the rectangle is larger than the cache, e.g. a PSRAM frame buffer. Such rectangles are therefore
+ * moved in square tiles for 90° and 270°: each tile is read row by row into a small buffer on the stack, then written
+ * out row by row, so both sides are accessed in runs of contiguous pixels. Smaller rectangles, like the partial
+ * buffers LVGL usually renders, use the plain transpose, which is faster while everything stays in cache.
+ *
+ * @tparam T The pixel type, e.g. uint16_t or lv_color_t. Tiles are 16x16 for pixels up to 2 bytes, 8x8 otherwise.
+ * @param src_stride Distance between source rows, in pixels.
+ * @param dst_stride Distance between destination rows, in pixels.
+ */
+template<typename T>
+void rotate_pixels(const T *src, size_t src_stride, T *dst, size_t dst_stride, int width, int height,
+                   DisplayRotation rotation) {
+  static constexpr int TILE = sizeof(T) <= 2 ? 16 : 8;
+  switch (rotation) {
+    case DISPLAY_ROTATION_0_DEGREES:
+      for (int r = 0; r != height; r++)
+        memcpy(dst + r * dst_stride, src + r * src_stride, width * sizeof(T));
+      break;
+
+    case DISPLAY_ROTATION_180_DEGREES:
+      // Rows are reversed as a whole, so both sides are already sequential
+      for (int r = 0; r != height; r++) {
+        const T *s = src + r * src_stride;
+        T *d = dst + (height - 1 - r) * dst_stride + width - 1;
+        for (int c = 0; c != width; c++)
+          *d-- = *s++;
+      }
+      break;
+
+    case DISPLAY_ROTATION_90_DEGREES:
+    case DISPLAY_ROTATION_270_DEGREES: {
+      if (static_cast<size_t>(width) * height * sizeof(T) < ROTATE_TILED_MIN_BYTES) {
+        // Source row r becomes destination column height - 1 - r (90°) or r (270°)
+        for (int r = 0; r != height; r++) {
+          const T *s = src + r * src_stride;
+          if (rotation == DISPLAY_ROTATION_90_DEGREES) {
+            T *d = dst + (height - 1 - r);
+            for (int c = 0; c != width; c++, d += dst_stride)
+              *d = *s++;
+          } else {
+            T *d = dst + (width - 1) * dst_stride + r;
+            for (int c = 0; c != width; c++, d -= dst_stride)
+              *d = *s++;
+          }
+        }
+        break;
+      }
+      T tile[TILE * TILE];
+      for (int r0 = 0; r0 < height; r0 += TILE) {
+        const int th = height - r0 < TILE ? height - r0 : TILE;
+        for (int c0 = 0; c0 < width; c0 += TILE) {
+          const int tw = width - c0 < TILE ? width - c0 : TILE;
+          for (int r = 0; r != th; r++)
+            memcpy(tile + r * TILE, src + (r0 + r) * src_stride + c0, tw * sizeof(T));
+          if (rotation == DISPLAY_ROTATION_90_DEGREES) {
+            // Source column c becomes destination row c, source rows in reverse order
+            for (int c = 0; c != tw; c++) {
+              T *d = dst + (c0 + c) * dst_stride + (height - r0 - th);
+              for (int r = th; r-- != 0;)
+                *d++ = tile[r * TILE + c];
+            }
+          } else {
+            // Source column c becomes destination row width - 1 - c, source rows in order
+            for (int c = 0; c != tw; c++) {
+              T *d = dst + (width - 1 - c0 - c) * dst_stride + r0;
+              for (int r = 0; r != th; r++)
+                *d++ = tile[r * TILE + c];
+            }
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+}  // namespace display
+}  // namespace esphome
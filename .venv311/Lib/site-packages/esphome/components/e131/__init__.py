@@ -23,11 +23,13 @@ CHANNELS = {
 
 CONF_UNIVERSE = "universe"
 CONF_E131_ID = "e131_id"
+CONF_DDP = "ddp"
 
 CONFIG_SCHEMA = cv.Schema(
     {
         cv.GenerateID(): cv.declare_id(E131Component),
         cv.Optional(CONF_METHOD, default="MULTICAST"): cv.one_of(*METHODS, upper=True),
+        cv.Optional(CONF_DDP, default=False): cv.boolean,
     }
 )
 
@@ -36,6 +38,7 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     cg.add(var.set_method(METHODS[config[CONF_METHOD]]))
+    cg.add(var.set_ddp(config[CONF_DDP]))
 
 
 @register_addressable_effect(
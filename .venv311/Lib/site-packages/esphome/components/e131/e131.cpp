@@ -1,6 +1,7 @@
 #include "e131.h"
 #ifdef USE_NETWORK
 #include "e131_addressable_light_effect.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
 namespace esphome {
@@ -8,6 +9,11 @@ namespace e131 {
 
 static const char *const TAG = "e131";
 static const int PORT = 5568;
+static const int DDP_PORT = 4048;
+// Packets read per loop and socket, so a flood of packets can't block the loop
+static const int MAX_PACKETS_PER_LOOP = 64;
+// Data waiting for a synchronization packet is shown anyway after the E1.31 network data loss timeout
+static const uint32_t SYNC_TIMEOUT = 2500;
 
 E131Component::E131Component() {}
 
@@ -15,63 +21,113 @@ E131Component::~E131Component() {
   if (this->socket_) {
     this->socket_->close();
   }
+  if (this->ddp_socket_) {
+    this->ddp_socket_->close();
+  }
 }
 
 void E131Component::setup() {
-  this->socket_ = socket::socket_ip(SOCK_DGRAM, IPPROTO_IP);
+  this->socket_ = this->open_socket_(PORT);
+  if (this->socket_ == nullptr) {
+    this->mark_failed();
+    return;
+  }
+
+  if (this->ddp_) {
+    this->ddp_socket_ = this->open_socket_(DDP_PORT);
+    if (this->ddp_socket_ == nullptr) {
+      this->mark_failed();
+      return;
+    }
+  }
+
+  join_igmp_groups_();
+}
+
+std::unique_ptr<socket::Socket> E131Component::open_socket_(uint16_t port) {
+  auto sock = socket::socket_ip(SOCK_DGRAM, IPPROTO_IP);
 
   int enable = 1;
-  int err = this->socket_->setsockopt(SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
+  int err = sock->setsockopt(SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
   if (err != 0) {
     ESP_LOGW(TAG, "Socket unable to set reuseaddr: errno %d", err);
     // we can still continue
   }
-  err = this->socket_->setblocking(false);
+  err = sock->setblocking(false);
   if (err != 0) {
     ESP_LOGW(TAG, "Socket unable to set nonblocking mode: errno %d", err);
-    this->mark_failed();
-    return;
+    return nullptr;
   }
 
   struct sockaddr_storage server;
 
-  socklen_t sl = socket::set_sockaddr_any((struct sockaddr *) &server, sizeof(server), PORT);
+  socklen_t sl = socket::set_sockaddr_any((struct sockaddr *) &server, sizeof(server), port);
   if (sl == 0) {
     ESP_LOGW(TAG, "Socket unable to set sockaddr: errno %d", errno);
-    this->mark_failed();
-    return;
+    return nullptr;
   }
 
-  err = this->socket_->bind((struct sockaddr *) &server, sizeof(server));
+  err = sock->bind((struct sockaddr *) &server, sizeof(server));
   if (err != 0) {
-    ESP_LOGW(TAG, "Socket unable to bind: errno %d", errno);
-    this->mark_failed();
-    return;
+    ESP_LOGW(TAG, "Socket unable to bind to port %u: errno %d", port, errno);
+    return nullptr;
   }
 
-  join_igmp_groups_();
+  return sock;
 }
 
 void E131Component::loop() {
-  std::vector<uint8_t> payload;
-  E131Packet packet;
-  int universe = 0;
-  uint8_t buf[1460];
-
-  ssize_t len = this->socket_->read(buf, sizeof(buf));
-  if (len == -1) {
-    return;
+  this->receive_(this->socket_.get(), false);
+  if (this->ddp_socket_ != nullptr)
+    this->receive_(this->ddp_socket_.get(), true);
+
+  if (this->sync_pending_ && millis() - this->sync_pending_since_ > SYNC_TIMEOUT) {
+    ESP_LOGD(TAG, "No synchronization packet received for %d universe, showing data unsynchronized.",
+             this->sync_universe_);
+    this->process_sync_(this->sync_universe_);
+    this->sync_lost_ = true;
   }
-  payload.resize(len);
-  memmove(&payload[0], buf, len);
+}
 
-  if (!this->packet_(payload, universe, packet)) {
-    ESP_LOGV(TAG, "Invalid packet received of size %zu.", payload.size());
-    return;
-  }
+void E131Component::receive_(socket::Socket *socket, bool ddp) {
+  uint8_t buf[1460];
 
-  if (!this->process_(universe, packet)) {
-    ESP_LOGV(TAG, "Ignored packet for %d universe of size %d.", universe, packet.count);
+  // Handle all queued packets, a frame of a large installation spans many packets
+  for (int i = 0; i < MAX_PACKETS_PER_LOOP; i++) {
+    ssize_t len = socket->read(buf, sizeof(buf));
+    if (len == -1) {
+      return;
+    }
+
+    if (ddp) {
+      DDPPacket packet;
+      if (!this->ddp_packet_(buf, len, packet)) {
+        ESP_LOGV(TAG, "Invalid DDP packet received of size %zd.", len);
+        continue;
+      }
+      this->process_ddp_(packet);
+      continue;
+    }
+
+    int universe = 0;
+    if (this->sync_packet_(buf, len, universe)) {
+      this->process_sync_(universe);
+      continue;
+    }
+
+    E131Packet packet;
+    if (!this->packet_(buf, len, universe, packet)) {
+      ESP_LOGV(TAG, "Invalid packet received of size %zd.", len);
+      continue;
+    }
+
+    // Until synchronization packets arrive again, data waiting for them is shown right away
+    if (this->sync_lost_ && packet.sync_universe == this->sync_universe_)
+      packet.sync_universe = 0;
+
+    if (!this->process_(universe, packet)) {
+      ESP_LOGV(TAG, "Ignored packet for %d universe of size %d.", universe, packet.count);
+    }
   }
 }
 
@@ -103,6 +159,11 @@ void E131Component::remove_effect(E131AddressableLightEffect *light_effect) {
   for (auto universe = light_effect->get_first_universe(); universe <= light_effect->get_last_universe(); ++universe) {
     leave_(universe);
   }
+
+  if (light_effects_.empty()) {
+    this->set_sync_universe_(0);
+    this->sync_pending_ = false;
+  }
 }
 
 bool E131Component::process_(int universe, const E131Packet &packet) {
@@ -114,9 +175,52 @@ bool E131Component::process_(int universe, const E131Packet &packet) {
     handled = light_effect->process_(universe, packet) || handled;
   }
 
+  if (handled && packet.sync_universe != 0) {
+    if (packet.sync_universe != this->sync_universe_)
+      this->set_sync_universe_(packet.sync_universe);
+    if (!this->sync_pending_) {
+      this->sync_pending_ = true;
+      this->sync_pending_since_ = millis();
+    }
+  }
+
   return handled;
 }
 
+void E131Component::process_sync_(int universe) {
+  if (universe != this->sync_universe_)
+    return;
+
+  ESP_LOGV(TAG, "Received E1.31 synchronization for %d universe", universe);
+  this->sync_lost_ = false;
+
+  for (auto *light_effect : light_effects_) {
+    light_effect->show_();
+  }
+  this->sync_pending_ = false;
+}
+
+void E131Component::process_ddp_(const DDPPacket &packet) {
+  ESP_LOGV(TAG, "Received DDP packet for offset %" PRIu32 ", with %u bytes", packet.offset, packet.length);
+
+  for (auto *light_effect : light_effects_) {
+    light_effect->process_ddp_(packet);
+    if (packet.push)
+      light_effect->show_();
+  }
+}
+
+void E131Component::set_sync_universe_(int universe) {
+  if (universe == this->sync_universe_)
+    return;
+  this->sync_lost_ = false;
+  if (this->sync_universe_ != 0)
+    leave_(this->sync_universe_);
+  this->sync_universe_ = universe;
+  if (universe != 0)
+    join_(universe);
+}
+
 }  // namespace e131
 }  // namespace esphome
 #endif
@@ -19,9 +19,22 @@ enum E131ListenMethod { E131_MULTICAST, E131_UNICAST };
 
 const int E131_MAX_PROPERTY_VALUES_COUNT = 513;
 
+/// Data of a received packet, values point into the receive buffer. values[0] is the start code.
 struct E131Packet {
   uint16_t count;
-  uint8_t values[E131_MAX_PROPERTY_VALUES_COUNT];
+  const uint8_t *values;
+  /// Universe of the synchronization packets that release this data, 0 to show it right away
+  uint16_t sync_universe;
+};
+
+/// Data of a received DDP packet, data points into the receive buffer.
+struct DDPPacket {
+  /// Offset of the data in bytes from the first LED
+  uint32_t offset;
+  uint16_t length;
+  const uint8_t *data;
+  /// Show the data now, set on the last packet of a frame
+  bool push;
 };
 
 class E131Component : public esphome::Component {
@@ -37,19 +50,38 @@ class E131Component : public esphome::Component {
   void remove_effect(E131AddressableLightEffect *light_effect);
 
   void set_method(E131ListenMethod listen_method) { this->listen_method_ = listen_method; }
+  void set_ddp(bool ddp) { this->ddp_ = ddp; }
 
  protected:
-  bool packet_(const std::vector<uint8_t> &data, int &universe, E131Packet &packet);
+  /// Parse a data packet, returns false if it isn't one.
+  bool packet_(const uint8_t *data, size_t len, int &universe, E131Packet &packet);
+  /// Parse a synchronization packet, returns false if it isn't one.
+  bool sync_packet_(const uint8_t *data, size_t len, int &universe);
   bool process_(int universe, const E131Packet &packet);
+  void process_sync_(int universe);
+  /// Parse a DDP packet with data for the display, returns false if it isn't one.
+  bool ddp_packet_(const uint8_t *data, size_t len, DDPPacket &packet);
+  void process_ddp_(const DDPPacket &packet);
+  std::unique_ptr<socket::Socket> open_socket_(uint16_t port);
+  void receive_(socket::Socket *socket, bool ddp);
   bool join_igmp_groups_();
   void join_(int universe);
   void leave_(int universe);
+  void set_sync_universe_(int universe);
 
   E131ListenMethod listen_method_{E131_MULTICAST};
+  bool ddp_{false};
   std::unique_ptr<socket::Socket> socket_;
+  std::unique_ptr<socket::Socket> ddp_socket_;
   std::set<E131AddressableLightEffect *> light_effects_;
   std::map<int, int> universe_consumers_;
-  std::map<int, E131Packet> universe_packets_;
+  /// Universe that synchronization packets are received on, 0 if none
+  int sync_universe_{0};
+  /// When the oldest data waiting for a synchronization packet was received
+  uint32_t sync_pending_since_{0};
+  bool sync_pending_{false};
+  /// The synchronization packets timed out, data for them is shown right away until one is received again
+  bool sync_lost_{false};
 };
 
 }  // namespace e131
@@ -7,7 +7,9 @@ namespace esphome {
 namespace e131 {
 
 static const char *const TAG = "e131_addressable_light_effect";
-static const int MAX_DATA_SIZE = (sizeof(E131Packet::values) - 1);
+static const int MAX_DATA_SIZE = E131_MAX_PROPERTY_VALUES_COUNT - 1;
+// LEDs converted at once before they are written to the light
+static const int32_t WRITE_CHUNK = 64;
 
 E131AddressableLightEffect::E131AddressableLightEffect(const std::string &name) : AddressableLightEffect(name) {}
 
@@ -54,41 +56,73 @@ bool E131AddressableLightEffect::process_(int universe, const E131Packet &packet
 
   int32_t output_offset = (universe - first_universe_) * get_lights_per_universe();
   // limit amount of lights per universe and received
-  int output_end =
-      std::min(it->size(), std::min(output_offset + get_lights_per_universe(), output_offset + packet.count - 1));
-  auto *input_data = packet.values + 1;
-
-  ESP_LOGV(TAG, "Applying data for '%s' on %d universe, for %" PRId32 "-%d.", get_name().c_str(), universe,
-           output_offset, output_end);
-
-  switch (channels_) {
-    case E131_MONO:
-      for (; output_offset < output_end; output_offset++, input_data++) {
-        auto output = (*it)[output_offset];
-        output.set(Color(input_data[0], input_data[0], input_data[0], input_data[0]));
-      }
-      break;
-
-    case E131_RGB:
-      for (; output_offset < output_end; output_offset++, input_data += 3) {
-        auto output = (*it)[output_offset];
-        output.set(
-            Color(input_data[0], input_data[1], input_data[2], (input_data[0] + input_data[1] + input_data[2]) / 3));
-      }
-      break;
-
-    case E131_RGBW:
-      for (; output_offset < output_end; output_offset++, input_data += 4) {
-        auto output = (*it)[output_offset];
-        output.set(Color(input_data[0], input_data[1], input_data[2], input_data[3]));
-      }
-      break;
-  }
+  int32_t count = std::min(get_lights_per_universe(), (packet.count - 1) / channels_);
+
+  ESP_LOGV(TAG, "Applying data for '%s' on %d universe, for %" PRId32 "-%" PRId32 ".", get_name().c_str(), universe,
+           output_offset, std::min(it->size(), output_offset + count));
+
+  this->write_(output_offset, packet.values + 1, count);
 
-  it->schedule_show();
+  if (packet.sync_universe == 0) {
+    it->schedule_show();
+  } else {
+    // shown when the synchronization packet arrives
+    this->show_pending_ = true;
+  }
   return true;
 }
 
+void E131AddressableLightEffect::process_ddp_(const DDPPacket &packet) {
+  // data has to start at an LED
+  if (packet.offset % channels_ != 0)
+    return;
+  // the offset is a 32 bit value from the network, only pass on LEDs this light has
+  const uint32_t led = packet.offset / channels_;
+  if (led >= static_cast<uint32_t>(get_addressable_()->size()))
+    return;
+
+  this->write_(led, packet.data, packet.length / channels_);
+  this->show_pending_ = true;
+}
+
+void E131AddressableLightEffect::show_() {
+  if (!this->show_pending_)
+    return;
+  this->show_pending_ = false;
+  get_addressable_()->schedule_show();
+}
+
+void E131AddressableLightEffect::write_(int32_t led, const uint8_t *data, int32_t count) {
+  auto *it = get_addressable_();
+  count = std::min(count, it->size() - led);
+
+  Color colors[WRITE_CHUNK];
+  while (count > 0) {
+    int32_t chunk = std::min(count, WRITE_CHUNK);
+
+    switch (channels_) {
+      case E131_MONO:
+        for (int32_t i = 0; i < chunk; i++, data++)
+          colors[i] = Color(data[0], data[0], data[0], data[0]);
+        break;
+
+      case E131_RGB:
+        for (int32_t i = 0; i < chunk; i++, data += 3)
+          colors[i] = Color(data[0], data[1], data[2], (data[0] + data[1] + data[2]) / 3);
+        break;
+
+      case E131_RGBW:
+        for (int32_t i = 0; i < chunk; i++, data += 4)
+          colors[i] = Color(data[0], data[1], data[2], data[3]);
+        break;
+    }
+
+    it->write_colors(led, colors, chunk);
+    led += chunk;
+    count -= chunk;
+  }
+}
+
 }  // namespace e131
 }  // namespace esphome
 #endif
@@ -8,6 +8,7 @@ namespace e131 {
 
 class E131Component;
 struct E131Packet;
+struct DDPPacket;
 
 enum E131LightChannels { E131_MONO = 1, E131_RGB = 3, E131_RGBW = 4 };
 
@@ -31,11 +32,17 @@ class E131AddressableLightEffect : public light::AddressableLightEffect {
 
  protected:
   bool process_(int universe, const E131Packet &packet);
+  void process_ddp_(const DDPPacket &packet);
+  /// Show the data received since the last call, if any.
+  void show_();
+  /// Write count LEDs from channel data, starting at led.
+  void write_(int32_t led, const uint8_t *data, int32_t count);
 
   int first_universe_{0};
   int last_universe_{0};
   E131LightChannels channels_{E131_RGB};
   E131Component *e131_{nullptr};
+  bool show_pending_{false};
 
   friend class E131Component;
 };
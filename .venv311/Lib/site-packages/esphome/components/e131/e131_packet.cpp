@@ -18,8 +18,23 @@ static const char *const TAG = "e131";
 
 static const uint8_t ACN_ID[12] = {0x41, 0x53, 0x43, 0x2d, 0x45, 0x31, 0x2e, 0x31, 0x37, 0x00, 0x00, 0x00};
 static const uint32_t VECTOR_ROOT = 4;
+static const uint32_t VECTOR_ROOT_EXTENDED = 8;
 static const uint32_t VECTOR_FRAME = 2;
+static const uint32_t VECTOR_FRAME_SYNCHRONIZATION = 1;
 static const uint8_t VECTOR_DMP = 2;
+static const uint8_t OPTION_PREVIEW_DATA = 0x80;
+
+// DDP, see http://www.3waylabs.com/ddp/
+static const uint8_t DDP_VERSION_MASK = 0xC0;
+static const uint8_t DDP_VERSION_1 = 0x40;
+static const uint8_t DDP_FLAG_TIMECODE = 0x10;
+static const uint8_t DDP_FLAG_STORAGE = 0x08;
+static const uint8_t DDP_FLAG_REPLY = 0x04;
+static const uint8_t DDP_FLAG_QUERY = 0x02;
+static const uint8_t DDP_FLAG_PUSH = 0x01;
+static const uint8_t DDP_ID_DISPLAY = 1;
+static const size_t DDP_HEADER_SIZE = 10;
+static const size_t DDP_TIMECODE_SIZE = 4;
 
 // E1.31 Packet Structure
 union E131RawPacket {
@@ -37,7 +52,7 @@ union E131RawPacket {
     uint32_t frame_vector;
     uint8_t source_name[64];
     uint8_t priority;
-    uint16_t reserved;
+    uint16_t sync_address;
     uint8_t sequence_number;
     uint8_t options;
     uint16_t universe;
@@ -55,9 +70,28 @@ union E131RawPacket {
   uint8_t raw[638];
 };
 
+// E1.31 Synchronization Packet Structure
+struct E131RawSyncPacket {
+  // Root Layer
+  uint16_t preamble_size;
+  uint16_t postamble_size;
+  uint8_t acn_id[12];
+  uint16_t root_flength;
+  uint32_t root_vector;
+  uint8_t cid[16];
+
+  // Frame Layer
+  uint16_t frame_flength;
+  uint32_t frame_vector;
+  uint8_t sequence_number;
+  uint16_t sync_address;
+  uint16_t reserved;
+} __attribute__((packed));
+
 // We need to have at least one `1` value
 // Get the offset of `property_values[1]`
 const size_t E131_MIN_PACKET_SIZE = reinterpret_cast<size_t>(&((E131RawPacket *) nullptr)->property_values[1]);
+const size_t E131_VALUES_OFFSET = reinterpret_cast<size_t>(&((E131RawPacket *) nullptr)->property_values[0]);
 
 bool E131Component::join_igmp_groups_() {
   if (listen_method_ != E131_MULTICAST)
@@ -116,11 +150,11 @@ void E131Component::leave_(int universe) {
   ESP_LOGD(TAG, "Left %d universe for E1.31.", universe);
 }
 
-bool E131Component::packet_(const std::vector<uint8_t> &data, int &universe, E131Packet &packet) {
-  if (data.size() < E131_MIN_PACKET_SIZE)
+bool E131Component::packet_(const uint8_t *data, size_t len, int &universe, E131Packet &packet) {
+  if (len < E131_MIN_PACKET_SIZE)
     return false;
 
-  auto *sbuff = reinterpret_cast<const E131RawPacket *>(&data[0]);
+  auto *sbuff = reinterpret_cast<const E131RawPacket *>(data);
 
   if (memcmp(sbuff->acn_id, ACN_ID, sizeof(sbuff->acn_id)) != 0)
     return false;
@@ -132,13 +166,61 @@ bool E131Component::packet_(const std::vector<uint8_t> &data, int &universe, E13
     return false;
   if (sbuff->property_values[0] != 0)
     return false;
+  // preview data is meant for visualizers, not for the lights
+  if (sbuff->options & OPTION_PREVIEW_DATA)
+    return false;
 
   universe = htons(sbuff->universe);
   packet.count = htons(sbuff->property_value_count);
-  if (packet.count > E131_MAX_PROPERTY_VALUES_COUNT)
+  if (packet.count > E131_MAX_PROPERTY_VALUES_COUNT || packet.count > len - E131_VALUES_OFFSET)
+    return false;
+
+  packet.values = sbuff->property_values;
+  packet.sync_universe = htons(sbuff->sync_address);
+  return true;
+}
+
+bool E131Component::sync_packet_(const uint8_t *data, size_t len, int &universe) {
+  if (len < sizeof(E131RawSyncPacket))
+    return false;
+
+  auto *sbuff = reinterpret_cast<const E131RawSyncPacket *>(data);
+
+  if (memcmp(sbuff->acn_id, ACN_ID, sizeof(sbuff->acn_id)) != 0)
+    return false;
+  if (htonl(sbuff->root_vector) != VECTOR_ROOT_EXTENDED)
+    return false;
+  if (htonl(sbuff->frame_vector) != VECTOR_FRAME_SYNCHRONIZATION)
+    return false;
+
+  universe = htons(sbuff->sync_address);
+  return true;
+}
+
+bool E131Component::ddp_packet_(const uint8_t *data, size_t len, DDPPacket &packet) {
+  if (len < DDP_HEADER_SIZE)
+    return false;
+
+  uint8_t flags = data[0];
+  if ((flags & DDP_VERSION_MASK) != DDP_VERSION_1)
+    return false;
+  // only pixel data is handled, no queries or configuration
+  if (flags & (DDP_FLAG_STORAGE | DDP_FLAG_REPLY | DDP_FLAG_QUERY))
+    return false;
+  if (data[3] != DDP_ID_DISPLAY)
+    return false;
+
+  size_t header_size = DDP_HEADER_SIZE;
+  if (flags & DDP_FLAG_TIMECODE)
+    header_size += DDP_TIMECODE_SIZE;
+
+  packet.offset = encode_uint32(data[4], data[5], data[6], data[7]);
+  packet.length = encode_uint16(data[8], data[9]);
+  if (len < header_size || packet.length > len - header_size)
     return false;
 
-  memcpy(packet.values, sbuff->property_values, packet.count);
+  packet.data = data + header_size;
+  packet.push = flags & DDP_FLAG_PUSH;
   return true;
 }
 
@@ -5,6 +5,7 @@
 #include "esphome/core/preferences.h"
 #include <nvs_flash.h>
 #include <cstring>
+#include <map>
 #include <cinttypes>
 #include <vector>
 #include <string>
@@ -20,6 +21,8 @@ struct NVSData {
 };
 
 static std::vector<NVSData> s_pending_save;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// Hash of the data last read from or written to flash per key, so unchanged saves are skipped without a flash read
+static std::map<std::string, uint32_t> s_stored_hash;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 class ESP32PreferenceBackend : public ESPPreferenceBackend {
  public:
@@ -70,6 +73,7 @@ class ESP32PreferenceBackend : public ESPPreferenceBackend {
     } else {
       ESP_LOGVV(TAG, "nvs_get_blob: key: %s, len: %d", key.c_str(), len);
     }
+    s_stored_hash[key] = fnv1_hash(data, len);
     return true;
   }
 };
@@ -120,8 +124,9 @@ class ESP32Preferences : public ESPPreferences {
     // go through vector from back to front (makes erase easier/more efficient)
     for (ssize_t i = s_pending_save.size() - 1; i >= 0; i--) {
       const auto &save = s_pending_save[i];
+      const uint32_t hash = fnv1_hash(save.data.data(), save.data.size());
       ESP_LOGVV(TAG, "Checking if NVS data %s has changed", save.key.c_str());
-      if (is_changed(nvs_handle, save)) {
+      if (is_changed(nvs_handle, save, hash)) {
         esp_err_t err = nvs_set_blob(nvs_handle, save.key.c_str(), save.data.data(), save.data.size());
         ESP_LOGV(TAG, "sync: key: %s, len: %d", save.key.c_str(), save.data.size());
         if (err != 0) {
@@ -132,6 +137,7 @@ class ESP32Preferences : public ESPPreferences {
           last_key = save.key;
           continue;
         }
+        s_stored_hash[save.key] = hash;
         written++;
       } else {
         ESP_LOGV(TAG, "NVS data not changed skipping %s  len=%u", save.key.c_str(), save.data.size());
@@ -139,8 +145,9 @@ class ESP32Preferences : public ESPPreferences {
       }
       s_pending_save.erase(s_pending_save.begin() + i);
     }
-    ESP_LOGD(TAG, "Writing %d items: %d cached, %d written, %d failed", cached + written + failed, cached, written,
-             failed);
+    this->writes_avoided_ += cached;
+    ESP_LOGD(TAG, "Writing %d items: %d cached, %d written, %d failed (%" PRIu32 " writes avoided since boot)",
+             cached + written + failed, cached, written, failed, this->writes_avoided_);
     if (failed > 0) {
       ESP_LOGE(TAG, "Writing %d items failed. Last error=%s for key=%s", failed, esp_err_to_name(last_err),
                last_key.c_str());
@@ -155,7 +162,12 @@ class ESP32Preferences : public ESPPreferences {
 
     return failed == 0;
   }
-  bool is_changed(const uint32_t nvs_handle, const NVSData &to_save) {
+  bool is_changed(const uint32_t nvs_handle, const NVSData &to_save, uint32_t hash) {
+    auto stored = s_stored_hash.find(to_save.key);
+    if (stored != s_stored_hash.end())
+      return stored->second != hash;
+
+    // Neither loaded nor written since boot: compare with flash once
     NVSData stored_data{};
     size_t actual_len;
     esp_err_t err = nvs_get_blob(nvs_handle, to_save.key.c_str(), nullptr, &actual_len);
@@ -169,12 +181,16 @@ class ESP32Preferences : public ESPPreferences {
       ESP_LOGV(TAG, "nvs_get_blob('%s') failed: %s", to_save.key.c_str(), esp_err_to_name(err));
       return true;
     }
-    return to_save.data != stored_data.data;
+    if (to_save.data != stored_data.data)
+      return true;
+    s_stored_hash[to_save.key] = hash;
+    return false;
   }
 
   bool reset() override {
     ESP_LOGD(TAG, "Erasing storage");
     s_pending_save.clear();
+    s_stored_hash.clear();
 
     nvs_flash_deinit();
     nvs_flash_erase();
@@ -182,6 +198,9 @@ class ESP32Preferences : public ESPPreferences {
     nvs_handle = 0;
     return true;
   }
+
+ protected:
+  uint32_t writes_avoided_{0};
 };
 
 void setup_preferences() {
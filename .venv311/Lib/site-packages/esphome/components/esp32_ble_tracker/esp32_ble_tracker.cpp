@@ -388,18 +388,33 @@ optional<ESPBLEiBeacon> ESPBLEiBeacon::from_manufacturer_data(const ServiceData
   return ESPBLEiBeacon(data.data.data());
 }
 
+/// Call callback(type, data, length) for each AD structure until it returns true.
+template<typename F> static void for_each_ad_record(std::span<const uint8_t> adv, F &&callback) {
+  size_t offset = 0;
+  while (offset + 2 < adv.size()) {
+    const uint8_t field_length = adv[offset++];
+    if (field_length == 0)
+      continue;
+    const uint8_t record_length = field_length - 1;
+    if (offset + field_length > adv.size())
+      return;
+    const uint8_t record_type = adv[offset++];
+    if (callback(record_type, &adv[offset], record_length))
+      return;
+    offset += record_length;
+  }
+}
+
 void ESPBTDevice::parse_scan_rst(const BLEScanResult &scan_result) {
   this->scan_result_ = &scan_result;
   for (uint8_t i = 0; i < ESP_BD_ADDR_LEN; i++)
     this->address_[i] = scan_result.bda[i];
   this->address_type_ = static_cast<esp_ble_addr_type_t>(scan_result.ble_addr_type);
   this->rssi_ = scan_result.rssi;
-
-  // Parse advertisement data directly
-  uint8_t total_len = scan_result.adv_data_len + scan_result.scan_rsp_len;
-  this->parse_adv_(scan_result.ble_adv, total_len);
+  // The advertisement itself is decoded when a listener asks for it
 
 #ifdef ESPHOME_LOG_HAS_VERY_VERBOSE
+  this->parse_();
   ESP_LOGVV(TAG, "Parse Result:");
   const char *address_type;
   switch (this->address_type_) {
@@ -460,7 +475,75 @@ void ESPBTDevice::parse_scan_rst(const BLEScanResult &scan_result) {
 #endif
 }
 
-void ESPBTDevice::parse_adv_(const uint8_t *payload, uint8_t len) {
+void ESPBTDevice::parse_() const {
+  if (this->parsed_)
+    return;
+  this->parsed_ = true;
+  auto adv = this->get_adv_data();
+  this->parse_adv_(adv.data(), adv.size());
+}
+
+optional<std::span<const uint8_t>> ESPBTDevice::get_manufacturer_data(uint16_t company_id) const {
+  optional<std::span<const uint8_t>> result;
+  for_each_ad_record(this->get_adv_data(), [&](uint8_t type, const uint8_t *record, uint8_t len) {
+    if (type != ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE || len < 2 || encode_uint16(record[1], record[0]) != company_id)
+      return false;
+    result = std::span<const uint8_t>(record + 2, len - 2);
+    return true;
+  });
+  return result;
+}
+
+optional<std::span<const uint8_t>> ESPBTDevice::get_service_data(uint16_t uuid) const {
+  optional<std::span<const uint8_t>> result;
+  for_each_ad_record(this->get_adv_data(), [&](uint8_t type, const uint8_t *record, uint8_t len) {
+    if (type != ESP_BLE_AD_TYPE_SERVICE_DATA || len < 2 || encode_uint16(record[1], record[0]) != uuid)
+      return false;
+    result = std::span<const uint8_t>(record + 2, len - 2);
+    return true;
+  });
+  return result;
+}
+
+bool ESPBTDevice::has_service_uuid(const ESPBTUUID &uuid) const {
+  bool found = false;
+  for_each_ad_record(this->get_adv_data(), [&](uint8_t type, const uint8_t *record, uint8_t len) {
+    switch (type) {
+      case ESP_BLE_AD_TYPE_16SRV_CMPL:
+      case ESP_BLE_AD_TYPE_16SRV_PART:
+        for (uint8_t i = 0; i + 2 <= len && !found; i += 2)
+          found = ESPBTUUID::from_uint16(encode_uint16(record[i + 1], record[i])) == uuid;
+        break;
+      case ESP_BLE_AD_TYPE_32SRV_CMPL:
+      case ESP_BLE_AD_TYPE_32SRV_PART:
+        for (uint8_t i = 0; i + 4 <= len && !found; i += 4)
+          found = ESPBTUUID::from_uint32(encode_uint32(record[i + 3], record[i + 2], record[i + 1], record[i])) == uuid;
+        break;
+      case ESP_BLE_AD_TYPE_128SRV_CMPL:
+      case ESP_BLE_AD_TYPE_128SRV_PART:
+        found = len >= 16 && ESPBTUUID::from_raw(record) == uuid;
+        break;
+      default:
+        break;
+    }
+    return found;
+  });
+  return found;
+}
+
+optional<ESPBLEiBeacon> ESPBTDevice::get_ibeacon() const {
+  optional<ESPBLEiBeacon> result;
+  for_each_ad_record(this->get_adv_data(), [&](uint8_t type, const uint8_t *record, uint8_t len) {
+    // Apple's company identifier followed by the 23 bytes of beacon data
+    if (type != ESP_BLE_AD_MANUFACTURER_SPECIFIC_TYPE || len != 25 || record[0] != 0x4C || record[1] != 0x00)
+      return false;
+    result = ESPBLEiBeacon(record + 2);
+    return true;
+  });
+  return result;
+}
+
+void ESPBTDevice::parse_adv_(const uint8_t *payload, uint8_t len) const {
   size_t offset = 0;
 
   while (offset + 2 < len) {
@@ -468,6 +551,9 @@ void ESPBTDevice::parse_adv_(const uint8_t *payload, uint8_t len) {
     if (field_length == 0) {
       continue;  // Possible zero padded advertisement data
     }
+    if (offset + field_length > len) {
+      break;  // Truncated record
+    }
 
     // first byte of adv record is adv record type
     const uint8_t record_type = payload[offset++];
@@ -499,7 +585,7 @@ void ESPBTDevice::parse_adv_(const uint8_t *payload, uint8_t len) {
         // CSS 1.5 TX POWER LEVEL
         // "The TX Power Level data type indicates the transmitted power level of the packet containing the data type."
         // CSS 1: Optional in this context (may appear more than once in a block).
-        this->tx_powers_.push_back(*payload);
+        this->tx_powers_.push_back(*record);
         break;
       }
       case ESP_BLE_AD_TYPE_APPEARANCE: {
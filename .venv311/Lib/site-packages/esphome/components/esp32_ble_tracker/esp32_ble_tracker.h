@@ -6,6 +6,7 @@
 #include "esphome/core/helpers.h"
 
 #include <array>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,14 @@ class ESPBLEiBeacon {
   } PACKED beacon_data_;
 };
 
+/**
+ * A scan result as seen by the listeners.
+ *
+ * The advertisement is only decoded into strings and vectors the first time one of the parsed getters is called.
+ * The lookups that return spans walk the raw data instead and don't allocate, so listeners that only match on the
+ * address, a manufacturer or a service cost no heap. Spans and the parsed data point into the scan result and are
+ * only valid during parse_device().
+ */
 class ESPBTDevice {
  public:
   void parse_scan_rst(const BLEScanResult &scan_result);
@@ -75,47 +84,76 @@ class ESPBTDevice {
 
   esp_ble_addr_type_t get_address_type() const { return this->address_type_; }
   int get_rssi() const { return rssi_; }
-  const std::string &get_name() const { return this->name_; }
+  const std::string &get_name() const {
+    this->parse_();
+    return this->name_;
+  }
 
-  const std::vector<int8_t> &get_tx_powers() const { return tx_powers_; }
+  const std::vector<int8_t> &get_tx_powers() const {
+    this->parse_();
+    return tx_powers_;
+  }
 
-  const optional<uint16_t> &get_appearance() const { return appearance_; }
-  const optional<uint8_t> &get_ad_flag() const { return ad_flag_; }
-  const std::vector<ESPBTUUID> &get_service_uuids() const { return service_uuids_; }
+  const optional<uint16_t> &get_appearance() const {
+    this->parse_();
+    return appearance_;
+  }
+  const optional<uint8_t> &get_ad_flag() const {
+    this->parse_();
+    return ad_flag_;
+  }
+  const std::vector<ESPBTUUID> &get_service_uuids() const {
+    this->parse_();
+    return service_uuids_;
+  }
 
-  const std::vector<ServiceData> &get_manufacturer_datas() const { return manufacturer_datas_; }
+  const std::vector<ServiceData> &get_manufacturer_datas() const {
+    this->parse_();
+    return manufacturer_datas_;
+  }
 
-  const std::vector<ServiceData> &get_service_datas() const { return service_datas_; }
+  const std::vector<ServiceData> &get_service_datas() const {
+    this->parse_();
+    return service_datas_;
+  }
+
+  /// Advertisement and scan response data as received.
+  std::span<const uint8_t> get_adv_data() const {
+    return {this->scan_result_->ble_adv,
+            static_cast<size_t>(this->scan_result_->adv_data_len + this->scan_result_->scan_rsp_len)};
+  }
+  /// Data of the first manufacturer specific record of a company, without the company identifier.
+  optional<std::span<const uint8_t>> get_manufacturer_data(uint16_t company_id) const;
+  /// Data of the first service data record with a 16 bit UUID, without the UUID.
+  optional<std::span<const uint8_t>> get_service_data(uint16_t uuid) const;
+  /// Whether the service UUID lists contain uuid.
+  bool has_service_uuid(const ESPBTUUID &uuid) const;
 
   // Exposed through a function for use in lambdas
   const BLEScanResult &get_scan_result() const { return *scan_result_; }
 
   bool resolve_irk(const uint8_t *irk) const;
 
-  optional<ESPBLEiBeacon> get_ibeacon() const {
-    for (auto &it : this->manufacturer_datas_) {
-      auto res = ESPBLEiBeacon::from_manufacturer_data(it);
-      if (res.has_value())
-        return *res;
-    }
-    return {};
-  }
+  optional<ESPBLEiBeacon> get_ibeacon() const;
 
  protected:
-  void parse_adv_(const uint8_t *payload, uint8_t len);
+  /// Decode the advertisement into the members below, once.
+  void parse_() const;
+  void parse_adv_(const uint8_t *payload, uint8_t len) const;
 
   esp_bd_addr_t address_{
       0,
   };
   esp_ble_addr_type_t address_type_{BLE_ADDR_TYPE_PUBLIC};
   int rssi_{0};
-  std::string name_{};
-  std::vector<int8_t> tx_powers_{};
-  optional<uint16_t> appearance_{};
-  optional<uint8_t> ad_flag_{};
-  std::vector<ESPBTUUID> service_uuids_{};
-  std::vector<ServiceData> manufacturer_datas_{};
-  std::vector<ServiceData> service_datas_{};
+  mutable bool parsed_{false};
+  mutable std::string name_{};
+  mutable std::vector<int8_t> tx_powers_{};
+  mutable optional<uint16_t> appearance_{};
+  mutable optional<uint8_t> ad_flag_{};
+  mutable std::vector<ESPBTUUID> service_uuids_{};
+  mutable std::vector<ServiceData> manufacturer_datas_{};
+  mutable std::vector<ServiceData> service_datas_{};
   const BLEScanResult *scan_result_{nullptr};
 };
 #endif  // USE_ESP32_BLE_DEVICE
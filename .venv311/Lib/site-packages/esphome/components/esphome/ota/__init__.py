@@ -1,7 +1,7 @@
 import logging
 
 import esphome.codegen as cg
-from esphome.components.ota import BASE_OTA_SCHEMA, OTAComponent, ota_to_code
+from esphome.components.ota import BASE_OTA_SCHEMA, OTAComponent, ota_ns, ota_to_code
 from esphome.config_helpers import merge_config
 import esphome.config_validation as cv
 from esphome.const import (
@@ -10,13 +10,15 @@ from esphome.const import (
     CONF_NUM_ATTEMPTS,
     CONF_OTA,
     CONF_PASSWORD,
+    CONF_PATH,
     CONF_PLATFORM,
     CONF_PORT,
     CONF_REBOOT_TIMEOUT,
     CONF_SAFE_MODE,
     CONF_VERSION,
+    PLATFORM_HOST,
 )
-from esphome.core import coroutine_with_priority
+from esphome.core import CORE, coroutine_with_priority
 import esphome.final_validate as fv
 
 _LOGGER = logging.getLogger(__name__)
@@ -26,7 +28,13 @@ CODEOWNERS = ["@esphome/core"]
 AUTO_LOAD = ["md5", "socket"]
 DEPENDENCIES = ["network"]
 
+CONF_ERASE_LATENCY = "erase_latency"
+CONF_HOST_BACKEND = "host_backend"
+CONF_RUNNING_IMAGE = "running_image"
+
 esphome = cg.esphome_ns.namespace("esphome")
+set_host_ota_backend = ota_ns.set_host_ota_backend
+set_host_ota_running_image = ota_ns.set_host_ota_running_image
 ESPHomeOTAComponent = esphome.class_("ESPHomeOTAComponent", OTAComponent)
 
 
@@ -101,8 +109,23 @@ CONFIG_SCHEMA = (
                 bk72xx=8892,
                 ln882x=8820,
                 rtl87xx=8892,
+                host=3232,
             ): cv.port,
             cv.Optional(CONF_PASSWORD): cv.string,
+            # Where the host platform stores received images, with a simulated flash erase stall per 4 KB sector
+            cv.Optional(CONF_HOST_BACKEND): cv.All(
+                cv.Schema(
+                    {
+                        cv.Optional(CONF_PATH, default="firmware.ota.bin"): cv.string,
+                        # Stands in for the running firmware that delta updates are applied to
+                        cv.Optional(CONF_RUNNING_IMAGE): cv.string,
+                        cv.Optional(
+                            CONF_ERASE_LATENCY, default="0us"
+                        ): cv.positive_time_period_microseconds,
+                    }
+                ),
+                cv.only_on(PLATFORM_HOST),
+            ),
             cv.Optional(CONF_NUM_ATTEMPTS): cv.invalid(
                 f"'{CONF_SAFE_MODE}' (and its related configuration variables) has moved from 'ota' to its own component. See https://esphome.io/components/safe_mode"
             ),
@@ -129,6 +152,24 @@ async def to_code(config):
         cg.add(var.set_auth_password(config[CONF_PASSWORD]))
         cg.add_define("USE_OTA_PASSWORD")
     cg.add_define("USE_OTA_VERSION", config[CONF_VERSION])
+    # Platforms with threads write the flash from a separate task while receiving
+    if CORE.is_esp32 or CORE.is_host:
+        cg.add_define("USE_OTA_PIPELINE")
+    # Compressed images are inflated on the device for backends without gzip support
+    # of their own; RP2040 needs the image size up front, which is only known at the end
+    if CORE.is_esp32 or CORE.is_libretiny or CORE.is_host:
+        cg.add_define("USE_OTA_INFLATE")
+    # Backends that can read the running image accept patches against it
+    if CORE.using_esp_idf or CORE.is_host:
+        cg.add_define("USE_OTA_DELTA")
+    if host_backend := config.get(CONF_HOST_BACKEND):
+        cg.add(
+            set_host_ota_backend(
+                host_backend[CONF_PATH], host_backend[CONF_ERASE_LATENCY]
+            )
+        )
+        if running_image := host_backend.get(CONF_RUNNING_IMAGE):
+            cg.add(set_host_ota_running_image(running_image))
 
     await cg.register_component(var, config)
     await ota_to_code(var, config)
@@ -8,6 +8,9 @@
 #include "esphome/components/ota/ota_backend_arduino_libretiny.h"
 #include "esphome/components/ota/ota_backend_arduino_rp2040.h"
 #include "esphome/components/ota/ota_backend_esp_idf.h"
+#include "esphome/components/ota/ota_backend_host.h"
+#include "esphome/components/ota/ota_delta.h"
+#include "esphome/components/ota/ota_inflate.h"
 #include "esphome/core/application.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/log.h"
@@ -20,6 +23,9 @@ namespace esphome {
 
 static const char *const TAG = "esphome.ota";
 static constexpr uint16_t OTA_BLOCK_SIZE = 8192;
+#ifdef USE_OTA_PIPELINE
+static constexpr size_t OTA_PIPELINE_BUFFERS = 3;  // receive buffers of OTA_BLOCK_SIZE while flash is written
+#endif
 static constexpr uint32_t OTA_SOCKET_TIMEOUT_HANDSHAKE = 10000;  // milliseconds for initial handshake
 static constexpr uint32_t OTA_SOCKET_TIMEOUT_DATA = 90000;       // milliseconds for data transfer
 
@@ -95,6 +101,7 @@ void ESPHomeOTAComponent::loop() {
 }
 
 static const uint8_t FEATURE_SUPPORTS_COMPRESSION = 0x01;
+static const uint8_t FEATURE_SUPPORTS_DELTA = 0x02;
 
 void ESPHomeOTAComponent::handle_handshake_() {
   /// Handle the initial OTA handshake.
@@ -195,7 +202,17 @@ void ESPHomeOTAComponent::handle_data_() {
   size_t ota_size;
   uint8_t ota_features;
   std::unique_ptr<ota::OTABackend> backend;
+#ifdef USE_OTA_PIPELINE
+  std::unique_ptr<ota::OTAWritePipeline> pipeline;
+#endif
+#ifdef USE_OTA_DELTA
+  std::unique_ptr<ota::DeltaPatcher> patcher;
+  ota::DeltaHeader delta_header;
+#endif
+  bool delta = false;
+  size_t image_size;
   (void) ota_features;
+  (void) delta;
 #if USE_OTA_VERSION == 2
   size_t size_acknowledged = 0;
 #endif
@@ -217,8 +234,28 @@ void ESPHomeOTAComponent::handle_data_() {
 
   // Acknowledge header - 1 byte
   buf[0] = ota::OTA_RESPONSE_HEADER_OK;
-  if ((ota_features & FEATURE_SUPPORTS_COMPRESSION) != 0 && backend->supports_compression()) {
-    buf[0] = ota::OTA_RESPONSE_SUPPORTS_COMPRESSION;
+#ifdef USE_OTA_DELTA
+  // A delta is only offered by the client when it has an image the patch can be made against
+  if ((ota_features & FEATURE_SUPPORTS_DELTA) != 0 && backend->supports_delta()) {
+    buf[0] = ota::OTA_RESPONSE_SUPPORTS_DELTA;
+    delta = true;
+  }
+#endif
+  if (!delta && (ota_features & FEATURE_SUPPORTS_COMPRESSION) != 0) {
+#ifdef USE_OTA_INFLATE
+    // Backends that can't take gzip images get them inflated on the way. The window is allocated before
+    // compression is offered, without it the client just sends the image uncompressed.
+    if (!backend->supports_compression()) {
+      uint8_t *window = ota::InflateOTABackend::allocate_window();
+      if (window != nullptr) {
+        backend = make_unique<ota::InflateOTABackend>(std::move(backend), window);
+      } else {
+        ESP_LOGW(TAG, "Not enough memory to decompress, requesting an uncompressed image");
+      }
+    }
+#endif
+    if (backend->supports_compression())
+      buf[0] = ota::OTA_RESPONSE_SUPPORTS_COMPRESSION;
   }
 
   this->writeall_(buf, 1);
@@ -308,8 +345,31 @@ void ESPHomeOTAComponent::handle_data_() {
   this->state_callback_.call(ota::OTA_STARTED, 0.0f, 0);
 #endif
 
+  image_size = ota_size;
+#ifdef USE_OTA_DELTA
+  // A delta update starts with a header describing the old and new images, the size above includes it
+  if (delta) {
+    if (ota_size < ota::DELTA_HEADER_SIZE || !this->readall_(buf, ota::DELTA_HEADER_SIZE)) {
+      this->log_read_error_("delta header");
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    // Reply with a distinct error if the device runs another image, the client then sends the full image
+    error_code = ota::OTA_RESPONSE_ERROR_DELTA_BASE;
+    if (!delta_header.parse(buf)) {
+      ESP_LOGW(TAG, "Invalid delta header");
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    }
+    patcher = make_unique<ota::DeltaPatcher>(backend.get(), delta_header);
+    if (!patcher->verify_base())
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    ota_size -= ota::DELTA_HEADER_SIZE;
+    image_size = delta_header.new_size;
+    ESP_LOGD(TAG, "Delta of %zu bytes for an image of %zu bytes", ota_size, image_size);
+  }
+#endif
+
   // This will block for a few seconds as it locks flash
-  error_code = backend->begin(ota_size);
+  error_code = backend->begin(image_size);
   if (error_code != ota::OTA_RESPONSE_OK)
     goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
   update_started = true;
@@ -331,6 +391,21 @@ void ESPHomeOTAComponent::handle_data_() {
   buf[0] = ota::OTA_RESPONSE_BIN_MD5_OK;
   this->writeall_(buf, 1);
 
+#ifdef USE_OTA_PIPELINE
+  // Hand the data to a writer task, so the socket keeps receiving while the flash is busy. Without the memory for
+  // the buffers this falls back to the synchronous loop below.
+  // Delta updates read the running image while patching, they stay in the synchronous loop.
+  pipeline = make_unique<ota::OTAWritePipeline>(backend.get());
+  if (!delta && pipeline->start(OTA_PIPELINE_BUFFERS, OTA_BLOCK_SIZE)) {
+    error_code = this->receive_pipelined_(*pipeline, ota_size);
+    pipeline->stop();
+    if (error_code != ota::OTA_RESPONSE_OK)
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
+    total = ota_size;
+  }
+  pipeline = nullptr;
+#endif
+
   while (total < ota_size) {
     // TODO: timeout check
     size_t requested = std::min(sizeof(buf), ota_size - total);
@@ -350,7 +425,11 @@ void ESPHomeOTAComponent::handle_data_() {
       goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
     }
 
+#ifdef USE_OTA_DELTA
+    error_code = delta ? patcher->feed(buf, read) : backend->write(buf, read);
+#else
     error_code = backend->write(buf, read);
+#endif
     if (error_code != ota::OTA_RESPONSE_OK) {
       ESP_LOGW(TAG, "Flash write error, code: %d", error_code);
       goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
@@ -364,18 +443,16 @@ void ESPHomeOTAComponent::handle_data_() {
     }
 #endif
 
-    uint32_t now = millis();
-    if (now - last_progress > 1000) {
-      last_progress = now;
-      float percentage = (total * 100.0f) / ota_size;
-      ESP_LOGD(TAG, "Progress: %0.1f%%", percentage);
-#ifdef USE_OTA_STATE_CALLBACK
-      this->state_callback_.call(ota::OTA_IN_PROGRESS, percentage, 0);
-#endif
-      // feed watchdog and give other tasks a chance to run
-      this->yield_and_feed_watchdog_();
-    }
+    this->report_progress_(total, ota_size, last_progress);
+  }
+
+#ifdef USE_OTA_DELTA
+  if (delta) {
+    error_code = patcher->finish();
+    if (error_code != ota::OTA_RESPONSE_OK)
+      goto error;  // NOLINT(cppcoreguidelines-avoid-goto)
   }
+#endif
 
   // Acknowledge receive OK - 1 byte
   buf[0] = ota::OTA_RESPONSE_RECEIVE_OK;
@@ -422,6 +499,84 @@ error:
 #endif
 }
 
+void ESPHomeOTAComponent::report_progress_(size_t total, size_t ota_size, uint32_t &last_progress) {
+  uint32_t now = millis();
+  if (now - last_progress > 1000) {
+    last_progress = now;
+    float percentage = (total * 100.0f) / ota_size;
+    ESP_LOGD(TAG, "Progress: %0.1f%%", percentage);
+#ifdef USE_OTA_STATE_CALLBACK
+    this->state_callback_.call(ota::OTA_IN_PROGRESS, percentage, 0);
+#endif
+    // feed watchdog and give other tasks a chance to run
+    this->yield_and_feed_watchdog_();
+  }
+}
+
+#ifdef USE_OTA_PIPELINE
+ota::OTAResponseTypes ESPHomeOTAComponent::receive_pipelined_(ota::OTAWritePipeline &pipeline, size_t ota_size) {
+  const size_t block_size = pipeline.get_buffer_size();
+  size_t received = 0;
+  size_t submitted = 0;
+  uint8_t *block = nullptr;
+  uint32_t last_progress = 0;
+#if USE_OTA_VERSION == 2
+  size_t size_acknowledged = 0;
+#endif
+  while (received < ota_size) {
+    if (pipeline.get_error() != ota::OTA_RESPONSE_OK) {
+      ESP_LOGW(TAG, "Flash write error, code: %d", pipeline.get_error());
+      return pipeline.get_error();
+    }
+    if (block == nullptr) {
+      block = pipeline.get_free_buffer();
+      if (block == nullptr) {
+        // All buffers wait for the flash; not reading leaves the sender to TCP flow control
+        this->yield_and_feed_watchdog_();
+        continue;
+      }
+    }
+    size_t filled = received - submitted;
+    ssize_t read = this->client_->read(block + filled, std::min(block_size - filled, ota_size - received));
+    if (read == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        this->yield_and_feed_watchdog_();
+        continue;
+      }
+      ESP_LOGW(TAG, "Read error, errno %d", errno);
+      return ota::OTA_RESPONSE_ERROR_UNKNOWN;
+    } else if (read == 0) {
+      ESP_LOGW(TAG, "Remote closed connection");
+      return ota::OTA_RESPONSE_ERROR_UNKNOWN;
+    }
+    received += read;
+    if (received - submitted == block_size || received == ota_size) {
+      pipeline.submit(received - submitted);
+      submitted = received;
+      block = nullptr;
+    }
+#if USE_OTA_VERSION == 2
+    // Acknowledge blocks as soon as they are queued, so the next one arrives while this one is written
+    while (size_acknowledged + OTA_BLOCK_SIZE <= submitted ||
+           (submitted == ota_size && size_acknowledged < ota_size)) {
+      uint8_t ack = ota::OTA_RESPONSE_CHUNK_OK;
+      this->writeall_(&ack, 1);
+      size_acknowledged += OTA_BLOCK_SIZE;
+    }
+#endif
+    this->report_progress_(received, ota_size, last_progress);
+  }
+
+  while (!pipeline.is_idle())
+    this->yield_and_feed_watchdog_();
+  if (pipeline.get_error() != ota::OTA_RESPONSE_OK) {
+    ESP_LOGW(TAG, "Flash write error, code: %d", pipeline.get_error());
+    return pipeline.get_error();
+  }
+  return ota::OTA_RESPONSE_OK;
+}
+#endif
+
 bool ESPHomeOTAComponent::readall_(uint8_t *buf, size_t len) {
   uint32_t start = millis();
   uint32_t at = 0;
@@ -5,6 +5,7 @@
 #include "esphome/core/helpers.h"
 #include "esphome/core/preferences.h"
 #include "esphome/components/ota/ota_backend.h"
+#include "esphome/components/ota/ota_pipeline.h"
 #include "esphome/components/socket/socket.h"
 
 namespace esphome {
@@ -31,6 +32,10 @@ class ESPHomeOTAComponent : public ota::OTAComponent {
   void handle_data_();
   bool readall_(uint8_t *buf, size_t len);
   bool writeall_(const uint8_t *buf, size_t len);
+  void report_progress_(size_t total, size_t ota_size, uint32_t &last_progress);
+#ifdef USE_OTA_PIPELINE
+  ota::OTAResponseTypes receive_pipelined_(ota::OTAWritePipeline &pipeline, size_t ota_size);
+#endif
   void log_socket_error_(const char *msg);
   void log_read_error_(const char *what);
   void log_start_(const char *phase);
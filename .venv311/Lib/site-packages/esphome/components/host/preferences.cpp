@@ -1,9 +1,12 @@
 #ifdef USE_HOST
 
+#include <cinttypes>
 #include <filesystem>
 #include <fstream>
 #include "preferences.h"
 #include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
 
 namespace esphome {
 namespace host {
@@ -11,6 +14,9 @@ namespace fs = std::filesystem;
 
 static const char *const TAG = "host.preferences";
 
+// Superseded records tolerated in the file before it is compacted
+static const size_t COMPACT_SLACK = 32;
+
 void HostPreferences::setup_() {
   if (this->setup_complete_)
     return;
@@ -35,29 +41,79 @@ void HostPreferences::setup_() {
         break;
       std::vector vec(data, data + len);
       this->data[key] = vec;
+      this->file_records_++;
     }
     fclose(fp);
   }
+  for (auto &it : this->data)
+    this->stored_hash_[it.first] = fnv1_hash(it.second.data(), it.second.size());
   this->setup_complete_ = true;
 }
 
+static void write_record(FILE *fp, uint32_t key, const std::vector<uint8_t> &value) {
+  fwrite(&key, sizeof(uint32_t), 1, fp);
+  uint8_t len = value.size();
+  fwrite(&len, sizeof(len), 1, fp);
+  fwrite(value.data(), sizeof(uint8_t), value.size(), fp);
+}
+
+bool HostPreferences::compact_() {
+  FILE *fp = fopen(this->filename_.c_str(), "wb");
+  if (fp == nullptr)
+    return false;
+  this->stored_hash_.clear();
+  for (auto &it : this->data) {
+    write_record(fp, it.first, it.second);
+    this->stored_hash_[it.first] = fnv1_hash(it.second.data(), it.second.size());
+  }
+  fclose(fp);
+  this->file_records_ = this->data.size();
+  this->dirty_.clear();
+  this->compact_pending_ = false;
+  return true;
+}
+
 bool HostPreferences::sync() {
   this->setup_();
-  FILE *fp = fopen(this->filename_.c_str(), "wb");
-  std::map<uint32_t, std::vector<uint8_t>>::iterator it;
+  if (this->compact_pending_ || this->file_records_ > this->data.size() * 2 + COMPACT_SLACK)
+    return this->compact_();
+  if (this->dirty_.empty())
+    return true;
 
-  for (it = this->data.begin(); it != this->data.end(); ++it) {
-    fwrite(&it->first, sizeof(uint32_t), 1, fp);
-    uint8_t len = it->second.size();
-    fwrite(&len, sizeof(len), 1, fp);
-    fwrite(it->second.data(), sizeof(uint8_t), it->second.size(), fp);
+  // Later records override earlier ones when loading, so changed values are simply appended
+  FILE *fp = nullptr;
+  int cached = 0, written = 0;
+  for (uint32_t key : this->dirty_) {
+    const auto &value = this->data[key];
+    uint32_t hash = fnv1_hash(value.data(), value.size());
+    auto stored = this->stored_hash_.find(key);
+    if (stored != this->stored_hash_.end() && stored->second == hash) {
+      cached++;
+      continue;
+    }
+    if (fp == nullptr) {
+      fp = fopen(this->filename_.c_str(), "ab");
+      if (fp == nullptr)
+        return false;
+    }
+    write_record(fp, key, value);
+    this->stored_hash_[key] = hash;
+    this->file_records_++;
+    written++;
   }
-  fclose(fp);
+  if (fp != nullptr)
+    fclose(fp);
+  this->dirty_.clear();
+  this->writes_avoided_ += cached;
+  ESP_LOGV(TAG, "Writing %d items: %d cached, %d written (%" PRIu32 " writes avoided since boot)", cached + written,
+           cached, written, this->writes_avoided_);
   return true;
 }
 
 bool HostPreferences::reset() {
-  host_preferences->data.clear();
+  this->data.clear();
+  this->dirty_.clear();
+  this->compact_pending_ = true;
   return true;
 }
 
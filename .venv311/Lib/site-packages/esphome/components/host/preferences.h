@@ -4,6 +4,7 @@
 
 #include "esphome/core/preferences.h"
 #include <map>
+#include <set>
 
 namespace esphome {
 namespace host {
@@ -35,6 +36,7 @@ class HostPreferences : public ESPPreferences {
     this->setup_();
     std::vector vec(data, data + len);
     this->data[key] = vec;
+    this->dirty_.insert(key);
     return true;
   }
 
@@ -53,9 +55,19 @@ class HostPreferences : public ESPPreferences {
 
  protected:
   void setup_();
+  /// Rewrite the file with only the current value of each key.
+  bool compact_();
   bool setup_complete_{};
   std::string filename_{};
   std::map<uint32_t, std::vector<uint8_t>> data{};
+  /// Keys saved since the last sync
+  std::set<uint32_t> dirty_{};
+  /// Hash of the value most recently written to the file per key
+  std::map<uint32_t, uint32_t> stored_hash_{};
+  /// Number of records in the file, including ones superseded by later records
+  size_t file_records_{0};
+  bool compact_pending_{false};
+  uint32_t writes_avoided_{0};
 };
 void setup_preferences();
 extern HostPreferences *host_preferences;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
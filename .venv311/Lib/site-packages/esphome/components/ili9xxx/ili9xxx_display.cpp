@@ -1,4 +1,5 @@
 #include "ili9xxx_display.h"
+#include "esphome/components/display/pixel_convert.h"
 #include "esphome/core/application.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
@@ -250,43 +251,41 @@ void ILI9XXXDisplay::display_() {
   } else {
     ESP_LOGV(TAG, "Doing multiple write");
     uint8_t transfer_buffer[ILI9XXX_TRANSFER_BUFFER_SIZE];
-    size_t rem = h * w;  // remaining number of pixels to write
+    // 8 bit modes are first expanded to big endian RGB565 here
+    uint8_t rgb565_buffer[ILI9XXX_TRANSFER_BUFFER_SIZE];
+    const size_t out_size = this->is_18bitdisplay_ ? 3 : 2;
+    const size_t chunk_pixels = sizeof(transfer_buffer) / out_size;
+    size_t idx = 0;  // index into transfer_buffer
     set_addr_window_(this->x_low_, this->y_low_, this->x_high_, this->y_high_);
-    size_t idx = 0;    // index into transfer_buffer
-    size_t pixel = 0;  // pixel number offset
-    size_t pos = this->y_low_ * this->width_ + this->x_low_;
-    while (rem-- != 0) {
-      uint16_t color_val;
-      switch (this->buffer_color_mode_) {
-        case BITS_8:
-          color_val = display::ColorUtil::color_to_565(display::ColorUtil::rgb332_to_color(this->buffer_[pos++]));
-          break;
-        case BITS_8_INDEXED:
-          color_val = display::ColorUtil::color_to_565(
-              display::ColorUtil::index8_to_color_palette888(this->buffer_[pos++], this->palette_));
-          break;
-        default:  // case BITS_16:
-          color_val = (this->buffer_[pos * 2] << 8) + this->buffer_[pos * 2 + 1];
-          pos++;
-          break;
-      }
-      if (this->is_18bitdisplay_) {
-        transfer_buffer[idx++] = (uint8_t) ((color_val & 0xF800) >> 8);  // Blue
-        transfer_buffer[idx++] = (uint8_t) ((color_val & 0x7E0) >> 3);   // Green
-        transfer_buffer[idx++] = (uint8_t) (color_val << 3);             // Red
-      } else {
-        put16_be(transfer_buffer + idx, color_val);
-        idx += 2;
-      }
-      if (idx == sizeof(transfer_buffer)) {
-        this->write_array(transfer_buffer, idx);
-        idx = 0;
-        App.feed_wdt();
-      }
-      // end of line? Skip to the next.
-      if (++pixel == w) {
-        pixel = 0;
-        pos += this->width_ - w;
+    for (size_t y = this->y_low_; y <= this->y_high_; y++) {
+      size_t pos = y * this->width_ + this->x_low_;
+      for (size_t x = 0; x != w;) {
+        size_t count = std::min(w - x, chunk_pixels - idx / out_size);
+        const uint8_t *rgb565;
+        if (this->buffer_color_mode_ == BITS_16) {
+          rgb565 = this->buffer_ + (pos + x) * 2;
+        } else {
+          for (size_t i = 0; i != count; i++) {
+            uint8_t value = this->buffer_[pos + x + i];
+            Color color = this->buffer_color_mode_ == BITS_8
+                              ? display::ColorUtil::rgb332_to_color(value)
+                              : display::ColorUtil::index8_to_color_palette888(value, this->palette_);
+            put16_be(rgb565_buffer + i * 2, display::ColorUtil::color_to_565(color));
+          }
+          rgb565 = rgb565_buffer;
+        }
+        if (this->is_18bitdisplay_) {
+          display::rgb565_to_rgb666(rgb565, transfer_buffer + idx, count, true);
+        } else {
+          memcpy(transfer_buffer + idx, rgb565, count * 2);
+        }
+        idx += count * out_size;
+        x += count;
+        if (idx == chunk_pixels * out_size) {
+          this->write_array(transfer_buffer, idx);
+          idx = 0;
+          App.feed_wdt();
+        }
       }
     }
     // flush any balance.
@@ -332,26 +331,21 @@ void ILI9XXXDisplay::draw_pixels_at(int x_start, int y_start, int w, int h, cons
   } else {
     // 18 bit mode
     uint8_t transfer_buffer[ILI9XXX_TRANSFER_BUFFER_SIZE * 4];
+    const size_t chunk_pixels = sizeof(transfer_buffer) / 3;
     ESP_LOGV(TAG, "Doing multiple write");
-    size_t rem = h * w;  // remaining number of pixels to write
-    size_t idx = 0;      // index into transfer_buffer
-    size_t pixel = 0;    // pixel number offset
-    ptr += (y_offset * stride + x_offset) * 2;
-    while (rem-- != 0) {
-      uint8_t hi_byte = *ptr++;
-      uint8_t lo_byte = *ptr++;
-      transfer_buffer[idx++] = hi_byte & 0xF8;                     // Blue
-      transfer_buffer[idx++] = ((hi_byte << 5) | (lo_byte) >> 5);  // Green
-      transfer_buffer[idx++] = lo_byte << 3;                       // Red
-      if (idx == sizeof(transfer_buffer)) {
-        this->write_array(transfer_buffer, idx);
-        idx = 0;
-        App.feed_wdt();
-      }
-      // end of line? Skip to the next.
-      if (++pixel == w) {
-        pixel = 0;
-        ptr += (x_pad + x_offset) * 2;
+    size_t idx = 0;  // index into transfer_buffer
+    for (size_t y = 0; y != h; y++) {
+      const uint8_t *line = ptr + ((y + y_offset) * stride + x_offset) * 2;
+      for (size_t x = 0; x != w;) {
+        size_t count = std::min<size_t>(w - x, chunk_pixels - idx / 3);
+        display::rgb565_to_rgb666(line + x * 2, transfer_buffer + idx, count, true);
+        idx += count * 3;
+        x += count;
+        if (idx == sizeof(transfer_buffer)) {
+          this->write_array(transfer_buffer, idx);
+          idx = 0;
+          App.feed_wdt();
+        }
       }
     }
     // flush any balance.
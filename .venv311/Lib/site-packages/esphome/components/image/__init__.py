@@ -12,6 +12,7 @@ from PIL import Image, UnidentifiedImageError
 from esphome import core, external_files
 import esphome.codegen as cg
 from esphome.components.const import CONF_BYTE_ORDER
+from esphome.components.display import DISPLAY_ROTATIONS, validate_rotation
 import esphome.config_validation as cv
 from esphome.const import (
     CONF_DEFAULTS,
@@ -22,6 +23,7 @@ from esphome.const import (
     CONF_PATH,
     CONF_RAW_DATA_ID,
     CONF_RESIZE,
+    CONF_ROTATION,
     CONF_SOURCE,
     CONF_TYPE,
     CONF_URL,
@@ -36,12 +38,24 @@ DEPENDENCIES = ["display"]
 image_ns = cg.esphome_ns.namespace("image")
 
 ImageType = image_ns.enum("ImageType")
+ImageCompression = image_ns.enum("ImageCompression")
 
 CONF_OPAQUE = "opaque"
 CONF_CHROMA_KEY = "chroma_key"
 CONF_ALPHA_CHANNEL = "alpha_channel"
 CONF_INVERT_ALPHA = "invert_alpha"
 CONF_IMAGES = "images"
+CONF_COMPRESSION = "compression"
+
+COMPRESSION_NONE = "NONE"
+COMPRESSION_RLE = "RLE"
+
+# Transpose that stores an image the way a display with the given rotation holds it in its buffer
+ROTATION_TRANSPOSE = {
+    90: Image.Transpose.ROTATE_270,
+    180: Image.Transpose.ROTATE_180,
+    270: Image.Transpose.ROTATE_90,
+}
 
 TRANSPARENCY_TYPES = (
     CONF_OPAQUE,
@@ -58,6 +72,74 @@ def get_transparency_enum(transparency):
     return getattr(TransparencyType, f"TRANSPARENCY_{transparency.upper()}")
 
 
+def get_compression_enum(compression):
+    return getattr(ImageCompression, f"IMAGE_COMPRESSION_{compression.upper()}")
+
+
+def rle_encode_row(row, pixel_size):
+    """
+    Run-length encode one row of pixels.
+    A control byte with bit 7 set is followed by one pixel repeated (control & 0x7F) + 1 times,
+    otherwise it is followed by control + 1 literal pixels.
+    """
+    pixels = [bytes(row[i : i + pixel_size]) for i in range(0, len(row), pixel_size)]
+    result = bytearray()
+    literals = []
+
+    def flush_literals():
+        while literals:
+            chunk = literals[:128]
+            del literals[:128]
+            result.append(len(chunk) - 1)
+            for pixel in chunk:
+                result.extend(pixel)
+
+    index = 0
+    while index < len(pixels):
+        run = 1
+        while (
+            index + run < len(pixels)
+            and run < 128
+            and pixels[index + run] == pixels[index]
+        ):
+            run += 1
+        if run > 1:
+            flush_literals()
+            result.append(0x80 | (run - 1))
+            result.extend(pixels[index])
+        else:
+            literals.append(pixels[index])
+        index += run
+    flush_literals()
+    return result
+
+
+def rle_compress(data, width, height, frame_count):
+    """
+    Compress the rows of all frames, preceded by a row offset table per frame.
+    Identical rows (e.g. unchanged parts of consecutive animation frames) are stored once.
+    """
+    total_rows = height * frame_count
+    row_size = len(data) // total_rows
+    pixel_size = row_size // width
+    table_size = total_rows * 4
+    rows = bytearray()
+    row_positions = {}
+    offsets = []
+    for row_index in range(total_rows):
+        row = bytes(data[row_index * row_size : (row_index + 1) * row_size])
+        if row not in row_positions:
+            row_positions[row] = table_size + len(rows)
+            rows.extend(rle_encode_row(row, pixel_size))
+        # Offsets are relative to the start of the frame's own table
+        frame_table_start = (row_index // height) * height * 4
+        offsets.append(row_positions[row] - frame_table_start)
+    table = bytearray()
+    for offset in offsets:
+        table.extend(offset.to_bytes(4, "little"))
+    return list(table + rows)
+
+
 class ImageEncoder:
     """
     Superclass of image type encoders
@@ -483,6 +565,19 @@ def validate_settings(value, path=()):
         and CONF_INVERT_ALPHA not in type_class.allow_config
     ):
         raise cv.Invalid("No alpha channel to invert")
+    if value.get(CONF_COMPRESSION) == COMPRESSION_RLE and conf_type == "BINARY":
+        raise cv.Invalid(
+            f"Image format '{conf_type}' does not support compression", path=path
+        )
+    if value.get(CONF_ROTATION):
+        if conf_type != "RGB565":
+            raise cv.Invalid(
+                f"Image format '{conf_type}' does not support rotation", path=path
+            )
+        if value.get(CONF_COMPRESSION) == COMPRESSION_RLE:
+            raise cv.Invalid(
+                "Rotation can't be combined with compression", path=path
+            )
     if value.get(CONF_BYTE_ORDER) is not None and not type_class.is_endian():
         raise cv.Invalid(
             f"Image format '{conf_type}' does not support byte order configuration",
@@ -517,6 +612,10 @@ OPTIONS_SCHEMA = {
     cv.Optional(CONF_INVERT_ALPHA, default=False): cv.boolean,
     cv.Optional(CONF_BYTE_ORDER): cv.one_of("BIG_ENDIAN", "LITTLE_ENDIAN", upper=True),
     cv.Optional(CONF_TRANSPARENCY, default=CONF_OPAQUE): validate_transparency(),
+    cv.Optional(CONF_COMPRESSION, default=COMPRESSION_NONE): cv.one_of(
+        COMPRESSION_NONE, COMPRESSION_RLE, upper=True
+    ),
+    cv.Optional(CONF_ROTATION, default=0): validate_rotation,
 }
 
 DEFAULTS_SCHEMA = {
@@ -715,20 +814,37 @@ async def write_image(config, all_frames=False):
         if frame_count <= 1:
             _LOGGER.warning("Image file %s has no animation frames", path)
 
-    total_rows = height * frame_count
-    encoder = IMAGE_TYPE[type](width, total_rows, transparency, dither, invert_alpha)
+    # Pre-rotated data is stored with the rows of the rotated image
+    rotation = config.get(CONF_ROTATION) or 0
+    stored_width, stored_height = (
+        (height, width) if rotation in (90, 270) else (width, height)
+    )
+    total_rows = stored_height * frame_count
+    encoder = IMAGE_TYPE[type](
+        stored_width, total_rows, transparency, dither, invert_alpha
+    )
     if byte_order := config.get(CONF_BYTE_ORDER):
         # Check for valid type has already been done in validate_settings
         encoder.set_big_endian(byte_order == "BIG_ENDIAN")
     for frame_index in range(frame_count):
         image.seek(frame_index)
-        pixels = encoder.convert(image.resize((width, height)), path).getdata()
-        for row in range(height):
-            for col in range(width):
-                encoder.encode(pixels[row * width + col])
+        frame = image.resize((width, height))
+        if rotation:
+            frame = frame.transpose(ROTATION_TRANSPOSE[rotation])
+        pixels = encoder.convert(frame, path).getdata()
+        for row in range(stored_height):
+            for col in range(stored_width):
+                encoder.encode(pixels[row * stored_width + col])
             encoder.end_row()
 
-    rhs = [HexInt(x) for x in encoder.data]
+    data = encoder.data
+    if config.get(CONF_COMPRESSION) == COMPRESSION_RLE:
+        cg.add_define("USE_IMAGE_COMPRESSION")
+        data = rle_compress(data, stored_width, stored_height, frame_count)
+        _LOGGER.debug(
+            "Compressed image %s from %d to %d bytes", path, len(encoder.data), len(data)
+        )
+    rhs = [HexInt(x) for x in data]
     prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], rhs)
     image_type = get_image_type_enum(type)
     trans_value = get_transparency_enum(encoder.transparency)
@@ -736,10 +852,27 @@ async def write_image(config, all_frames=False):
     return prog_arr, width, height, image_type, trans_value, frame_count
 
 
+def setup_image_options(var, config):
+    """
+    Apply the options that are set on the image object rather than passed to its constructor
+    """
+    if config.get(CONF_BYTE_ORDER) == "LITTLE_ENDIAN":
+        cg.add(var.set_big_endian(False))
+    if rotation := config.get(CONF_ROTATION):
+        cg.add(var.set_rotation(DISPLAY_ROTATIONS[rotation]))
+
+
 async def to_code(config):
     # By now the config should be a simple list.
     for entry in config:
         prog_arr, width, height, image_type, trans_value, _ = await write_image(entry)
-        cg.new_Pvariable(
-            entry[CONF_ID], prog_arr, width, height, image_type, trans_value
+        var = cg.new_Pvariable(
+            entry[CONF_ID],
+            prog_arr,
+            width,
+            height,
+            image_type,
+            trans_value,
+            get_compression_enum(entry.get(CONF_COMPRESSION) or COMPRESSION_NONE),
         )
+        setup_image_options(var, entry)
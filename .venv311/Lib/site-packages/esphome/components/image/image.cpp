@@ -2,11 +2,23 @@
 
 #include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
 
 namespace esphome {
 namespace image {
 
+#ifdef USE_LVGL
+static const char *const TAG = "image";
+#endif
+
 void Image::draw(int x, int y, display::Display *display, Color color_on, Color color_off) {
+  // Opaque RGB565 data may already be in the display's buffer format, the display then clips and copies it itself
+  if (this->type_ == IMAGE_TYPE_RGB565 && this->transparency_ == TRANSPARENCY_OPAQUE &&
+      this->compression_ == IMAGE_COMPRESSION_NONE &&
+      display->draw_native_pixels_at(x, y, this->width_, this->height_, this->data_start_,
+                                     display::COLOR_BITNESS_565, this->big_endian_, this->rotation_))
+    return;
+
   int img_x0 = 0;
   int img_y0 = 0;
   int w = width_;
@@ -24,6 +36,13 @@ void Image::draw(int x, int y, display::Display *display, Color color_on, Color
       h = clipping.y2() - y;
   }
 
+#ifdef USE_IMAGE_COMPRESSION
+  if (this->compression_ != IMAGE_COMPRESSION_NONE) {
+    this->draw_compressed_(x, y, img_x0, img_y0, w, h, display, color_on, color_off);
+    return;
+  }
+#endif
+
   switch (type_) {
     case IMAGE_TYPE_BINARY: {
       for (int img_x = img_x0; img_x < w; img_x++) {
@@ -89,6 +108,21 @@ void Image::draw(int x, int y, display::Display *display, Color color_on, Color
 Color Image::get_pixel(int x, int y, const Color color_on, const Color color_off) const {
   if (x < 0 || x >= this->width_ || y < 0 || y >= this->height_)
     return color_off;
+#ifdef USE_IMAGE_COMPRESSION
+  if (this->compression_ != IMAGE_COMPRESSION_NONE) {
+    const uint8_t *pos = this->get_compressed_pixel_(x, y);
+    switch (this->type_) {
+      case IMAGE_TYPE_GRAYSCALE:
+        return this->get_grayscale_pixel_(pos);
+      case IMAGE_TYPE_RGB565:
+        return this->get_rgb565_pixel_(pos);
+      case IMAGE_TYPE_RGB:
+        return this->get_rgb_pixel_(pos);
+      default:
+        return color_off;
+    }
+  }
+#endif
   switch (this->type_) {
     case IMAGE_TYPE_BINARY:
       if (this->get_binary_pixel_(x, y))
@@ -106,9 +140,15 @@ Color Image::get_pixel(int x, int y, const Color color_on, const Color color_off
 }
 #ifdef USE_LVGL
 lv_img_dsc_t *Image::get_lv_img_dsc() {
+  const uint8_t *data = this->data_start_;
+  if (this->compression_ != IMAGE_COMPRESSION_NONE || this->rotation_ != display::DISPLAY_ROTATION_0_DEGREES) {
+    if (this->lv_data_source_ != this->data_start_ && !this->decode_lv_data_())
+      return nullptr;
+    data = this->lv_data_;
+  }
   // lazily construct lvgl image_dsc.
-  if (this->dsc_.data != this->data_start_) {
-    this->dsc_.data = this->data_start_;
+  if (this->dsc_.data != data) {
+    this->dsc_.data = data;
     this->dsc_.header.always_zero = 0;
     this->dsc_.header.reserved = 0;
     this->dsc_.header.w = this->width_;
@@ -163,6 +203,49 @@ lv_img_dsc_t *Image::get_lv_img_dsc() {
   }
   return &this->dsc_;
 }
+
+bool Image::decode_lv_data_() {
+  const size_t pixel_size = this->bpp_ / 8;
+  if (this->lv_data_ == nullptr) {
+    RAMAllocator<uint8_t> allocator;
+    this->lv_data_ = allocator.allocate(this->get_width_stride() * this->height_);
+    if (this->lv_data_ == nullptr) {
+      ESP_LOGE(TAG, "Not enough memory to decode a %dx%d image for LVGL", this->width_, this->height_);
+      return false;
+    }
+  }
+  uint8_t *out = this->lv_data_;
+  for (int y = 0; y < this->height_; y++) {
+#ifdef USE_IMAGE_COMPRESSION
+    if (this->compression_ != IMAGE_COMPRESSION_NONE) {
+      // Walk the runs of the row once instead of looking up every pixel
+      const uint8_t *pos = this->get_compressed_row_(y);
+      for (int x = 0; x < this->width_;) {
+        const uint8_t control = progmem_read_byte(pos++);
+        const int count = (control & 0x7F) + 1;
+        const bool repeat = (control & 0x80) != 0;
+        for (int i = 0; i < count; i++) {
+          for (size_t b = 0; b < pixel_size; b++)
+            *out++ = progmem_read_byte(pos + b);
+          if (!repeat)
+            pos += pixel_size;
+        }
+        if (repeat)
+          pos += pixel_size;
+        x += count;
+      }
+      continue;
+    }
+#endif
+    for (int x = 0; x < this->width_; x++) {
+      const uint8_t *pos = this->data_start_ + this->get_pixel_index_(x, y) * pixel_size;
+      for (size_t b = 0; b < pixel_size; b++)
+        *out++ = progmem_read_byte(pos + b);
+    }
+  }
+  this->lv_data_source_ = this->data_start_;
+  return true;
+}
 #endif  // USE_LVGL
 
 bool Image::get_binary_pixel_(int x, int y) const {
@@ -171,9 +254,10 @@ bool Image::get_binary_pixel_(int x, int y) const {
   return progmem_read_byte(this->data_start_ + (pos / 8u)) & (0x80 >> (pos % 8u));
 }
 Color Image::get_rgb_pixel_(int x, int y) const {
-  const uint32_t pos = (x + y * this->width_) * this->bpp_ / 8;
-  Color color = Color(progmem_read_byte(this->data_start_ + pos + 0), progmem_read_byte(this->data_start_ + pos + 1),
-                      progmem_read_byte(this->data_start_ + pos + 2), 0xFF);
+  return this->get_rgb_pixel_(this->data_start_ + (x + y * this->width_) * this->bpp_ / 8);
+}
+Color Image::get_rgb_pixel_(const uint8_t *pos) const {
+  Color color = Color(progmem_read_byte(pos + 0), progmem_read_byte(pos + 1), progmem_read_byte(pos + 2), 0xFF);
 
   switch (this->transparency_) {
     case TRANSPARENCY_CHROMA_KEY:
@@ -183,16 +267,31 @@ Color Image::get_rgb_pixel_(int x, int y) const {
       }
       break;
     case TRANSPARENCY_ALPHA_CHANNEL:
-      color.w = progmem_read_byte(this->data_start_ + (pos + 3));
+      color.w = progmem_read_byte(pos + 3);
       break;
     default:
       break;
   }
   return color;
 }
+size_t Image::get_pixel_index_(int x, int y) const {
+  switch (this->rotation_) {
+    case display::DISPLAY_ROTATION_90_DEGREES:
+      return (this->height_ - 1 - y) + x * this->height_;
+    case display::DISPLAY_ROTATION_180_DEGREES:
+      return (this->width_ - 1 - x) + (this->height_ - 1 - y) * this->width_;
+    case display::DISPLAY_ROTATION_270_DEGREES:
+      return y + (this->width_ - 1 - x) * this->height_;
+    default:
+      return x + y * this->width_;
+  }
+}
 Color Image::get_rgb565_pixel_(int x, int y) const {
-  const uint8_t *pos = this->data_start_ + (x + y * this->width_) * this->bpp_ / 8;
-  uint16_t rgb565 = encode_uint16(progmem_read_byte(pos), progmem_read_byte(pos + 1));
+  return this->get_rgb565_pixel_(this->data_start_ + this->get_pixel_index_(x, y) * this->bpp_ / 8);
+}
+Color Image::get_rgb565_pixel_(const uint8_t *pos) const {
+  uint16_t rgb565 = this->big_endian_ ? encode_uint16(progmem_read_byte(pos), progmem_read_byte(pos + 1))
+                                      : encode_uint16(progmem_read_byte(pos + 1), progmem_read_byte(pos));
   auto r = (rgb565 & 0xF800) >> 11;
   auto g = (rgb565 & 0x07E0) >> 5;
   auto b = rgb565 & 0x001F;
@@ -212,8 +311,10 @@ Color Image::get_rgb565_pixel_(int x, int y) const {
 }
 
 Color Image::get_grayscale_pixel_(int x, int y) const {
-  const uint32_t pos = (x + y * this->width_);
-  const uint8_t gray = progmem_read_byte(this->data_start_ + pos);
+  return this->get_grayscale_pixel_(this->data_start_ + (x + y * this->width_));
+}
+Color Image::get_grayscale_pixel_(const uint8_t *pos) const {
+  const uint8_t gray = progmem_read_byte(pos);
   switch (this->transparency_) {
     case TRANSPARENCY_CHROMA_KEY:
       if (gray == 1)
@@ -228,8 +329,14 @@ Color Image::get_grayscale_pixel_(int x, int y) const {
 int Image::get_width() const { return this->width_; }
 int Image::get_height() const { return this->height_; }
 ImageType Image::get_type() const { return this->type_; }
-Image::Image(const uint8_t *data_start, int width, int height, ImageType type, Transparency transparency)
-    : width_(width), height_(height), type_(type), data_start_(data_start), transparency_(transparency) {
+Image::Image(const uint8_t *data_start, int width, int height, ImageType type, Transparency transparency,
+             ImageCompression compression)
+    : width_(width),
+      height_(height),
+      type_(type),
+      data_start_(data_start),
+      transparency_(transparency),
+      compression_(compression) {
   switch (this->type_) {
     case IMAGE_TYPE_BINARY:
       this->bpp_ = 1;
@@ -246,5 +353,132 @@ Image::Image(const uint8_t *data_start, int width, int height, ImageType type, T
   }
 }
 
+#ifdef USE_IMAGE_COMPRESSION
+/// Pixels draw_compressed_() collects before copying them to the display
+static const int COMPRESSED_SPAN_PIXELS = 64;
+
+const uint8_t *Image::get_compressed_row_(int y) const {
+  const uint8_t *entry = this->data_start_ + y * sizeof(uint32_t);
+  return this->data_start_ + encode_uint32(progmem_read_byte(entry + 3), progmem_read_byte(entry + 2),
+                                           progmem_read_byte(entry + 1), progmem_read_byte(entry));
+}
+
+const uint8_t *Image::get_compressed_pixel_(int x, int y) const {
+  const size_t pixel_size = this->bpp_ / 8;
+  const uint8_t *pos = this->get_compressed_row_(y);
+  while (true) {
+    const uint8_t control = progmem_read_byte(pos++);
+    const int count = (control & 0x7F) + 1;
+    if (x < count)
+      return (control & 0x80) ? pos : pos + x * pixel_size;
+    x -= count;
+    pos += (control & 0x80) ? pixel_size : count * pixel_size;
+  }
+}
+
+bool Image::get_draw_color_(const uint8_t *pos, Color color_on, Color color_off, Color *color) const {
+  switch (this->type_) {
+    case IMAGE_TYPE_GRAYSCALE: {
+      const uint8_t gray = progmem_read_byte(pos);
+      switch (this->transparency_) {
+        case TRANSPARENCY_CHROMA_KEY:
+          if (gray == 1)
+            return false;
+          break;
+        case TRANSPARENCY_ALPHA_CHANNEL: {
+          auto on = (float) gray / 255.0f;
+          auto off = 1.0f - on;
+          // blend color_on and color_off
+          *color = Color(color_on.r * on + color_off.r * off, color_on.g * on + color_off.g * off,
+                         color_on.b * on + color_off.b * off, 0xFF);
+          return true;
+        }
+        default:
+          break;
+      }
+      *color = Color(gray, gray, gray, 0xFF);
+      return true;
+    }
+    case IMAGE_TYPE_RGB565:
+      *color = this->get_rgb565_pixel_(pos);
+      return color->w >= 0x80;
+    case IMAGE_TYPE_RGB:
+      *color = this->get_rgb_pixel_(pos);
+      return color->w >= 0x80;
+    default:
+      return false;
+  }
+}
+
+void Image::draw_compressed_(int x, int y, int img_x0, int img_y0, int w, int h, display::Display *display,
+                             Color color_on, Color color_off) {
+  const size_t pixel_size = this->bpp_ / 8;
+  // Consecutive opaque pixels are collected into a span in the usual display buffer format, big-endian RGB565, and
+  // copied with one draw_native_pixels_at() call. Displays without such a buffer get the pixels one by one.
+  bool native = true;
+  uint16_t span[COMPRESSED_SPAN_PIXELS];
+  Color span_colors[COMPRESSED_SPAN_PIXELS];
+  int span_x = 0;
+  int span_len = 0;
+  int row_y = 0;
+  auto flush = [&]() {
+    if (span_len == 0)
+      return;
+    if (!display->draw_native_pixels_at(x + span_x, row_y, span_len, 1, reinterpret_cast<const uint8_t *>(span),
+                                        display::COLOR_BITNESS_565, true, display::DISPLAY_ROTATION_0_DEGREES)) {
+      native = false;
+      for (int i = 0; i < span_len; i++)
+        display->draw_pixel_at(x + span_x + i, row_y, span_colors[i]);
+    }
+    span_len = 0;
+  };
+  auto draw = [&](int img_x, Color color) {
+    if (!native) {
+      display->draw_pixel_at(x + img_x, row_y, color);
+      return;
+    }
+    if (span_len != 0 && (span_x + span_len != img_x || span_len == COMPRESSED_SPAN_PIXELS))
+      flush();
+    if (span_len == 0)
+      span_x = img_x;
+    // Same rounding as the displays' own Color to RGB565 conversion
+    const uint16_t rgb565 = (color.r & 0xF8) << 8 | (color.g & 0xFC) << 3 | color.b >> 3;
+    auto *bytes = reinterpret_cast<uint8_t *>(&span[span_len]);
+    bytes[0] = rgb565 >> 8;
+    bytes[1] = rgb565;
+    span_colors[span_len++] = color;
+  };
+
+  Color color;
+  for (int img_y = img_y0; img_y < h; img_y++) {
+    const uint8_t *pos = this->get_compressed_row_(img_y);
+    row_y = y + img_y;
+    int img_x = 0;
+    while (img_x < w) {
+      const uint8_t control = progmem_read_byte(pos++);
+      const int count = (control & 0x7F) + 1;
+      const int start = std::max(img_x, img_x0);
+      const int end = std::min(img_x + count, w);
+      if (control & 0x80) {
+        // A run is decoded once
+        if (start < end && this->get_draw_color_(pos, color_on, color_off, &color)) {
+          for (int i = start; i < end; i++)
+            draw(i, color);
+        }
+        pos += pixel_size;
+      } else {
+        for (int i = start; i < end; i++) {
+          if (this->get_draw_color_(pos + (i - img_x) * pixel_size, color_on, color_off, &color))
+            draw(i, color);
+        }
+        pos += count * pixel_size;
+      }
+      img_x += count;
+    }
+    flush();
+  }
+}
+#endif  // USE_IMAGE_COMPRESSION
+
 }  // namespace image
 }  // namespace esphome
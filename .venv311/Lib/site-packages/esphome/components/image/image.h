@@ -1,5 +1,6 @@
 #pragma once
 #include "esphome/core/color.h"
+#include "esphome/core/defines.h"
 #include "esphome/components/display/display.h"
 
 #ifdef USE_LVGL
@@ -22,14 +23,34 @@ enum Transparency {
   TRANSPARENCY_ALPHA_CHANNEL = 2,
 };
 
+enum ImageCompression {
+  IMAGE_COMPRESSION_NONE = 0,
+  /// Each row is a sequence of packets: a control byte c, followed by one pixel repeated (c & 0x7F) + 1 times
+  /// if bit 7 is set, or by c + 1 literal pixels otherwise. The data starts with a table of little-endian uint32
+  /// row offsets (relative to the table start) so any row can be decoded on its own, e.g. when clipping.
+  IMAGE_COMPRESSION_RLE = 1,
+};
+
 class Image : public display::BaseImage {
  public:
-  Image(const uint8_t *data_start, int width, int height, ImageType type, Transparency transparency);
+  Image(const uint8_t *data_start, int width, int height, ImageType type, Transparency transparency,
+        ImageCompression compression = IMAGE_COMPRESSION_NONE);
   Color get_pixel(int x, int y, Color color_on = display::COLOR_ON, Color color_off = display::COLOR_OFF) const;
   int get_width() const override;
   int get_height() const override;
   const uint8_t *get_data_start() const { return this->data_start_; }
   ImageType get_type() const;
+  ImageCompression get_compression() const { return this->compression_; }
+
+  /// Set the byte order of RGB565 pixel data.
+  void set_big_endian(bool big_endian) { this->big_endian_ = big_endian; }
+  /** Set the display rotation the RGB565 pixel data was rotated for at build time.
+   *
+   * Displays with the same rotation and buffer format can then copy the rows directly, other displays still
+   * get the image in its original orientation.
+   */
+  void set_rotation(display::DisplayRotation rotation) { this->rotation_ = rotation; }
+  display::DisplayRotation get_rotation() const { return this->rotation_; }
 
   int get_bpp() const { return this->bpp_; }
 
@@ -41,23 +62,50 @@ class Image : public display::BaseImage {
   bool has_transparency() const { return this->transparency_ != TRANSPARENCY_OPAQUE; }
 
 #ifdef USE_LVGL
+  /// Compressed and pre-rotated images are decoded into RAM on first use, LVGL can only use plain data.
+  /// Returns nullptr if that allocation fails.
   lv_img_dsc_t *get_lv_img_dsc();
 #endif
  protected:
+  /// Map image coordinates to the position in the (possibly pre-rotated) pixel data.
+  size_t get_pixel_index_(int x, int y) const;
   bool get_binary_pixel_(int x, int y) const;
   Color get_rgb_pixel_(int x, int y) const;
   Color get_rgb565_pixel_(int x, int y) const;
   Color get_grayscale_pixel_(int x, int y) const;
+  Color get_rgb_pixel_(const uint8_t *pos) const;
+  Color get_rgb565_pixel_(const uint8_t *pos) const;
+  Color get_grayscale_pixel_(const uint8_t *pos) const;
+
+#ifdef USE_IMAGE_COMPRESSION
+  /// Return the encoded data of a row of a compressed image.
+  const uint8_t *get_compressed_row_(int y) const;
+  /// Return the position of a pixel's bytes in a compressed image.
+  const uint8_t *get_compressed_pixel_(int x, int y) const;
+  /// Determine the color draw() uses for the pixel at pos, returns false if the pixel is transparent.
+  bool get_draw_color_(const uint8_t *pos, Color color_on, Color color_off, Color *color) const;
+  void draw_compressed_(int x, int y, int img_x0, int img_y0, int w, int h, display::Display *display,
+                        Color color_on, Color color_off);
+#endif
 
   int width_;
   int height_;
   ImageType type_;
   const uint8_t *data_start_;
   Transparency transparency_;
+  ImageCompression compression_;
+  display::DisplayRotation rotation_{display::DISPLAY_ROTATION_0_DEGREES};
+  bool big_endian_{true};
   size_t bpp_{};
   size_t stride_{};
 #ifdef USE_LVGL
+  /// Decode the current pixel data into lv_data_ in plain row order.
+  bool decode_lv_data_();
+
   lv_img_dsc_t dsc_{};
+  /// Decoded copy for LVGL, and the data_start_ it was decoded from (animations change it per frame)
+  uint8_t *lv_data_{nullptr};
+  const uint8_t *lv_data_source_{nullptr};
 #endif
 };
 
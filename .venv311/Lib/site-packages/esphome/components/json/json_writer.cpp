@@ -0,0 +1,241 @@
+#include "json_writer.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace json {
+
+JsonWriter::JsonWriter(char *buffer, size_t capacity) : buffer_(buffer), capacity_(capacity) {
+  if (this->capacity_ == 0) {
+    this->overflowed_ = true;
+  } else {
+    this->buffer_[0] = '\0';
+  }
+}
+
+void JsonWriter::begin_object() {
+  this->write_('{');
+  this->first_ = true;
+}
+void JsonWriter::end_object() { this->write_('}'); }
+
+void JsonWriter::add(const char *key, const char *value) { this->add(key, value, strlen(value)); }
+void JsonWriter::add(const char *key, const char *value, size_t length) {
+  this->key_(key);
+  this->write_('"');
+  this->write_escaped_(value, length);
+  this->write_('"');
+}
+void JsonWriter::add(const char *key, const char *prefix, const std::string &value) {
+  this->key_(key);
+  this->write_('"');
+  this->write_escaped_(prefix, strlen(prefix));
+  this->write_escaped_(value.data(), value.size());
+  this->write_('"');
+}
+void JsonWriter::add(const char *key, bool value) {
+  this->key_(key);
+  if (value) {
+    this->write_("true", 4);
+  } else {
+    this->write_("false", 5);
+  }
+}
+void JsonWriter::add(const char *key, int32_t value) {
+  this->key_(key);
+  char tmp[12];
+  int len = snprintf(tmp, sizeof(tmp), "%" PRId32, value);
+  this->write_(tmp, len);
+}
+void JsonWriter::add(const char *key, uint32_t value) {
+  this->key_(key);
+  char tmp[11];
+  int len = snprintf(tmp, sizeof(tmp), "%" PRIu32, value);
+  this->write_(tmp, len);
+}
+// Scale value into [1e-5, 1e7) by binary powers of ten, returning the exponent; as ArduinoJson's normalize()
+static int16_t normalize_float(double &value) {
+  static const double POSITIVE_POWERS[9] = {1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256};
+  static const double NEGATIVE_POWERS[9] = {1e-1, 1e-2, 1e-4, 1e-8, 1e-16, 1e-32, 1e-64, 1e-128, 1e-256};
+  static const double NEGATIVE_POWERS_PLUS_ONE[9] = {1e0, 1e-1, 1e-3, 1e-7, 1e-15, 1e-31, 1e-63, 1e-127, 1e-255};
+  int16_t exponent = 0;
+  int index = 8;
+  int bit = 1 << index;
+  if (value >= 1e7) {
+    for (; index >= 0; index--) {
+      if (value >= POSITIVE_POWERS[index]) {
+        value *= NEGATIVE_POWERS[index];
+        exponent += bit;
+      }
+      bit >>= 1;
+    }
+  }
+  if (value > 0 && value <= 1e-5) {
+    for (; index >= 0; index--) {
+      if (value < NEGATIVE_POWERS_PLUS_ONE[index]) {
+        value *= POSITIVE_POWERS[index];
+        exponent -= bit;
+      }
+      bit >>= 1;
+    }
+  }
+  return exponent;
+}
+
+void JsonWriter::add(const char *key, float value) {
+  this->key_(key);
+  if (!std::isfinite(value)) {
+    this->write_("null", 4);
+    return;
+  }
+  // Formatted the way ArduinoJson serializes a float (6 decimal places less the integral digits, trailing zeros
+  // removed, exponent outside 1e-5..1e7), so the output is the same as when the payload falls back to build_json()
+  double number = value;
+  char tmp[24];
+  int len = 0;
+  if (number < 0.0) {
+    tmp[len++] = '-';
+    number = -number;
+  }
+  int16_t exponent = normalize_float(number);
+  uint32_t integral = static_cast<uint32_t>(number);
+  uint32_t max_decimal = 1000000;
+  int8_t decimal_places = 6;
+  for (uint32_t rest = integral; rest >= 10; rest /= 10) {
+    max_decimal /= 10;
+    decimal_places--;
+  }
+  double remainder = (number - integral) * max_decimal;
+  uint32_t decimal = static_cast<uint32_t>(remainder);
+  remainder -= decimal;
+  decimal += static_cast<uint32_t>(remainder * 2);
+  if (decimal >= max_decimal) {
+    decimal = 0;
+    integral++;
+    if (exponent != 0 && integral >= 10) {
+      exponent++;
+      integral = 1;
+    }
+  }
+  while (decimal % 10 == 0 && decimal_places > 0) {
+    decimal /= 10;
+    decimal_places--;
+  }
+
+  len += snprintf(tmp + len, sizeof(tmp) - len, "%" PRIu32, integral);
+  if (decimal_places > 0)
+    len += snprintf(tmp + len, sizeof(tmp) - len, ".%0*" PRIu32, decimal_places, decimal);
+  if (exponent != 0)
+    len += snprintf(tmp + len, sizeof(tmp) - len, "e%d", exponent);
+  this->write_(tmp, len);
+}
+
+void JsonWriter::begin_array(const char *key) {
+  this->key_(key);
+  this->write_('[');
+  this->first_ = true;
+}
+void JsonWriter::add_element(const std::string &value) {
+  if (!this->first_)
+    this->write_(',');
+  this->first_ = false;
+  this->write_('"');
+  this->write_escaped_(value.data(), value.size());
+  this->write_('"');
+}
+void JsonWriter::end_array() {
+  this->write_(']');
+  this->first_ = false;
+}
+
+void JsonWriter::begin_string(const char *key) {
+  this->key_(key);
+  this->write_('"');
+}
+void JsonWriter::append_string(const char *value, size_t length) { this->write_escaped_(value, length); }
+void JsonWriter::append_string(const char *value) { this->write_escaped_(value, strlen(value)); }
+void JsonWriter::append_accuracy(float value, int8_t accuracy_decimals) {
+  if (accuracy_decimals < 0) {
+    auto multiplier = powf(10.0f, accuracy_decimals);
+    value = roundf(value * multiplier) / multiplier;
+    accuracy_decimals = 0;
+  }
+  char tmp[32];
+  int len = snprintf(tmp, sizeof(tmp), "%.*f", accuracy_decimals, value);
+  if (len >= static_cast<int>(sizeof(tmp)))
+    len = sizeof(tmp) - 1;
+  // Digits, sign and '.' never need escaping
+  this->write_(tmp, len);
+}
+void JsonWriter::end_string() { this->write_('"'); }
+
+void JsonWriter::key_(const char *key) {
+  if (!this->first_)
+    this->write_(',');
+  this->first_ = false;
+  this->write_('"');
+  this->write_(key, strlen(key));
+  this->write_("\":", 2);
+}
+
+void JsonWriter::write_(char c) { this->write_(&c, 1); }
+void JsonWriter::write_(const char *data, size_t length) {
+  if (this->overflowed_)
+    return;
+  // Always keep room for the null terminator
+  if (this->at_ + length >= this->capacity_) {
+    this->overflowed_ = true;
+    return;
+  }
+  memcpy(this->buffer_ + this->at_, data, length);
+  this->at_ += length;
+  this->buffer_[this->at_] = '\0';
+}
+
+void JsonWriter::write_escaped_(const char *data, size_t length) {
+  // Same escaping as ArduinoJson's TextFormatter: quote, backslash and \b \f \n \r \t get a short escape, a null
+  // byte is written as \u0000 and every other byte (including other control characters) is copied as is
+  size_t run_start = 0;
+  for (size_t i = 0; i < length; i++) {
+    const char *escape;
+    switch (data[i]) {
+      case '"':
+        escape = "\\\"";
+        break;
+      case '\\':
+        escape = "\\\\";
+        break;
+      case '\b':
+        escape = "\\b";
+        break;
+      case '\f':
+        escape = "\\f";
+        break;
+      case '\n':
+        escape = "\\n";
+        break;
+      case '\r':
+        escape = "\\r";
+        break;
+      case '\t':
+        escape = "\\t";
+        break;
+      case '\0':
+        escape = "\\u0000";
+        break;
+      default:
+        continue;
+    }
+    // Flush the run of characters that need no escaping
+    this->write_(data + run_start, i - run_start);
+    this->write_(escape, strlen(escape));
+    run_start = i + 1;
+  }
+  this->write_(data + run_start, length - run_start);
+}
+
+}  // namespace json
+}  // namespace esphome
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+namespace json {
+
+/** Streaming JSON writer into a caller-provided, fixed-capacity buffer.
+ *
+ * Unlike build_json() this never touches the heap: keys and values are emitted directly as they are added, so
+ * it is meant for small, flat payloads on hot paths (e.g. web_server entity events). Strings are escaped and
+ * floats formatted exactly like ArduinoJson does, so the text is the same as build_json() would produce for the
+ * same members in the same order. When the buffer is too small the writer stops writing and overflowed()
+ * returns true; callers should then fall back to build_json().
+ *
+ * Usage:
+ *
+ * ```cpp
+ * char buf[128];
+ * json::JsonWriter writer(buf, sizeof(buf));
+ * writer.begin_object();
+ * writer.add("id", "sensor-", obj->get_object_id());
+ * writer.add("value", obj->state);
+ * writer.end_object();
+ * if (!writer.overflowed())
+ *   return std::string(writer.c_str(), writer.size());
+ * ```
+ */
+class JsonWriter {
+ public:
+  JsonWriter(char *buffer, size_t capacity);
+
+  void begin_object();
+  void end_object();
+
+  /// Add a string member.
+  void add(const char *key, const char *value);
+  void add(const char *key, const std::string &value) { this->add(key, value.data(), value.size()); }
+  void add(const char *key, const char *value, size_t length);
+  /// Add a string member made of prefix followed by value, without concatenating them first.
+  void add(const char *key, const char *prefix, const std::string &value);
+  void add(const char *key, bool value);
+  void add(const char *key, int32_t value);
+  void add(const char *key, uint32_t value);
+  /// Add a number member, formatted like ArduinoJson formats a float; NaN and infinity are written as null.
+  void add(const char *key, float value);
+
+  /// Start an array member of strings, add its elements with add_element() and end it with end_array().
+  void begin_array(const char *key);
+  void add_element(const std::string &value);
+  void end_array();
+
+  /// Start a string member whose contents are appended piecewise with append_string(), end with end_string().
+  void begin_string(const char *key);
+  void append_string(const char *value, size_t length);
+  void append_string(const char *value);
+  void append_string(const std::string &value) { this->append_string(value.data(), value.size()); }
+  /// Append a number formatted like value_accuracy_to_string() to the current string.
+  void append_accuracy(float value, int8_t accuracy_decimals);
+  void end_string();
+
+  bool overflowed() const { return this->overflowed_; }
+  /// Length of the JSON text written so far (excluding the null terminator).
+  size_t size() const { return this->at_; }
+  const char *c_str() const { return this->buffer_; }
+
+ protected:
+  void key_(const char *key);
+  void write_(char c);
+  void write_(const char *data, size_t length);
+  void write_escaped_(const char *data, size_t length);
+
+  char *buffer_;
+  size_t capacity_;
+  size_t at_{0};
+  bool first_{true};
+  bool overflowed_{false};
+};
+
+}  // namespace json
+}  // namespace esphome
@@ -4,7 +4,9 @@
 #include "esphome/core/log.h"
 #include "esphome/core/preferences.h"
 #include <flashdb.h>
+#include <cinttypes>
 #include <cstring>
+#include <map>
 #include <vector>
 #include <string>
 
@@ -19,6 +21,8 @@ struct NVSData {
 };
 
 static std::vector<NVSData> s_pending_save;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// Hash of the data last read from or written to flash per key, so unchanged saves are skipped without a flash read
+static std::map<std::string, uint32_t> s_stored_hash;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 class LibreTinyPreferenceBackend : public ESPPreferenceBackend {
  public:
@@ -63,6 +67,7 @@ class LibreTinyPreferenceBackend : public ESPPreferenceBackend {
     } else {
       ESP_LOGVV(TAG, "fdb_kv_get_blob: key: %s, len: %d", key.c_str(), len);
     }
+    s_stored_hash[key] = fnv1_hash(data, len);
     return true;
   }
 };
@@ -110,8 +115,9 @@ class LibreTinyPreferences : public ESPPreferences {
     // go through vector from back to front (makes erase easier/more efficient)
     for (ssize_t i = s_pending_save.size() - 1; i >= 0; i--) {
       const auto &save = s_pending_save[i];
+      const uint32_t hash = fnv1_hash(save.data.data(), save.data.size());
       ESP_LOGVV(TAG, "Checking if FDB data %s has changed", save.key.c_str());
-      if (is_changed(&db, save)) {
+      if (is_changed(&db, save, hash)) {
         ESP_LOGV(TAG, "sync: key: %s, len: %d", save.key.c_str(), save.data.size());
         fdb_blob_make(&blob, save.data.data(), save.data.size());
         fdb_err_t err = fdb_kv_set_blob(&db, save.key.c_str(), &blob);
@@ -122,6 +128,7 @@ class LibreTinyPreferences : public ESPPreferences {
           last_key = save.key;
           continue;
         }
+        s_stored_hash[save.key] = hash;
         written++;
       } else {
         ESP_LOGD(TAG, "FDB data not changed; skipping %s  len=%u", save.key.c_str(), save.data.size());
@@ -129,8 +136,9 @@ class LibreTinyPreferences : public ESPPreferences {
       }
       s_pending_save.erase(s_pending_save.begin() + i);
     }
-    ESP_LOGD(TAG, "Writing %d items: %d cached, %d written, %d failed", cached + written + failed, cached, written,
-             failed);
+    this->writes_avoided_ += cached;
+    ESP_LOGD(TAG, "Writing %d items: %d cached, %d written, %d failed (%" PRIu32 " writes avoided since boot)",
+             cached + written + failed, cached, written, failed, this->writes_avoided_);
     if (failed > 0) {
       ESP_LOGE(TAG, "Writing %d items failed. Last error=%d for key=%s", failed, last_err, last_key.c_str());
     }
@@ -138,7 +146,12 @@ class LibreTinyPreferences : public ESPPreferences {
     return failed == 0;
   }
 
-  bool is_changed(const fdb_kvdb_t db, const NVSData &to_save) {
+  bool is_changed(const fdb_kvdb_t db, const NVSData &to_save, uint32_t hash) {
+    auto stored = s_stored_hash.find(to_save.key);
+    if (stored != s_stored_hash.end())
+      return stored->second != hash;
+
+    // Neither loaded nor written since boot: compare with flash once
     NVSData stored_data{};
     struct fdb_kv kv;
     fdb_kv_t kvp = fdb_kv_get_obj(db, to_save.key.c_str(), &kv);
@@ -153,17 +166,24 @@ class LibreTinyPreferences : public ESPPreferences {
       ESP_LOGV(TAG, "fdb_kv_get_blob('%s') len mismatch: %u != %u", to_save.key.c_str(), actual_len, kv.value_len);
       return true;
     }
-    return to_save.data != stored_data.data;
+    if (to_save.data != stored_data.data)
+      return true;
+    s_stored_hash[to_save.key] = hash;
+    return false;
   }
 
   bool reset() override {
     ESP_LOGD(TAG, "Erasing storage");
     s_pending_save.clear();
+    s_stored_hash.clear();
 
     fdb_kv_set_default(&db);
     fdb_kvdb_deinit(&db);
     return true;
   }
+
+ protected:
+  uint32_t writes_avoided_{0};
 };
 
 void setup_preferences() {
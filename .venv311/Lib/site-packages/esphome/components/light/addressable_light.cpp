@@ -1,6 +1,8 @@
 #include "addressable_light.h"
 #include "esphome/core/log.h"
 
+#include <cstring>
+
 namespace esphome {
 namespace light {
 
@@ -23,6 +25,201 @@ void AddressableLight::call_setup() {
 #endif
 }
 
+const AddressableLight::Layout &AddressableLight::update_layout_() {
+  const int32_t size = this->size();
+  const ESPColorView first = this->get_view_internal(0);
+  const ESPColorView last = this->get_view_internal(size - 1);
+  uint8_t *const first_pointers[5] = {first.red_, first.green_, first.blue_, first.white_, first.effect_data_};
+  for (auto &layout : this->layouts_) {
+    if (layout.size == size && memcmp(layout.first, first_pointers, sizeof(first_pointers)) == 0 &&
+        layout.last_red == last.red_ && layout.last_effect_data == last.effect_data_)
+      return layout;
+  }
+
+  Layout &layout = this->layouts_[this->layout_next_];
+  this->layout_next_ = (this->layout_next_ + 1) % 2;
+  layout = Layout{};
+  layout.size = size;
+  memcpy(layout.first, first_pointers, sizeof(first_pointers));
+  layout.last_red = last.red_;
+  layout.last_effect_data = last.effect_data_;
+  if (size < 2)
+    return layout;
+
+  const ESPColorView second = this->get_view_internal(1);
+  const int32_t stride = second.red_ - first.red_;
+  const int32_t effect_stride = second.effect_data_ - first.effect_data_;
+  bool colors_linear = true;
+  bool effect_data_linear = first.effect_data_ != nullptr;
+  // Every LED has to be checked, partitions can look linear at their ends only
+  for (int32_t i = 1; i < size && (colors_linear || effect_data_linear); i++) {
+    ESPColorView view = this->get_view_internal(i);
+    int32_t offset = i * stride;
+    if (view.red_ != first.red_ + offset || view.green_ != first.green_ + offset ||
+        view.blue_ != first.blue_ + offset || (view.white_ == nullptr) != (first.white_ == nullptr) ||
+        (view.white_ != nullptr && view.white_ != first.white_ + offset))
+      colors_linear = false;
+    if (view.effect_data_ != first.effect_data_ + i * effect_stride)
+      effect_data_linear = false;
+  }
+  if (colors_linear) {
+    layout.red = first.red_;
+    layout.green = first.green_;
+    layout.blue = first.blue_;
+    layout.white = first.white_;
+    layout.stride = stride;
+  }
+  if (effect_data_linear) {
+    layout.effect_data = first.effect_data_;
+    layout.effect_stride = effect_stride;
+  }
+  return layout;
+}
+
+bool AddressableLight::clamp_range_(int32_t &index, int32_t &count, int32_t &skipped) const {
+  skipped = 0;
+  if (index < 0) {
+    skipped = -index;
+    count += index;
+    index = 0;
+  }
+  count = std::min(count, this->size() - index);
+  return count > 0;
+}
+
+void AddressableLight::write_colors(int32_t index, const Color *colors, int32_t count, bool white) {
+  int32_t skipped;
+  if (!this->clamp_range_(index, count, skipped))
+    return;
+  colors += skipped;
+
+  const Layout &layout = this->update_layout_();
+  if (layout.red == nullptr) {
+    for (int32_t i = 0; i < count; i++) {
+      if (white) {
+        this->get_view_internal(index + i).set(colors[i]);
+      } else {
+        this->get_view_internal(index + i).set_rgb(colors[i].red, colors[i].green, colors[i].blue);
+      }
+    }
+    return;
+  }
+
+  const uint8_t *lut = this->correction_.get_lookup_tables();
+  const int32_t stride = layout.stride;
+  const int32_t offset = index * stride;
+  uint8_t *red = layout.red + offset;
+  uint8_t *green = layout.green + offset;
+  uint8_t *blue = layout.blue + offset;
+  for (int32_t i = 0; i < count; i++, red += stride, green += stride, blue += stride) {
+    *red = lut[colors[i].red];
+    *green = lut[256 + colors[i].green];
+    *blue = lut[512 + colors[i].blue];
+  }
+  if (white && layout.white != nullptr) {
+    uint8_t *dst = layout.white + offset;
+    for (int32_t i = 0; i < count; i++, dst += stride)
+      *dst = lut[768 + colors[i].white];
+  }
+}
+
+void AddressableLight::fill_colors(int32_t index, const Color &color, int32_t count) {
+  int32_t skipped;
+  if (!this->clamp_range_(index, count, skipped))
+    return;
+
+  const Layout &layout = this->update_layout_();
+  if (layout.red == nullptr) {
+    for (int32_t i = 0; i < count; i++)
+      this->get_view_internal(index + i).set(color);
+    return;
+  }
+
+  const Color corrected = this->correction_.color_correct(color);
+  const int32_t stride = layout.stride;
+  const int32_t offset = index * stride;
+  uint8_t *red = layout.red + offset;
+  uint8_t *green = layout.green + offset;
+  uint8_t *blue = layout.blue + offset;
+  uint8_t *white = layout.white == nullptr ? nullptr : layout.white + offset;
+  for (int32_t i = 0; i < count; i++, red += stride, green += stride, blue += stride) {
+    *red = corrected.red;
+    *green = corrected.green;
+    *blue = corrected.blue;
+    if (white != nullptr) {
+      *white = corrected.white;
+      white += stride;
+    }
+  }
+}
+
+void AddressableLight::read_colors(int32_t index, Color *colors, int32_t count) {
+  int32_t skipped;
+  if (!this->clamp_range_(index, count, skipped))
+    return;
+  colors += skipped;
+
+  const Layout &layout = this->update_layout_();
+  if (layout.red == nullptr) {
+    for (int32_t i = 0; i < count; i++)
+      colors[i] = this->get_view_internal(index + i).get();
+    return;
+  }
+
+  const uint8_t *lut = this->correction_.get_reverse_lookup_tables();
+  const int32_t stride = layout.stride;
+  const int32_t offset = index * stride;
+  const uint8_t *red = layout.red + offset;
+  const uint8_t *green = layout.green + offset;
+  const uint8_t *blue = layout.blue + offset;
+  const uint8_t *white = layout.white == nullptr ? nullptr : layout.white + offset;
+  for (int32_t i = 0; i < count; i++, red += stride, green += stride, blue += stride) {
+    colors[i] = Color(lut[*red], lut[256 + *green], lut[512 + *blue], 0);
+    if (white != nullptr) {
+      colors[i].white = lut[768 + *white];
+      white += stride;
+    }
+  }
+}
+
+void AddressableLight::read_effect_data(int32_t index, uint8_t *data, int32_t count) {
+  int32_t skipped;
+  if (!this->clamp_range_(index, count, skipped))
+    return;
+  data += skipped;
+
+  const Layout &layout = this->update_layout_();
+  if (layout.effect_data == nullptr) {
+    for (int32_t i = 0; i < count; i++)
+      data[i] = this->get_view_internal(index + i).get_effect_data();
+    return;
+  }
+
+  const int32_t stride = layout.effect_stride;
+  const uint8_t *src = layout.effect_data + index * stride;
+  for (int32_t i = 0; i < count; i++, src += stride)
+    data[i] = *src;
+}
+
+void AddressableLight::write_effect_data(int32_t index, const uint8_t *data, int32_t count) {
+  int32_t skipped;
+  if (!this->clamp_range_(index, count, skipped))
+    return;
+  data += skipped;
+
+  const Layout &layout = this->update_layout_();
+  if (layout.effect_data == nullptr) {
+    for (int32_t i = 0; i < count; i++)
+      this->get_view_internal(index + i).set_effect_data(data[i]);
+    return;
+  }
+
+  const int32_t stride = layout.effect_stride;
+  uint8_t *dst = layout.effect_data + index * stride;
+  for (int32_t i = 0; i < count; i++, dst += stride)
+    *dst = data[i];
+}
+
 std::unique_ptr<LightTransformer> AddressableLight::create_default_transition() {
   return make_unique<AddressableLightTransformer>(*this);
 }
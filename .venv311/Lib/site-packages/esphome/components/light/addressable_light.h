@@ -74,6 +74,22 @@ class AddressableLight : public LightOutput, public Component {
   }
   void update_state(LightState *state) override;
   void schedule_show() { this->state_parent_->next_write_ = true; }
+  /** Set count LEDs starting at index to the given colors, with color correction.
+   *
+   * Same result as setting each LED through its ESPColorView, but the correction is done with lookup tables and, for
+   * outputs that keep all LEDs at a fixed distance in one buffer, the colors are written directly to that buffer.
+   * LEDs outside of the light are skipped. With white false, the white channel of the LEDs is left unchanged, like
+   * ESPColorSettable::set_rgb() does.
+   */
+  void write_colors(int32_t index, const Color *colors, int32_t count, bool white = true);
+  /// Set count LEDs starting at index to one color, with color correction.
+  void fill_colors(int32_t index, const Color &color, int32_t count);
+  /// Get the uncorrected colors of count LEDs starting at index, like ESPColorView::get() does for one LED.
+  void read_colors(int32_t index, Color *colors, int32_t count);
+  /// Copy the effect data of count LEDs starting at index to data.
+  void read_effect_data(int32_t index, uint8_t *data, int32_t count);
+  /// Set the effect data of count LEDs starting at index.
+  void write_effect_data(int32_t index, const uint8_t *data, int32_t count);
 
 #ifdef USE_POWER_SUPPLY
   void set_power_supply(power_supply::PowerSupply *power_supply) { this->power_.set_parent(power_supply); }
@@ -97,7 +113,38 @@ class AddressableLight : public LightOutput, public Component {
   }
   virtual ESPColorView get_view_internal(int32_t index) const = 0;
 
+  /// Where the LEDs are in the output buffer, for one position of that buffer.
+  struct Layout {
+    /// Number of LEDs, and pointers of the first LED (red, green, blue, white, effect data) and of the last LED
+    /// (red, effect data) when the layout was checked. -1 if the layout wasn't checked yet.
+    int32_t size{-1};
+    uint8_t *first[5]{};
+    uint8_t *last_red{nullptr};
+    uint8_t *last_effect_data{nullptr};
+    /// Channels of the first LED and the distance between LEDs, red is null if there is no fixed distance
+    uint8_t *red{nullptr};
+    uint8_t *green{nullptr};
+    uint8_t *blue{nullptr};
+    uint8_t *white{nullptr};
+    int32_t stride{0};
+    /// Effect data of the first LED and the distance between LEDs, null if there is no fixed distance
+    uint8_t *effect_data{nullptr};
+    int32_t effect_stride{0};
+  };
+  /** Get the layout of the LEDs in the output buffer as it is now.
+   *
+   * Outputs can move their buffer, NeoPixelBus swaps between two buffers on every show for example. So the first and
+   * the last LED are looked up on every call and the layout is only reused while they are where they were. The last
+   * two layouts are kept, so alternating buffers are only checked once each.
+   */
+  const Layout &update_layout_();
+  /// Limit a range of LEDs to the light, false if nothing is left.
+  bool clamp_range_(int32_t &index, int32_t &count, int32_t &skipped) const;
+
   ESPColorCorrection correction_{};
+  Layout layouts_[2];
+  /// Slot of layouts_ that the next newly checked layout goes to
+  uint8_t layout_next_{0};
   LightState *state_parent_{nullptr};
 #ifdef USE_POWER_SUPPLY
   power_supply::PowerSupplyRequester power_;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -45,7 +46,33 @@ class AddressableLightEffect : public LightEffect {
   }
 
  protected:
+  /// Number of LEDs that the effects below render at once, in a row of colors on the stack.
+  static constexpr int32_t ROW_SIZE = 64;
+
   AddressableLight *get_addressable_() const { return (AddressableLight *) this->state_->get_output(); }
+
+  /** Render the light in rows of up to ROW_SIZE LEDs.
+   *
+   * f(index, row, count) fills the colors of LEDs index to index + count - 1 into row, each row is then written to
+   * the light with one color correction pass. Compared to setting every LED through its ESPColorView, this keeps the
+   * per LED work in plain loops over the row. With white false, the white channel of the LEDs is left unchanged.
+   */
+  template<typename F> static void render_rows_(AddressableLight &it, F &&f, bool white = true) {
+    Color row[ROW_SIZE];
+    const int32_t size = it.size();
+    for (int32_t index = 0; index < size; index += ROW_SIZE) {
+      const int32_t count = std::min(size - index, ROW_SIZE);
+      f(index, row, count);
+      it.write_colors(index, row, count, white);
+    }
+  }
+  /// Like render_rows_(), but row starts out with the current (uncorrected) colors of the LEDs.
+  template<typename F> static void update_rows_(AddressableLight &it, F &&f) {
+    render_rows_(it, [&it, &f](int32_t index, Color *row, int32_t count) {
+      it.read_colors(index, row, count);
+      f(index, row, count);
+    });
+  }
 };
 
 class AddressableLambdaLightEffect : public AddressableLightEffect {
@@ -81,11 +108,15 @@ class AddressableRainbowLightEffect : public AddressableLightEffect {
     hsv.saturation = 240;
     uint16_t hue = (millis() * this->speed_) % 0xFFFF;
     const uint16_t add = 0xFFFF / this->width_;
-    for (auto var : it) {
-      hsv.hue = hue >> 8;
-      var = hsv;
-      hue += add;
-    }
+    auto render = [&](int32_t index, Color *row, int32_t count) {
+      for (int32_t i = 0; i < count; i++) {
+        hsv.hue = hue >> 8;
+        row[i] = hsv.to_rgb();
+        hue += add;
+      }
+    };
+    // like setting an ESPHSVColor, the white channel is left unchanged
+    render_rows_(it, render, false);
     it.schedule_show();
   }
   void set_speed(uint32_t speed) { this->speed_ = speed; }
@@ -204,20 +235,25 @@ class AddressableTwinkleEffect : public AddressableLightEffect {
       pos_add = pos_add32;
       this->last_progress_ += pos_add32 * this->progress_interval_;
     }
-    for (auto view : addressable) {
-      if (view.get_effect_data() != 0) {
-        const uint8_t sine = half_sin8(view.get_effect_data());
-        view = current_color * sine;
-        const uint8_t new_pos = view.get_effect_data() + pos_add;
-        if (new_pos < view.get_effect_data()) {
-          view.set_effect_data(0);
+    render_rows_(addressable, [&](int32_t index, Color *row, int32_t count) {
+      uint8_t data[ROW_SIZE];
+      addressable.read_effect_data(index, data, count);
+      for (int32_t i = 0; i < count; i++) {
+        if (data[i] != 0) {
+          const uint8_t sine = half_sin8(data[i]);
+          row[i] = current_color * sine;
+          const uint8_t new_pos = data[i] + pos_add;
+          if (new_pos < data[i]) {
+            data[i] = 0;
+          } else {
+            data[i] = new_pos;
+          }
         } else {
-          view.set_effect_data(new_pos);
+          row[i] = Color::BLACK;
         }
-      } else {
-        view = Color::BLACK;
       }
-    }
+      addressable.write_effect_data(index, data, count);
+    });
     while (random_float() < this->twinkle_probability_) {
       const size_t pos = random_uint32() % addressable.size();
       if (addressable[pos].get_effect_data() != 0)
@@ -246,26 +282,31 @@ class AddressableRandomTwinkleEffect : public AddressableLightEffect {
       this->last_progress_ = now;
     }
     uint8_t subsine = ((8 * (now - this->last_progress_)) / this->progress_interval_) & 0b111;
-    for (auto view : it) {
-      if (view.get_effect_data() != 0) {
-        const uint8_t x = (view.get_effect_data() >> 3) & 0b11111;
-        const uint8_t color = view.get_effect_data() & 0b111;
-        const uint16_t sine = half_sin8((x << 3) | subsine);
-        if (color == 0) {
-          view = current_color * sine;
-        } else {
-          view = Color(((color >> 2) & 1) * sine, ((color >> 1) & 1) * sine, ((color >> 0) & 1) * sine);
-        }
-        const uint8_t new_x = x + pos_add;
-        if (new_x > 0b11111) {
-          view.set_effect_data(0);
+    render_rows_(it, [&](int32_t index, Color *row, int32_t count) {
+      uint8_t data[ROW_SIZE];
+      it.read_effect_data(index, data, count);
+      for (int32_t i = 0; i < count; i++) {
+        if (data[i] != 0) {
+          const uint8_t x = (data[i] >> 3) & 0b11111;
+          const uint8_t color = data[i] & 0b111;
+          const uint16_t sine = half_sin8((x << 3) | subsine);
+          if (color == 0) {
+            row[i] = current_color * sine;
+          } else {
+            row[i] = Color(((color >> 2) & 1) * sine, ((color >> 1) & 1) * sine, ((color >> 0) & 1) * sine);
+          }
+          const uint8_t new_x = x + pos_add;
+          if (new_x > 0b11111) {
+            data[i] = 0;
+          } else {
+            data[i] = (new_x << 3) | color;
+          }
         } else {
-          view.set_effect_data((new_x << 3) | color);
+          row[i] = Color(0, 0, 0, 0);
         }
-      } else {
-        view = Color(0, 0, 0, 0);
       }
-    }
+      it.write_effect_data(index, data, count);
+    });
     while (random_float() < this->twinkle_probability_) {
       const size_t pos = random_uint32() % it.size();
       if (it[pos].get_effect_data() != 0)
@@ -298,18 +339,37 @@ class AddressableFireworksEffect : public AddressableLightEffect {
     this->last_update_ = now;
     // "invert" the fade out parameter so that higher values make fade out faster
     const uint8_t fade_out_mult = 255u - this->fade_out_rate_;
-    for (auto view : it) {
-      Color target = view.get() * fade_out_mult;
+    auto fade = [fade_out_mult](Color color) {
+      Color target = color * fade_out_mult;
       if (target.r < 64)
         target *= 170;
-      view = target;
-    }
-    int last = it.size() - 1;
-    it[0].set(it[0].get() + (it[1].get() * 128));
-    for (int i = 1; i < last; i++) {
-      it[i] = (it[i - 1].get() * 64) + it[i].get() + (it[i + 1].get() * 64);
-    }
-    it[last] = it[last].get() + (it[last - 1].get() * 128);
+      return target;
+    };
+    // Fade out, then blur every LED with its neighbors from left to right. The left neighbor is already blurred,
+    // the right one only faded, so each row needs the faded first LED of the next row.
+    const int32_t last = it.size() - 1;
+    Color left;
+    update_rows_(it, [&](int32_t index, Color *row, int32_t count) {
+      for (int32_t i = 0; i < count; i++)
+        row[i] = fade(row[i]);
+      Color next;
+      if (index + count <= last) {
+        it.read_colors(index + count, &next, 1);
+        next = fade(next);
+      }
+      for (int32_t i = 0; i < count; i++) {
+        const int32_t led = index + i;
+        const Color right = i + 1 < count ? row[i + 1] : next;
+        if (led == 0) {
+          row[i] = row[i] + (right * 128);
+        } else if (led == last) {
+          row[i] = row[i] + (left * 128);
+        } else {
+          row[i] = (left * 64) + row[i] + (right * 64);
+        }
+        left = row[i];
+      }
+    });
     if (random_float() < this->spark_probability_) {
       const size_t pos = random_uint32() % it.size();
       if (this->use_random_color_) {
@@ -345,15 +405,15 @@ class AddressableFlickerEffect : public AddressableLightEffect {
 
     this->last_update_ = now;
     uint32_t rng_state = random_uint32();
-    for (auto var : it) {
-      rng_state = (rng_state * 0x9E3779B9) + 0x9E37;
-      const uint8_t flicker = (rng_state & 0xFF) % intensity;
-      // scale down by random factor
-      var = var.get() * (255 - flicker);
-
-      // slowly fade back to "real" value
-      var = (var.get() * inv_intensity) + (current_color * intensity);
-    }
+    const Color target = current_color * intensity;
+    update_rows_(it, [&](int32_t index, Color *row, int32_t count) {
+      for (int32_t i = 0; i < count; i++) {
+        rng_state = (rng_state * 0x9E3779B9) + 0x9E37;
+        const uint8_t flicker = (rng_state & 0xFF) % intensity;
+        // scale down by random factor, and slowly fade back to "real" value
+        row[i] = ((row[i] * (255 - flicker)) * inv_intensity) + target;
+      }
+    });
     it.schedule_show();
   }
   void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
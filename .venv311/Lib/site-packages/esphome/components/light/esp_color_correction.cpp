@@ -1,11 +1,13 @@
 #include "esp_color_correction.h"
 #include "light_color_values.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
 namespace esphome {
 namespace light {
 
 void ESPColorCorrection::calculate_gamma_table(float gamma) {
+  this->invalidate_lookup_tables_();
   for (uint16_t i = 0; i < 256; i++) {
     // corrected = val ^ gamma
     auto corrected = to_uint8_scale(gamma_correct(i / 255.0f, gamma));
@@ -23,5 +25,37 @@ void ESPColorCorrection::calculate_gamma_table(float gamma) {
   }
 }
 
+const uint8_t *ESPColorCorrection::get_lookup_tables() {
+  if (this->lut_valid_)
+    return this->lut_.get();
+  if (!this->lut_)
+    this->lut_ = make_unique<uint8_t[]>(4 * 256);
+  uint8_t *lut = this->lut_.get();
+  for (uint16_t i = 0; i < 256; i++) {
+    lut[i] = this->color_correct_red(i);
+    lut[256 + i] = this->color_correct_green(i);
+    lut[512 + i] = this->color_correct_blue(i);
+    lut[768 + i] = this->color_correct_white(i);
+  }
+  this->lut_valid_ = true;
+  return lut;
+}
+
+const uint8_t *ESPColorCorrection::get_reverse_lookup_tables() {
+  if (this->reverse_lut_valid_)
+    return this->reverse_lut_.get();
+  if (!this->reverse_lut_)
+    this->reverse_lut_ = make_unique<uint8_t[]>(4 * 256);
+  uint8_t *lut = this->reverse_lut_.get();
+  for (uint16_t i = 0; i < 256; i++) {
+    lut[i] = this->color_uncorrect_red(i);
+    lut[256 + i] = this->color_uncorrect_green(i);
+    lut[512 + i] = this->color_uncorrect_blue(i);
+    lut[768 + i] = this->color_uncorrect_white(i);
+  }
+  this->reverse_lut_valid_ = true;
+  return lut;
+}
+
 }  // namespace light
 }  // namespace esphome
@@ -2,15 +2,32 @@
 
 #include "esphome/core/color.h"
 
+#include <memory>
+
 namespace esphome {
 namespace light {
 
 class ESPColorCorrection {
  public:
   ESPColorCorrection() : max_brightness_(255, 255, 255, 255) {}
-  void set_max_brightness(const Color &max_brightness) { this->max_brightness_ = max_brightness; }
-  void set_local_brightness(uint8_t local_brightness) { this->local_brightness_ = local_brightness; }
+  void set_max_brightness(const Color &max_brightness) {
+    this->max_brightness_ = max_brightness;
+    this->invalidate_lookup_tables_();
+  }
+  void set_local_brightness(uint8_t local_brightness) {
+    if (local_brightness != this->local_brightness_)
+      this->invalidate_lookup_tables_();
+    this->local_brightness_ = local_brightness;
+  }
   void calculate_gamma_table(float gamma);
+  /** Lookup tables with the complete correction of each channel, for correcting many LEDs at once.
+   *
+   * Returns 4 tables of 256 entries for red, green, blue and white, in this order. They are allocated on first use
+   * and rebuilt after the correction changed.
+   */
+  const uint8_t *get_lookup_tables();
+  /// Lookup tables for the reverse of the correction, in the same order as get_lookup_tables().
+  const uint8_t *get_reverse_lookup_tables();
   inline Color color_correct(Color color) const ESPHOME_ALWAYS_INLINE {
     // corrected = (uncorrected * max_brightness * local_brightness) ^ gamma
     return Color(this->color_correct_red(color.red), this->color_correct_green(color.green),
@@ -67,10 +84,19 @@ class ESPColorCorrection {
   }
 
  protected:
+  void invalidate_lookup_tables_() {
+    this->lut_valid_ = false;
+    this->reverse_lut_valid_ = false;
+  }
+
   uint8_t gamma_table_[256];
   uint8_t gamma_reverse_table_[256];
   Color max_brightness_;
   uint8_t local_brightness_{255};
+  std::unique_ptr<uint8_t[]> lut_;
+  std::unique_ptr<uint8_t[]> reverse_lut_;
+  bool lut_valid_{false};
+  bool reverse_lut_valid_{false};
 };
 
 }  // namespace light
@@ -98,6 +98,8 @@ class ESPColorView : public ESPColorSettable {
   }
 
  protected:
+  friend class AddressableLight;
+
   uint8_t *const red_;
   uint8_t *const green_;
   uint8_t *const blue_;
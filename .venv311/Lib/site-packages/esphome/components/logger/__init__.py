@@ -96,6 +96,7 @@ DEFAULT = "DEFAULT"
 CONF_INITIAL_LEVEL = "initial_level"
 CONF_LOGGER_ID = "logger_id"
 CONF_TASK_LOG_BUFFER_SIZE = "task_log_buffer_size"
+CONF_BINARY_LOG_SLOTS = "binary_log_slots"
 
 UART_SELECTION_ESP32 = {
     VARIANT_ESP32: [UART0, UART1, UART2],
@@ -221,6 +222,11 @@ CONFIG_SCHEMA = cv.All(
                     ),
                 ),
             ),
+            # Deferred formatting: each slot holds one unformatted message (~128 bytes)
+            cv.Optional(CONF_BINARY_LOG_SLOTS, default=0): cv.Any(
+                cv.int_(0),  # Disabled
+                cv.int_range(min=8, max=1024),
+            ),
             cv.SplitDefault(
                 CONF_HARDWARE_UART,
                 esp8266=UART0,
@@ -292,6 +298,9 @@ async def to_code(config):
         if task_log_buffer_size > 0:
             cg.add_define("USE_ESPHOME_TASK_LOG_BUFFER")
             cg.add(log.init_log_buffer(task_log_buffer_size))
+    if config[CONF_BINARY_LOG_SLOTS] > 0:
+        cg.add_define("USE_LOGGER_BINARY_LOG")
+        cg.add(log.init_binary_log(config[CONF_BINARY_LOG_SLOTS]))
 
     cg.add(log.set_log_level(initial_level))
     if CONF_HARDWARE_UART in config:
@@ -0,0 +1,422 @@
+#include "binary_log_ring.h"
+
+#ifdef USE_LOGGER_BINARY_LOG
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+namespace esphome::logger {
+
+BinaryLogRing::BinaryLogRing(size_t slot_count) {
+  uint32_t count = 1;
+  while (count < slot_count)
+    count <<= 1;
+  this->mask_ = count - 1;
+
+  RAMAllocator<uint8_t> allocator;
+  auto *storage = allocator.allocate(count * sizeof(Slot));
+  this->slots_ = reinterpret_cast<Slot *>(storage);
+  for (uint32_t i = 0; i < count; i++) {
+    new (&this->slots_[i]) Slot();
+    this->slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+BinaryLogRing::~BinaryLogRing() {
+  if (this->slots_ == nullptr)
+    return;
+  RAMAllocator<uint8_t> allocator;
+  allocator.deallocate(reinterpret_cast<uint8_t *>(this->slots_), this->slot_count() * sizeof(Slot));
+  this->slots_ = nullptr;
+}
+
+bool BinaryLogRing::push(uint8_t level, const char *tag, uint16_t line, const char *thread_name, const char *format,
+                         va_list args) {
+  // Capture into a stack record first so a failed capture never needs to give back a claimed slot
+  Record record;
+  va_list args_copy;
+  va_copy(args_copy, args);
+  bool captured = capture_args_(&record, format, args_copy);
+  va_end(args_copy);
+  if (!captured)
+    return false;
+
+  record.tag = tag;
+  record.format = format;
+  record.line = line;
+  record.level = level;
+  if (thread_name != nullptr) {
+    strncpy(record.thread_name, thread_name, sizeof(record.thread_name) - 1);
+    record.thread_name[sizeof(record.thread_name) - 1] = '\0';
+  } else {
+    record.thread_name[0] = '\0';
+  }
+
+  // Claim a slot
+  Slot *slot;
+  uint32_t pos = this->enqueue_pos_.load(std::memory_order_relaxed);
+  while (true) {
+    slot = &this->slots_[pos & this->mask_];
+    uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+    int32_t diff = static_cast<int32_t>(seq - pos);
+    if (diff == 0) {
+      if (this->enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      return false;  // Full
+    } else {
+      pos = this->enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Only copy the used part of the argument area
+  memcpy(&slot->record, &record, offsetof(Record, args) + record.args_length);
+  // Publish
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool BinaryLogRing::borrow_record_main_loop(Record **record) {
+  if (!this->has_records())
+    return false;
+  *record = &this->slots_[this->dequeue_pos_ & this->mask_].record;
+  return true;
+}
+
+void BinaryLogRing::release_record_main_loop() {
+  Slot &slot = this->slots_[this->dequeue_pos_ & this->mask_];
+  slot.sequence.store(this->dequeue_pos_ + this->mask_ + 1, std::memory_order_release);
+  this->dequeue_pos_++;
+}
+
+namespace {
+
+enum class ArgLength : uint8_t { NONE, HH, H, L, LL, Z, J, T, LONG_DOUBLE };
+
+// Parsed "%[flags][width][.precision][length]conversion" specifier
+struct Spec {
+  const char *start;    // Points at '%'
+  const char *end;      // One past the conversion character
+  uint8_t stars;        // Number of '*' width/precision arguments
+  bool precision_star;  // The precision is the last '*' argument
+  int precision;        // -1 if there is no precision
+  ArgLength length;
+  char conversion;
+};
+
+bool is_flag(char c) { return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0'; }
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+// p must point just after a '%' that is not "%%"
+const char *parse_spec(const char *p, Spec *spec) {
+  spec->start = p - 1;
+  spec->stars = 0;
+  spec->precision_star = false;
+  spec->precision = -1;
+  spec->length = ArgLength::NONE;
+  while (is_flag(*p))
+    p++;
+  if (*p == '*') {
+    spec->stars++;
+    p++;
+  } else {
+    while (is_digit(*p))
+      p++;
+  }
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      spec->stars++;
+      spec->precision_star = true;
+      p++;
+    } else {
+      // A lone '.' means a precision of zero
+      spec->precision = 0;
+      while (is_digit(*p))
+        spec->precision = spec->precision * 10 + (*p++ - '0');
+    }
+  }
+  switch (*p) {
+    case 'h':
+      p++;
+      spec->length = ArgLength::H;
+      if (*p == 'h') {
+        p++;
+        spec->length = ArgLength::HH;
+      }
+      break;
+    case 'l':
+      p++;
+      spec->length = ArgLength::L;
+      if (*p == 'l') {
+        p++;
+        spec->length = ArgLength::LL;
+      }
+      break;
+    case 'z':
+      p++;
+      spec->length = ArgLength::Z;
+      break;
+    case 'j':
+      p++;
+      spec->length = ArgLength::J;
+      break;
+    case 't':
+      p++;
+      spec->length = ArgLength::T;
+      break;
+    case 'L':
+      p++;
+      spec->length = ArgLength::LONG_DOUBLE;
+      break;
+    default:
+      break;
+  }
+  spec->conversion = *p;
+  if (*p != '\0')
+    p++;
+  spec->end = p;
+  return p;
+}
+
+// Appends raw values to the record argument area
+struct ArgWriter {
+  uint8_t *data;
+  size_t at;
+
+  template<typename T> bool put(T value) {
+    if (this->at + sizeof(T) > BinaryLogRing::MAX_ARGS_SIZE)
+      return false;
+    memcpy(this->data + this->at, &value, sizeof(T));
+    this->at += sizeof(T);
+    return true;
+  }
+  // With a precision only that many bytes may be read, the string doesn't need to be terminated ("%.*s" slices)
+  bool put_string(const char *str, int precision) {
+    if (str == nullptr)
+      str = "(null)";
+    size_t length = precision >= 0 ? strnlen(str, precision) : strlen(str);
+    // A string that doesn't fit rejects the whole record, the caller then formats the message eagerly
+    if (this->at + length + 1 > BinaryLogRing::MAX_ARGS_SIZE)
+      return false;
+    memcpy(this->data + this->at, str, length);
+    this->data[this->at + length] = '\0';
+    this->at += length + 1;
+    return true;
+  }
+};
+
+// Reads back values written by ArgWriter in the same order
+struct ArgReader {
+  const uint8_t *data;
+  size_t at;
+
+  template<typename T> T get() {
+    T value;
+    memcpy(&value, this->data + this->at, sizeof(T));
+    this->at += sizeof(T);
+    return value;
+  }
+  const char *get_string() {
+    const char *str = reinterpret_cast<const char *>(this->data + this->at);
+    this->at += strlen(str) + 1;
+    return str;
+  }
+};
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+template<typename T> int emit(char *out, size_t size, const char *spec, uint8_t stars, const int *star_values, T value) {
+  switch (stars) {
+    case 0:
+      return snprintf(out, size, spec, value);
+    case 1:
+      return snprintf(out, size, spec, star_values[0], value);
+    default:
+      return snprintf(out, size, spec, star_values[0], star_values[1], value);
+  }
+}
+#pragma GCC diagnostic pop
+
+}  // namespace
+
+bool BinaryLogRing::capture_args_(Record *record, const char *format, va_list args) {
+  ArgWriter writer{record->args, 0};
+  const char *p = format;
+  while (*p != '\0') {
+    if (*p++ != '%')
+      continue;
+    if (*p == '%') {
+      p++;
+      continue;
+    }
+    Spec spec;
+    p = parse_spec(p, &spec);
+    int star_value = 0;
+    for (uint8_t i = 0; i < spec.stars; i++) {
+      star_value = va_arg(args, int);
+      if (!writer.put<int>(star_value))
+        return false;
+    }
+    bool ok;
+    switch (spec.conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        // Signedness doesn't change the size, so store the unsigned bit pattern
+        switch (spec.length) {
+          case ArgLength::L:
+            ok = writer.put<unsigned long>(va_arg(args, unsigned long));
+            break;
+          case ArgLength::LL:
+            ok = writer.put<unsigned long long>(va_arg(args, unsigned long long));
+            break;
+          case ArgLength::Z:
+            ok = writer.put<size_t>(va_arg(args, size_t));
+            break;
+          case ArgLength::J:
+            ok = writer.put<uintmax_t>(va_arg(args, uintmax_t));
+            break;
+          case ArgLength::T:
+            ok = writer.put<ptrdiff_t>(va_arg(args, ptrdiff_t));
+            break;
+          default:
+            // char and short are promoted to int
+            ok = writer.put<unsigned int>(va_arg(args, unsigned int));
+            break;
+        }
+        break;
+      case 'c':
+        if (spec.length != ArgLength::NONE)
+          return false;  // Wide character
+        ok = writer.put<int>(va_arg(args, int));
+        break;
+      case 'p':
+        ok = writer.put<void *>(va_arg(args, void *));
+        break;
+      case 's':
+        if (spec.length != ArgLength::NONE)
+          return false;  // Wide string
+        // A negative '*' precision counts as no precision
+        ok = writer.put_string(va_arg(args, const char *), spec.precision_star ? star_value : spec.precision);
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (spec.length == ArgLength::LONG_DOUBLE) {
+          ok = writer.put<long double>(va_arg(args, long double));
+        } else {
+          ok = writer.put<double>(va_arg(args, double));
+        }
+        break;
+      default:
+        // %n, wide characters or a malformed specifier: format eagerly instead
+        return false;
+    }
+    if (!ok)
+      return false;
+  }
+  record->args_length = writer.at;
+  return true;
+}
+
+uint16_t BinaryLogRing::format_record(const Record &record, char *buffer, uint16_t buffer_size) {
+  if (buffer_size == 0)
+    return 0;
+  ArgReader reader{record.args, 0};
+  uint16_t at = 0;
+  const char *p = record.format;
+  // Leave room for the terminator snprintf always writes
+  while (*p != '\0' && at < buffer_size - 1) {
+    if (*p != '%') {
+      buffer[at++] = *p++;
+      continue;
+    }
+    p++;
+    if (*p == '%') {
+      buffer[at++] = '%';
+      p++;
+      continue;
+    }
+    Spec spec;
+    p = parse_spec(p, &spec);
+    char spec_str[24];
+    size_t spec_len = spec.end - spec.start;
+    if (spec_len >= sizeof(spec_str))
+      break;
+    memcpy(spec_str, spec.start, spec_len);
+    spec_str[spec_len] = '\0';
+
+    int star_values[2] = {0, 0};
+    for (uint8_t i = 0; i < spec.stars; i++)
+      star_values[i] = reader.get<int>();
+
+    char *out = buffer + at;
+    size_t remaining = buffer_size - at;
+    int ret;
+    switch (spec.conversion) {
+      case 'd':
+      case 'i':
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X':
+        switch (spec.length) {
+          case ArgLength::L:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<unsigned long>());
+            break;
+          case ArgLength::LL:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<unsigned long long>());
+            break;
+          case ArgLength::Z:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<size_t>());
+            break;
+          case ArgLength::J:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<uintmax_t>());
+            break;
+          case ArgLength::T:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<ptrdiff_t>());
+            break;
+          default:
+            ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<unsigned int>());
+            break;
+        }
+        break;
+      case 'c':
+        ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<int>());
+        break;
+      case 'p':
+        ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<void *>());
+        break;
+      case 's':
+        ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get_string());
+        break;
+      default:
+        if (spec.length == ArgLength::LONG_DOUBLE) {
+          ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<long double>());
+        } else {
+          ret = emit(out, remaining, spec_str, spec.stars, star_values, reader.get<double>());
+        }
+        break;
+    }
+    if (ret < 0)
+      break;
+    // Handle truncation: snprintf wrote at most remaining - 1 characters
+    at += (static_cast<size_t>(ret) >= remaining) ? remaining - 1 : ret;
+  }
+  buffer[at] = '\0';
+  return at;
+}
+
+}  // namespace esphome::logger
+
+#endif  // USE_LOGGER_BINARY_LOG
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
+
+#ifdef USE_LOGGER_BINARY_LOG
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome::logger {
+
+/**
+ * @brief Lock-free multi-producer, single-consumer ring of unformatted log records.
+ *
+ * Producers store the format string pointer and the raw printf arguments (strings are copied, since their
+ * storage may be gone by the time the record is formatted). Formatting happens only when the logger drains
+ * the ring from the main loop and there is a consumer (UART or log callback) for the text.
+ *
+ * The ring is a bounded queue with a sequence number per slot (Vyukov style): producers claim a slot with a
+ * CAS on the enqueue position and publish it by advancing the slot sequence, so no task ever blocks on a
+ * lock while logging.
+ */
+class BinaryLogRing {
+ public:
+  /// Bytes reserved for packed arguments (including copied strings) per record.
+  static constexpr size_t MAX_ARGS_SIZE = 96;
+
+  struct Record {
+    const char *tag;          // Assumed static, like everywhere else in the logger
+    const char *format;       // Assumed static (string literal)
+    uint16_t line;            // Source code line number
+    uint8_t level;            // Log level (0-7)
+    uint8_t args_length;      // Bytes used in args
+    char thread_name[16];     // Empty for the main task
+    uint8_t args[MAX_ARGS_SIZE];
+  };
+
+  /// Create a ring with slot_count records, rounded up to a power of two.
+  explicit BinaryLogRing(size_t slot_count);
+  ~BinaryLogRing();
+
+  /** Thread-safe - capture a message without formatting it.
+   *
+   * @return false if the ring is full or the format uses a conversion that can't be captured
+   *         (e.g. %n, or arguments exceeding MAX_ARGS_SIZE); the caller should then format eagerly.
+   */
+  bool push(uint8_t level, const char *tag, uint16_t line, const char *thread_name, const char *format,
+            va_list args);
+
+  // NOT thread-safe - borrow the oldest record, only call from main loop
+  bool borrow_record_main_loop(Record **record);
+  // NOT thread-safe - release the record returned by borrow_record_main_loop, only call from main loop
+  void release_record_main_loop();
+
+  inline bool HOT has_records() const {
+    const Slot &slot = this->slots_[this->dequeue_pos_ & this->mask_];
+    return slot.sequence.load(std::memory_order_acquire) == this->dequeue_pos_ + 1;
+  }
+
+  /// Format a record's message body (no header/footer) into buffer, returns the number of bytes written.
+  static uint16_t format_record(const Record &record, char *buffer, uint16_t buffer_size);
+
+  inline size_t slot_count() const { return this->mask_ + 1; }
+
+ protected:
+  /// Pack the arguments described by format into record, returns false if that is not possible.
+  static bool capture_args_(Record *record, const char *format, va_list args);
+
+  struct Slot {
+    std::atomic<uint32_t> sequence;
+    Record record;
+  };
+
+  Slot *slots_{nullptr};
+  uint32_t mask_{0};
+  std::atomic<uint32_t> enqueue_pos_{0};
+  uint32_t dequeue_pos_{0};  // Only touched by the main loop
+};
+
+}  // namespace esphome::logger
+
+#endif  // USE_LOGGER_BINARY_LOG
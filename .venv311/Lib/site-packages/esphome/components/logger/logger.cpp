@@ -35,6 +35,19 @@ void HOT Logger::log_vprintf_(uint8_t level, const char *tag, int line, const ch
     return;  // Recursion detected
   }
 
+#ifdef USE_LOGGER_BINARY_LOG
+  // Capture the arguments without formatting; the logger loop formats the message only if something consumes it
+  if (this->binary_log_->push(level, tag, static_cast<uint16_t>(line),
+                              is_main_task ? nullptr : pcTaskGetName(current_task), format, args)) {
+    this->enable_loop_soon_any_context();
+    this->reset_task_log_recursion_(is_main_task);
+    return;
+  }
+  // Ring full (or uncapturable format): flush older records first so console order is preserved
+  if (is_main_task)
+    this->process_binary_log_();
+#endif
+
   // Main task uses the shared buffer for efficiency
   if (is_main_task) {
     this->log_message_to_buffer_and_send_(level, tag, line, format, args);
@@ -79,6 +92,17 @@ void HOT Logger::log_vprintf_(uint8_t level, const char *tag, int line, const ch
 
   global_recursion_guard_ = true;
 
+#ifdef USE_LOGGER_BINARY_LOG
+  // Capture the arguments without formatting; the logger loop formats the message only if something consumes it
+  if (this->binary_log_->push(level, tag, static_cast<uint16_t>(line), nullptr, format, args)) {
+    this->enable_loop_soon_any_context();
+    global_recursion_guard_ = false;
+    return;
+  }
+  // Ring full (or uncapturable format): flush older records first so console order is preserved
+  this->process_binary_log_();
+#endif
+
   // Format and send to both console and callbacks
   this->log_message_to_buffer_and_send_(level, tag, line, format, args);
 
@@ -172,9 +196,17 @@ void Logger::init_log_buffer(size_t total_buffer_size) {
   this->disable_loop_when_buffer_empty_();
 }
 #endif
+#ifdef USE_LOGGER_BINARY_LOG
+void Logger::init_binary_log(size_t slot_count) {
+  this->binary_log_ = esphome::make_unique<logger::BinaryLogRing>(slot_count);
+
+  // The loop will be enabled automatically when messages arrive
+  this->disable_loop_when_buffer_empty_();
+}
+#endif
 
 #ifndef USE_ZEPHYR
-#if defined(USE_LOGGER_USB_CDC) || defined(USE_ESP32)
+#if defined(USE_LOGGER_USB_CDC) || defined(USE_ESP32) || defined(USE_LOGGER_BINARY_LOG)
 void Logger::loop() {
 #if defined(USE_LOGGER_USB_CDC) && defined(USE_ARDUINO)
   if (this->uart_ == UART_SELECTION_USB_CDC) {
@@ -194,6 +226,9 @@ void Logger::loop() {
 #endif
 
 void Logger::process_messages_() {
+#ifdef USE_LOGGER_BINARY_LOG
+  this->process_binary_log_();
+#endif
 #ifdef USE_ESPHOME_TASK_LOG_BUFFER
   // Process any buffered messages when available
   if (this->log_buffer_->has_messages()) {
@@ -227,7 +262,10 @@ void Logger::process_messages_() {
         this->write_msg_(this->tx_buffer_);
       }
     }
-  } else {
+  }
+#endif
+#if defined(USE_ESPHOME_TASK_LOG_BUFFER) || defined(USE_LOGGER_BINARY_LOG)
+  if (!this->has_pending_messages_()) {
     // No messages to process, disable loop if appropriate
     // This reduces overhead when there's no async logging activity
     this->disable_loop_when_buffer_empty_();
@@ -235,6 +273,48 @@ void Logger::process_messages_() {
 #endif
 }
 
+#ifdef USE_LOGGER_BINARY_LOG
+void Logger::process_binary_log_() {
+  // A callback logging into a full ring must not re-enter and overwrite tx_buffer_ while it is being sent
+  if (this->binary_log_draining_)
+    return;
+  this->binary_log_draining_ = true;
+  // Bound the work per call so records logged by callbacks while draining wait for the next loop
+  size_t budget = this->binary_log_->slot_count();
+  logger::BinaryLogRing::Record *record;
+  while (budget-- > 0 && this->binary_log_->borrow_record_main_loop(&record)) {
+    if (this->baud_rate_ == 0 && this->log_callback_.size() == 0) {
+      // Nobody consumes the text, so it is never formatted
+      this->binary_log_->release_record_main_loop();
+      continue;
+    }
+    const uint8_t level = record->level;
+    const char *tag = record->tag;
+    this->tx_buffer_at_ = 0;
+    const char *thread_name = record->thread_name[0] != '\0' ? record->thread_name : nullptr;
+    this->write_header_to_buffer_(level, tag, record->line, thread_name, this->tx_buffer_, &this->tx_buffer_at_,
+                                  this->tx_buffer_size_);
+    if (this->tx_buffer_at_ < this->tx_buffer_size_) {
+      this->tx_buffer_at_ += logger::BinaryLogRing::format_record(*record, this->tx_buffer_ + this->tx_buffer_at_,
+                                                                  this->tx_buffer_size_ - this->tx_buffer_at_);
+      // Remove all trailing newlines, like format_body_to_buffer_
+      while (this->tx_buffer_at_ > 0 && this->tx_buffer_[this->tx_buffer_at_ - 1] == '\n') {
+        this->tx_buffer_at_--;
+      }
+    }
+    // Everything needed from the record is in tx_buffer_ now, free the slot for producers
+    this->binary_log_->release_record_main_loop();
+    this->write_footer_to_buffer_(this->tx_buffer_, &this->tx_buffer_at_, this->tx_buffer_size_);
+    this->tx_buffer_[this->tx_buffer_at_] = '\0';
+    this->log_callback_.call(level, tag, this->tx_buffer_, this->tx_buffer_at_);
+    if (this->baud_rate_ > 0) {
+      this->write_msg_(this->tx_buffer_);
+    }
+  }
+  this->binary_log_draining_ = false;
+}
+#endif
+
 void Logger::set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
 void Logger::set_log_level(const std::string &tag, uint8_t log_level) { this->log_levels_[tag] = log_level; }
 
@@ -265,6 +345,9 @@ void Logger::dump_config() {
     ESP_LOGCONFIG(TAG, "  Task Log Buffer Size: %u", this->log_buffer_->size());
   }
 #endif
+#ifdef USE_LOGGER_BINARY_LOG
+  ESP_LOGCONFIG(TAG, "  Binary Log Slots: %u", static_cast<unsigned>(this->binary_log_->slot_count()));
+#endif
 
   for (auto &it : this->log_levels_) {
     ESP_LOGCONFIG(TAG, "  Level for '%s': %s", it.first.c_str(), LOG_LEVELS[it.second]);
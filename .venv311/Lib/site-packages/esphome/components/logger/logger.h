@@ -14,6 +14,9 @@
 #ifdef USE_ESPHOME_TASK_LOG_BUFFER
 #include "task_log_buffer.h"
 #endif
+#ifdef USE_LOGGER_BINARY_LOG
+#include "binary_log_ring.h"
+#endif
 
 #ifdef USE_ARDUINO
 #if defined(USE_ESP8266) || defined(USE_ESP32)
@@ -110,7 +113,11 @@ class Logger : public Component {
 #ifdef USE_ESPHOME_TASK_LOG_BUFFER
   void init_log_buffer(size_t total_buffer_size);
 #endif
-#if defined(USE_LOGGER_USB_CDC) || defined(USE_ESP32) || defined(USE_ZEPHYR)
+#ifdef USE_LOGGER_BINARY_LOG
+  /// Capture messages unformatted into a lock-free ring and format them from loop() when drained.
+  void init_binary_log(size_t slot_count);
+#endif
+#if defined(USE_LOGGER_USB_CDC) || defined(USE_ESP32) || defined(USE_ZEPHYR) || defined(USE_LOGGER_BINARY_LOG)
   void loop() override;
 #endif
   /// Manually set the baud rate for serial, set to 0 to disable.
@@ -258,6 +265,9 @@ class Logger : public Component {
 #ifdef USE_ESPHOME_TASK_LOG_BUFFER
   std::unique_ptr<logger::TaskLogBuffer> log_buffer_;  // Will be initialized with init_log_buffer
 #endif
+#ifdef USE_LOGGER_BINARY_LOG
+  std::unique_ptr<logger::BinaryLogRing> binary_log_;  // Will be initialized with init_binary_log
+#endif
 
   // Group smaller types together at the end
   uint16_t tx_buffer_at_{0};
@@ -269,6 +279,9 @@ class Logger : public Component {
 #ifdef USE_LIBRETINY
   UARTSelection uart_{UART_SELECTION_DEFAULT};
 #endif
+#ifdef USE_LOGGER_BINARY_LOG
+  bool binary_log_draining_{false};
+#endif
 #ifdef USE_ESP32
   bool main_task_recursion_guard_{false};
 #else
@@ -367,12 +380,31 @@ class Logger : public Component {
     }
   }
 
+#ifdef USE_LOGGER_BINARY_LOG
+  // Process messages captured by the binary log ring, formatting them only if someone consumes the text
+  void process_binary_log_();
+#endif
+
+#if defined(USE_ESPHOME_TASK_LOG_BUFFER) || defined(USE_LOGGER_BINARY_LOG)
+  inline bool has_pending_messages_() const {
+#ifdef USE_ESPHOME_TASK_LOG_BUFFER
+    if (this->log_buffer_->has_messages())
+      return true;
+#endif
+#ifdef USE_LOGGER_BINARY_LOG
+    if (this->binary_log_->has_records())
+      return true;
+#endif
+    return false;
+  }
+#endif
+
   inline void HOT write_footer_to_buffer_(char *buffer, uint16_t *buffer_at, uint16_t buffer_size) {
     static constexpr uint16_t RESET_COLOR_LEN = sizeof(ESPHOME_LOG_RESET_COLOR) - 1;
     this->write_body_to_buffer_(ESPHOME_LOG_RESET_COLOR, RESET_COLOR_LEN, buffer, buffer_at, buffer_size);
   }
 
-#ifdef USE_ESP32
+#if defined(USE_ESP32) || defined(USE_LOGGER_BINARY_LOG)
   // Disable loop when task buffer is empty (with USB CDC check)
   inline void disable_loop_when_buffer_empty_() {
     // Thread safety note: This is safe even if another task calls enable_loop_soon_any_context()
@@ -380,7 +412,7 @@ class Logger : public Component {
     // will be processed on the next main loop iteration since:
     // - disable_loop() takes effect immediately
     // - enable_loop_soon_any_context() sets a pending flag that's checked at loop start
-#if defined(USE_LOGGER_USB_CDC) && defined(USE_ARDUINO)
+#if defined(USE_LOGGER_USB_CDC) && (defined(USE_ARDUINO) || defined(USE_ZEPHYR))
     // Only disable if not using USB CDC (which needs loop for connection detection)
     if (this->uart_ != UART_SELECTION_USB_CDC) {
       this->disable_loop();
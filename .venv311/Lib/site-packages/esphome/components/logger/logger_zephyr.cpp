@@ -13,6 +13,10 @@ namespace esphome::logger {
 static const char *const TAG = "logger";
 
 void Logger::loop() {
+#ifdef USE_LOGGER_BINARY_LOG
+  // Binary log records must not wait for a DTR change
+  this->process_binary_log_();
+#endif
 #ifdef USE_LOGGER_USB_CDC
   if (this->uart_ != UART_SELECTION_USB_CDC || nullptr == this->uart_dev_) {
     return;
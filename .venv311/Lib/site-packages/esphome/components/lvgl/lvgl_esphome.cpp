@@ -1,3 +1,4 @@
+#include "esphome/components/display/rotate.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
@@ -5,6 +6,7 @@
 #include "lvgl_hal.h"
 #include "lvgl_esphome.h"
 
+#include <algorithm>
 #include <numeric>
 
 namespace esphome {
@@ -161,11 +163,7 @@ void LvglComponent::draw_buffer_(const lv_area_t *area, lv_color_t *ptr) {
   lv_color_t *dst = this->rotate_buf_;
   switch (this->rotation) {
     case display::DISPLAY_ROTATION_90_DEGREES:
-      for (lv_coord_t x = height; x-- != 0;) {
-        for (lv_coord_t y = 0; y != width; y++) {
-          dst[y * height + x] = *ptr++;
-        }
-      }
+      display::rotate_pixels(ptr, width, dst, height, width, height, this->rotation);
       y1 = x1;
       x1 = this->disp_drv_.ver_res - area->y1 - height;
       width = height;
@@ -173,21 +171,13 @@ void LvglComponent::draw_buffer_(const lv_area_t *area, lv_color_t *ptr) {
       break;
 
     case display::DISPLAY_ROTATION_180_DEGREES:
-      for (lv_coord_t y = height; y-- != 0;) {
-        for (lv_coord_t x = width; x-- != 0;) {
-          dst[y * width + x] = *ptr++;
-        }
-      }
+      display::rotate_pixels(ptr, width, dst, width, width, height, this->rotation);
       x1 = this->disp_drv_.hor_res - x1 - width;
       y1 = this->disp_drv_.ver_res - y1 - height;
       break;
 
     case display::DISPLAY_ROTATION_270_DEGREES:
-      for (lv_coord_t x = 0; x != height; x++) {
-        for (lv_coord_t y = width; y-- != 0;) {
-          dst[y * height + x] = *ptr++;
-        }
-      }
+      display::rotate_pixels(ptr, width, dst, height, width, height, this->rotation);
       x1 = y1;
       y1 = this->disp_drv_.hor_res - area->x1 - width;
       width = height;
@@ -441,9 +431,27 @@ void LvglComponent::setup() {
   if (frac == 0)
     frac = 1;
   size_t buffer_pixels = width * height / frac;
+  this->rotation = display->get_rotation();
+  // A single display that keeps its own buffer in LVGL's format can lend it, LVGL then renders (or rotates) straight
+  // into it and the flush goes directly to the display transfer.
+  void *lent = nullptr;
+  if (this->displays_.size() == 1) {
+    size_t min_pixels = this->full_refresh_ ? width * height : std::max(width, height);
+    size_t lent_pixels = 0;
+    lent = display->lend_buffer(LV_BITNESS, LV_COLOR_16_SWAP, min_pixels, lent_pixels);
+    if (lent != nullptr) {
+      ESP_LOGD(TAG, "Using the display buffer of %zu pixels", lent_pixels);
+      if (lent_pixels < buffer_pixels) {
+        buffer_pixels = lent_pixels;
+        frac = width * height / buffer_pixels;
+      }
+    }
+  }
   auto buf_bytes = buffer_pixels * LV_COLOR_DEPTH / 8;
   void *buffer = nullptr;
-  if (this->buffer_frac_ >= MIN_BUFFER_FRAC / 2)
+  if (lent != nullptr && this->rotation == display::DISPLAY_ROTATION_0_DEGREES)
+    buffer = lent;
+  if (buffer == nullptr && this->buffer_frac_ >= MIN_BUFFER_FRAC / 2)
     buffer = malloc(buf_bytes);  // NOLINT
   if (buffer == nullptr)
     buffer = lv_custom_mem_alloc(buf_bytes);  // NOLINT
@@ -455,6 +463,8 @@ void LvglComponent::setup() {
     buffer = lv_custom_mem_alloc(buf_bytes);  // NOLINT
   }
   if (buffer == nullptr) {
+    if (lent != nullptr)
+      display->return_buffer();
     this->status_set_error("Memory allocation failure");
     this->mark_failed();
     return;
@@ -465,9 +475,12 @@ void LvglComponent::setup() {
   this->disp_drv_.ver_res = height;
   // this->setup_driver_(display->get_width(), display->get_height());
   lv_disp_drv_update(this->disp_, &this->disp_drv_);
-  this->rotation = display->get_rotation();
   if (this->rotation != display::DISPLAY_ROTATION_0_DEGREES) {
-    this->rotate_buf_ = static_cast<lv_color_t *>(lv_custom_mem_alloc(buf_bytes));  // NOLINT
+    if (lent != nullptr) {
+      this->rotate_buf_ = static_cast<lv_color_t *>(lent);
+    } else {
+      this->rotate_buf_ = static_cast<lv_color_t *>(lv_custom_mem_alloc(buf_bytes));  // NOLINT
+    }
     if (this->rotate_buf_ == nullptr) {
       this->status_set_error("Memory allocation failure");
       this->mark_failed();
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "esphome/components/spi/spi.h"
 #include "esphome/components/display/display.h"
 #include "esphome/components/display/display_color_utils.h"
+#include "esphome/components/display/pixel_convert.h"
+#include "esphome/components/display/rotate.h"
 
 namespace esphome {
 namespace mipi_spi {
@@ -369,47 +373,35 @@ class MipiSpi : public display::Display,
                                 x_pad * sizeof(BUFFERTYPE));
     } else {
       // type conversion required, do it in chunks
-      uint8_t dbuffer[DISPLAYPIXEL * 48];
-      uint8_t *dptr = dbuffer;
+      static constexpr size_t CHUNK_PIXELS = 48;
+      uint8_t dbuffer[DISPLAYPIXEL * CHUNK_PIXELS];
+      size_t used = 0;                     // pixels in dbuffer
       auto stride = x_offset + w + x_pad;  // stride in pixels
       for (size_t y = 0; y != h; y++) {
-        for (size_t x = 0; x != w; x++) {
-          auto color_val = ptr[y * stride + x];
+        const BUFFERTYPE *line = ptr + y * stride;
+        for (size_t x = 0; x != w;) {
+          size_t count = std::min<size_t>(w - x, CHUNK_PIXELS - used);
+          auto *src = reinterpret_cast<const uint8_t *>(line + x);
+          uint8_t *dst = dbuffer + used * DISPLAYPIXEL;
           if constexpr (DISPLAYPIXEL == PIXEL_MODE_18 && BUFFERPIXEL == PIXEL_MODE_16) {
-            // 16 to 18 bit conversion
-            if constexpr (IS_BIG_ENDIAN) {
-              *dptr++ = color_val & 0xF8;
-              *dptr++ = ((color_val & 0x7) << 5) | (color_val & 0xE000) >> 11;
-              *dptr++ = (color_val >> 5) & 0xF8;
-            } else {
-              *dptr++ = (color_val >> 8) & 0xF8;  // Blue
-              *dptr++ = (color_val & 0x7E0) >> 3;
-              *dptr++ = color_val << 3;
-            }
+            display::rgb565_to_rgb666(src, dst, count, IS_BIG_ENDIAN);
           } else if constexpr (DISPLAYPIXEL == PIXEL_MODE_18 && BUFFERPIXEL == PIXEL_MODE_8) {
-            // 8 bit to 18 bit conversion
-            *dptr++ = color_val << 6;           // Blue
-            *dptr++ = (color_val & 0x1C) << 3;  // Green
-            *dptr++ = (color_val & 0xE0);       // Red
+            display::rgb332_to_rgb666(src, dst, count);
           } else if constexpr (DISPLAYPIXEL == PIXEL_MODE_16 && BUFFERPIXEL == PIXEL_MODE_8) {
-            if constexpr (IS_BIG_ENDIAN) {
-              *dptr++ = (color_val & 0xE0) | ((color_val & 0x1C) >> 2);
-              *dptr++ = (color_val & 3) << 3;
-            } else {
-              *dptr++ = (color_val & 3) << 3;
-              *dptr++ = (color_val & 0xE0) | ((color_val & 0x1C) >> 2);
-            }
+            display::rgb332_to_rgb565(src, dst, count, IS_BIG_ENDIAN);
           }
+          x += count;
+          used += count;
           // buffer full? Flush.
-          if (dptr == dbuffer + sizeof(dbuffer)) {
+          if (used == CHUNK_PIXELS) {
             this->write_display_data_(dbuffer, sizeof(dbuffer), 1, 0);
-            dptr = dbuffer;
+            used = 0;
           }
         }
       }
       // flush any remaining data
-      if (dptr != dbuffer) {
-        this->write_display_data_(dbuffer, dptr - dbuffer, 1, 0);
+      if (used != 0) {
+        this->write_display_data_(dbuffer, used * DISPLAYPIXEL, 1, 0);
       }
     }
     this->disable();
@@ -479,7 +471,8 @@ class MipiSpiBuffer : public MipiSpi<BUFFERTYPE, BUFFERPIXEL, IS_BIG_ENDIAN, DIS
 #if ESPHOME_LOG_LEVEL == ESPHOME_LOG_LEVEL_VERBOSE
     auto now = millis();
 #endif
-    if (this->is_failed()) {
+    // A lent buffer belongs to the renderer, which writes it to the display itself
+    if (this->is_failed() || this->buffer_lent_) {
       return;
     }
     // for updates with a small buffer, we repeatedly call the writer_ function, clipping the height to a fraction of
@@ -554,6 +547,79 @@ class MipiSpiBuffer : public MipiSpi<BUFFERTYPE, BUFFERPIXEL, IS_BIG_ENDIAN, DIS
     }
   }
 
+  // Copy pixels in the buffer format directly into the buffer. Data pre-rotated for this display is copied one row
+  // at a time, unrotated data is rotated on the way with the tiled rotation kernel.
+  bool draw_native_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr,
+                             display::ColorBitness bitness, bool big_endian,
+                             display::DisplayRotation rotation) override {
+    if constexpr (BUFFERPIXEL != PIXEL_MODE_16) {
+      return false;
+    } else {
+      if (bitness != display::COLOR_BITNESS_565 || big_endian != IS_BIG_ENDIAN)
+        return false;
+      const bool pre_rotated = rotation == ROTATION;
+      // Rotating reads whole pixels, so the data has to be aligned for them
+      if (!pre_rotated && (rotation != display::DISPLAY_ROTATION_0_DEGREES ||
+                           reinterpret_cast<uintptr_t>(ptr) % alignof(BUFFERTYPE) != 0))
+        return false;
+      if (w <= 0 || h <= 0)
+        return true;
+      // The source rectangle in buffer coordinates; its rows are the rows of the pre-rotated data
+      int src_x0, src_y0, src_x1, src_y1;
+      this->rotate_rect_(x_start, y_start, x_start + w - 1, y_start + h - 1, src_x0, src_y0, src_x1, src_y1);
+      const int src_stride = src_x1 - src_x0 + 1;
+      int x0 = std::max(src_x0, 0);
+      int y0 = std::max(src_y0, (int) this->start_line_);
+      int x1 = std::min(src_x1, WIDTH - 1);
+      int y1 = std::min(src_y1, (int) this->end_line_ - 1);
+      auto clipping = this->get_clipping();
+      if (clipping.is_set()) {
+        int clip_x0, clip_y0, clip_x1, clip_y1;
+        this->rotate_rect_(clipping.x, clipping.y, clipping.x2() - 1, clipping.y2() - 1, clip_x0, clip_y0, clip_x1,
+                           clip_y1);
+        x0 = std::max(x0, clip_x0);
+        y0 = std::max(y0, clip_y0);
+        x1 = std::min(x1, clip_x1);
+        y1 = std::min(y1, clip_y1);
+      }
+      if (x0 > x1 || y0 > y1)
+        return true;
+      BUFFERTYPE *dst = this->buffer_ + (y0 - this->start_line_) * WIDTH + x0;
+      if (pre_rotated) {
+        const size_t row_bytes = (x1 - x0 + 1) * sizeof(BUFFERTYPE);
+        for (int y = y0; y <= y1; y++, dst += WIDTH) {
+          memcpy(dst, ptr + ((y - src_y0) * src_stride + (x0 - src_x0)) * sizeof(BUFFERTYPE), row_bytes);
+        }
+      } else {
+        // Map the clipped rectangle back to the unrotated source
+        int cx0, cy0, cx1, cy1;
+        this->unrotate_rect_(x0, y0, x1, y1, cx0, cy0, cx1, cy1);
+        auto *src = reinterpret_cast<const BUFFERTYPE *>(ptr) + (cy0 - y_start) * w + (cx0 - x_start);
+        display::rotate_pixels(src, w, dst, WIDTH, cx1 - cx0 + 1, cy1 - cy0 + 1, ROTATION);
+      }
+      this->x_low_ = std::min<int>(this->x_low_, x0);
+      this->y_low_ = std::min<int>(this->y_low_, y0);
+      this->x_high_ = std::max<int>(this->x_high_, x1);
+      this->y_high_ = std::max<int>(this->y_high_, y1);
+      return true;
+    }
+  }
+
+  uint8_t *lend_buffer(display::ColorBitness bitness, bool big_endian, size_t min_pixels, size_t &pixels) override {
+    if constexpr (BUFFERPIXEL != PIXEL_MODE_16) {
+      return nullptr;
+    } else {
+      if (this->buffer_ == nullptr || bitness != display::COLOR_BITNESS_565 || big_endian != IS_BIG_ENDIAN ||
+          WIDTH * HEIGHT / FRACTION < min_pixels)
+        return nullptr;
+      this->buffer_lent_ = true;
+      pixels = WIDTH * HEIGHT / FRACTION;
+      return reinterpret_cast<uint8_t *>(this->buffer_);
+    }
+  }
+
+  void return_buffer() override { this->buffer_lent_ = false; }
+
   // Fills the display with a color.
   void fill(Color color) override {
     this->x_low_ = 0;
@@ -592,6 +658,41 @@ class MipiSpiBuffer : public MipiSpi<BUFFERTYPE, BUFFERPIXEL, IS_BIG_ENDIAN, DIS
     }
   }
 
+  // The inverse of rotate_coordinates_(), from buffer to display coordinates.
+  void unrotate_coordinates_(int &x, int &y) const {
+    if constexpr (ROTATION == display::DISPLAY_ROTATION_180_DEGREES) {
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+    } else if constexpr (ROTATION == display::DISPLAY_ROTATION_90_DEGREES) {
+      auto tmp = y;
+      y = WIDTH - x - 1;
+      x = tmp;
+    } else if constexpr (ROTATION == display::DISPLAY_ROTATION_270_DEGREES) {
+      auto tmp = x;
+      x = HEIGHT - y - 1;
+      y = tmp;
+    }
+  }
+
+  void unrotate_rect_(int x0, int y0, int x1, int y1, int &out_x0, int &out_y0, int &out_x1, int &out_y1) const {
+    unrotate_coordinates_(x0, y0);
+    unrotate_coordinates_(x1, y1);
+    out_x0 = std::min(x0, x1);
+    out_y0 = std::min(y0, y1);
+    out_x1 = std::max(x0, x1);
+    out_y1 = std::max(y0, y1);
+  }
+
+  // Rotate the inclusive rectangle (x0, y0)-(x1, y1) and return it with ordered corners.
+  void rotate_rect_(int x0, int y0, int x1, int y1, int &out_x0, int &out_y0, int &out_x1, int &out_y1) const {
+    rotate_coordinates_(x0, y0);
+    rotate_coordinates_(x1, y1);
+    out_x0 = std::min(x0, x1);
+    out_y0 = std::min(y0, y1);
+    out_x1 = std::max(x0, x1);
+    out_y1 = std::max(y0, y1);
+  }
+
   // Convert a color to the buffer pixel format.
   BUFFERTYPE convert_color_(Color &color) const {
     if constexpr (BUFFERPIXEL == PIXEL_MODE_8) {
@@ -607,6 +708,7 @@ class MipiSpiBuffer : public MipiSpi<BUFFERTYPE, BUFFERPIXEL, IS_BIG_ENDIAN, DIS
   }
 
   BUFFERTYPE *buffer_{};
+  bool buffer_lent_{};
   uint16_t x_low_{WIDTH};
   uint16_t y_low_{HEIGHT};
   uint16_t x_high_{0};
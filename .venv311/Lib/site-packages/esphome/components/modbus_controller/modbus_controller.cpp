@@ -45,6 +45,7 @@ bool ModbusController::send_next_command_() {
       command->send();
 
       this->last_command_timestamp_ = millis();
+      this->cycle_commands_++;
 
       this->command_sent_callback_.call((int) command->function_code, command->register_address);
 
@@ -76,6 +77,7 @@ void ModbusController::on_modbus_data(const std::vector<uint8_t> &data) {
     }
 
     // Move the commandItem to the response queue
+    this->cycle_bytes_ += data.size();
     current_command->payload = data;
     this->incoming_queue_.push(std::move(current_command));
     ESP_LOGV(TAG, "Modbus response queued");
@@ -232,27 +234,26 @@ void ModbusController::on_modbus_write_registers(uint8_t function_code, const st
   this->send_raw(response);
 }
 
-SensorSet ModbusController::find_sensors_(ModbusRegisterType register_type, uint16_t start_address) const {
+const SensorSet *ModbusController::find_sensors_(ModbusRegisterType register_type, uint16_t start_address) const {
   auto reg_it = std::find_if(
       std::begin(this->register_ranges_), std::end(this->register_ranges_),
       [=](RegisterRange const &r) { return (r.start_address == start_address && r.register_type == register_type); });
 
   if (reg_it == this->register_ranges_.end()) {
     ESP_LOGE(TAG, "No matching range for sensor found - start_address : 0x%X", start_address);
-  } else {
-    return reg_it->sensors;
+    return nullptr;
   }
-
-  // not found
-  return {};
+  return &reg_it->sensors;
 }
 void ModbusController::on_register_data(ModbusRegisterType register_type, uint16_t start_address,
                                         const std::vector<uint8_t> &data) {
   ESP_LOGV(TAG, "data for register address : 0x%X : ", start_address);
 
   // loop through all sensors with the same start address
-  auto sensors = find_sensors_(register_type, start_address);
-  for (auto *sensor : sensors) {
+  const SensorSet *sensors = this->find_sensors_(register_type, start_address);
+  if (sensors == nullptr)
+    return;
+  for (auto *sensor : *sensors) {
     sensor->parse_and_publish(data);
   }
 }
@@ -281,9 +282,9 @@ void ModbusController::update_range_(RegisterRange &r) {
   if (r.skip_updates_counter == 0) {
     // if a custom command is used the user supplied custom_data is only available in the SensorItem.
     if (r.register_type == ModbusRegisterType::CUSTOM) {
-      auto sensors = this->find_sensors_(r.register_type, r.start_address);
-      if (!sensors.empty()) {
-        auto sensor = sensors.cbegin();
+      const SensorSet *sensors = this->find_sensors_(r.register_type, r.start_address);
+      if (sensors != nullptr && !sensors->empty()) {
+        auto sensor = sensors->cbegin();
         auto command_item = ModbusCommandItem::create_custom_command(
             this, (*sensor)->custom_data,
             [this](ModbusRegisterType register_type, uint16_t start_address, const std::vector<uint8_t> &data) {
@@ -317,6 +318,13 @@ void ModbusController::update() {
     ESP_LOGVV(TAG, "Updating range 0x%X", r.start_address);
     update_range_(r);
   }
+
+  if (!this->cycle_active_ && !this->command_queue_.empty()) {
+    this->cycle_active_ = true;
+    this->cycle_start_ = millis();
+    this->cycle_commands_ = 0;
+    this->cycle_bytes_ = 0;
+  }
 }
 
 // walk through the sensors and determine the register ranges to read
@@ -370,8 +378,18 @@ size_t ModbusController::create_register_ranges_() {
 
           ESP_LOGV(TAG, "Re-use previous register - change to register: 0x%X %d offset=%u", curr->start_address,
                    curr->register_count, curr->offset);
-        } else if (curr->start_address == (r.start_address + r.register_count)) {
-          // this register can extend the current range
+        } else if (curr->start_address >= (r.start_address + r.register_count) &&
+                   curr->start_address - (r.start_address + r.register_count) <= this->max_register_gap_ &&
+                   curr->start_address + curr->register_count - r.start_address <= this->max_registers_per_request_) {
+          // this register can extend the current range, reading the unused registers in between if there is a gap
+          uint16_t gap = curr->start_address - (r.start_address + r.register_count);
+          // unused coils take one bit of the response, unused registers two bytes
+          if (curr->register_type == ModbusRegisterType::COIL ||
+              curr->register_type == ModbusRegisterType::DISCRETE_INPUT) {
+            buffer_offset += gap;
+          } else {
+            buffer_offset += gap * 2;
+          }
 
           // remove this sensore because start_address is changed (sort-order)
           ix = this->sensorset_.erase(ix);
@@ -379,7 +397,7 @@ size_t ModbusController::create_register_ranges_() {
           curr->start_address = r.start_address;
           curr->offset += buffer_offset;
           buffer_offset += curr->get_register_size();
-          r.register_count += curr->register_count;
+          r.register_count += gap + curr->register_count;
 
           this->sensorset_.insert(curr);
           // move iterator backwards because it will be incremented later
@@ -431,8 +449,12 @@ void ModbusController::dump_config() {
                 "ModbusController:\n"
                 "  Address: 0x%02X\n"
                 "  Max Command Retries: %d\n"
-                "  Offline Skip Updates: %d",
-                this->address_, this->max_cmd_retries_, this->offline_skip_updates_);
+                "  Offline Skip Updates: %d\n"
+                "  Max Register Gap: %u\n"
+                "  Max Registers Per Request: %u\n"
+                "  Register Ranges: %zu",
+                this->address_, this->max_cmd_retries_, this->offline_skip_updates_, this->max_register_gap_,
+                this->max_registers_per_request_, this->register_ranges_.size());
 #if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
   ESP_LOGCONFIG(TAG, "sensormap");
   for (auto &it : this->sensorset_) {
@@ -454,19 +476,36 @@ void ModbusController::dump_config() {
 }
 
 void ModbusController::loop() {
+  // Send the next command first, so the bus is busy while the previous response is processed
+  bool pending = this->send_next_command_();
+
   // Incoming data to process?
   if (!this->incoming_queue_.empty()) {
     auto &message = this->incoming_queue_.front();
     if (message != nullptr)
       this->process_modbus_data_(message.get());
     this->incoming_queue_.pop();
+  }
 
+  if (pending || !this->incoming_queue_.empty()) {
+    this->high_freq_.start();
   } else {
-    // all messages processed send pending commands
-    this->send_next_command_();
+    this->high_freq_.stop();
+    if (this->cycle_active_)
+      this->end_cycle_();
   }
 }
 
+void ModbusController::end_cycle_() {
+  this->cycle_active_ = false;
+  this->last_cycle_duration_ = millis() - this->cycle_start_;
+  this->max_cycle_duration_ = std::max(this->max_cycle_duration_, this->last_cycle_duration_);
+  this->last_cycle_commands_ = this->cycle_commands_;
+  this->last_cycle_bytes_ = this->cycle_bytes_;
+  ESP_LOGD(TAG, "Modbus device=%d poll cycle: %u commands, %" PRIu32 " bytes in %" PRIu32 " ms", this->address_,
+           this->last_cycle_commands_, this->last_cycle_bytes_, this->last_cycle_duration_);
+}
+
 void ModbusController::on_write_register_response(ModbusRegisterType register_type, uint16_t start_address,
                                                   const std::vector<uint8_t> &data) {
   ESP_LOGV(TAG, "Command ACK 0x%X %d ", get_data<uint16_t>(data, 0), get_data<int16_t>(data, 1));
@@ -4,6 +4,7 @@
 
 #include "esphome/components/modbus/modbus.h"
 #include "esphome/core/automation.h"
+#include "esphome/core/helpers.h"
 
 #include <list>
 #include <queue>
@@ -530,12 +531,26 @@ class ModbusController : public PollingComponent, public modbus::ModbusDevice {
   void set_max_cmd_retries(uint8_t max_cmd_retries) { this->max_cmd_retries_ = max_cmd_retries; }
   /// get how many times a command will be (re)sent if no response is received
   uint8_t get_max_cmd_retries() { return this->max_cmd_retries_; }
+  /// called by esphome generated code to set how many unused registers may be read to join two ranges
+  void set_max_register_gap(uint8_t max_register_gap) { this->max_register_gap_ = max_register_gap; }
+  /// called by esphome generated code to set the max number of registers read by one command
+  void set_max_registers_per_request(uint8_t max_registers_per_request) {
+    this->max_registers_per_request_ = max_registers_per_request;
+  }
+  /// time in ms from the start of the last completed poll cycle until all its responses were processed
+  uint32_t get_last_cycle_duration() { return this->last_cycle_duration_; }
+  /// longest poll cycle in ms since boot
+  uint32_t get_max_cycle_duration() { return this->max_cycle_duration_; }
+  /// number of commands sent during the last completed poll cycle, including retries
+  uint16_t get_last_cycle_commands() { return this->last_cycle_commands_; }
+  /// number of payload bytes received during the last completed poll cycle
+  uint32_t get_last_cycle_bytes() { return this->last_cycle_bytes_; }
 
  protected:
   /// parse sensormap_ and create range of sequential addresses
   size_t create_register_ranges_();
-  // find register in sensormap. Returns iterator with all registers having the same start address
-  SensorSet find_sensors_(ModbusRegisterType register_type, uint16_t start_address) const;
+  // find register in sensormap. Returns all registers having the same start address or nullptr
+  const SensorSet *find_sensors_(ModbusRegisterType register_type, uint16_t start_address) const;
   /// submit the read command for the address range to the send queue
   void update_range_(RegisterRange &r);
   /// parse incoming modbus data
@@ -544,6 +559,8 @@ class ModbusController : public PollingComponent, public modbus::ModbusDevice {
   bool send_next_command_();
   /// dump the parsed sensormap for diagnostics
   void dump_sensors_();
+  /// finish the poll cycle statistics once all commands are answered
+  void end_cycle_();
   /// Collection of all sensors for this component
   SensorSet sensorset_;
   /// Collection of all server registers for this component
@@ -566,6 +583,21 @@ class ModbusController : public PollingComponent, public modbus::ModbusDevice {
   uint16_t offline_skip_updates_{0};
   /// How many times we will retry a command if we get no response
   uint8_t max_cmd_retries_{4};
+  /// how many unused registers may be read to join two ranges
+  uint8_t max_register_gap_{0};
+  /// max number of registers read by one command
+  uint8_t max_registers_per_request_{125};
+  /// keep the loop running while commands are pending, so responses are picked up as soon as they arrive
+  HighFrequencyLoopRequester high_freq_;
+  /// poll cycle statistics
+  bool cycle_active_{false};
+  uint32_t cycle_start_{0};
+  uint16_t cycle_commands_{0};
+  uint32_t cycle_bytes_{0};
+  uint32_t last_cycle_duration_{0};
+  uint32_t max_cycle_duration_{0};
+  uint16_t last_cycle_commands_{0};
+  uint32_t last_cycle_bytes_{0};
   /// Command sent callback
   CallbackManager<void(int, int)> command_sent_callback_{};
   /// Server online callback
@@ -28,6 +28,7 @@ from esphome.const import (
     CONF_KEEPALIVE,
     CONF_LEVEL,
     CONF_LOG_TOPIC,
+    CONF_MAX_LENGTH,
     CONF_ON_CONNECT,
     CONF_ON_DISCONNECT,
     CONF_ON_JSON_MESSAGE,
@@ -71,6 +72,9 @@ def AUTO_LOAD():
 CONF_DISCOVER_IP = "discover_ip"
 CONF_IDF_SEND_ASYNC = "idf_send_async"
 CONF_WAIT_FOR_CONNECTION = "wait_for_connection"
+CONF_PUBLISH_QUEUE = "publish_queue"
+CONF_BATCH_WINDOW = "batch_window"
+CONF_MIN_INTERVAL = "min_interval"
 
 
 def validate_message_just_topic(value):
@@ -302,6 +306,19 @@ CONFIG_SCHEMA = cv.All(
             ),
             cv.Optional(CONF_PUBLISH_NAN_AS_NONE, default=False): cv.boolean,
             cv.Optional(CONF_WAIT_FOR_CONNECTION, default=False): cv.boolean,
+            cv.Optional(CONF_PUBLISH_QUEUE): cv.Schema(
+                {
+                    cv.Optional(CONF_MAX_LENGTH, default=16): cv.int_range(
+                        min=1, max=255
+                    ),
+                    cv.Optional(
+                        CONF_BATCH_WINDOW, default="0ms"
+                    ): cv.positive_time_period_milliseconds,
+                    cv.Optional(
+                        CONF_MIN_INTERVAL, default="0ms"
+                    ): cv.positive_time_period_milliseconds,
+                }
+            ),
         }
     ),
     validate_config,
@@ -418,6 +435,13 @@ async def to_code(config):
 
     cg.add(var.set_reboot_timeout(config[CONF_REBOOT_TIMEOUT]))
 
+    if CONF_PUBLISH_QUEUE in config:
+        publish_queue = config[CONF_PUBLISH_QUEUE]
+        cg.add_define("USE_MQTT_PUBLISH_QUEUE")
+        cg.add(var.set_publish_queue_length(publish_queue[CONF_MAX_LENGTH]))
+        cg.add(var.set_publish_batch_window(publish_queue[CONF_BATCH_WINDOW]))
+        cg.add(var.set_publish_min_interval(publish_queue[CONF_MIN_INTERVAL]))
+
     # esp-idf only
     if CONF_CERTIFICATE_AUTHORITY in config:
         cg.add(var.set_ca_certificate(config[CONF_CERTIFICATE_AUTHORITY]))
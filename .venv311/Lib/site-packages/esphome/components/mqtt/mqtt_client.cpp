@@ -2,6 +2,7 @@
 
 #ifdef USE_MQTT
 
+#include <algorithm>
 #include <utility>
 #include "esphome/components/network/util.h"
 #include "esphome/core/application.h"
@@ -26,6 +27,9 @@ namespace esphome {
 namespace mqtt {
 
 static const char *const TAG = "mqtt";
+#ifdef USE_MQTT_PUBLISH_QUEUE
+static const uint32_t PUBLISH_DROP_LOG_INTERVAL_MS = 10000;
+#endif
 
 MQTTClientComponent::MQTTClientComponent() {
   global_mqtt_client = this;
@@ -44,7 +48,8 @@ void MQTTClientComponent::setup() {
 
         // MQTT fully received
         if (len + index == total) {
-          this->on_message(topic, this->payload_buffer_);
+          this->topic_buffer_.assign(topic);
+          this->on_message(this->topic_buffer_, this->payload_buffer_);
           this->payload_buffer_.clear();
         }
       });
@@ -176,6 +181,14 @@ void MQTTClientComponent::dump_config() {
   if (!this->availability_.topic.empty()) {
     ESP_LOGCONFIG(TAG, "  Availability: '%s'", this->availability_.topic.c_str());
   }
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  ESP_LOGCONFIG(TAG,
+                "  Publish queue length: %zu\n"
+                "  Publish batch window: %" PRIu32 " ms\n"
+                "  Publish min interval: %" PRIu32 " ms",
+                this->publish_queue_.get_max_length(), this->publish_queue_.get_batch_window(),
+                this->publish_min_interval_);
+#endif
 }
 bool MQTTClientComponent::can_proceed() {
   return network::is_disabled() || this->state_ == MQTT_CLIENT_DISABLED || this->is_connected() ||
@@ -187,6 +200,10 @@ void MQTTClientComponent::start_dnslookup_() {
     subscription.subscribed = false;
     subscription.resubscribe_timeout = 0;
   }
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  // all states are sent again once connected
+  this->publish_queue_.clear();
+#endif
 
   this->status_set_warning();
   this->dns_resolve_error_ = false;
@@ -387,6 +404,9 @@ void MQTTClientComponent::loop() {
 
         this->last_connected_ = now;
         this->resubscribe_subscriptions_();
+#ifdef USE_MQTT_PUBLISH_QUEUE
+        this->flush_publish_queue_(now);
+#endif
       }
       break;
   }
@@ -433,34 +453,78 @@ void MQTTClientComponent::resubscribe_subscriptions_() {
   }
 }
 
+void MQTTClientComponent::add_subscription_(MQTTSubscription &&subscription) {
+  this->resubscribe_subscription_(&subscription);
+  this->subscriptions_.push_back(std::move(subscription));
+  this->index_subscription_(this->subscriptions_.size() - 1);
+}
+
+void MQTTClientComponent::index_subscription_(uint16_t index) {
+  std::string_view topic = this->subscriptions_[index].topic;
+  MQTTTopicNode *node = &this->topic_index_;
+  while (true) {
+    size_t separator = topic.find('/');
+    std::string_view level = topic.substr(0, separator);
+    if (level == "#") {
+      // multi-level wildcard - MQTT mandates that this must be the last level
+      node->multi_wildcard.push_back(index);
+      return;
+    }
+    if (level == "+") {
+      if (!node->single_wildcard)
+        node->single_wildcard = make_unique<MQTTTopicNode>();
+      node = node->single_wildcard.get();
+    } else {
+      auto it = std::lower_bound(node->children.begin(), node->children.end(), level,
+                                 [](const MQTTTopicNode &child, std::string_view level) { return child.level < level; });
+      if (it == node->children.end() || it->level != level) {
+        it = node->children.insert(it, MQTTTopicNode{});
+        it->level = std::string(level);
+      }
+      node = &*it;
+    }
+    if (separator == std::string_view::npos)
+      break;
+    topic.remove_prefix(separator + 1);
+  }
+  node->subscriptions.push_back(index);
+}
+
 void MQTTClientComponent::subscribe(const std::string &topic, mqtt_callback_t callback, uint8_t qos) {
-  MQTTSubscription subscription{
+  this->add_subscription_({
       .topic = topic,
       .qos = qos,
       .callback = std::move(callback),
       .subscribed = false,
       .resubscribe_timeout = 0,
-  };
-  this->resubscribe_subscription_(&subscription);
-  this->subscriptions_.push_back(subscription);
+  });
+}
+
+void MQTTClientComponent::subscribe_view(const std::string &topic, mqtt_view_callback_t callback, uint8_t qos) {
+  this->add_subscription_({
+      .topic = topic,
+      .qos = qos,
+      .callback = nullptr,
+      .subscribed = false,
+      .resubscribe_timeout = 0,
+      .view_callback = std::move(callback),
+  });
 }
 
 void MQTTClientComponent::subscribe_json(const std::string &topic, const mqtt_json_callback_t &callback, uint8_t qos) {
   auto f = [callback](const std::string &topic, const std::string &payload) {
-    json::parse_json(payload, [topic, callback](JsonObject root) -> bool {
+    json::parse_json(payload, [&topic, &callback](JsonObject root) -> bool {
       callback(topic, root);
       return true;
     });
   };
-  MQTTSubscription subscription{
+  this->add_subscription_({
       .topic = topic,
       .qos = qos,
       .callback = f,
       .subscribed = false,
       .resubscribe_timeout = 0,
-  };
-  this->resubscribe_subscription_(&subscription);
-  this->subscriptions_.push_back(subscription);
+  });
 }
 
 void MQTTClientComponent::unsubscribe(const std::string &topic) {
@@ -482,6 +546,11 @@ void MQTTClientComponent::unsubscribe(const std::string &topic) {
       ++it;
     }
   }
+
+  // indices of the remaining subscriptions have changed, so rebuild the topic index
+  this->topic_index_ = MQTTTopicNode{};
+  for (size_t i = 0; i < this->subscriptions_.size(); i++)
+    this->index_subscription_(i);
 }
 
 // Publish
@@ -520,6 +589,29 @@ bool MQTTClientComponent::publish(const MQTTMessage &message) {
   }
   return ret != 0;
 }
+#ifdef USE_MQTT_PUBLISH_QUEUE
+bool MQTTClientComponent::queue_publish(MQTTMessage &&message, uint32_t due, MQTTComponent *owner) {
+  if (!this->is_connected())
+    return false;
+  return this->publish_queue_.push(std::move(message), due, owner);
+}
+
+void MQTTClientComponent::flush_publish_queue_(uint32_t now) {
+  this->publish_queue_.flush(now, [this](const MQTTMessage &message) { return this->publish(message); });
+
+  // Summarize drops instead of logging each one, which would only add to the load if logging goes to MQTT too
+  if (now - this->last_dropped_log_time_ >= PUBLISH_DROP_LOG_INTERVAL_MS) {
+    uint32_t dropped = this->publish_queue_.get_dropped_count();
+    if (dropped != this->last_dropped_count_) {
+      ESP_LOGW(TAG, "Publish queue full, dropped %" PRIu32 " messages (%" PRIu32 "s)",
+               dropped - this->last_dropped_count_, PUBLISH_DROP_LOG_INTERVAL_MS / 1000);
+      this->last_dropped_count_ = dropped;
+    }
+    this->last_dropped_log_time_ = now;
+  }
+}
+#endif
+
 bool MQTTClientComponent::publish_json(const std::string &topic, const json::json_build_t &f, uint8_t qos,
                                        bool retain) {
   std::string message = json::build_json(f);
@@ -543,75 +635,63 @@ void MQTTClientComponent::disable() {
   this->on_shutdown();
 }
 
-/** Check if the message topic matches the given subscription topic
+/** Collect the subscriptions matching a message topic, starting at a node of the topic index.
  *
- * INFO: MQTT spec mandates that topics must not be empty and must be valid NULL-terminated UTF-8 strings.
+ * INFO: MQTT spec mandates that topics must not be empty and that message topics must not contain wildcard
+ * characters.
  *
- * @param message The message topic that was received from the MQTT server. Note: this must not contain
- *                wildcard characters as mandated by the MQTT spec.
- * @param subscription The subscription topic we are matching against.
- * @param is_normal Is this a "normal" topic - Does the message topic not begin with a "$".
- * @param past_separator Are we past the first '/' topic separator.
- * @return true if the subscription topic matches the message topic, false otherwise.
+ * @param node The node for the levels of the topic that are already matched.
+ * @param topic The remaining levels of the message topic.
+ * @param wildcards Whether wildcards match this level. Topics that begin with a "$" are not matched by wildcards on
+ *                  the first level.
+ * @param matches Indices of the matching subscriptions are appended here.
  */
-static bool topic_match(const char *message, const char *subscription, bool is_normal, bool past_separator) {
-  // Reached end of both strings at the same time, this means we have a successful match
-  if (*message == '\0' && *subscription == '\0')
-    return true;
-
-  // Either the message or the subscribe are at the end. This means they don't match.
-  if (*message == '\0' || *subscription == '\0')
-    return false;
-
-  bool do_wildcards = is_normal || past_separator;
-
-  if (*subscription == '+' && do_wildcards) {
-    // single level wildcard
-    // consume + from subscription
-    subscription++;
-    // consume everything from message until '/' found or end of string
-    while (*message != '\0' && *message != '/') {
-      message++;
+static void topic_match(const MQTTTopicNode &node, std::string_view topic, bool wildcards,
+                        std::vector<uint16_t> &matches) {
+  size_t separator = topic.find('/');
+  std::string_view level = topic.substr(0, separator);
+
+  auto match_child = [&](const MQTTTopicNode &child) {
+    if (separator == std::string_view::npos) {
+      matches.insert(matches.end(), child.subscriptions.begin(), child.subscriptions.end());
+    } else {
+      topic_match(child, topic.substr(separator + 1), true, matches);
     }
-    // after this, both pointers will point to a '/' or to the end of the string
-
-    return topic_match(message, subscription, is_normal, true);
-  }
+  };
 
-  if (*subscription == '#' && do_wildcards) {
-    // multilevel wildcard - MQTT mandates that this must be at end of subscribe topic
-    return true;
+  if (wildcards) {
+    matches.insert(matches.end(), node.multi_wildcard.begin(), node.multi_wildcard.end());
+    if (node.single_wildcard)
+      match_child(*node.single_wildcard);
+  }
+  auto it = std::lower_bound(node.children.begin(), node.children.end(), level,
+                             [](const MQTTTopicNode &child, std::string_view level) { return child.level < level; });
+  if (it != node.children.end() && it->level == level)
+    match_child(*it);
+}
+
+void MQTTClientComponent::dispatch_message_(const std::string &topic, const std::string &payload) {
+  this->matches_.clear();
+  topic_match(this->topic_index_, topic, !topic.empty() && topic[0] != '$', this->matches_);
+  // call back in the order of subscription, like a plain walk over all subscriptions would
+  std::sort(this->matches_.begin(), this->matches_.end());
+  for (uint16_t index : this->matches_) {
+    auto &subscription = this->subscriptions_[index];
+    if (subscription.view_callback) {
+      subscription.view_callback(topic, payload);
+    } else {
+      subscription.callback(topic, payload);
+    }
   }
-
-  // this handles '/' and normal characters at the same time.
-  if (*message != *subscription)
-    return false;
-
-  past_separator = past_separator || *subscription == '/';
-
-  // consume characters
-  subscription++;
-  message++;
-
-  return topic_match(message, subscription, is_normal, past_separator);
-}
-
-static bool topic_match(const char *message, const char *subscription) {
-  return topic_match(message, subscription, *message != '\0' && *message != '$', false);
 }
 
 void MQTTClientComponent::on_message(const std::string &topic, const std::string &payload) {
 #ifdef USE_ESP8266
   // on ESP8266, this is called in lwIP/AsyncTCP task; some components do not like running
   // from a different task.
-  this->defer([this, topic, payload]() {
-#endif
-    for (auto &subscription : this->subscriptions_) {
-      if (topic_match(topic.c_str(), subscription.topic.c_str()))
-        subscription.callback(topic, payload);
-    }
-#ifdef USE_ESP8266
-  });
+  this->defer([this, topic, payload]() { this->dispatch_message_(topic, payload); });
+#else
+  this->dispatch_message_(topic, payload);
 #endif
 }
 
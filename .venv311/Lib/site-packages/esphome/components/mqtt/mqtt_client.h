@@ -17,8 +17,13 @@
 #elif defined(USE_LIBRETINY)
 #include "mqtt_backend_libretiny.h"
 #endif
+#ifdef USE_MQTT_PUBLISH_QUEUE
+#include "mqtt_publish_queue.h"
+#endif
 #include "lwip/ip_addr.h"
 
+#include <memory>
+#include <string_view>
 #include <vector>
 
 namespace esphome {
@@ -35,6 +40,11 @@ using mqtt_on_disconnect_callback_t = std::function<MQTTBackend::on_disconnect_c
  */
 using mqtt_callback_t = std::function<void(const std::string &, const std::string &)>;
 using mqtt_json_callback_t = std::function<void(const std::string &, JsonObject)>;
+/** Callback for MQTT subscriptions that gets the topic and payload as views into the receive buffers.
+ *
+ * The views are only valid during the call.
+ */
+using mqtt_view_callback_t = std::function<void(std::string_view, std::string_view)>;
 
 /// internal struct for MQTT subscriptions.
 struct MQTTSubscription {
@@ -43,6 +53,24 @@ struct MQTTSubscription {
   mqtt_callback_t callback;
   bool subscribed;
   uint32_t resubscribe_timeout;
+  mqtt_view_callback_t view_callback{};
+};
+
+/** internal index of the subscription topics, one node per topic level.
+ *
+ * A message topic is matched by walking down its levels, so the cost depends on the depth of the topic and not
+ * on the number of subscriptions.
+ */
+struct MQTTTopicNode {
+  std::string level;
+  /// Children for literal levels, sorted by level.
+  std::vector<MQTTTopicNode> children;
+  /// Child for a '+' level.
+  std::unique_ptr<MQTTTopicNode> single_wildcard;
+  /// Indices of the subscriptions whose topic ends at this level.
+  std::vector<uint16_t> subscriptions;
+  /// Indices of the subscriptions whose topic continues with '#' after this level.
+  std::vector<uint16_t> multi_wildcard;
 };
 
 /// internal struct for MQTT credentials.
@@ -179,17 +207,28 @@ class MQTTClientComponent : public Component {
 
   /** Subscribe to an MQTT topic and call callback when a message is received.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain '+' and '#' wildcards.
    * @param callback The callback function.
    * @param qos The QoS of this subscription.
    */
   void subscribe(const std::string &topic, mqtt_callback_t callback, uint8_t qos = 0);
 
+  /** Subscribe to an MQTT topic and call callback with views of the topic and payload when a message is received.
+   *
+   * Unlike subscribe(), the callback doesn't need std::string arguments; the views point into the receive buffers
+   * and are only valid during the call.
+   *
+   * @param topic The topic, may contain '+' and '#' wildcards.
+   * @param callback The callback function.
+   * @param qos The QoS of this subscription.
+   */
+  void subscribe_view(const std::string &topic, mqtt_view_callback_t callback, uint8_t qos = 0);
+
   /** Subscribe to a MQTT topic and automatically parse JSON payload.
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain '+' and '#' wildcards.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The QoS of this subscription.
@@ -230,6 +269,26 @@ class MQTTClientComponent : public Component {
    */
   bool publish_json(const std::string &topic, const json::json_build_t &f, uint8_t qos = 0, bool retain = false);
 
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  /** Queue a state message, to be sent from loop().
+   *
+   * A message to the same topic that is still queued is replaced.
+   *
+   * @param message The message.
+   * @param due The time in ms (from millis()) the message can be sent at.
+   * @param owner The component whose state this is, it is asked to resend the state if the message is replaced.
+   * @return false if not connected or the queue is full.
+   */
+  bool queue_publish(MQTTMessage &&message, uint32_t due, MQTTComponent *owner);
+
+  void set_publish_queue_length(size_t length) { this->publish_queue_.set_max_length(length); }
+  void set_publish_batch_window(uint32_t batch_window) { this->publish_queue_.set_batch_window(batch_window); }
+  /// Set the minimum time between the state messages of an entity.
+  void set_publish_min_interval(uint32_t min_interval) { this->publish_min_interval_ = min_interval; }
+  uint32_t get_publish_min_interval() const { return this->publish_min_interval_; }
+  const MQTTPublishQueue &get_publish_queue() const { return this->publish_queue_; }
+#endif
+
   /// Setup the MQTT client, registering a bunch of callbacks and attempting to connect.
   void setup() override;
   void dump_config() override;
@@ -289,6 +348,14 @@ class MQTTClientComponent : public Component {
   bool subscribe_(const char *topic, uint8_t qos);
   void resubscribe_subscription_(MQTTSubscription *sub);
   void resubscribe_subscriptions_();
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  void flush_publish_queue_(uint32_t now);
+#endif
+  void add_subscription_(MQTTSubscription &&subscription);
+  /// Add the subscription with the given index to the topic index.
+  void index_subscription_(uint16_t index);
+  /// Call the callbacks of all subscriptions matching the topic, in the order they were subscribed.
+  void dispatch_message_(const std::string &topic, const std::string &payload);
 
   MQTTCredentials credentials_;
   /// The last will message. Disabled optional denotes it being default and
@@ -313,10 +380,14 @@ class MQTTClientComponent : public Component {
   };
   std::string topic_prefix_{};
   MQTTMessage log_message_;
+  std::string topic_buffer_;
   std::string payload_buffer_;
   int log_level_{ESPHOME_LOG_LEVEL};
 
   std::vector<MQTTSubscription> subscriptions_;
+  MQTTTopicNode topic_index_;
+  /// Subscriptions matching the message being dispatched, kept to reuse the allocation.
+  std::vector<uint16_t> matches_;
 #if defined(USE_ESP32)
   MQTTBackendESP32 mqtt_backend_;
 #elif defined(USE_ESP8266)
@@ -338,6 +409,12 @@ class MQTTClientComponent : public Component {
   CallbackManager<MQTTBackend::on_disconnect_callback_t> on_disconnect_;
 
   bool publish_nan_as_none_{false};
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  MQTTPublishQueue publish_queue_;
+  uint32_t publish_min_interval_{0};
+  uint32_t last_dropped_count_{0};
+  uint32_t last_dropped_log_time_{0};
+#endif
   bool wait_for_connection_{false};
 };
 
@@ -51,14 +51,45 @@ std::string MQTTComponent::get_command_topic_() const {
 bool MQTTComponent::publish(const std::string &topic, const std::string &payload) {
   if (topic.empty())
     return false;
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  return this->queue_publish_(topic, std::string(payload));
+#else
   return global_mqtt_client->publish(topic, payload, this->qos_, this->retain_);
+#endif
 }
 
 bool MQTTComponent::publish_json(const std::string &topic, const json::json_build_t &f) {
   if (topic.empty())
     return false;
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  return this->queue_publish_(topic, json::build_json(f));
+#else
   return global_mqtt_client->publish_json(topic, f, this->qos_, this->retain_);
+#endif
+}
+
+#ifdef USE_MQTT_PUBLISH_QUEUE
+bool MQTTComponent::queue_publish_(const std::string &topic, std::string &&payload) {
+  const uint32_t now = millis();
+  const uint32_t min_interval = global_mqtt_client->get_publish_min_interval();
+  uint32_t due = now;
+  if (this->has_publish_due_ && min_interval != 0) {
+    int32_t since = static_cast<int32_t>(now - this->publish_due_);
+    if (since <= 0) {
+      // join the states that are waiting to be sent, or were sent in this same millisecond
+      due = this->publish_due_;
+    } else if (static_cast<uint32_t>(since) < min_interval) {
+      due = this->publish_due_ + min_interval;
+    }
+  }
+  if (!global_mqtt_client->queue_publish(
+          {.topic = topic, .payload = std::move(payload), .qos = this->qos_, .retain = this->retain_}, due, this))
+    return false;
+  this->has_publish_due_ = true;
+  this->publish_due_ = due;
+  return true;
 }
+#endif
 
 bool MQTTComponent::send_discovery_() {
   const MQTTDiscoveryInfo &discovery_info = global_mqtt_client->get_discovery_info();
@@ -116,6 +116,8 @@ class MQTTComponent : public Component {
   void schedule_resend_state();
 
   /** Send a MQTT message.
+   *
+   * With the publish queue enabled, the message is queued and replaces a queued message to the same topic.
    *
    * @param topic The topic.
    * @param payload The payload.
@@ -131,7 +133,7 @@ class MQTTComponent : public Component {
 
   /** Subscribe to a MQTT topic.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain '+' and '#' wildcards.
    * @param callback The callback that will be called when a message with matching topic is received.
    * @param qos The MQTT quality of service. Defaults to 0.
    */
@@ -141,7 +143,7 @@ class MQTTComponent : public Component {
    *
    * If an invalid JSON payload is received, the callback will not be called.
    *
-   * @param topic The topic. Wildcards are currently not supported.
+   * @param topic The topic, may contain '+' and '#' wildcards.
    * @param callback The callback with a parsed JsonObject that will be called when a message with matching topic is
    * received.
    * @param qos The MQTT quality of service. Defaults to 0.
@@ -184,6 +186,11 @@ class MQTTComponent : public Component {
   /// Internal method to start sending discovery info, this will call send_discovery().
   bool send_discovery_();
 
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  /// Queue a state message, due when the minimum interval since the last state of this entity has passed.
+  bool queue_publish_(const std::string &topic, std::string &&payload);
+#endif
+
   // ========== INTERNAL METHODS ==========
   // (In most use cases you won't need these)
   /// Generate the Home Assistant MQTT discovery object id by automatically transforming the friendly name.
@@ -203,6 +210,11 @@ class MQTTComponent : public Component {
   uint8_t subscribe_qos_{0};
   bool discovery_enabled_{true};
   bool resend_state_{false};
+#ifdef USE_MQTT_PUBLISH_QUEUE
+  bool has_publish_due_{false};
+  /// When the last queued state of this entity was due.
+  uint32_t publish_due_{0};
+#endif
 };
 
 }  // namespace mqtt
@@ -0,0 +1,86 @@
+#include "mqtt_publish_queue.h"
+
+#ifdef USE_MQTT_PUBLISH_QUEUE
+
+#include "mqtt_component.h"
+
+#include <utility>
+
+namespace esphome {
+namespace mqtt {
+
+/// Compare timestamps that may have rolled over.
+static bool is_due(uint32_t due, uint32_t now) { return static_cast<int32_t>(now - due) >= 0; }
+
+void MQTTPublishQueue::set_max_length(size_t max_length) {
+  this->max_length_ = max_length;
+  this->entries_.reserve(max_length);
+}
+
+bool MQTTPublishQueue::push(MQTTMessage &&message, uint32_t due, MQTTComponent *owner) {
+  for (auto &entry : this->entries_) {
+    if (entry.message.topic == message.topic) {
+      entry.message.payload = std::move(message.payload);
+      entry.message.qos = message.qos;
+      entry.message.retain = message.retain;
+      entry.owner = owner;
+      this->coalesced_count_++;
+      return true;
+    }
+  }
+
+  if (this->entries_.size() >= this->max_length_) {
+    auto victim = this->entries_.end();
+    if (message.qos > 0) {
+      // The publisher of an accepted message isn't told when it's lost, so only replace one whose owner can resend
+      for (auto it = this->entries_.begin(); it != this->entries_.end(); ++it) {
+        if (it->message.qos == 0 && it->owner != nullptr) {
+          victim = it;
+          break;
+        }
+      }
+    }
+    this->dropped_count_++;
+    if (victim == this->entries_.end())
+      return false;
+    victim->owner->schedule_resend_state();
+    this->entries_.erase(victim);
+  }
+
+  this->entries_.push_back({std::move(message), due + this->batch_window_, owner});
+  return true;
+}
+
+void MQTTPublishQueue::flush(uint32_t now, const std::function<bool(const MQTTMessage &)> &send) {
+  bool any_due = false;
+  for (auto &entry : this->entries_) {
+    if (is_due(entry.due, now)) {
+      any_due = true;
+      break;
+    }
+  }
+  if (!any_due)
+    return;
+
+  // Send the batch in queue order, moving the messages that stay queued to the front
+  uint32_t batch_end = now + this->batch_window_;
+  bool blocked = false;
+  size_t kept = 0;
+  for (size_t i = 0; i < this->entries_.size(); i++) {
+    auto &entry = this->entries_[i];
+    if (!blocked && is_due(entry.due, batch_end)) {
+      if (send(entry.message))
+        continue;
+      blocked = true;
+    }
+    if (kept != i)
+      this->entries_[kept] = std::move(entry);
+    kept++;
+  }
+  this->entries_.erase(this->entries_.begin() + kept, this->entries_.end());
+}
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT_PUBLISH_QUEUE
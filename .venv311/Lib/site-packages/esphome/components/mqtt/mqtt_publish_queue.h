@@ -0,0 +1,79 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_MQTT_PUBLISH_QUEUE
+
+#include "mqtt_backend.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace esphome {
+namespace mqtt {
+
+class MQTTComponent;
+
+/** Queue for state messages, with the latest message winning per topic.
+ *
+ * A message to a topic that is already queued replaces the queued payload, so an entity that updates faster than the
+ * broker takes its messages only ever has its newest state waiting. Each message is due at a given time (used for
+ * rate limiting), plus the batch window: once a message is due, all messages that become due within the window are
+ * sent along with it.
+ *
+ * The queue never grows beyond its maximum length. When it is full, a new message with QoS 0 is dropped; a new message
+ * with a higher QoS replaces the oldest queued QoS 0 message of a component, which is told to send its state again.
+ */
+class MQTTPublishQueue {
+ public:
+  void set_max_length(size_t max_length);
+  size_t get_max_length() const { return this->max_length_; }
+  void set_batch_window(uint32_t batch_window) { this->batch_window_ = batch_window; }
+  uint32_t get_batch_window() const { return this->batch_window_; }
+
+  /** Queue a message.
+   *
+   * @param message The message, its payload is moved from.
+   * @param due The time in ms (from millis()) the message can be sent at.
+   * @param owner The component that published the message. Only messages with an owner are replaced when the queue
+   * is full, the owner then resends its state once there is room again.
+   * @return false if the message was dropped because the queue is full.
+   */
+  bool push(MQTTMessage &&message, uint32_t due, MQTTComponent *owner);
+
+  /** Send the messages that are due.
+   *
+   * Sending stops at the first message send returns false for; it and all later messages stay queued in order,
+   * until the next flush.
+   */
+  void flush(uint32_t now, const std::function<bool(const MQTTMessage &)> &send);
+
+  /// Remove all queued messages, e.g. when the connection was lost and all states will be sent again.
+  void clear() { this->entries_.clear(); }
+
+  /// The number of messages currently queued.
+  size_t size() const { return this->entries_.size(); }
+  /// The number of messages that replaced a queued message to the same topic.
+  uint32_t get_coalesced_count() const { return this->coalesced_count_; }
+  /// The number of messages that were dropped because the queue was full.
+  uint32_t get_dropped_count() const { return this->dropped_count_; }
+
+ protected:
+  struct Entry {
+    MQTTMessage message;
+    uint32_t due;
+    MQTTComponent *owner;
+  };
+
+  std::vector<Entry> entries_;
+  size_t max_length_{16};
+  uint32_t batch_window_{0};
+  uint32_t coalesced_count_{0};
+  uint32_t dropped_count_{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
+
+#endif  // USE_MQTT_PUBLISH_QUEUE
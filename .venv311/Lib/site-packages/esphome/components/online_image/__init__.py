@@ -25,23 +25,38 @@ from esphome.const import (
     CONF_TRIGGER_ID,
     CONF_TYPE,
     CONF_URL,
+    PLATFORM_ESP32,
+    PLATFORM_HOST,
 )
-from esphome.core import Lambda
+from esphome.core import CORE, Lambda
+from esphome.helpers import fnv1a_32bit_hash
 
 AUTO_LOAD = ["image"]
 DEPENDENCIES = ["display", "http_request"]
 CODEOWNERS = ["@guillempages", "@clydebarrow"]
 MULTI_CONF = True
 
+CONF_CACHE = "cache"
+CONF_CACHE_PARTITION = "cache_partition"
 CONF_ON_DOWNLOAD_FINISHED = "on_download_finished"
+CONF_ON_ROWS_READY = "on_rows_ready"
 CONF_PLACEHOLDER = "placeholder"
+CONF_PROGRESSIVE = "progressive"
 CONF_UPDATE = "update"
+CONF_VARIANTS = "variants"
 
 _LOGGER = logging.getLogger(__name__)
 
 online_image_ns = cg.esphome_ns.namespace("online_image")
 
 ImageFormat = online_image_ns.enum("ImageFormat")
+DitherMode = online_image_ns.enum("DitherMode")
+
+DITHER_MODES = {
+    "NONE": DitherMode.DITHER_NONE,
+    "ORDERED": DitherMode.DITHER_ORDERED,
+    "FLOYDSTEINBERG": DitherMode.DITHER_FLOYD_STEINBERG,
+}
 
 
 class Format:
@@ -82,9 +97,21 @@ class PNGFormat(Format):
         cg.add_library("pngle", "1.1.0")
 
 
+class AutoFormat(Format):
+    """Detect the format of each download; compiles in every decoder."""
+
+    def __init__(self):
+        super().__init__("AUTO")
+
+    def actions(self):
+        for image_format in (BMPFormat(), JPEGFormat(), PNGFormat()):
+            image_format.actions()
+
+
 IMAGE_FORMATS = {
     x.image_type: x
     for x in (
+        AutoFormat(),
         BMPFormat(),
         JPEGFormat(),
         PNGFormat(),
@@ -93,6 +120,7 @@ IMAGE_FORMATS = {
 IMAGE_FORMATS.update({"JPG": IMAGE_FORMATS["JPEG"]})
 
 OnlineImage = online_image_ns.class_("OnlineImage", cg.PollingComponent, Image_)
+OnlineImageVariant = online_image_ns.class_("OnlineImageVariant", Image_)
 
 # Actions
 SetUrlAction = online_image_ns.class_(
@@ -109,6 +137,9 @@ DownloadFinishedTrigger = online_image_ns.class_(
 DownloadErrorTrigger = online_image_ns.class_(
     "DownloadErrorTrigger", automation.Trigger.template()
 )
+RowsReadyTrigger = online_image_ns.class_(
+    "RowsReadyTrigger", automation.Trigger.template(cg.int_, cg.int_)
+)
 
 
 def remove_options(*options):
@@ -121,7 +152,7 @@ def remove_options(*options):
 
 
 ONLINE_IMAGE_SCHEMA = (
-    IMAGE_SCHEMA.extend(remove_options(CONF_FILE, CONF_INVERT_ALPHA, CONF_DITHER))
+    IMAGE_SCHEMA.extend(remove_options(CONF_FILE, CONF_INVERT_ALPHA))
     .extend(
         {
             cv.Required(CONF_ID): cv.declare_id(OnlineImage),
@@ -134,6 +165,15 @@ ONLINE_IMAGE_SCHEMA = (
             cv.Required(CONF_FORMAT): cv.one_of(*IMAGE_FORMATS, upper=True),
             cv.Optional(CONF_PLACEHOLDER): cv.use_id(Image_),
             cv.Optional(CONF_BUFFER_SIZE, default=65536): cv.int_range(256, 65536),
+            # The decoded buffer is stored in a data partition on ESP32 and in a file on
+            # host, only the small header with the validators goes to the preferences
+            cv.Optional(CONF_CACHE): cv.All(
+                cv.boolean, cv.only_on([PLATFORM_ESP32, PLATFORM_HOST])
+            ),
+            # Label of a data partition in the partition table, one per image
+            cv.Optional(CONF_CACHE_PARTITION): cv.All(
+                cv.string_strict, cv.Length(max=16), cv.only_on_esp32
+            ),
             cv.Optional(CONF_ON_DOWNLOAD_FINISHED): automation.validate_automation(
                 {
                     cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
@@ -141,6 +181,23 @@ ONLINE_IMAGE_SCHEMA = (
                     ),
                 }
             ),
+            cv.Optional(CONF_PROGRESSIVE, default=False): cv.boolean,
+            # Applied while decoding, to RGB565 and binary images
+            cv.Optional(CONF_DITHER, default="NONE"): cv.enum(DITHER_MODES, upper=True),
+            # Smaller copies derived from the same download and decode
+            cv.Optional(CONF_VARIANTS): cv.ensure_list(
+                cv.Schema(
+                    {
+                        cv.Required(CONF_ID): cv.declare_id(OnlineImageVariant),
+                        cv.Required(CONF_RESIZE): cv.dimensions,
+                    }
+                )
+            ),
+            cv.Optional(CONF_ON_ROWS_READY): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(RowsReadyTrigger),
+                }
+            ),
             cv.Optional(CONF_ON_ERROR): automation.validate_automation(
                 {
                     cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(DownloadErrorTrigger),
@@ -151,9 +208,24 @@ ONLINE_IMAGE_SCHEMA = (
     .extend(cv.polling_component_schema("never"))
 )
 
+def validate_cache(config):
+    if config.get(CONF_CACHE) and CORE.is_esp32 and CONF_CACHE_PARTITION not in config:
+        raise cv.Invalid(
+            f"{CONF_CACHE_PARTITION} is required to cache the image on ESP32",
+            [CONF_CACHE_PARTITION],
+        )
+    if CONF_CACHE_PARTITION in config and not config.get(CONF_CACHE):
+        raise cv.Invalid(
+            f"{CONF_CACHE_PARTITION} requires {CONF_CACHE}: true",
+            [CONF_CACHE_PARTITION],
+        )
+    return config
+
+
 CONFIG_SCHEMA = cv.Schema(
     cv.All(
         ONLINE_IMAGE_SCHEMA,
+        validate_cache,
         cv.require_framework_version(
             # esp8266 not supported yet; if enabled in the future, minimum version of 2.7.0 is needed
             # esp8266_arduino=cv.Version(2, 7, 0),
@@ -227,6 +299,41 @@ async def to_code(config):
         else:
             cg.add(var.add_request_header(key, value))
 
+    if config.get(CONF_CACHE):
+        cg.add_define("USE_ONLINE_IMAGE_CACHE")
+        # Any setting that changes the buffer layout must invalidate the cached image
+        layout = ":".join(
+            str(x)
+            for x in (
+                config[CONF_ID],
+                config[CONF_TYPE],
+                config[CONF_TRANSPARENCY],
+                config.get(CONF_BYTE_ORDER),
+                width,
+                height,
+            )
+        )
+        cg.add(var.set_cache_key(fnv1a_32bit_hash(layout)))
+        if partition := config.get(CONF_CACHE_PARTITION):
+            cg.add(var.set_cache_partition(partition))
+
+    # Build the chain from large to small, each level derived from the smallest one that still covers it
+    sources = []
+    for variant in sorted(
+        config.get(CONF_VARIANTS, []),
+        key=lambda v: v[CONF_RESIZE][0] * v[CONF_RESIZE][1],
+        reverse=True,
+    ):
+        v_width, v_height = variant[CONF_RESIZE]
+        source = var
+        for s_width, s_height, s_var in reversed(sources):
+            if s_width >= v_width and s_height >= v_height:
+                source = s_var
+                break
+        v_var = cg.new_Pvariable(variant[CONF_ID], var, source, v_width, v_height)
+        cg.add(var.add_variant(v_var))
+        sources.append((v_width, v_height, v_var))
+
     if placeholder_id := config.get(CONF_PLACEHOLDER):
         placeholder = await cg.get_variable(placeholder_id)
         cg.add(var.set_placeholder(placeholder))
@@ -235,6 +342,19 @@ async def to_code(config):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
         await automation.build_automation(trigger, [(bool, "cached")], conf)
 
+    if config[CONF_DITHER] != "NONE":
+        cg.add(var.set_dither(DITHER_MODES[config[CONF_DITHER]]))
+
+    # Row notifications only happen while rendering progressively
+    if config[CONF_PROGRESSIVE] or CONF_ON_ROWS_READY in config:
+        cg.add(var.set_progressive(True))
+
+    for conf in config.get(CONF_ON_ROWS_READY, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        await automation.build_automation(
+            trigger, [(int, "first_row"), (int, "last_row")], conf
+        )
+
     for conf in config.get(CONF_ON_ERROR, []):
         trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
         await automation.build_automation(trigger, [], conf)
@@ -13,6 +13,9 @@ static const char *const TAG = "online_image.bmp";
 
 int HOT BmpDecoder::decode(uint8_t *buffer, size_t size) {
   size_t index = 0;
+  // The headers are parsed from the start of the buffer in one call, wait until all of them have arrived
+  if (this->current_index_ == 0 && size <= 14)
+    return 0;
   if (this->current_index_ == 0 && index == 0 && size > 14) {
     /**
      * BMP file format:
@@ -35,6 +38,10 @@ int HOT BmpDecoder::decode(uint8_t *buffer, size_t size) {
 
     this->current_index_ = 14;
     index = 14;
+    if (size <= this->data_offset_) {
+      this->current_index_ = 0;
+      return 0;
+    }
   }
   if (this->current_index_ == 14 && index == 14 && size > this->data_offset_) {
     /**
@@ -0,0 +1,115 @@
+#include "dither.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace online_image {
+
+// Bayer matrix, values 0..63
+static const uint8_t BAYER_8X8[8][8] = {
+    {0, 32, 8, 40, 2, 34, 10, 42},  {48, 16, 56, 24, 50, 18, 58, 26}, {12, 44, 4, 36, 14, 46, 6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22}, {3, 35, 11, 43, 1, 33, 9, 41},  {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47, 7, 39, 13, 45, 5, 37},  {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+// Number of bits per channel in RGB565
+static const uint8_t RGB565_BITS[3] = {5, 6, 5};
+
+static inline int clamp_channel(int value) { return std::max(0, std::min(255, value)); }
+
+// 0.25 * R + 0.5 * G + 0.25 * B like is_color_on(), but rounded so white reaches 255 and stays above every threshold
+static inline int luma(const Color &color) { return (color.r + 2 * color.g + color.b + 2) >> 2; }
+
+// Nearest level with the given number of bits, expanded back to 8 bits the way the image reader does
+static inline int quantize(int value, uint8_t bits) {
+  int max_level = (1 << bits) - 1;
+  int level = (value * max_level + 127) / 255;
+  return (level << (8 - bits)) | (level >> (2 * bits - 8));
+}
+
+void Ditherer::reset(int width) {
+  this->row_ = -1;
+  this->last_x_ = -1;
+  if (this->mode_ != DITHER_FLOYD_STEINBERG)
+    return;
+  this->width_ = width;
+  this->errors_.assign(static_cast<size_t>(width) * 3, 0);
+}
+
+void Ditherer::release() {
+  this->errors_.clear();
+  this->errors_.shrink_to_fit();
+  this->width_ = 0;
+}
+
+void Ditherer::apply(DitherMode mode, int x, int y, Color &color, bool binary) {
+  if (mode == DITHER_FLOYD_STEINBERG && x < this->width_) {
+    this->apply_error_diffusion_(x, y, color, binary);
+  } else if (mode != DITHER_NONE) {
+    this->apply_ordered_(x, y, color, binary);
+  }
+}
+
+void Ditherer::apply_ordered_(int x, int y, Color &color, bool binary) {
+  uint8_t threshold = BAYER_8X8[y & 7][x & 7];
+  if (binary) {
+    uint8_t value = luma(color) > threshold * 4 + 2 ? 0xFF : 0;
+    color.r = color.g = color.b = value;
+    return;
+  }
+  uint8_t *channels[3] = {&color.r, &color.g, &color.b};
+  for (uint8_t c = 0; c < 3; c++) {
+    uint8_t shift = 8 - RGB565_BITS[c];
+    // Offset by up to one quantization step, then let the output format truncate
+    int value = std::min(255, *channels[c] + ((threshold << shift) >> 6));
+    *channels[c] = (value >> shift) << shift;
+  }
+}
+
+void Ditherer::apply_error_diffusion_(int x, int y, Color &color, bool binary) {
+  if (y != this->row_) {
+    // Rows may be decoded top-down or bottom-up; anything else restarts the diffusion
+    if (this->row_ < 0 || (y != this->row_ + 1 && y != this->row_ - 1))
+      std::fill(this->errors_.begin(), this->errors_.end(), 0);
+    this->row_ = y;
+    this->last_x_ = -1;
+  }
+  bool contiguous = x == this->last_x_ + 1;
+  // The errors carried along the previous row don't belong to the start of this one
+  if (!contiguous || this->last_x_ < 0) {
+    std::fill(std::begin(this->carry_), std::end(this->carry_), 0);
+    std::fill(std::begin(this->pending_), std::end(this->pending_), 0);
+  }
+  this->last_x_ = x;
+
+  int16_t *errors = &this->errors_[x * 3];
+  uint8_t channel_count = binary ? 1 : 3;
+  int error[3];
+  if (binary) {
+    int value = luma(color) + errors[0] + this->carry_[0];
+    uint8_t out = value >= 128 ? 0xFF : 0;
+    error[0] = value - out;
+    color.r = color.g = color.b = out;
+  } else {
+    uint8_t *channels[3] = {&color.r, &color.g, &color.b};
+    for (uint8_t c = 0; c < 3; c++) {
+      int value = clamp_channel(*channels[c] + errors[c] + this->carry_[c]);
+      int out = quantize(value, RGB565_BITS[c]);
+      error[c] = value - out;
+      *channels[c] = out;
+    }
+  }
+
+  // Distribute 7/16 right, 3/16 below left, 5/16 below, 1/16 below right
+  for (uint8_t c = 0; c < channel_count; c++) {
+    int e = error[c];
+    if (contiguous && x > 0)
+      errors[c - 3] += e * 3 / 16;
+    errors[c] = e * 5 / 16 + this->pending_[c];
+    this->pending_[c] = e / 16;
+    this->carry_[c] = e * 7 / 16;
+  }
+}
+
+}  // namespace online_image
+}  // namespace esphome
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "esphome/core/color.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace online_image {
+
+enum DitherMode : uint8_t {
+  /** Truncate to the output format. */
+  DITHER_NONE,
+  /** 8x8 Bayer threshold matrix; no state, works with any pixel order. */
+  DITHER_ORDERED,
+  /** Floyd-Steinberg error diffusion; needs pixels in row order. */
+  DITHER_FLOYD_STEINBERG,
+};
+
+/**
+ * @brief Quantize decoded colors to RGB565 or 1 bit, spreading the quantization error.
+ *
+ * Error diffusion keeps a single row of error terms (3 channels per column), plus the error carried to the
+ * right neighbour and the one pending for the next row's column. Pixels must arrive left to right within a
+ * row, and rows must follow each other (top-down or bottom-up, as BMP stores them); out-of-order pixels
+ * simply restart the diffusion, so the output is never worse than without dithering.
+ */
+class Ditherer {
+ public:
+  void set_mode(DitherMode mode) { this->mode_ = mode; }
+  DitherMode get_mode() const { return this->mode_; }
+
+  /// Prepare for a new image with the given width. Allocates the error row for error diffusion.
+  void reset(int width);
+  /// Free the error row.
+  void release();
+
+  /**
+   * @brief Adjust a color so that the output format's truncation yields the dithered value.
+   *
+   * @param mode The method to use for this pixel, error diffusion falls back to ordered if not prepared.
+   * @param binary true for 1 bit output (as thresholded by is_color_on()), false for RGB565.
+   */
+  void apply(DitherMode mode, int x, int y, Color &color, bool binary);
+
+ protected:
+  void apply_ordered_(int x, int y, Color &color, bool binary);
+  void apply_error_diffusion_(int x, int y, Color &color, bool binary);
+
+  DitherMode mode_{DITHER_NONE};
+  /// Errors for the next row in columns left of the current pixel, for the current row from it on.
+  std::vector<int16_t> errors_;
+  int width_{0};
+  int row_{-1};
+  int last_x_{-1};
+  /// Error for the pixel to the right.
+  int16_t carry_[3]{};
+  /// Error for the next row in the current column, from the pixel to the left.
+  int16_t pending_[3]{};
+};
+
+}  // namespace online_image
+}  // namespace esphome
@@ -10,6 +10,8 @@ static const char *const TAG = "online_image.decoder";
 
 bool ImageDecoder::set_size(int width, int height) {
   bool success = this->image_->resize_(width, height) > 0;
+  if (success)
+    this->image_->ditherer_.reset(this->image_->buffer_width_);
   this->x_scale_ = static_cast<double>(this->image_->buffer_width_) / width;
   this->y_scale_ = static_cast<double>(this->image_->buffer_height_) / height;
   return success;
@@ -25,6 +27,12 @@ void ImageDecoder::draw(int x, int y, int w, int h, const Color &color) {
   }
 }
 
+void ImageDecoder::rows_complete(int rows) {
+  auto buffer_rows = std::min(this->image_->buffer_height_, static_cast<int>(rows * this->y_scale_));
+  if (buffer_rows > this->image_->rows_ready_)
+    this->image_->rows_ready_ = buffer_rows;
+}
+
 DownloadBuffer::DownloadBuffer(size_t size) : size_(size) {
   this->buffer_ = this->allocator_.allocate(size);
   this->reset();
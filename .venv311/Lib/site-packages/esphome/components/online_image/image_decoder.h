@@ -73,8 +73,22 @@ class ImageDecoder {
    */
   void draw(int x, int y, int w, int h, const Color &color);
 
+  /**
+   * @brief Report that all rows above the given one are fully decoded, for progressive rendering.
+   * Only decoders that fill the image top to bottom call this.
+   *
+   * @param rows The number of completed rows of the source image, counted from the top.
+   */
+  void rows_complete(int rows);
+
   bool is_finished() const { return this->decoded_bytes_ == this->download_size_; }
 
+  /**
+   * @brief Whether pixels are drawn row after row, left to right, as error diffusion dithering requires.
+   * Decoders that draw in blocks get ordered dithering instead.
+   */
+  virtual bool is_row_ordered() const { return true; }
+
  protected:
   OnlineImage *image_;
   // Initializing to 1, to ensure it is distinguishable from initial "decoded_bytes_".
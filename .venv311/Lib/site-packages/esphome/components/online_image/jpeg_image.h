@@ -23,6 +23,8 @@ class JpegDecoder : public ImageDecoder {
 
   int prepare(size_t download_size) override;
   int HOT decode(uint8_t *buffer, size_t size) override;
+  /// JPEGDEC draws in MCU blocks.
+  bool is_row_ordered() const override { return false; }
 
  protected:
   JPEGDEC jpeg_{};
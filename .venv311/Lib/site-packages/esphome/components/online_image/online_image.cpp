@@ -1,12 +1,29 @@
 #include "online_image.h"
 
+#include "esphome/core/hal.h"
 #include "esphome/core/log.h"
 
+#include <cstring>
+
+#ifdef USE_ONLINE_IMAGE_CACHE
+#ifdef USE_ESP32
+#include <esp_partition.h>
+#endif
+#ifdef USE_HOST
+#include "esphome/core/application.h"
+#include <cstdio>
+#include <cstdlib>
+#endif
+#endif
+
 static const char *const TAG = "online_image";
 static const char *const ETAG_HEADER_NAME = "etag";
 static const char *const IF_NONE_MATCH_HEADER_NAME = "if-none-match";
 static const char *const LAST_MODIFIED_HEADER_NAME = "last-modified";
 static const char *const IF_MODIFIED_SINCE_HEADER_NAME = "if-modified-since";
+static const char *const CONTENT_TYPE_HEADER_NAME = "content-type";
+/// Number of bytes needed to recognize every supported signature (PNG has the longest)
+static const size_t SNIFF_SIZE = 8;
 
 #include "image_decoder.h"
 
@@ -44,6 +61,8 @@ OnlineImage::OnlineImage(const std::string &url, int width, int height, ImageFor
       fixed_width_(width),
       fixed_height_(height),
       is_big_endian_(is_big_endian) {
+  // Reads of the decoded buffer (including the native blit) have to use the byte order it was written in
+  this->set_big_endian(is_big_endian);
   this->set_url(url);
 }
 
@@ -68,7 +87,12 @@ void OnlineImage::release() {
     this->last_modified_ = "";
     this->etag_ = "";
     this->end_connection_();
+#ifdef USE_ONLINE_IMAGE_CACHE
+    this->cache_saving_ = false;
+#endif
   }
+  for (auto *variant : this->variants_)
+    variant->release();
 }
 
 size_t OnlineImage::resize_(int width_in, int height_in) {
@@ -101,8 +125,161 @@ size_t OnlineImage::resize_(int width_in, int height_in) {
   return new_size;
 }
 
+#ifdef USE_ONLINE_IMAGE_CACHE
+/// Bytes of the image written to the cache per loop, one flash sector
+static const size_t CACHE_WRITE_CHUNK = 4096;
+
+void OnlineImage::setup() {
+  if (this->cache_key_ == 0)
+    return;
+  this->cache_header_pref_ = global_preferences->make_preference<CacheHeader>(this->cache_key_);
+  uint32_t start = millis();
+  if (this->restore_cache_()) {
+    this->update_variants_();
+    this->cache_hits_++;
+    ESP_LOGD(TAG, "Restored %dx%d image from cache in %" PRIu32 "ms", this->width_, this->height_, millis() - start);
+  } else {
+    this->cache_misses_++;
+    ESP_LOGD(TAG, "No cached image");
+  }
+}
+
+bool OnlineImage::restore_cache_() {
+  CacheHeader header;
+  if (!this->cache_header_pref_.load(&header))
+    return false;
+  if (header.url_hash != fnv1_hash(this->url_))
+    return false;
+  if (this->resize_(header.width, header.height) == 0)
+    return false;
+  if (this->buffer_width_ != header.width || this->buffer_height_ != header.height) {
+    this->release();
+    return false;
+  }
+  size_t size = this->get_buffer_size_();
+  // The hash guards against a buffer left over from an interrupted save with a different header
+  if (!this->read_cache_data_(this->buffer_, size) || fnv1_hash(this->buffer_, size) != header.data_hash) {
+    this->release();
+    return false;
+  }
+  this->cache_data_hash_ = header.data_hash;
+  this->data_start_ = this->buffer_;
+  this->width_ = this->buffer_width_;
+  this->height_ = this->buffer_height_;
+  this->etag_ = std::string(header.etag, strnlen(header.etag, sizeof(header.etag)));
+  this->last_modified_ = std::string(header.last_modified, strnlen(header.last_modified, sizeof(header.last_modified)));
+  return true;
+}
+
+void OnlineImage::save_cache_() {
+  size_t size = this->get_buffer_size_();
+  CacheHeader &header = this->cache_pending_header_;
+  header = CacheHeader{};
+  header.url_hash = fnv1_hash(this->url_);
+  header.data_hash = fnv1_hash(this->buffer_, size);
+  header.width = this->buffer_width_;
+  header.height = this->buffer_height_;
+  // Validators that don't fit are dropped; the next update then downloads unconditionally
+  if (this->etag_.size() < sizeof(header.etag))
+    memcpy(header.etag, this->etag_.data(), this->etag_.size());
+  if (this->last_modified_.size() < sizeof(header.last_modified))
+    memcpy(header.last_modified, this->last_modified_.data(), this->last_modified_.size());
+
+  // The validators can change without the image changing, only write the (large) image when it did
+  if (header.data_hash == this->cache_data_hash_) {
+    this->save_cache_header_();
+    return;
+  }
+  // Erasing and writing flash blocks for a while, so the image is written one sector per loop. Until the header
+  // follows, the stored image matches no header.
+  this->cache_data_hash_ = 0;
+  this->cache_write_offset_ = 0;
+  this->cache_saving_ = true;
+  this->enable_loop();
+}
+
+void OnlineImage::continue_cache_save_() {
+  size_t size = this->get_buffer_size_();
+  size_t len = std::min(CACHE_WRITE_CHUNK, size - this->cache_write_offset_);
+  if (!this->write_cache_data_(this->cache_write_offset_, this->buffer_ + this->cache_write_offset_, len)) {
+    ESP_LOGW(TAG, "Could not cache image (%zu bytes)", size);
+    this->cache_saving_ = false;
+    return;
+  }
+  this->cache_write_offset_ += len;
+  if (this->cache_write_offset_ < size)
+    return;
+  this->cache_saving_ = false;
+  this->save_cache_header_();
+}
+
+void OnlineImage::save_cache_header_() {
+  if (!this->cache_header_pref_.save(&this->cache_pending_header_)) {
+    ESP_LOGW(TAG, "Could not save image cache header");
+    return;
+  }
+  this->cache_data_hash_ = this->cache_pending_header_.data_hash;
+}
+
+#ifdef USE_ESP32
+bool OnlineImage::read_cache_data_(uint8_t *dest, size_t len) {
+  const esp_partition_t *partition =
+      esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, this->cache_partition_);
+  if (partition == nullptr || len > partition->size)
+    return false;
+  return esp_partition_read(partition, 0, dest, len) == ESP_OK;
+}
+
+bool OnlineImage::write_cache_data_(size_t offset, const uint8_t *src, size_t len) {
+  const esp_partition_t *partition =
+      esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, this->cache_partition_);
+  if (partition == nullptr) {
+    ESP_LOGW(TAG, "Cache partition '%s' not found", this->cache_partition_);
+    return false;
+  }
+  if (offset + len > partition->size) {
+    ESP_LOGW(TAG, "Image doesn't fit cache partition '%s' of %" PRIu32 " bytes", this->cache_partition_,
+             partition->size);
+    return false;
+  }
+  // Erasing works on whole sectors; offset is at the start of one
+  size_t erase_len = (len + CACHE_WRITE_CHUNK - 1) / CACHE_WRITE_CHUNK * CACHE_WRITE_CHUNK;
+  if (esp_partition_erase_range(partition, offset, std::min<size_t>(erase_len, partition->size - offset)) != ESP_OK)
+    return false;
+  return esp_partition_write(partition, offset, src, len) == ESP_OK;
+}
+#endif  // USE_ESP32
+
+#ifdef USE_HOST
+std::string OnlineImage::cache_filename_() const {
+  // Next to the preferences file
+  return str_sprintf("%s/.esphome/prefs/%s.online_image_%08" PRIx32 ".bin", getenv("HOME"), App.get_name().c_str(),
+                     this->cache_key_);
+}
+
+bool OnlineImage::read_cache_data_(uint8_t *dest, size_t len) {
+  FILE *fp = fopen(this->cache_filename_().c_str(), "rb");
+  if (fp == nullptr)
+    return false;
+  bool ok = fread(dest, 1, len, fp) == len;
+  fclose(fp);
+  return ok;
+}
+
+bool OnlineImage::write_cache_data_(size_t offset, const uint8_t *src, size_t len) {
+  // The first chunk replaces the file
+  FILE *fp = fopen(this->cache_filename_().c_str(), offset == 0 ? "wb" : "r+b");
+  if (fp == nullptr)
+    return false;
+  bool ok = fseek(fp, offset, SEEK_SET) == 0 && fwrite(src, 1, len, fp) == len;
+  ok = fclose(fp) == 0 && ok;
+  return ok;
+}
+#endif  // USE_HOST
+#endif  // USE_ONLINE_IMAGE_CACHE
+
 void OnlineImage::update() {
-  if (this->decoder_) {
+  if (this->decoder_ || this->downloader_) {
     ESP_LOGW(TAG, "Image already being updated.");
     return;
   }
@@ -148,7 +325,8 @@ void OnlineImage::update() {
     headers.push_back(http_request::Header{header.first, header.second.value()});
   }
 
-  this->downloader_ = this->parent_->get(this->url_, headers, {ETAG_HEADER_NAME, LAST_MODIFIED_HEADER_NAME});
+  this->downloader_ = this->parent_->get(this->url_, headers,
+                                         {ETAG_HEADER_NAME, LAST_MODIFIED_HEADER_NAME, CONTENT_TYPE_HEADER_NAME});
 
   if (this->downloader_ == nullptr) {
     ESP_LOGE(TAG, "Download failed.");
@@ -161,6 +339,10 @@ void OnlineImage::update() {
   if (http_code == HTTP_CODE_NOT_MODIFIED) {
     // Image hasn't changed on server. Skip download.
     ESP_LOGI(TAG, "Server returned HTTP 304 (Not Modified). Download skipped.");
+#ifdef USE_ONLINE_IMAGE_CACHE
+    if (this->cache_key_ != 0)
+      this->cache_hits_++;
+#endif
     this->end_connection_();
     this->download_finished_callback_.call(true);
     return;
@@ -172,52 +354,151 @@ void OnlineImage::update() {
     return;
   }
 
+#ifdef USE_ONLINE_IMAGE_CACHE
+  // The new image is decoded into the buffer that is being saved; it is saved again once it is complete
+  this->cache_saving_ = false;
+#endif
   ESP_LOGD(TAG, "Starting download");
+  this->start_time_ = ::time(nullptr);
+  this->rows_ready_ = 0;
+  this->rows_reported_ = 0;
+
+  if (this->format_ == ImageFormat::AUTO) {
+    std::string content_type = str_lower_case(this->downloader_->get_response_header(CONTENT_TYPE_HEADER_NAME));
+    if (str_startswith(content_type, "text/") || str_startswith(content_type, "application/json")) {
+      // Most likely an error page; reject it before reading the body or allocating anything
+      ESP_LOGE(TAG, "Response is not an image (Content-Type: %s)", content_type.c_str());
+      this->end_connection_();
+      this->download_error_callback_.call();
+      return;
+    }
+    // The decoder is chosen in loop() once the first bytes have arrived
+    this->sniff_time_ = millis();
+    this->enable_loop();
+    return;
+  }
+
+  this->decoder_ = this->create_decoder_(this->format_);
+  if (!this->decoder_) {
+    ESP_LOGE(TAG, "Could not instantiate decoder. Image format unsupported: %d", this->format_);
+    this->end_connection_();
+    this->download_error_callback_.call();
+    return;
+  }
   size_t total_size = this->downloader_->content_length;
+  auto prepare_result = this->decoder_->prepare(total_size);
+  if (prepare_result < 0) {
+    this->end_connection_();
+    this->download_error_callback_.call();
+    return;
+  }
+  ESP_LOGI(TAG, "Downloading image (Size: %zu)", total_size);
+  this->enable_loop();
+}
 
+std::unique_ptr<ImageDecoder> OnlineImage::create_decoder_(ImageFormat format) {
+  switch (format) {
 #ifdef USE_ONLINE_IMAGE_BMP_SUPPORT
-  if (this->format_ == ImageFormat::BMP) {
-    ESP_LOGD(TAG, "Allocating BMP decoder");
-    this->decoder_ = make_unique<BmpDecoder>(this);
-    this->enable_loop();
-  }
+    case ImageFormat::BMP:
+      ESP_LOGD(TAG, "Allocating BMP decoder");
+      return make_unique<BmpDecoder>(this);
 #endif  // USE_ONLINE_IMAGE_BMP_SUPPORT
 #ifdef USE_ONLINE_IMAGE_JPEG_SUPPORT
-  if (this->format_ == ImageFormat::JPEG) {
-    ESP_LOGD(TAG, "Allocating JPEG decoder");
-    this->decoder_ = esphome::make_unique<JpegDecoder>(this);
-    this->enable_loop();
-  }
+    case ImageFormat::JPEG:
+      ESP_LOGD(TAG, "Allocating JPEG decoder");
+      return make_unique<JpegDecoder>(this);
 #endif  // USE_ONLINE_IMAGE_JPEG_SUPPORT
 #ifdef USE_ONLINE_IMAGE_PNG_SUPPORT
-  if (this->format_ == ImageFormat::PNG) {
-    ESP_LOGD(TAG, "Allocating PNG decoder");
-    this->decoder_ = make_unique<PngDecoder>(this);
-    this->enable_loop();
-  }
+    case ImageFormat::PNG:
+      ESP_LOGD(TAG, "Allocating PNG decoder");
+      return make_unique<PngDecoder>(this);
 #endif  // USE_ONLINE_IMAGE_PNG_SUPPORT
+    default:
+      return nullptr;
+  }
+}
+
+ImageFormat OnlineImage::detect_format_(const uint8_t *data, size_t len, const std::string &content_type) {
+  static const uint8_t PNG_SIGNATURE[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  if (len >= sizeof(PNG_SIGNATURE) && memcmp(data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) == 0)
+    return ImageFormat::PNG;
+  if (len >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF)
+    return ImageFormat::JPEG;
+  if (len >= 2 && data[0] == 'B' && data[1] == 'M')
+    return ImageFormat::BMP;
+
+  // Unknown signature; only trust the header if it names an image type
+  std::string mime = str_lower_case(content_type.substr(0, content_type.find(';')));
+  if (mime == "image/png")
+    return ImageFormat::PNG;
+  if (mime == "image/jpeg" || mime == "image/jpg")
+    return ImageFormat::JPEG;
+  if (mime == "image/bmp" || mime == "image/x-ms-bmp")
+    return ImageFormat::BMP;
+  return ImageFormat::AUTO;
+}
+
+bool OnlineImage::start_auto_decoder_() {
+  // Without a Content-Length the length reads as SIZE_MAX, a short body then only ends by the timeout below
+  size_t total_size = this->downloader_->content_length;
+  size_t wanted = std::min(SNIFF_SIZE, total_size);
+  if (this->download_buffer_.unread() < wanted) {
+    auto len = this->downloader_->read(this->download_buffer_.append(), wanted - this->download_buffer_.unread());
+    if (len < 0) {
+      ESP_LOGE(TAG, "Error when reading image data");
+      this->end_connection_();
+      this->download_error_callback_.call();
+      return false;
+    }
+    this->download_buffer_.write(len);
+    if (len > 0)
+      this->sniff_time_ = millis();
+    if (this->download_buffer_.unread() < wanted) {
+      if (millis() - this->sniff_time_ < this->parent_->get_timeout())
+        return false;
+      ESP_LOGD(TAG, "No more data after %zu bytes, detecting the format from them", this->download_buffer_.unread());
+    }
+  }
+  if (this->download_buffer_.unread() == 0) {
+    ESP_LOGE(TAG, "Response contains no image data");
+    this->end_connection_();
+    this->download_error_callback_.call();
+    return false;
+  }
 
+  std::string content_type = this->downloader_->get_response_header(CONTENT_TYPE_HEADER_NAME);
+  ImageFormat format = detect_format_(this->download_buffer_.data(), this->download_buffer_.unread(), content_type);
+  this->decoder_ = this->create_decoder_(format);
   if (!this->decoder_) {
-    ESP_LOGE(TAG, "Could not instantiate decoder. Image format unsupported: %d", this->format_);
+    ESP_LOGE(TAG, "Unrecognized or unsupported image data (Content-Type: %s)", content_type.c_str());
     this->end_connection_();
     this->download_error_callback_.call();
-    return;
+    return false;
   }
-  auto prepare_result = this->decoder_->prepare(total_size);
-  if (prepare_result < 0) {
+  if (this->decoder_->prepare(total_size) < 0) {
     this->end_connection_();
     this->download_error_callback_.call();
-    return;
+    return false;
   }
   ESP_LOGI(TAG, "Downloading image (Size: %zu)", total_size);
-  this->start_time_ = ::time(nullptr);
+  return true;
 }
 
 void OnlineImage::loop() {
   if (!this->decoder_) {
-    // Not decoding at the moment => nothing to do.
-    this->disable_loop();
-    return;
+#ifdef USE_ONLINE_IMAGE_CACHE
+    if (this->cache_saving_) {
+      this->continue_cache_save_();
+      return;
+    }
+#endif
+    if (this->downloader_ == nullptr || this->format_ != ImageFormat::AUTO) {
+      // Not decoding at the moment => nothing to do.
+      this->disable_loop();
+      return;
+    }
+    if (!this->start_auto_decoder_())
+      return;
   }
   if (!this->downloader_ || this->decoder_->is_finished()) {
     this->data_start_ = buffer_;
@@ -226,8 +507,19 @@ void OnlineImage::loop() {
     ESP_LOGD(TAG, "Image fully downloaded, read %zu bytes, width/height = %d/%d", this->downloader_->get_bytes_read(),
              this->width_, this->height_);
     ESP_LOGD(TAG, "Total time: %" PRIu32 "s", (uint32_t) (::time(nullptr) - this->start_time_));
+    if (this->progressive_) {
+      this->rows_ready_ = this->buffer_height_;
+      this->publish_rows_();
+    }
     this->etag_ = this->downloader_->get_response_header(ETAG_HEADER_NAME);
     this->last_modified_ = this->downloader_->get_response_header(LAST_MODIFIED_HEADER_NAME);
+#ifdef USE_ONLINE_IMAGE_CACHE
+    if (this->cache_key_ != 0) {
+      this->cache_misses_++;
+      this->save_cache_();
+    }
+#endif
+    this->update_variants_();
     this->download_finished_callback_.call(false);
     this->end_connection_();
     return;
@@ -253,10 +545,24 @@ void OnlineImage::loop() {
         return;
       }
       this->download_buffer_.read(fed);
+      if (this->progressive_)
+        this->publish_rows_();
     }
   }
 }
 
+void OnlineImage::publish_rows_() {
+  if (this->rows_ready_ <= this->rows_reported_)
+    return;
+  this->data_start_ = this->buffer_;
+  this->width_ = this->buffer_width_;
+  // When replacing an image of the same size, keep showing the old rows below the new ones
+  if (this->rows_ready_ > this->height_)
+    this->height_ = this->rows_ready_;
+  this->rows_ready_callback_.call(this->rows_reported_, this->rows_ready_);
+  this->rows_reported_ = this->rows_ready_;
+}
+
 void OnlineImage::map_chroma_key(Color &color) {
   if (this->transparency_ == image::TRANSPARENCY_CHROMA_KEY) {
     if (color.g == 1 && color.r == 0 && color.b == 0) {
@@ -279,10 +585,21 @@ void OnlineImage::draw_pixel_(int x, int y, Color color) {
     ESP_LOGE(TAG, "Tried to paint a pixel (%d,%d) outside the image!", x, y);
     return;
   }
-  uint32_t pos = this->get_position_(x, y);
+  DitherMode dither = this->ditherer_.get_mode();
+  bool quantized = this->type_ == ImageType::IMAGE_TYPE_RGB565 || this->type_ == ImageType::IMAGE_TYPE_BINARY;
+  if (dither != DITHER_NONE && quantized && !(this->has_transparency() && color.w < 0x80)) {
+    if (dither == DITHER_FLOYD_STEINBERG && this->decoder_ && !this->decoder_->is_row_ordered())
+      dither = DITHER_ORDERED;
+    this->ditherer_.apply(dither, x, y, color, this->type_ == ImageType::IMAGE_TYPE_BINARY);
+  }
+  this->encode_pixel_(this->buffer_, this->buffer_width_, x, y, color);
+}
+
+void OnlineImage::encode_pixel_(uint8_t *buffer, int width, int x, int y, Color color) {
+  uint32_t pos = (x + y * width) * this->get_bpp() / 8;
   switch (this->type_) {
     case ImageType::IMAGE_TYPE_BINARY: {
-      const uint32_t width_8 = ((this->width_ + 7u) / 8u) * 8u;
+      const uint32_t width_8 = ((width + 7u) / 8u) * 8u;
       pos = x + y * width_8;
       auto bitno = 0x80 >> (pos % 8u);
       pos /= 8u;
@@ -290,9 +607,9 @@ void OnlineImage::draw_pixel_(int x, int y, Color color) {
       if (this->has_transparency() && color.w < 0x80)
         on = false;
       if (on) {
-        this->buffer_[pos] |= bitno;
+        buffer[pos] |= bitno;
       } else {
-        this->buffer_[pos] &= ~bitno;
+        buffer[pos] &= ~bitno;
       }
       break;
     }
@@ -309,37 +626,124 @@ void OnlineImage::draw_pixel_(int x, int y, Color color) {
         if (color.w != 0xFF)
           gray = color.w;
       }
-      this->buffer_[pos] = gray;
+      buffer[pos] = gray;
       break;
     }
     case ImageType::IMAGE_TYPE_RGB565: {
       this->map_chroma_key(color);
       uint16_t col565 = display::ColorUtil::color_to_565(color);
       if (this->is_big_endian_) {
-        this->buffer_[pos + 0] = static_cast<uint8_t>((col565 >> 8) & 0xFF);
-        this->buffer_[pos + 1] = static_cast<uint8_t>(col565 & 0xFF);
+        buffer[pos + 0] = static_cast<uint8_t>((col565 >> 8) & 0xFF);
+        buffer[pos + 1] = static_cast<uint8_t>(col565 & 0xFF);
       } else {
-        this->buffer_[pos + 0] = static_cast<uint8_t>(col565 & 0xFF);
-        this->buffer_[pos + 1] = static_cast<uint8_t>((col565 >> 8) & 0xFF);
+        buffer[pos + 0] = static_cast<uint8_t>(col565 & 0xFF);
+        buffer[pos + 1] = static_cast<uint8_t>((col565 >> 8) & 0xFF);
       }
       if (this->transparency_ == image::TRANSPARENCY_ALPHA_CHANNEL) {
-        this->buffer_[pos + 2] = color.w;
+        buffer[pos + 2] = color.w;
       }
       break;
     }
     case ImageType::IMAGE_TYPE_RGB: {
       this->map_chroma_key(color);
-      this->buffer_[pos + 0] = color.r;
-      this->buffer_[pos + 1] = color.g;
-      this->buffer_[pos + 2] = color.b;
+      buffer[pos + 0] = color.r;
+      buffer[pos + 1] = color.g;
+      buffer[pos + 2] = color.b;
       if (this->transparency_ == image::TRANSPARENCY_ALPHA_CHANNEL) {
-        this->buffer_[pos + 3] = color.w;
+        buffer[pos + 3] = color.w;
       }
       break;
     }
   }
 }
 
+void OnlineImage::update_variants_() {
+  // Variants are ordered from large to small, so each one can be derived from an already updated one
+  for (auto *variant : this->variants_)
+    variant->generate_();
+}
+
+OnlineImageVariant::OnlineImageVariant(OnlineImage *parent, const image::Image *source, int width, int height)
+    : Image(nullptr, 0, 0, parent->get_type(), parent->transparency_),
+      parent_(parent),
+      source_(source),
+      target_width_(width),
+      target_height_(height) {
+  this->set_big_endian(parent->is_big_endian_);
+}
+
+void OnlineImageVariant::release() {
+  if (this->buffer_) {
+    this->allocator_.deallocate(this->buffer_, this->parent_->get_buffer_size_(this->width_, this->height_));
+    this->buffer_ = nullptr;
+  }
+  this->data_start_ = nullptr;
+  this->width_ = 0;
+  this->height_ = 0;
+}
+
+void OnlineImageVariant::generate_() {
+  const int src_width = this->source_->get_width();
+  const int src_height = this->source_->get_height();
+  if (src_width == 0 || src_height == 0)
+    return;
+  const int width = this->target_width_;
+  const int height = this->target_height_;
+  if (this->buffer_ == nullptr) {
+    size_t size = this->parent_->get_buffer_size_(width, height);
+    this->buffer_ = this->allocator_.allocate(size);
+    if (this->buffer_ == nullptr) {
+      ESP_LOGE(TAG, "Allocation of %zu bytes for %dx%d variant failed", size, width, height);
+      return;
+    }
+  }
+  // Grayscale images with alpha only store the alpha value
+  const bool alpha_only = this->type_ == ImageType::IMAGE_TYPE_GRAYSCALE &&
+                          this->transparency_ == image::TRANSPARENCY_ALPHA_CHANNEL;
+  // Binary pixels carry no alpha; on and off are both averaged as opaque colors and the
+  // luma of the result decides the bit, like when the image was decoded
+  const bool binary = this->type_ == ImageType::IMAGE_TYPE_BINARY;
+  const bool weighted = this->has_transparency() && !binary;
+  const Color color_on(255, 255, 255, 255);
+  const Color color_off(0, 0, 0, 255);
+
+  for (int y = 0; y < height; y++) {
+    // Integer box covering the source rows that map onto this row; at least one row when enlarging
+    const int y0 = y * src_height / height;
+    const int y1 = std::max(y0 + 1, (y + 1) * src_height / height);
+    for (int x = 0; x < width; x++) {
+      const int x0 = x * src_width / width;
+      const int x1 = std::max(x0 + 1, (x + 1) * src_width / width);
+      // Weight colors by alpha so transparent pixels don't darken the edges
+      uint32_t r = 0, g = 0, b = 0, a = 0;
+      for (int sy = y0; sy < y1; sy++) {
+        for (int sx = x0; sx < x1; sx++) {
+          Color c = this->source_->get_pixel(sx, sy, color_on, color_off);
+          const uint32_t w = weighted ? c.w : 255;
+          r += c.r * w;
+          g += c.g * w;
+          b += c.b * w;
+          a += w;
+        }
+      }
+      const uint32_t count = (x1 - x0) * (y1 - y0);
+      Color color;
+      color.w = a / count;
+      if (alpha_only) {
+        color.r = color.g = color.b = color.w;
+      } else if (a != 0) {
+        color.r = r / a;
+        color.g = g / a;
+        color.b = b / a;
+      }
+      this->parent_->encode_pixel_(this->buffer_, width, x, y, color);
+    }
+  }
+  this->data_start_ = this->buffer_;
+  this->width_ = width;
+  this->height_ = height;
+}
+
 void OnlineImage::end_connection_() {
   if (this->downloader_) {
     this->downloader_->end();
@@ -347,6 +751,7 @@ void OnlineImage::end_connection_() {
   }
   this->decoder_.reset();
   this->download_buffer_.reset();
+  this->ditherer_.release();
 }
 
 bool OnlineImage::validate_url_(const std::string &url) {
@@ -361,6 +766,10 @@ void OnlineImage::add_on_finished_callback(std::function<void(bool)> &&callback)
   this->download_finished_callback_.add(std::move(callback));
 }
 
+void OnlineImage::add_on_rows_ready_callback(std::function<void(int, int)> &&callback) {
+  this->rows_ready_callback_.add(std::move(callback));
+}
+
 void OnlineImage::add_on_error_callback(std::function<void()> &&callback) {
   this->download_error_callback_.add(std::move(callback));
 }
@@ -5,7 +5,11 @@
 #include "esphome/core/component.h"
 #include "esphome/core/defines.h"
 #include "esphome/core/helpers.h"
+#ifdef USE_ONLINE_IMAGE_CACHE
+#include "esphome/core/preferences.h"
+#endif
 
+#include "dither.h"
 #include "image_decoder.h"
 
 namespace esphome {
@@ -21,7 +25,7 @@ using t_http_codes = enum {
  * @brief Format that the image is encoded with.
  */
 enum ImageFormat {
-  /** Automatically detect from MIME type. Not supported yet. */
+  /** Detect from the first bytes of the response, falling back to the Content-Type header. */
   AUTO,
   /** JPEG format. */
   JPEG,
@@ -31,6 +35,8 @@ enum ImageFormat {
   BMP,
 };
 
+class OnlineImageVariant;
+
 /**
  * @brief Download an image from a given URL, and decode it using the specified decoder.
  * The image will then be stored in a buffer, so that it can be re-displayed without the
@@ -54,6 +60,9 @@ class OnlineImage : public PollingComponent,
 
   void draw(int x, int y, display::Display *display, Color color_on, Color color_off) override;
 
+#ifdef USE_ONLINE_IMAGE_CACHE
+  void setup() override;
+#endif
   void update() override;
   void loop() override;
   void map_chroma_key(Color &color);
@@ -96,9 +105,116 @@ class OnlineImage : public PollingComponent,
   void add_on_finished_callback(std::function<void(bool)> &&callback);
   void add_on_error_callback(std::function<void()> &&callback);
 
+  /**
+   * @brief Show the image while it is being decoded.
+   *
+   * The completed rows become visible as soon as the decoder reports them, instead of only once
+   * the whole image is done. Only decoders that work top to bottom while downloading (PNG) report
+   * rows early; the others still show the image at once.
+   */
+  void set_progressive(bool progressive) { this->progressive_ = progressive; }
+
+  /**
+   * @brief Dither decoded RGB565 and binary images instead of truncating the colors.
+   *
+   * Error diffusion needs one row of error terms; decoders that don't draw in row order use ordered dithering.
+   */
+  void set_dither(DitherMode mode) { this->ditherer_.set_mode(mode); }
+  /**
+   * @brief Add a callback for newly decoded rows in progressive mode.
+   *
+   * Called at most once per loop with the band of rows [first_row, last_row) that became visible,
+   * so a display can refresh just that part.
+   */
+  void add_on_rows_ready_callback(std::function<void(int, int)> &&callback);
+
+  /** Add a smaller copy of the image that is derived after every download, without decoding again. */
+  void add_variant(OnlineImageVariant *variant) { this->variants_.push_back(variant); }
+
+#ifdef USE_ONLINE_IMAGE_CACHE
+  /**
+   * @brief Keep the decoded image in flash (a file on host) so it is shown right after a reboot.
+   *
+   * @param key Preference key; derived from the image id and the settings that affect the buffer layout,
+   *        so a changed configuration never restores a stale buffer. 0 (the default) disables the cache.
+   */
+  void set_cache_key(uint32_t key) { this->cache_key_ = key; }
+#ifdef USE_ESP32
+  /// Label of the data partition that holds the image; the header with the validators goes to the preferences.
+  void set_cache_partition(const char *label) { this->cache_partition_ = label; }
+#endif
+  /** Number of times the image was restored from the cache or confirmed unchanged by the server (HTTP 304). */
+  uint32_t get_cache_hits() const { return this->cache_hits_; }
+  /** Number of times the image could not be restored or had to be downloaded and decoded again. */
+  uint32_t get_cache_misses() const { return this->cache_misses_; }
+#endif
+
  protected:
   bool validate_url_(const std::string &url);
 
+  /// Create the decoder for a format, or nullptr if its support is not compiled in.
+  std::unique_ptr<ImageDecoder> create_decoder_(ImageFormat format);
+
+  /**
+   * @brief Determine the format of an image from its first bytes and the response's Content-Type.
+   *
+   * @param data The first bytes of the response.
+   * @param len The number of bytes available in data.
+   * @param content_type The Content-Type header value, may be empty.
+   * @return The detected format, or AUTO if the response is not a supported image.
+   */
+  static ImageFormat detect_format_(const uint8_t *data, size_t len, const std::string &content_type);
+
+  /**
+   * @brief With format AUTO, read the start of the response and create the matching decoder.
+   *
+   * The bytes read stay in the download buffer and are decoded as usual. A body shorter than the signatures is
+   * detected from the bytes that arrived once it ended, or once no more data came within the request timeout.
+   * @return true once the decoder is ready, false while more data is needed or after an error.
+   */
+  bool start_auto_decoder_();
+
+#ifdef USE_ONLINE_IMAGE_CACHE
+  /// Validators and layout of the cached buffer; stored separately from the (large) buffer itself.
+  struct CacheHeader {
+    uint32_t url_hash;
+    uint32_t data_hash;
+    uint16_t width;
+    uint16_t height;
+    char etag[64];
+    char last_modified[32];
+  };
+
+  /// Restore the last decoded image from the cache, returns false if there is no usable entry.
+  bool restore_cache_();
+  /// Store the current image and its validators in the cache; a changed image is written over the next loops.
+  void save_cache_();
+  /// Write the next chunk of the image being saved, and the header once all of it is written.
+  void continue_cache_save_();
+  void save_cache_header_();
+  /// Read or write the image itself; it is too large for the preferences, so it goes to a partition or a file.
+  bool read_cache_data_(uint8_t *dest, size_t len);
+  bool write_cache_data_(size_t offset, const uint8_t *src, size_t len);
+#ifdef USE_HOST
+  std::string cache_filename_() const;
+#endif
+
+  ESPPreferenceObject cache_header_pref_;
+  uint32_t cache_key_{0};
+  /// Hash of the image that is in the cache, so an unchanged image isn't written again
+  uint32_t cache_data_hash_{0};
+  /// Header of the save in progress, stored after the image
+  CacheHeader cache_pending_header_{};
+  /// Bytes of the image written so far by the save in progress
+  size_t cache_write_offset_{0};
+  bool cache_saving_{false};
+#ifdef USE_ESP32
+  const char *cache_partition_{nullptr};
+#endif
+  uint32_t cache_hits_{0};
+  uint32_t cache_misses_{0};
+#endif
+
   RAMAllocator<uint8_t> allocator_{};
 
   uint32_t get_buffer_size_() const { return get_buffer_size_(this->buffer_width_, this->buffer_height_); }
@@ -136,10 +252,25 @@ class OnlineImage : public PollingComponent,
    */
   void draw_pixel_(int x, int y, Color color);
 
+  /**
+   * @brief Convert a color into this image's storage format and write it into a pixel buffer.
+   *
+   * @param buffer The buffer to write to, laid out like this image's buffer.
+   * @param width The width of the image stored in buffer.
+   */
+  void encode_pixel_(uint8_t *buffer, int width, int x, int y, Color color);
+
+  /// Derive all variants from the current image.
+  void update_variants_();
+
   void end_connection_();
 
+  /// Make the rows decoded since the last call visible and notify the rows-ready callbacks.
+  void publish_rows_();
+
   CallbackManager<void(bool)> download_finished_callback_{};
   CallbackManager<void()> download_error_callback_{};
+  CallbackManager<void(int, int)> rows_ready_callback_{};
 
   std::shared_ptr<http_request::HttpContainer> downloader_{nullptr};
   std::unique_ptr<ImageDecoder> decoder_{nullptr};
@@ -197,9 +328,55 @@ class OnlineImage : public PollingComponent,
   std::string last_modified_ = "";
 
   time_t start_time_;
+  /// When data for detecting the format of an AUTO image last arrived, or the download started
+  uint32_t sniff_time_{0};
+
+  std::vector<OnlineImageVariant *> variants_;
+  Ditherer ditherer_;
+
+  bool progressive_{false};
+  /** Number of buffer rows, from the top, that are fully decoded in the current download. */
+  int rows_ready_{0};
+  /** Number of buffer rows already passed to the rows-ready callbacks. */
+  int rows_reported_{0};
 
   friend bool ImageDecoder::set_size(int width, int height);
   friend void ImageDecoder::draw(int x, int y, int w, int h, const Color &color);
+  friend void ImageDecoder::rows_complete(int rows);
+  friend class OnlineImageVariant;
+};
+
+/**
+ * @brief A smaller copy of an OnlineImage, e.g. a thumbnail.
+ *
+ * Produced from the parent's decoded image (or a larger variant) with a box filter every time the
+ * parent finishes a download, so several sizes cost a single download and decode.
+ */
+class OnlineImageVariant : public image::Image {
+ public:
+  /**
+   * @param parent The online image this is a variant of; defines the pixel format.
+   * @param source The image to scale down: the parent, or a larger variant of it.
+   * @param width Width of the variant.
+   * @param height Height of the variant.
+   */
+  OnlineImageVariant(OnlineImage *parent, const image::Image *source, int width, int height);
+
+  /** Release the buffer; the variant is empty until the parent is downloaded again. */
+  void release();
+
+ protected:
+  friend class OnlineImage;
+
+  /// Rebuild the variant from the source image.
+  void generate_();
+
+  RAMAllocator<uint8_t> allocator_{};
+  OnlineImage *parent_;
+  const image::Image *source_;
+  const int target_width_;
+  const int target_height_;
+  uint8_t *buffer_{nullptr};
 };
 
 template<typename... Ts> class OnlineImageSetUrlAction : public Action<Ts...> {
@@ -234,6 +411,13 @@ class DownloadFinishedTrigger : public Trigger<bool> {
   }
 };
 
+class RowsReadyTrigger : public Trigger<int, int> {
+ public:
+  explicit RowsReadyTrigger(OnlineImage *parent) {
+    parent->add_on_rows_ready_callback([this](int first_row, int last_row) { this->trigger(first_row, last_row); });
+  }
+};
+
 class DownloadErrorTrigger : public Trigger<> {
  public:
   explicit DownloadErrorTrigger(OnlineImage *parent) {
@@ -38,6 +38,8 @@ static void draw_callback(pngle_t *pngle, uint32_t x, uint32_t y, uint32_t w, ui
   PngDecoder *decoder = (PngDecoder *) pngle_get_user_data(pngle);
   Color color(rgba[0], rgba[1], rgba[2], rgba[3]);
   decoder->draw(x, y, w, h, color);
+  // Rows arrive top to bottom, so everything above the current one is done
+  decoder->rows_complete(y);
 }
 
 PngDecoder::PngDecoder(OnlineImage *image) : ImageDecoder(image) {
@@ -23,6 +23,7 @@ enum OTAResponseTypes {
   OTA_RESPONSE_UPDATE_END_OK = 0x45,
   OTA_RESPONSE_SUPPORTS_COMPRESSION = 0x46,
   OTA_RESPONSE_CHUNK_OK = 0x47,
+  OTA_RESPONSE_SUPPORTS_DELTA = 0x48,
 
   OTA_RESPONSE_ERROR_MAGIC = 0x80,
   OTA_RESPONSE_ERROR_UPDATE_PREPARE = 0x81,
@@ -37,6 +38,7 @@ enum OTAResponseTypes {
   OTA_RESPONSE_ERROR_NO_UPDATE_PARTITION = 0x8A,
   OTA_RESPONSE_ERROR_MD5_MISMATCH = 0x8B,
   OTA_RESPONSE_ERROR_RP2040_NOT_ENOUGH_SPACE = 0x8C,
+  OTA_RESPONSE_ERROR_DELTA_BASE = 0x8D,
   OTA_RESPONSE_ERROR_UNKNOWN = 0xFF,
 };
 
@@ -57,6 +59,10 @@ class OTABackend {
   virtual OTAResponseTypes end() = 0;
   virtual void abort() = 0;
   virtual bool supports_compression() = 0;
+  /// Whether read_running() works, which is what delta updates are patched against.
+  virtual bool supports_delta() { return false; }
+  /// Read from the firmware image that is running now.
+  virtual bool read_running(size_t offset, uint8_t *data, size_t len) { return false; }
 };
 
 class OTAComponent : public Component {
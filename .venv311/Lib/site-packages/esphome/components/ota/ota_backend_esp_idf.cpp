@@ -34,6 +34,9 @@ OTAResponseTypes IDFOTABackend::begin(size_t image_size) {
   esp_task_wdt_reconfigure(&wdtc);
 #endif
 
+  // Without a size (compressed uploads) erase while writing, erasing the whole partition takes too long
+  if (image_size == 0)
+    image_size = OTA_WITH_SEQUENTIAL_WRITES;
   esp_err_t err = esp_ota_begin(this->partition_, image_size, &this->update_handle_);
 
 #if CONFIG_ESP_TASK_WDT_TIMEOUT_S < 15
@@ -100,6 +103,13 @@ OTAResponseTypes IDFOTABackend::end() {
   return OTA_RESPONSE_ERROR_UNKNOWN;
 }
 
+bool IDFOTABackend::read_running(size_t offset, uint8_t *data, size_t len) {
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  if (running == nullptr || offset + len > running->size)
+    return false;
+  return esp_partition_read(running, offset, data, len) == ESP_OK;
+}
+
 void IDFOTABackend::abort() {
   esp_ota_abort(this->update_handle_);
   this->update_handle_ = 0;
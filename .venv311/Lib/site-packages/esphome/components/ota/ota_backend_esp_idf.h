@@ -18,6 +18,8 @@ class IDFOTABackend : public OTABackend {
   OTAResponseTypes end() override;
   void abort() override;
   bool supports_compression() override { return false; }
+  bool supports_delta() override { return true; }
+  bool read_running(size_t offset, uint8_t *data, size_t len) override;
 
  private:
   esp_ota_handle_t update_handle_{0};
@@ -0,0 +1,110 @@
+#ifdef USE_HOST
+#include "ota_backend_host.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.host";
+
+static constexpr size_t SECTOR_SIZE = 4096;
+
+static std::string host_path = "firmware.ota.bin";  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static std::string host_running_path;               // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t host_erase_latency_us = 0;          // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void set_host_ota_backend(const std::string &path, uint32_t erase_latency_us) {
+  host_path = path;
+  host_erase_latency_us = erase_latency_us;
+}
+
+void set_host_ota_running_image(const std::string &path) { host_running_path = path; }
+
+std::unique_ptr<ota::OTABackend> make_ota_backend() {
+  return make_unique<ota::HostOTABackend>(host_path, host_running_path, host_erase_latency_us);
+}
+
+HostOTABackend::~HostOTABackend() {
+  this->abort();
+  if (this->running_file_ != nullptr)
+    fclose(this->running_file_);
+}
+
+bool HostOTABackend::read_running(size_t offset, uint8_t *data, size_t len) {
+  if (this->running_file_ == nullptr) {
+    if (this->running_path_.empty())
+      return false;
+    this->running_file_ = fopen(this->running_path_.c_str(), "rb");
+    if (this->running_file_ == nullptr) {
+      ESP_LOGW(TAG, "Cannot open %s", this->running_path_.c_str());
+      return false;
+    }
+  }
+  return fseek(this->running_file_, offset, SEEK_SET) == 0 && fread(data, 1, len, this->running_file_) == len;
+}
+
+OTAResponseTypes HostOTABackend::begin(size_t image_size) {
+  this->file_ = fopen(this->path_.c_str(), "wb");
+  if (this->file_ == nullptr) {
+    ESP_LOGW(TAG, "Cannot open %s", this->path_.c_str());
+    return OTA_RESPONSE_ERROR_UPDATE_PREPARE;
+  }
+  this->image_size_ = image_size;
+  this->written_ = 0;
+  this->md5_.init();
+  return OTA_RESPONSE_OK;
+}
+
+void HostOTABackend::set_update_md5(const char *expected_md5) {
+  memcpy(this->expected_bin_md5_, expected_md5, 32);
+  this->md5_set_ = true;
+}
+
+OTAResponseTypes HostOTABackend::write(uint8_t *data, size_t len) {
+  if (this->file_ == nullptr)
+    return OTA_RESPONSE_ERROR_WRITING_FLASH;
+  if (this->erase_latency_us_ != 0) {
+    size_t sectors = (this->written_ + len + SECTOR_SIZE - 1) / SECTOR_SIZE -
+                     (this->written_ + SECTOR_SIZE - 1) / SECTOR_SIZE;
+    if (sectors != 0)
+      delayMicroseconds(sectors * this->erase_latency_us_);
+  }
+  if (fwrite(data, 1, len, this->file_) != len)
+    return OTA_RESPONSE_ERROR_WRITING_FLASH;
+  this->md5_.add(data, len);
+  this->written_ += len;
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes HostOTABackend::end() {
+  if (this->file_ == nullptr)
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  bool ok = fclose(this->file_) == 0;
+  this->file_ = nullptr;
+  if (!ok || (this->image_size_ != 0 && this->written_ != this->image_size_))
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  if (this->md5_set_) {
+    this->md5_.calculate();
+    if (!this->md5_.equals_hex(this->expected_bin_md5_))
+      return OTA_RESPONSE_ERROR_MD5_MISMATCH;
+  }
+  ESP_LOGI(TAG, "Wrote %zu bytes to %s", this->written_, this->path_.c_str());
+  return OTA_RESPONSE_OK;
+}
+
+void HostOTABackend::abort() {
+  if (this->file_ != nullptr) {
+    fclose(this->file_);
+    this->file_ = nullptr;
+  }
+}
+
+}  // namespace ota
+}  // namespace esphome
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#ifdef USE_HOST
+#include "ota_backend.h"
+
+#include "esphome/components/md5/md5.h"
+#include "esphome/core/defines.h"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace esphome {
+namespace ota {
+
+/// Set where the host backend stores received images, and how long it stalls per erased flash sector.
+void set_host_ota_backend(const std::string &path, uint32_t erase_latency_us);
+/// Set the file that stands in for the running firmware, which delta updates are applied to.
+void set_host_ota_running_image(const std::string &path);
+
+/**
+ * OTA backend for the host platform that writes the image to a file instead of flash.
+ *
+ * Every time the write position crosses into a new 4 KB sector the backend sleeps for the configured erase
+ * latency, to mimic the stalls of a real flash so that the OTA transfer can be measured without hardware.
+ * If a running image file is set, delta updates are patched against it.
+ */
+class HostOTABackend : public OTABackend {
+ public:
+  HostOTABackend(std::string path, std::string running_path, uint32_t erase_latency_us)
+      : path_(std::move(path)), running_path_(std::move(running_path)), erase_latency_us_(erase_latency_us) {}
+  ~HostOTABackend() override;
+  OTAResponseTypes begin(size_t image_size) override;
+  void set_update_md5(const char *md5) override;
+  OTAResponseTypes write(uint8_t *data, size_t len) override;
+  OTAResponseTypes end() override;
+  void abort() override;
+  bool supports_compression() override { return false; }
+  bool supports_delta() override { return !this->running_path_.empty(); }
+  bool read_running(size_t offset, uint8_t *data, size_t len) override;
+
+ private:
+  std::string path_;
+  std::string running_path_;
+  FILE *running_file_{nullptr};
+  uint32_t erase_latency_us_;
+  FILE *file_{nullptr};
+  size_t image_size_{0};
+  size_t written_{0};
+  md5::MD5Digest md5_{};
+  char expected_bin_md5_[32];
+  bool md5_set_{false};
+};
+
+}  // namespace ota
+}  // namespace esphome
+#endif
@@ -0,0 +1,248 @@
+#include "ota_delta.h"
+#ifdef USE_OTA_DELTA
+
+#include "esphome/components/md5/md5.h"
+#include "esphome/core/application.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.delta";
+
+static const uint8_t DELTA_MAGIC[4] = {'E', 'S', 'P', 'D'};
+static const uint8_t DELTA_VERSION = 1;
+
+static uint32_t get_le32(const uint8_t *data) {
+  return data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+bool DeltaHeader::parse(const uint8_t *data) {
+  if (memcmp(data, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0 || data[4] != DELTA_VERSION)
+    return false;
+  this->new_size = get_le32(data + 8);
+  this->old_size = get_le32(data + 12);
+  memcpy(this->old_md5, data + 16, sizeof(this->old_md5));
+  return true;
+}
+
+bool DeltaPatcher::verify_base() {
+  md5::MD5Digest md5{};
+  md5.init();
+  for (uint32_t offset = 0; offset < this->header_.old_size; offset += OUT_SIZE) {
+    size_t len = std::min<size_t>(OUT_SIZE, this->header_.old_size - offset);
+    if (!this->backend_->read_running(offset, this->out_, len)) {
+      ESP_LOGW(TAG, "Reading the running image failed at %" PRIu32, offset);
+      return false;
+    }
+    md5.add(this->out_, len);
+    if (offset % 65536 == 0)
+      App.feed_wdt();
+  }
+  md5.calculate();
+  if (!md5.equals_bytes(this->header_.old_md5)) {
+    ESP_LOGW(TAG, "The patch was made for a different firmware");
+    return false;
+  }
+  return true;
+}
+
+OTAResponseTypes DeltaPatcher::feed(const uint8_t *data, size_t len) {
+  while (len != 0) {
+    switch (this->state_) {
+      case STATE_LITERALS: {
+        size_t count = std::min<size_t>(len, this->literals_left_);
+        OTAResponseTypes error = this->copy_old_(count, data);
+        if (error != OTA_RESPONSE_OK)
+          return error;
+        data += count;
+        len -= count;
+        this->literals_left_ -= count;
+        this->diff_left_ -= count;
+        if (this->literals_left_ == 0) {
+          error = this->continue_record_();
+          if (error != OTA_RESPONSE_OK)
+            return error;
+        }
+        break;
+      }
+
+      case STATE_EXTRA: {
+        size_t count = std::min<size_t>(len, this->extra_left_);
+        OTAResponseTypes error = this->copy_extra_(data, count);
+        if (error != OTA_RESPONSE_OK)
+          return error;
+        data += count;
+        len -= count;
+        this->extra_left_ -= count;
+        if (this->extra_left_ == 0) {
+          error = this->end_record_();
+          if (error != OTA_RESPONSE_OK)
+            return error;
+        }
+        break;
+      }
+
+      default: {
+        // All other states read a varint
+        uint8_t byte = *data++;
+        len--;
+        // A 32 bit value takes at most 5 bytes, of which the last holds the top 4 bits
+        if (this->varint_shift_ == 28 && (byte & 0xF0) != 0) {
+          ESP_LOGW(TAG, "Patch number exceeds 32 bits");
+          return OTA_RESPONSE_ERROR_UPDATE_END;
+        }
+        this->varint_ |= static_cast<uint32_t>(byte & 0x7F) << this->varint_shift_;
+        this->varint_shift_ += 7;
+        if ((byte & 0x80) != 0)
+          break;
+        uint32_t value = this->varint_;
+        this->varint_ = 0;
+        this->varint_shift_ = 0;
+
+        switch (this->state_) {
+          case STATE_DIFF_LENGTH:
+            this->diff_left_ = value;
+            this->state_ = STATE_EXTRA_LENGTH;
+            break;
+          case STATE_EXTRA_LENGTH:
+            this->extra_left_ = value;
+            this->state_ = STATE_SEEK;
+            break;
+          case STATE_SEEK:
+            this->seek_ = static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+            if (this->diff_left_ > this->header_.new_size - this->produced_ ||
+                this->extra_left_ > this->header_.new_size - this->produced_ - this->diff_left_) {
+              ESP_LOGW(TAG, "Patch record exceeds the image size");
+              return OTA_RESPONSE_ERROR_UPDATE_END;
+            }
+            {
+              OTAResponseTypes error = this->continue_record_();
+              if (error != OTA_RESPONSE_OK)
+                return error;
+            }
+            break;
+          case STATE_ZERO_RUN: {
+            if (value > this->diff_left_)
+              return OTA_RESPONSE_ERROR_UPDATE_END;
+            OTAResponseTypes error = this->copy_old_(value, nullptr);
+            if (error != OTA_RESPONSE_OK)
+              return error;
+            this->diff_left_ -= value;
+            this->state_ = STATE_LITERAL_COUNT;
+            break;
+          }
+          case STATE_LITERAL_COUNT:
+            if (value > this->diff_left_)
+              return OTA_RESPONSE_ERROR_UPDATE_END;
+            this->literals_left_ = value;
+            if (value != 0) {
+              this->state_ = STATE_LITERALS;
+            } else {
+              OTAResponseTypes error = this->continue_record_();
+              if (error != OTA_RESPONSE_OK)
+                return error;
+            }
+            break;
+          default:
+            break;
+        }
+        break;
+      }
+    }
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes DeltaPatcher::continue_record_() {
+  if (this->diff_left_ != 0) {
+    this->state_ = STATE_ZERO_RUN;
+  } else if (this->extra_left_ != 0) {
+    this->state_ = STATE_EXTRA;
+  } else {
+    return this->end_record_();
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes DeltaPatcher::end_record_() {
+  int64_t pos = static_cast<int64_t>(this->old_pos_) + this->seek_;
+  if (pos < 0 || pos > this->header_.old_size) {
+    ESP_LOGW(TAG, "Patch seeks outside the old image");
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  }
+  this->old_pos_ = pos;
+  this->state_ = STATE_DIFF_LENGTH;
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes DeltaPatcher::copy_old_(size_t count, const uint8_t *add) {
+  if (count > this->header_.old_size - this->old_pos_) {
+    ESP_LOGW(TAG, "Patch reads past the old image");
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  }
+  while (count != 0) {
+    size_t chunk = std::min(count, OUT_SIZE - this->out_len_);
+    uint8_t *out = this->out_ + this->out_len_;
+    if (!this->backend_->read_running(this->old_pos_, out, chunk))
+      return OTA_RESPONSE_ERROR_UPDATE_END;
+    if (add != nullptr) {
+      for (size_t i = 0; i != chunk; i++)
+        out[i] += add[i];
+      add += chunk;
+    }
+    this->old_pos_ += chunk;
+    this->produced_ += chunk;
+    this->out_len_ += chunk;
+    count -= chunk;
+    if (this->out_len_ == OUT_SIZE) {
+      OTAResponseTypes error = this->flush_();
+      if (error != OTA_RESPONSE_OK)
+        return error;
+    }
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes DeltaPatcher::copy_extra_(const uint8_t *data, size_t count) {
+  while (count != 0) {
+    size_t chunk = std::min(count, OUT_SIZE - this->out_len_);
+    memcpy(this->out_ + this->out_len_, data, chunk);
+    data += chunk;
+    this->produced_ += chunk;
+    this->out_len_ += chunk;
+    count -= chunk;
+    if (this->out_len_ == OUT_SIZE) {
+      OTAResponseTypes error = this->flush_();
+      if (error != OTA_RESPONSE_OK)
+        return error;
+    }
+  }
+  return OTA_RESPONSE_OK;
+}
+
+OTAResponseTypes DeltaPatcher::flush_() {
+  if (this->out_len_ == 0)
+    return OTA_RESPONSE_OK;
+  OTAResponseTypes error = this->backend_->write(this->out_, this->out_len_);
+  this->out_len_ = 0;
+  return error;
+}
+
+OTAResponseTypes DeltaPatcher::finish() {
+  OTAResponseTypes error = this->flush_();
+  if (error != OTA_RESPONSE_OK)
+    return error;
+  if (this->produced_ != this->header_.new_size || this->state_ != STATE_DIFF_LENGTH) {
+    ESP_LOGW(TAG, "Patch ended after %" PRIu32 " of %" PRIu32 " bytes", this->produced_, this->header_.new_size);
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  }
+  return OTA_RESPONSE_OK;
+}
+
+}  // namespace ota
+}  // namespace esphome
+#endif
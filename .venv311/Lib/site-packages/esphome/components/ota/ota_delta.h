@@ -0,0 +1,90 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_OTA_DELTA
+#include "ota_backend.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace ota {
+
+static constexpr size_t DELTA_HEADER_SIZE = 32;
+
+/**
+ * Header at the start of a delta update: magic "ESPD", format version and 3 reserved bytes, the size of the new
+ * image and of the image the patch was made against (little endian), and the MD5 of the latter.
+ */
+struct DeltaHeader {
+  uint32_t new_size;
+  uint32_t old_size;
+  uint8_t old_md5[16];
+
+  /// Parse DELTA_HEADER_SIZE bytes, returns false if the magic or the format version don't match.
+  bool parse(const uint8_t *data);
+};
+
+/**
+ * @brief Rebuild a firmware image from the running one and a patch, streaming.
+ *
+ * The patch is a sequence of records in the style of bsdiff, all numbers as LEB128 varints:
+ *  - diff length, extra length, and a signed (zigzag) seek;
+ *  - the diff section: pairs of a zero run and a literal count followed by the literals, until diff length bytes
+ *    are described. Each byte of the new image is the byte at the current position of the old image, plus the
+ *    literal for that byte if there is one;
+ *  - extra length bytes that are copied to the new image as they are;
+ *  - then the position in the old image moves by the seek.
+ *
+ * Patch data can be fed in pieces of any size. The old image is read with OTABackend::read_running() and the
+ * output goes through a small buffer to OTABackend::write(), so RAM use doesn't depend on the image size.
+ */
+class DeltaPatcher {
+ public:
+  DeltaPatcher(OTABackend *backend, const DeltaHeader &header) : backend_(backend), header_(header) {}
+
+  /// Check that the running image is the one the patch was made against.
+  bool verify_base();
+  /// Apply the next part of the patch.
+  OTAResponseTypes feed(const uint8_t *data, size_t len);
+  /// Write out buffered data, returns an error if the patch didn't produce the complete image.
+  OTAResponseTypes finish();
+
+ protected:
+  enum State : uint8_t {
+    STATE_DIFF_LENGTH,
+    STATE_EXTRA_LENGTH,
+    STATE_SEEK,
+    STATE_ZERO_RUN,
+    STATE_LITERAL_COUNT,
+    STATE_LITERALS,
+    STATE_EXTRA,
+  };
+  static constexpr size_t OUT_SIZE = 512;
+
+  /// Move on to the next section of the record that still has data, or to the next record.
+  OTAResponseTypes continue_record_();
+  OTAResponseTypes end_record_();
+  /// Append count bytes of the old image, with the literals in add added if not null.
+  OTAResponseTypes copy_old_(size_t count, const uint8_t *add);
+  OTAResponseTypes copy_extra_(const uint8_t *data, size_t count);
+  OTAResponseTypes flush_();
+
+  OTABackend *backend_;
+  DeltaHeader header_;
+  State state_{STATE_DIFF_LENGTH};
+  uint32_t varint_{0};
+  uint8_t varint_shift_{0};
+  uint32_t diff_left_{0};
+  uint32_t extra_left_{0};
+  uint32_t literals_left_{0};
+  int32_t seek_{0};
+  uint32_t old_pos_{0};
+  uint32_t produced_{0};
+  size_t out_len_{0};
+  uint8_t out_[OUT_SIZE];
+};
+
+}  // namespace ota
+}  // namespace esphome
+#endif
@@ -0,0 +1,536 @@
+#include "ota_inflate.h"
+#ifdef USE_OTA_INFLATE
+
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.inflate";
+
+// Pending output is handed to the backend once there is this much, or when the window wraps
+static constexpr size_t FLUSH_SIZE = 4096;
+
+static const uint8_t GZIP_FLAG_HEADER_CRC = 1 << 1;
+static const uint8_t GZIP_FLAG_EXTRA = 1 << 2;
+static const uint8_t GZIP_FLAG_NAME = 1 << 3;
+static const uint8_t GZIP_FLAG_COMMENT = 1 << 4;
+static const uint8_t GZIP_FLAGS_RESERVED = 0xE0;
+
+static const uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                         31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                         2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t DISTANCE_BASE[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                           193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                           6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// Order in which the code lengths of the code length code are stored
+static const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+  static const uint32_t TABLE[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                     0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                     0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+  }
+  return crc;
+}
+
+InflateOTABackend::~InflateOTABackend() {
+  if (this->window_ != nullptr) {
+    RAMAllocator<uint8_t> allocator(RAMAllocator<uint8_t>::ALLOC_INTERNAL);
+    allocator.deallocate(this->window_, WINDOW_SIZE);
+  }
+}
+
+uint8_t *InflateOTABackend::allocate_window() {
+  // The window is written to flash directly, so it has to be in internal RAM like other flash write buffers
+  RAMAllocator<uint8_t> allocator(RAMAllocator<uint8_t>::ALLOC_INTERNAL);
+  return allocator.allocate(WINDOW_SIZE);
+}
+
+OTAResponseTypes InflateOTABackend::begin(size_t image_size) {
+  this->error_ = OTA_RESPONSE_OK;
+  this->state_ = STATE_GZIP_HEADER;
+  this->carry_len_ = 0;
+  this->bit_buf_ = 0;
+  this->bit_count_ = 0;
+  this->window_pos_ = 0;
+  this->flushed_ = 0;
+  this->total_out_ = 0;
+  this->crc_ = 0xFFFFFFFF;
+  this->md5_.init();
+  ESP_LOGD(TAG, "Inflating %zu bytes of compressed data", image_size);
+  // The inflated size is only known from the gzip trailer
+  return this->backend_->begin(0);
+}
+
+void InflateOTABackend::set_update_md5(const char *expected_md5) {
+  memcpy(this->expected_md5_, expected_md5, 32);
+  this->md5_set_ = true;
+}
+
+OTAResponseTypes InflateOTABackend::write(uint8_t *data, size_t len) {
+  if (this->error_ != OTA_RESPONSE_OK)
+    return this->error_;
+  this->md5_.add(data, len);
+  this->input_ = data;
+  this->input_len_ = len;
+  this->input_pos_ = 0;
+  OTAResponseTypes error = this->inflate_();
+  if (error == OTA_RESPONSE_OK && this->window_pos_ - this->flushed_ >= FLUSH_SIZE)
+    error = this->flush_();
+  this->error_ = error;
+  return error;
+}
+
+OTAResponseTypes InflateOTABackend::end() {
+  if (this->error_ != OTA_RESPONSE_OK)
+    return this->error_;
+  if (this->state_ != STATE_DONE) {
+    ESP_LOGW(TAG, "Compressed image ended after %" PRIu32 " bytes", this->total_out_);
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  }
+  if (this->md5_set_) {
+    this->md5_.calculate();
+    if (!this->md5_.equals_hex(this->expected_md5_)) {
+      this->abort();
+      return OTA_RESPONSE_ERROR_MD5_MISMATCH;
+    }
+  }
+  ESP_LOGD(TAG, "Inflated to %" PRIu32 " bytes", this->total_out_);
+  return this->backend_->end();
+}
+
+void InflateOTABackend::abort() { this->backend_->abort(); }
+
+OTAResponseTypes InflateOTABackend::inflate_() {
+  while (this->state_ != STATE_DONE) {
+    this->mark_();
+    int result = this->step_();
+    if (this->error_ != OTA_RESPONSE_OK)
+      return this->error_;
+    if (result == INVALID)
+      return OTA_RESPONSE_ERROR_UPDATE_END;
+    if (result == NEED_INPUT) {
+      // Go back to the start of the incomplete step and keep its input for the next write
+      this->input_pos_ = this->mark_pos_;
+      this->bit_buf_ = this->mark_bit_buf_;
+      this->bit_count_ = this->mark_bit_count_;
+      break;
+    }
+  }
+
+  if (this->state_ == STATE_DONE) {
+    this->carry_len_ = 0;
+    return OTA_RESPONSE_OK;
+  }
+  size_t unread = this->carry_len_ + this->input_len_ - this->input_pos_;
+  if (unread > CARRY_SIZE) {
+    ESP_LOGW(TAG, "Invalid compressed data");
+    return OTA_RESPONSE_ERROR_UPDATE_END;
+  }
+  if (this->input_pos_ < this->carry_len_) {
+    size_t carried = this->carry_len_ - this->input_pos_;
+    memmove(this->carry_, this->carry_ + this->input_pos_, carried);
+    memcpy(this->carry_ + carried, this->input_, this->input_len_);
+  } else {
+    memcpy(this->carry_, this->input_ + (this->input_pos_ - this->carry_len_), unread);
+  }
+  this->carry_len_ = unread;
+  this->input_ = nullptr;
+  this->input_len_ = 0;
+  this->input_pos_ = 0;
+  return OTA_RESPONSE_OK;
+}
+
+int InflateOTABackend::step_() {
+  switch (this->state_) {
+    case STATE_GZIP_HEADER: {
+      uint8_t header[10];
+      for (uint8_t &byte : header) {
+        if (!this->need_(8))
+          return NEED_INPUT;
+        byte = this->bits_(8);
+      }
+      // Magic and the deflate method
+      if (header[0] != 0x1F || header[1] != 0x8B || header[2] != 8 || (header[3] & GZIP_FLAGS_RESERVED) != 0) {
+        ESP_LOGW(TAG, "Not a gzip stream");
+        return INVALID;
+      }
+      this->gzip_flags_ = header[3];
+      this->next_gzip_field_();
+      return 0;
+    }
+
+    case STATE_GZIP_EXTRA_LENGTH:
+      if (!this->need_(16))
+        return NEED_INPUT;
+      this->remaining_ = this->bits_(16);
+      this->state_ = STATE_GZIP_EXTRA;
+      return 0;
+
+    case STATE_GZIP_EXTRA:
+      if (this->remaining_ != 0) {
+        if (!this->need_(8))
+          return NEED_INPUT;
+        this->bits_(8);
+        this->remaining_--;
+      } else {
+        this->next_gzip_field_();
+      }
+      return 0;
+
+    case STATE_GZIP_NAME:
+    case STATE_GZIP_COMMENT:
+      if (!this->need_(8))
+        return NEED_INPUT;
+      if (this->bits_(8) == 0)
+        this->next_gzip_field_();
+      return 0;
+
+    case STATE_GZIP_HEADER_CRC:
+      if (!this->need_(16))
+        return NEED_INPUT;
+      this->bits_(16);
+      this->next_gzip_field_();
+      return 0;
+
+    case STATE_BLOCK_HEADER:
+      return this->read_block_header_();
+
+    case STATE_STORED:
+      if (this->remaining_ == 0) {
+        this->state_ = this->final_block_ ? STATE_GZIP_TRAILER : STATE_BLOCK_HEADER;
+        return 0;
+      }
+      if (!this->need_(8))
+        return NEED_INPUT;
+      this->put_(this->bits_(8));
+      this->remaining_--;
+      return 0;
+
+    case STATE_CODES:
+      return this->inflate_codes_();
+
+    case STATE_GZIP_TRAILER: {
+      this->bits_(this->bit_count_ % 8);
+      if (!this->need_(16))
+        return NEED_INPUT;
+      uint32_t crc = this->bits_(16);
+      if (!this->need_(16))
+        return NEED_INPUT;
+      crc |= this->bits_(16) << 16;
+      if (!this->need_(16))
+        return NEED_INPUT;
+      uint32_t size = this->bits_(16);
+      if (!this->need_(16))
+        return NEED_INPUT;
+      size |= this->bits_(16) << 16;
+      if (this->flush_() != OTA_RESPONSE_OK)
+        return 0;
+      if (crc != (this->crc_ ^ 0xFFFFFFFF) || size != this->total_out_) {
+        ESP_LOGW(TAG, "Inflated image does not match the gzip trailer");
+        return INVALID;
+      }
+      this->state_ = STATE_DONE;
+      return 0;
+    }
+
+    default:
+      return INVALID;
+  }
+}
+
+void InflateOTABackend::next_gzip_field_() {
+  if ((this->gzip_flags_ & GZIP_FLAG_EXTRA) != 0) {
+    this->gzip_flags_ &= ~GZIP_FLAG_EXTRA;
+    this->state_ = STATE_GZIP_EXTRA_LENGTH;
+  } else if ((this->gzip_flags_ & GZIP_FLAG_NAME) != 0) {
+    this->gzip_flags_ &= ~GZIP_FLAG_NAME;
+    this->state_ = STATE_GZIP_NAME;
+  } else if ((this->gzip_flags_ & GZIP_FLAG_COMMENT) != 0) {
+    this->gzip_flags_ &= ~GZIP_FLAG_COMMENT;
+    this->state_ = STATE_GZIP_COMMENT;
+  } else if ((this->gzip_flags_ & GZIP_FLAG_HEADER_CRC) != 0) {
+    this->gzip_flags_ &= ~GZIP_FLAG_HEADER_CRC;
+    this->state_ = STATE_GZIP_HEADER_CRC;
+  } else {
+    this->state_ = STATE_BLOCK_HEADER;
+  }
+}
+
+int InflateOTABackend::read_block_header_() {
+  if (!this->need_(3))
+    return NEED_INPUT;
+  this->final_block_ = this->bits_(1) != 0;
+  switch (this->bits_(2)) {
+    case 0: {
+      // Stored: the length and its complement start at the next byte
+      this->bits_(this->bit_count_ % 8);
+      if (!this->need_(16))
+        return NEED_INPUT;
+      uint32_t length = this->bits_(16);
+      if (!this->need_(16))
+        return NEED_INPUT;
+      if ((this->bits_(16) ^ 0xFFFF) != length)
+        return INVALID;
+      this->remaining_ = length;
+      this->state_ = STATE_STORED;
+      return 0;
+    }
+    case 1: {
+      uint8_t lengths[MAX_LITERAL_CODES + MAX_DISTANCE_CODES];
+      memset(lengths, 8, 144);
+      memset(lengths + 144, 9, 112);
+      memset(lengths + 256, 7, 24);
+      memset(lengths + 280, 8, 8);
+      memset(lengths + MAX_LITERAL_CODES, 5, MAX_DISTANCE_CODES);
+      build_(this->literals_, lengths, MAX_LITERAL_CODES);
+      build_(this->distances_, lengths + MAX_LITERAL_CODES, MAX_DISTANCE_CODES);
+      this->state_ = STATE_CODES;
+      return 0;
+    }
+    case 2: {
+      int result = this->read_dynamic_tables_();
+      if (result == 0)
+        this->state_ = STATE_CODES;
+      return result;
+    }
+    default:
+      return INVALID;
+  }
+}
+
+int InflateOTABackend::read_dynamic_tables_() {
+  if (!this->need_(14))
+    return NEED_INPUT;
+  size_t literal_count = this->bits_(5) + 257;
+  size_t distance_count = this->bits_(5) + 1;
+  size_t code_length_count = this->bits_(4) + 4;
+  if (literal_count > 286 || distance_count > 30)
+    return INVALID;
+
+  uint8_t lengths[MAX_LITERAL_CODES + MAX_DISTANCE_CODES] = {};
+  for (size_t i = 0; i < code_length_count; i++) {
+    if (!this->need_(3))
+      return NEED_INPUT;
+    lengths[CODE_LENGTH_ORDER[i]] = this->bits_(3);
+  }
+  // The code length code is only needed here, it is kept in the literal table until the real one is built
+  if (!build_(this->literals_, lengths, 19))
+    return INVALID;
+
+  size_t count = literal_count + distance_count;
+  size_t index = 0;
+  while (index < count) {
+    int symbol = this->decode_(this->literals_);
+    if (symbol < 0)
+      return symbol;
+    if (symbol < 16) {
+      lengths[index++] = symbol;
+      continue;
+    }
+    uint8_t value = 0;
+    size_t repeat;
+    if (symbol == 16) {
+      if (index == 0)
+        return INVALID;
+      if (!this->need_(2))
+        return NEED_INPUT;
+      value = lengths[index - 1];
+      repeat = 3 + this->bits_(2);
+    } else if (symbol == 17) {
+      if (!this->need_(3))
+        return NEED_INPUT;
+      repeat = 3 + this->bits_(3);
+    } else {
+      if (!this->need_(7))
+        return NEED_INPUT;
+      repeat = 11 + this->bits_(7);
+    }
+    if (index + repeat > count)
+      return INVALID;
+    memset(lengths + index, value, repeat);
+    index += repeat;
+  }
+  // Without an end of block code the block can't end
+  if (lengths[256] == 0)
+    return INVALID;
+  if (!build_(this->literals_, lengths, literal_count) ||
+      !build_(this->distances_, lengths + literal_count, distance_count))
+    return INVALID;
+  return 0;
+}
+
+int InflateOTABackend::inflate_codes_() {
+  while (this->error_ == OTA_RESPONSE_OK) {
+    int symbol = this->decode_(this->literals_);
+    if (symbol < 0)
+      return symbol;
+    if (symbol < 256) {
+      this->put_(symbol);
+    } else if (symbol == 256) {
+      this->state_ = this->final_block_ ? STATE_GZIP_TRAILER : STATE_BLOCK_HEADER;
+      return 0;
+    } else {
+      symbol -= 257;
+      if (symbol >= 29)
+        return INVALID;
+      if (!this->need_(LENGTH_EXTRA[symbol]))
+        return NEED_INPUT;
+      size_t length = LENGTH_BASE[symbol] + this->bits_(LENGTH_EXTRA[symbol]);
+      symbol = this->decode_(this->distances_);
+      if (symbol < 0)
+        return symbol;
+      if (symbol >= 30)
+        return INVALID;
+      if (!this->need_(DISTANCE_EXTRA[symbol]))
+        return NEED_INPUT;
+      size_t distance = DISTANCE_BASE[symbol] + this->bits_(DISTANCE_EXTRA[symbol]);
+      if (distance > this->total_out_)
+        return INVALID;
+      size_t from = (this->window_pos_ - distance) & (WINDOW_SIZE - 1);
+      while (length-- != 0) {
+        this->put_(this->window_[from]);
+        from = (from + 1) & (WINDOW_SIZE - 1);
+      }
+    }
+    // The symbol is complete, an incomplete next one is retried from here
+    this->mark_();
+  }
+  return 0;
+}
+
+void InflateOTABackend::mark_() {
+  this->mark_pos_ = this->input_pos_;
+  this->mark_bit_buf_ = this->bit_buf_;
+  this->mark_bit_count_ = this->bit_count_;
+}
+
+bool InflateOTABackend::need_(uint8_t bits) {
+  while (this->bit_count_ < bits) {
+    uint8_t byte;
+    if (this->input_pos_ < this->carry_len_) {
+      byte = this->carry_[this->input_pos_];
+    } else if (this->input_pos_ - this->carry_len_ < this->input_len_) {
+      byte = this->input_[this->input_pos_ - this->carry_len_];
+    } else {
+      return false;
+    }
+    this->input_pos_++;
+    this->bit_buf_ |= static_cast<uint32_t>(byte) << this->bit_count_;
+    this->bit_count_ += 8;
+  }
+  return true;
+}
+
+uint32_t InflateOTABackend::bits_(uint8_t count) {
+  uint32_t value = this->bit_buf_ & ((1u << count) - 1);
+  this->bit_buf_ >>= count;
+  this->bit_count_ -= count;
+  return value;
+}
+
+int InflateOTABackend::decode_(const Huffman &huffman) {
+  if (this->need_(FAST_BITS)) {
+    uint16_t entry = huffman.fast[this->bit_buf_ & ((1 << FAST_BITS) - 1)];
+    if (entry != 0) {
+      this->bits_(entry & 0x0F);
+      return entry >> 4;
+    }
+  }
+  // Longer codes, or fewer bits left than FAST_BITS: walk the canonical code one bit at a time
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (uint8_t length = 1; length < 16; length++) {
+    if (!this->need_(length))
+      return NEED_INPUT;
+    code |= (this->bit_buf_ >> (length - 1)) & 1;
+    int count = huffman.counts[length];
+    if (code - count < first) {
+      this->bits_(length);
+      return huffman.symbols[index + (code - first)];
+    }
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  return INVALID;
+}
+
+bool InflateOTABackend::build_(Huffman &huffman, const uint8_t *lengths, size_t count) {
+  memset(huffman.counts, 0, sizeof(huffman.counts));
+  for (size_t i = 0; i < count; i++)
+    huffman.counts[lengths[i]]++;
+  huffman.counts[0] = 0;
+
+  // Reject codes with more symbols than code space
+  int left = 1;
+  for (uint8_t length = 1; length < 16; length++) {
+    left = (left << 1) - huffman.counts[length];
+    if (left < 0)
+      return false;
+  }
+
+  uint16_t offsets[16];
+  offsets[1] = 0;
+  for (uint8_t length = 1; length < 15; length++)
+    offsets[length + 1] = offsets[length] + huffman.counts[length];
+  for (size_t symbol = 0; symbol < count; symbol++) {
+    if (lengths[symbol] != 0)
+      huffman.symbols[offsets[lengths[symbol]]++] = symbol;
+  }
+
+  // Codes are stored starting with their most significant bit, so the table is indexed by the reversed code
+  memset(huffman.fast, 0, sizeof(huffman.fast));
+  uint32_t code = 0;
+  size_t index = 0;
+  for (uint8_t length = 1; length <= FAST_BITS; length++) {
+    for (uint16_t i = 0; i < huffman.counts[length]; i++, code++, index++) {
+      uint32_t reversed = 0;
+      for (uint8_t bit = 0; bit < length; bit++)
+        reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+      uint16_t entry = huffman.symbols[index] << 4 | length;
+      for (uint32_t slot = reversed; slot < (1u << FAST_BITS); slot += 1u << length)
+        huffman.fast[slot] = entry;
+    }
+    code <<= 1;
+  }
+  return true;
+}
+
+void InflateOTABackend::put_(uint8_t byte) {
+  this->window_[this->window_pos_++] = byte;
+  this->total_out_++;
+  if (this->window_pos_ == WINDOW_SIZE) {
+    this->error_ = this->flush_();
+    this->window_pos_ = 0;
+    this->flushed_ = 0;
+  }
+}
+
+OTAResponseTypes InflateOTABackend::flush_() {
+  if (this->window_pos_ == this->flushed_)
+    return OTA_RESPONSE_OK;
+  uint8_t *data = this->window_ + this->flushed_;
+  size_t len = this->window_pos_ - this->flushed_;
+  this->crc_ = crc32_update(this->crc_, data, len);
+  this->flushed_ = this->window_pos_;
+  OTAResponseTypes error = this->backend_->write(data, len);
+  if (error != OTA_RESPONSE_OK)
+    this->error_ = error;
+  return error;
+}
+
+}  // namespace ota
+}  // namespace esphome
+#endif
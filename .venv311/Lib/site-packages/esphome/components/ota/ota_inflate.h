@@ -0,0 +1,129 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_OTA_INFLATE
+#include "ota_backend.h"
+
+#include "esphome/components/md5/md5.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esphome {
+namespace ota {
+
+/**
+ * @brief Backend that inflates a gzip compressed image and passes it on to another backend.
+ *
+ * Decoding is streaming: input of any size is decoded as far as it goes and the rest of an incomplete symbol or
+ * block header is kept for the next write(). Output goes through the 32 KB deflate window, which is handed to the
+ * wrapped backend in large pieces, so the image itself is never buffered.
+ *
+ * The client sends the MD5 of the compressed data, which is checked here; the wrapped backend only sees the
+ * inflated image, which is checked against the CRC and size in the gzip trailer.
+ */
+class InflateOTABackend : public OTABackend {
+ public:
+  /// Takes ownership of a window from allocate_window().
+  InflateOTABackend(std::unique_ptr<OTABackend> backend, uint8_t *window)
+      : backend_(std::move(backend)), window_(window) {}
+  ~InflateOTABackend() override;
+
+  /// Allocate the decompression window, nullptr if there isn't enough memory for it.
+  static uint8_t *allocate_window();
+
+  OTAResponseTypes begin(size_t image_size) override;
+  void set_update_md5(const char *md5) override;
+  OTAResponseTypes write(uint8_t *data, size_t len) override;
+  OTAResponseTypes end() override;
+  void abort() override;
+  bool supports_compression() override { return true; }
+
+ protected:
+  static constexpr size_t WINDOW_SIZE = 32768;
+  static constexpr size_t CARRY_SIZE = 512;
+  static constexpr uint8_t FAST_BITS = 9;
+  static constexpr size_t MAX_LITERAL_CODES = 288;
+  static constexpr size_t MAX_DISTANCE_CODES = 32;
+
+  /// Canonical Huffman code, with a table that decodes codes of up to FAST_BITS bits in one lookup.
+  struct Huffman {
+    uint16_t counts[16];
+    uint16_t symbols[MAX_LITERAL_CODES];
+    /// symbol << 4 | code length, 0 for codes longer than FAST_BITS
+    uint16_t fast[1 << FAST_BITS];
+  };
+
+  enum State : uint8_t {
+    STATE_GZIP_HEADER,
+    STATE_GZIP_EXTRA_LENGTH,
+    STATE_GZIP_EXTRA,
+    STATE_GZIP_NAME,
+    STATE_GZIP_COMMENT,
+    STATE_GZIP_HEADER_CRC,
+    STATE_BLOCK_HEADER,
+    STATE_STORED,
+    STATE_CODES,
+    STATE_GZIP_TRAILER,
+    STATE_DONE,
+  };
+
+  /// Result of a step that needs more input than there is; the step is retried with the next write().
+  static constexpr int NEED_INPUT = -1;
+  static constexpr int INVALID = -2;
+
+  OTAResponseTypes inflate_();
+  int step_();
+  void next_gzip_field_();
+  int read_block_header_();
+  int read_dynamic_tables_();
+  int inflate_codes_();
+
+  /// Remember the input position as the start of the next step.
+  void mark_();
+  /// Make sure bits are available in the bit buffer, false if the input ran out.
+  bool need_(uint8_t bits);
+  uint32_t bits_(uint8_t count);
+  int decode_(const Huffman &huffman);
+  static bool build_(Huffman &huffman, const uint8_t *lengths, size_t count);
+
+  void put_(uint8_t byte);
+  OTAResponseTypes flush_();
+
+  std::unique_ptr<OTABackend> backend_;
+  md5::MD5Digest md5_{};
+  char expected_md5_[32];
+  bool md5_set_{false};
+  OTAResponseTypes error_{OTA_RESPONSE_OK};
+
+  State state_{STATE_GZIP_HEADER};
+  uint8_t gzip_flags_{0};
+  bool final_block_{false};
+  uint32_t remaining_{0};  // bytes left of a stored block or the gzip extra field
+
+  // Input is read from the carried over bytes first, then from the data of the current write()
+  uint8_t carry_[CARRY_SIZE];
+  size_t carry_len_{0};
+  const uint8_t *input_{nullptr};
+  size_t input_len_{0};
+  size_t input_pos_{0};
+  uint32_t bit_buf_{0};
+  uint8_t bit_count_{0};
+  size_t mark_pos_{0};
+  uint32_t mark_bit_buf_{0};
+  uint8_t mark_bit_count_{0};
+
+  Huffman literals_;
+  Huffman distances_;
+
+  uint8_t *window_{nullptr};
+  size_t window_pos_{0};
+  size_t flushed_{0};
+  uint32_t total_out_{0};
+  uint32_t crc_{0xFFFFFFFF};
+};
+
+}  // namespace ota
+}  // namespace esphome
+#endif
@@ -0,0 +1,135 @@
+#include "ota_pipeline.h"
+#ifdef USE_OTA_PIPELINE
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_HOST
+#include <chrono>
+#endif
+
+namespace esphome {
+namespace ota {
+
+static const char *const TAG = "ota.pipeline";
+
+#ifdef USE_ESP32
+static constexpr uint32_t TASK_STACK_SIZE = 6144;  // compressed images are inflated in the writer task
+static constexpr UBaseType_t TASK_PRIORITY = 1;
+#endif
+
+bool OTAWritePipeline::start(size_t buffer_count, size_t buffer_size) {
+  if (buffer_count < 2 || buffer_count > MAX_BUFFERS)
+    return false;
+  // Flash is written with the cache disabled, so keep the data in internal RAM
+  RAMAllocator<uint8_t> allocator(RAMAllocator<uint8_t>::ALLOC_INTERNAL);
+  this->memory_ = allocator.allocate(buffer_count * buffer_size);
+  if (this->memory_ == nullptr) {
+    ESP_LOGW(TAG, "Not enough memory for %zu receive buffers", buffer_count);
+    return false;
+  }
+  this->buffer_count_ = buffer_count;
+  this->buffer_size_ = buffer_size;
+  this->submitted_count_ = 0;
+  this->written_count_ = 0;
+  this->bytes_written_ = 0;
+  this->error_ = OTA_RESPONSE_OK;
+  this->running_ = true;
+#ifdef USE_ESP32
+  this->task_exited_ = false;
+  xTaskCreate(writer_task, "ota_writer", TASK_STACK_SIZE, this, TASK_PRIORITY, &this->task_handle_);
+  if (this->task_handle_ == nullptr) {
+    ESP_LOGW(TAG, "Failed to create writer task");
+    this->task_exited_ = true;
+    this->stop();
+    return false;
+  }
+#endif
+#ifdef USE_HOST
+  this->thread_ = std::thread(writer_task, this);
+#endif
+  ESP_LOGV(TAG, "Started with %zu buffers of %zu bytes", buffer_count, buffer_size);
+  return true;
+}
+
+void OTAWritePipeline::stop() {
+  if (!this->is_idle()) {
+    // Make the writer skip what is left
+    uint8_t expected = OTA_RESPONSE_OK;
+    this->error_.compare_exchange_strong(expected, OTA_RESPONSE_ERROR_UNKNOWN);
+  }
+  this->running_ = false;
+#ifdef USE_ESP32
+  if (this->task_handle_ != nullptr) {
+    xTaskNotifyGive(this->task_handle_);
+    while (!this->task_exited_)
+      delay(1);
+    this->task_handle_ = nullptr;
+  }
+#endif
+#ifdef USE_HOST
+  if (this->thread_.joinable())
+    this->thread_.join();
+#endif
+  if (this->memory_ != nullptr) {
+    RAMAllocator<uint8_t> allocator(RAMAllocator<uint8_t>::ALLOC_INTERNAL);
+    allocator.deallocate(this->memory_, this->buffer_count_ * this->buffer_size_);
+    this->memory_ = nullptr;
+  }
+  this->buffer_count_ = 0;
+}
+
+uint8_t *OTAWritePipeline::get_free_buffer() {
+  uint32_t submitted = this->submitted_count_.load();
+  if (this->memory_ == nullptr || submitted - this->written_count_.load() >= this->buffer_count_)
+    return nullptr;
+  return this->memory_ + (submitted % this->buffer_count_) * this->buffer_size_;
+}
+
+void OTAWritePipeline::submit(size_t len) {
+  uint32_t submitted = this->submitted_count_.load();
+  this->lengths_[submitted % this->buffer_count_] = len;
+  this->submitted_count_.store(submitted + 1);
+#ifdef USE_ESP32
+  xTaskNotifyGive(this->task_handle_);
+#endif
+}
+
+void OTAWritePipeline::write_pending_() {
+  uint32_t written = this->written_count_.load();
+  while (written != this->submitted_count_.load()) {
+    size_t index = written % this->buffer_count_;
+    if (this->error_.load() == OTA_RESPONSE_OK) {
+      OTAResponseTypes error = this->backend_->write(this->memory_ + index * this->buffer_size_, this->lengths_[index]);
+      if (error == OTA_RESPONSE_OK) {
+        this->bytes_written_ += this->lengths_[index];
+      } else {
+        this->error_ = error;
+      }
+    }
+    this->written_count_.store(++written);
+  }
+}
+
+void OTAWritePipeline::writer_task(void *arg) {
+  auto *pipeline = static_cast<OTAWritePipeline *>(arg);
+  // Drain whatever was submitted before the stop request
+  while (pipeline->running_.load() || !pipeline->is_idle()) {
+    pipeline->write_pending_();
+#ifdef USE_ESP32
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+#endif
+#ifdef USE_HOST
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+  }
+#ifdef USE_ESP32
+  pipeline->task_exited_ = true;
+  vTaskDelete(nullptr);
+#endif
+}
+
+}  // namespace ota
+}  // namespace esphome
+#endif
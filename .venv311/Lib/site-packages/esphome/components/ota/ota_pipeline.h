@@ -0,0 +1,82 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#ifdef USE_OTA_PIPELINE
+#include "ota_backend.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+#ifdef USE_HOST
+#include <thread>
+#endif
+
+namespace esphome {
+namespace ota {
+
+/**
+ * @brief A small pool of receive buffers written to the backend by a separate task.
+ *
+ * The receiving side fills a free buffer and submits it, then carries on reading the next one while the writer
+ * task programs the flash. Buffers are used in ring order: the receiving side only advances the submitted count
+ * and the writer only the written count, so two atomic counters are all the synchronization needed.
+ *
+ * Once the backend reports an error the writer stops and discards the remaining buffers; the error is then
+ * available from get_error().
+ */
+class OTAWritePipeline {
+ public:
+  static constexpr size_t MAX_BUFFERS = 4;
+
+  explicit OTAWritePipeline(OTABackend *backend) : backend_(backend) {}
+  ~OTAWritePipeline() { this->stop(); }
+
+  /// Allocate the buffers and start the writer task. Returns false if either fails.
+  bool start(size_t buffer_count, size_t buffer_size);
+  /// Wait for the writer task to finish and free the buffers. Buffers not written yet are discarded.
+  void stop();
+
+  /// The next buffer to receive into, or nullptr while all buffers are still waiting to be written.
+  uint8_t *get_free_buffer();
+  size_t get_buffer_size() const { return this->buffer_size_; }
+  /// Hand the buffer returned by get_free_buffer() to the writer, with len bytes filled.
+  void submit(size_t len);
+
+  /// True once every submitted buffer has been written or discarded.
+  bool is_idle() const { return this->written_count_.load() == this->submitted_count_.load(); }
+  /// The first error returned by the backend, OTA_RESPONSE_OK if there was none.
+  OTAResponseTypes get_error() const { return static_cast<OTAResponseTypes>(this->error_.load()); }
+  /// Number of bytes written to the backend so far.
+  size_t get_bytes_written() const { return this->bytes_written_.load(); }
+
+ protected:
+  static void writer_task(void *arg);
+  void write_pending_();
+
+  OTABackend *backend_;
+  uint8_t *memory_{nullptr};
+  size_t buffer_count_{0};
+  size_t buffer_size_{0};
+  size_t lengths_[MAX_BUFFERS]{};
+  std::atomic<uint32_t> submitted_count_{0};
+  std::atomic<uint32_t> written_count_{0};
+  std::atomic<size_t> bytes_written_{0};
+  std::atomic<uint8_t> error_{OTA_RESPONSE_OK};
+  std::atomic<bool> running_{false};
+#ifdef USE_ESP32
+  TaskHandle_t task_handle_{nullptr};
+  std::atomic<bool> task_exited_{true};
+#endif
+#ifdef USE_HOST
+  std::thread thread_;
+#endif
+};
+
+}  // namespace ota
+}  // namespace esphome
+#endif
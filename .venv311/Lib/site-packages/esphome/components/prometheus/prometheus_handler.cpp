@@ -1,12 +1,74 @@
 #include "prometheus_handler.h"
 #ifdef USE_NETWORK
 #include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace esphome {
 namespace prometheus {
 
+#ifdef USE_ARDUINO
+void ExpositionBuffer::print(const __FlashStringHelper *str) {
+  const auto *p = reinterpret_cast<const uint8_t *>(str);
+  while (uint8_t c = progmem_read_byte(p++))
+    this->data_.push_back(static_cast<char>(c));
+}
+
+void ExpositionBuffer::print(float value) {
+  // Print::print(double) uses two decimals
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.2f", value);
+  this->data_.append(buf);
+}
+
+void ExpositionBuffer::print(int value) {
+  char buf[12];
+  snprintf(buf, sizeof(buf), "%d", value);
+  this->data_.append(buf);
+}
+#else
+// AsyncResponseStream on ESP-IDF formats every number through std::to_string(float)
+void ExpositionBuffer::print(float value) { this->data_.append(to_string(value)); }
+
+void ExpositionBuffer::print(int value) { this->print(static_cast<float>(value)); }
+#endif
+
 void PrometheusHandler::handleRequest(AsyncWebServerRequest *req) {
-  AsyncResponseStream *stream = req->beginResponseStream("text/plain; version=0.0.4; charset=utf-8");
+  const uint32_t now = millis();
+  if (this->cache_ttl_ == 0 || this->buffer_ == nullptr || now - this->rendered_at_ >= this->cache_ttl_) {
+    // A response that is still being sent keeps its buffer, the new exposition goes into another one
+    if (this->buffer_ == nullptr || this->buffer_.use_count() > 1)
+      this->buffer_ = std::make_shared<ExpositionBuffer>();
+    this->render_(this->buffer_.get());
+    this->rendered_at_ = now;
+  }
+
+  // The response references the buffer instead of copying it; without caching it is freed once sent
+  std::shared_ptr<const ExpositionBuffer> buffer = this->buffer_;
+  if (this->cache_ttl_ == 0)
+    this->buffer_.reset();
+  static const char *const CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+#ifdef USE_ARDUINO
+  AsyncWebServerResponse *response =
+      req->beginResponse(CONTENT_TYPE, buffer->size(), [buffer](uint8_t *data, size_t max_len, size_t index) {
+        size_t len = std::min(max_len, buffer->size() - index);
+        memcpy(data, buffer->c_str() + index, len);
+        return len;
+      });
+  req->send(response);
+#else
+  // The response is sent before send() returns
+  AsyncWebServerResponse *response = req->beginResponse(
+      200, CONTENT_TYPE, reinterpret_cast<const uint8_t *>(buffer->c_str()), buffer->size());
+  req->send(response);
+#endif
+}
+
+void PrometheusHandler::render_(ExpositionBuffer *stream) {
+  stream->clear();
   std::string area = App.get_area();
   std::string node = App.get_name();
   std::string friendly_name = App.get_friendly_name();
@@ -95,7 +157,9 @@ void PrometheusHandler::handleRequest(AsyncWebServerRequest *req) {
     this->climate_row_(stream, obj, area, node, friendly_name);
 #endif
 
-  req->send(stream);
+#ifdef USE_RUNTIME_STATS
+  this->runtime_stats_rows_(stream, node);
+#endif
 }
 
 std::string PrometheusHandler::relabel_id_(EntityBase *obj) {
@@ -108,55 +172,57 @@ std::string PrometheusHandler::relabel_name_(EntityBase *obj) {
   return item == relabel_map_name_.end() ? obj->get_name() : item->second;
 }
 
-void PrometheusHandler::add_area_label_(AsyncResponseStream *stream, std::string &area) {
+const std::string &PrometheusHandler::entity_labels_(EntityBase *obj, std::string &area, std::string &node,
+                                                     std::string &friendly_name) {
+  auto item = this->entity_labels_cache_.find(obj);
+  if (item != this->entity_labels_cache_.end())
+    return item->second;
+
+  // Everything up to the open "name" label value; rows close it themselves
+  std::string labels = "id=\"";
+  labels += relabel_id_(obj);
   if (!area.empty()) {
-    stream->print(F("\",area=\""));
-    stream->print(area.c_str());
+    labels += "\",area=\"";
+    labels += area;
+  }
+  if (!node.empty()) {
+    labels += "\",node=\"";
+    labels += node;
+  }
+  if (!friendly_name.empty()) {
+    labels += "\",friendly_name=\"";
+    labels += friendly_name;
   }
+  labels += "\",name=\"";
+  labels += relabel_name_(obj);
+  return this->entity_labels_cache_.emplace(obj, std::move(labels)).first->second;
 }
 
-void PrometheusHandler::add_node_label_(AsyncResponseStream *stream, std::string &node) {
+void PrometheusHandler::add_node_label_(ExpositionBuffer *stream, std::string &node) {
   if (!node.empty()) {
     stream->print(F("\",node=\""));
     stream->print(node.c_str());
   }
 }
 
-void PrometheusHandler::add_friendly_name_label_(AsyncResponseStream *stream, std::string &friendly_name) {
-  if (!friendly_name.empty()) {
-    stream->print(F("\",friendly_name=\""));
-    stream->print(friendly_name.c_str());
-  }
-}
-
 // Type-specific implementation
 #ifdef USE_SENSOR
-void PrometheusHandler::sensor_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::sensor_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_sensor_value gauge\n"));
   stream->print(F("#TYPE esphome_sensor_failed gauge\n"));
 }
-void PrometheusHandler::sensor_row_(AsyncResponseStream *stream, sensor::Sensor *obj, std::string &area,
+void PrometheusHandler::sensor_row_(ExpositionBuffer *stream, sensor::Sensor *obj, std::string &area,
                                     std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (!std::isnan(obj->state)) {
     // We have a valid value, output this value
-    stream->print(F("esphome_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_sensor_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_sensor_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",unit=\""));
     stream->print(obj->get_unit_of_measurement().c_str());
     stream->print(F("\"} "));
@@ -164,13 +230,8 @@ void PrometheusHandler::sensor_row_(AsyncResponseStream *stream, sensor::Sensor
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
@@ -178,101 +239,66 @@ void PrometheusHandler::sensor_row_(AsyncResponseStream *stream, sensor::Sensor
 
 // Type-specific implementation
 #ifdef USE_BINARY_SENSOR
-void PrometheusHandler::binary_sensor_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::binary_sensor_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_binary_sensor_value gauge\n"));
   stream->print(F("#TYPE esphome_binary_sensor_failed gauge\n"));
 }
-void PrometheusHandler::binary_sensor_row_(AsyncResponseStream *stream, binary_sensor::BinarySensor *obj,
+void PrometheusHandler::binary_sensor_row_(ExpositionBuffer *stream, binary_sensor::BinarySensor *obj,
                                            std::string &area, std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (obj->has_state()) {
     // We have a valid value, output this value
-    stream->print(F("esphome_binary_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_binary_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_binary_sensor_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_binary_sensor_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->state);
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_binary_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_binary_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
 #endif
 
 #ifdef USE_FAN
-void PrometheusHandler::fan_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::fan_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_fan_value gauge\n"));
   stream->print(F("#TYPE esphome_fan_failed gauge\n"));
   stream->print(F("#TYPE esphome_fan_speed gauge\n"));
   stream->print(F("#TYPE esphome_fan_oscillation gauge\n"));
 }
-void PrometheusHandler::fan_row_(AsyncResponseStream *stream, fan::Fan *obj, std::string &area, std::string &node,
+void PrometheusHandler::fan_row_(ExpositionBuffer *stream, fan::Fan *obj, std::string &area, std::string &node,
                                  std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
-  stream->print(F("esphome_fan_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_fan_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} 0\n"));
   // Data itself
-  stream->print(F("esphome_fan_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_fan_value{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   stream->print(obj->state);
   stream->print(F("\n"));
   // Speed if available
   if (obj->get_traits().supports_speed()) {
-    stream->print(F("esphome_fan_speed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_fan_speed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->speed);
     stream->print(F("\n"));
   }
   // Oscillation if available
   if (obj->get_traits().supports_oscillation()) {
-    stream->print(F("esphome_fan_oscillation{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_fan_oscillation{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->oscillating);
     stream->print(F("\n"));
@@ -281,23 +307,18 @@ void PrometheusHandler::fan_row_(AsyncResponseStream *stream, fan::Fan *obj, std
 #endif
 
 #ifdef USE_LIGHT
-void PrometheusHandler::light_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::light_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_light_state gauge\n"));
   stream->print(F("#TYPE esphome_light_color gauge\n"));
   stream->print(F("#TYPE esphome_light_effect_active gauge\n"));
 }
-void PrometheusHandler::light_row_(AsyncResponseStream *stream, light::LightState *obj, std::string &area,
+void PrometheusHandler::light_row_(ExpositionBuffer *stream, light::LightState *obj, std::string &area,
                                    std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   // State
-  stream->print(F("esphome_light_state{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_state{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   stream->print(obj->remote_values.is_on());
   stream->print(F("\n"));
@@ -306,75 +327,40 @@ void PrometheusHandler::light_row_(AsyncResponseStream *stream, light::LightStat
   float brightness, r, g, b, w;
   color.as_brightness(&brightness);
   color.as_rgbw(&r, &g, &b, &w);
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_color{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",channel=\"brightness\"} "));
   stream->print(brightness);
   stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_color{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",channel=\"r\"} "));
   stream->print(r);
   stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_color{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",channel=\"g\"} "));
   stream->print(g);
   stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_color{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",channel=\"b\"} "));
   stream->print(b);
   stream->print(F("\n"));
-  stream->print(F("esphome_light_color{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_light_color{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",channel=\"w\"} "));
   stream->print(w);
   stream->print(F("\n"));
   // Effect
   std::string effect = obj->get_effect_name();
   if (effect == "None") {
-    stream->print(F("esphome_light_effect_active{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_light_effect_active{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",effect=\"None\"} 0\n"));
   } else {
-    stream->print(F("esphome_light_effect_active{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_light_effect_active{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",effect=\""));
     stream->print(effect.c_str());
     stream->print(F("\"} 1\n"));
@@ -383,86 +369,56 @@ void PrometheusHandler::light_row_(AsyncResponseStream *stream, light::LightStat
 #endif
 
 #ifdef USE_COVER
-void PrometheusHandler::cover_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::cover_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_cover_value gauge\n"));
   stream->print(F("#TYPE esphome_cover_failed gauge\n"));
 }
-void PrometheusHandler::cover_row_(AsyncResponseStream *stream, cover::Cover *obj, std::string &area, std::string &node,
+void PrometheusHandler::cover_row_(ExpositionBuffer *stream, cover::Cover *obj, std::string &area, std::string &node,
                                    std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (!std::isnan(obj->position)) {
     // We have a valid value, output this value
-    stream->print(F("esphome_cover_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_cover_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_cover_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_cover_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->position);
     stream->print(F("\n"));
     if (obj->get_traits().get_supports_tilt()) {
-      stream->print(F("esphome_cover_tilt{id=\""));
-      stream->print(relabel_id_(obj).c_str());
-      add_area_label_(stream, area);
-      add_node_label_(stream, node);
-      add_friendly_name_label_(stream, friendly_name);
-      stream->print(F("\",name=\""));
-      stream->print(relabel_name_(obj).c_str());
+      stream->print(F("esphome_cover_tilt{"));
+      stream->print(this->entity_labels_(obj, area, node, friendly_name));
       stream->print(F("\"} "));
       stream->print(obj->tilt);
       stream->print(F("\n"));
     }
   } else {
     // Invalid state
-    stream->print(F("esphome_cover_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_cover_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
 #endif
 
 #ifdef USE_SWITCH
-void PrometheusHandler::switch_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::switch_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_switch_value gauge\n"));
   stream->print(F("#TYPE esphome_switch_failed gauge\n"));
 }
-void PrometheusHandler::switch_row_(AsyncResponseStream *stream, switch_::Switch *obj, std::string &area,
+void PrometheusHandler::switch_row_(ExpositionBuffer *stream, switch_::Switch *obj, std::string &area,
                                     std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
-  stream->print(F("esphome_switch_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_switch_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} 0\n"));
   // Data itself
-  stream->print(F("esphome_switch_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_switch_value{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   stream->print(obj->state);
   stream->print(F("\n"));
@@ -470,30 +426,20 @@ void PrometheusHandler::switch_row_(AsyncResponseStream *stream, switch_::Switch
 #endif
 
 #ifdef USE_LOCK
-void PrometheusHandler::lock_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::lock_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_lock_value gauge\n"));
   stream->print(F("#TYPE esphome_lock_failed gauge\n"));
 }
-void PrometheusHandler::lock_row_(AsyncResponseStream *stream, lock::Lock *obj, std::string &area, std::string &node,
+void PrometheusHandler::lock_row_(ExpositionBuffer *stream, lock::Lock *obj, std::string &area, std::string &node,
                                   std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
-  stream->print(F("esphome_lock_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_lock_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} 0\n"));
   // Data itself
-  stream->print(F("esphome_lock_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_lock_value{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   stream->print(obj->state);
   stream->print(F("\n"));
@@ -502,32 +448,22 @@ void PrometheusHandler::lock_row_(AsyncResponseStream *stream, lock::Lock *obj,
 
 // Type-specific implementation
 #ifdef USE_TEXT_SENSOR
-void PrometheusHandler::text_sensor_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::text_sensor_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_text_sensor_value gauge\n"));
   stream->print(F("#TYPE esphome_text_sensor_failed gauge\n"));
 }
-void PrometheusHandler::text_sensor_row_(AsyncResponseStream *stream, text_sensor::TextSensor *obj, std::string &area,
+void PrometheusHandler::text_sensor_row_(ExpositionBuffer *stream, text_sensor::TextSensor *obj, std::string &area,
                                          std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (obj->has_state()) {
     // We have a valid value, output this value
-    stream->print(F("esphome_text_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_text_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_text_sensor_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_text_sensor_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",value=\""));
     stream->print(obj->state.c_str());
     stream->print(F("\"} "));
@@ -535,13 +471,8 @@ void PrometheusHandler::text_sensor_row_(AsyncResponseStream *stream, text_senso
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_text_sensor_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_text_sensor_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
@@ -549,76 +480,51 @@ void PrometheusHandler::text_sensor_row_(AsyncResponseStream *stream, text_senso
 
 // Type-specific implementation
 #ifdef USE_NUMBER
-void PrometheusHandler::number_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::number_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_number_value gauge\n"));
   stream->print(F("#TYPE esphome_number_failed gauge\n"));
 }
-void PrometheusHandler::number_row_(AsyncResponseStream *stream, number::Number *obj, std::string &area,
+void PrometheusHandler::number_row_(ExpositionBuffer *stream, number::Number *obj, std::string &area,
                                     std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (!std::isnan(obj->state)) {
     // We have a valid value, output this value
-    stream->print(F("esphome_number_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_number_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_number_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_number_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->state);
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_number_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_number_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
 #endif
 
 #ifdef USE_SELECT
-void PrometheusHandler::select_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::select_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_select_value gauge\n"));
   stream->print(F("#TYPE esphome_select_failed gauge\n"));
 }
-void PrometheusHandler::select_row_(AsyncResponseStream *stream, select::Select *obj, std::string &area,
+void PrometheusHandler::select_row_(ExpositionBuffer *stream, select::Select *obj, std::string &area,
                                     std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (obj->has_state()) {
     // We have a valid value, output this value
-    stream->print(F("esphome_select_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_select_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // Data itself
-    stream->print(F("esphome_select_value{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_select_value{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",value=\""));
     stream->print(obj->state.c_str());
     stream->print(F("\"} "));
@@ -626,67 +532,42 @@ void PrometheusHandler::select_row_(AsyncResponseStream *stream, select::Select
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_select_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_select_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
 #endif
 
 #ifdef USE_MEDIA_PLAYER
-void PrometheusHandler::media_player_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::media_player_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_media_player_state_value gauge\n"));
   stream->print(F("#TYPE esphome_media_player_volume gauge\n"));
   stream->print(F("#TYPE esphome_media_player_is_muted gauge\n"));
   stream->print(F("#TYPE esphome_media_player_failed gauge\n"));
 }
-void PrometheusHandler::media_player_row_(AsyncResponseStream *stream, media_player::MediaPlayer *obj,
+void PrometheusHandler::media_player_row_(ExpositionBuffer *stream, media_player::MediaPlayer *obj,
                                           std::string &area, std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
-  stream->print(F("esphome_media_player_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_media_player_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} 0\n"));
   // Data itself
-  stream->print(F("esphome_media_player_state_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_media_player_state_value{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",value=\""));
   stream->print(media_player::media_player_state_to_string(obj->state));
   stream->print(F("\"} "));
   stream->print(F("1.0"));
   stream->print(F("\n"));
-  stream->print(F("esphome_media_player_volume{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_media_player_volume{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   stream->print(obj->volume);
   stream->print(F("\n"));
-  stream->print(F("esphome_media_player_is_muted{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_media_player_is_muted{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} "));
   if (obj->is_muted()) {
     stream->print(F("1.0"));
@@ -698,13 +579,13 @@ void PrometheusHandler::media_player_row_(AsyncResponseStream *stream, media_pla
 #endif
 
 #ifdef USE_UPDATE
-void PrometheusHandler::update_entity_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::update_entity_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_update_entity_state gauge\n"));
   stream->print(F("#TYPE esphome_update_entity_info gauge\n"));
   stream->print(F("#TYPE esphome_update_entity_failed gauge\n"));
 }
 
-void PrometheusHandler::handle_update_state_(AsyncResponseStream *stream, update::UpdateState state) {
+void PrometheusHandler::handle_update_state_(ExpositionBuffer *stream, update::UpdateState state) {
   switch (state) {
     case update::UpdateState::UPDATE_STATE_UNKNOWN:
       stream->print("unknown");
@@ -724,41 +605,26 @@ void PrometheusHandler::handle_update_state_(AsyncResponseStream *stream, update
   }
 }
 
-void PrometheusHandler::update_entity_row_(AsyncResponseStream *stream, update::UpdateEntity *obj, std::string &area,
+void PrometheusHandler::update_entity_row_(ExpositionBuffer *stream, update::UpdateEntity *obj, std::string &area,
                                            std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
   if (obj->has_state()) {
     // We have a valid value, output this value
-    stream->print(F("esphome_update_entity_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_update_entity_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 0\n"));
     // First update state
-    stream->print(F("esphome_update_entity_state{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_update_entity_state{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",value=\""));
     handle_update_state_(stream, obj->state);
     stream->print(F("\"} "));
     stream->print(F("1.0"));
     stream->print(F("\n"));
     // Next update info
-    stream->print(F("esphome_update_entity_info{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_update_entity_info{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\",current_version=\""));
     stream->print(obj->update_info.current_version.c_str());
     stream->print(F("\",latest_version=\""));
@@ -770,45 +636,30 @@ void PrometheusHandler::update_entity_row_(AsyncResponseStream *stream, update::
     stream->print(F("\n"));
   } else {
     // Invalid state
-    stream->print(F("esphome_update_entity_failed{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_update_entity_failed{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} 1\n"));
   }
 }
 #endif
 
 #ifdef USE_VALVE
-void PrometheusHandler::valve_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::valve_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_valve_operation gauge\n"));
   stream->print(F("#TYPE esphome_valve_failed gauge\n"));
   stream->print(F("#TYPE esphome_valve_position gauge\n"));
 }
 
-void PrometheusHandler::valve_row_(AsyncResponseStream *stream, valve::Valve *obj, std::string &area, std::string &node,
+void PrometheusHandler::valve_row_(ExpositionBuffer *stream, valve::Valve *obj, std::string &area, std::string &node,
                                    std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
-  stream->print(F("esphome_valve_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_valve_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\"} 0\n"));
   // Data itself
-  stream->print(F("esphome_valve_operation{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_valve_operation{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",operation=\""));
   stream->print(valve::valve_operation_to_str(obj->current_operation));
   stream->print(F("\"} "));
@@ -816,13 +667,8 @@ void PrometheusHandler::valve_row_(AsyncResponseStream *stream, valve::Valve *ob
   stream->print(F("\n"));
   // Now see if position is supported
   if (obj->get_traits().get_supports_position()) {
-    stream->print(F("esphome_valve_position{id=\""));
-    stream->print(relabel_id_(obj).c_str());
-    add_area_label_(stream, area);
-    add_node_label_(stream, node);
-    add_friendly_name_label_(stream, friendly_name);
-    stream->print(F("\",name=\""));
-    stream->print(relabel_name_(obj).c_str());
+    stream->print(F("esphome_valve_position{"));
+    stream->print(this->entity_labels_(obj, area, node, friendly_name));
     stream->print(F("\"} "));
     stream->print(obj->position);
     stream->print(F("\n"));
@@ -831,22 +677,17 @@ void PrometheusHandler::valve_row_(AsyncResponseStream *stream, valve::Valve *ob
 #endif
 
 #ifdef USE_CLIMATE
-void PrometheusHandler::climate_type_(AsyncResponseStream *stream) {
+void PrometheusHandler::climate_type_(ExpositionBuffer *stream) {
   stream->print(F("#TYPE esphome_climate_setting gauge\n"));
   stream->print(F("#TYPE esphome_climate_value gauge\n"));
   stream->print(F("#TYPE esphome_climate_failed gauge\n"));
 }
 
-void PrometheusHandler::climate_setting_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area,
+void PrometheusHandler::climate_setting_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area,
                                              std::string &node, std::string &friendly_name, std::string &setting,
                                              const LogString *setting_value) {
-  stream->print(F("esphome_climate_setting{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_climate_setting{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",category=\""));
   stream->print(setting.c_str());
   stream->print(F("\",setting_value=\""));
@@ -856,16 +697,11 @@ void PrometheusHandler::climate_setting_row_(AsyncResponseStream *stream, climat
   stream->print(F("\n"));
 }
 
-void PrometheusHandler::climate_value_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area,
+void PrometheusHandler::climate_value_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area,
                                            std::string &node, std::string &friendly_name, std::string &category,
                                            std::string &climate_value) {
-  stream->print(F("esphome_climate_value{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_climate_value{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",category=\""));
   stream->print(category.c_str());
   stream->print(F("\"} "));
@@ -873,16 +709,11 @@ void PrometheusHandler::climate_value_row_(AsyncResponseStream *stream, climate:
   stream->print(F("\n"));
 }
 
-void PrometheusHandler::climate_failed_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area,
+void PrometheusHandler::climate_failed_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area,
                                             std::string &node, std::string &friendly_name, std::string &category,
                                             bool is_failed_value) {
-  stream->print(F("esphome_climate_failed{id=\""));
-  stream->print(relabel_id_(obj).c_str());
-  add_area_label_(stream, area);
-  add_node_label_(stream, node);
-  add_friendly_name_label_(stream, friendly_name);
-  stream->print(F("\",name=\""));
-  stream->print(relabel_name_(obj).c_str());
+  stream->print(F("esphome_climate_failed{"));
+  stream->print(this->entity_labels_(obj, area, node, friendly_name));
   stream->print(F("\",category=\""));
   stream->print(category.c_str());
   stream->print(F("\"} "));
@@ -894,7 +725,7 @@ void PrometheusHandler::climate_failed_row_(AsyncResponseStream *stream, climate
   stream->print(F("\n"));
 }
 
-void PrometheusHandler::climate_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area,
+void PrometheusHandler::climate_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area,
                                      std::string &node, std::string &friendly_name) {
   if (obj->is_internal() && !this->include_internal_)
     return;
@@ -998,6 +829,55 @@ void PrometheusHandler::climate_row_(AsyncResponseStream *stream, climate::Clima
 }
 #endif
 
+#ifdef USE_RUNTIME_STATS
+void PrometheusHandler::runtime_stats_rows_(ExpositionBuffer *stream, std::string &node) {
+  if (global_runtime_stats == nullptr)
+    return;
+  stream->print(F("#TYPE esphome_component_runtime_us histogram\n"));
+  for (const auto &it : global_runtime_stats->get_component_stats()) {
+    const auto &stats = it.second;
+    const auto &hist = stats.get_total_histogram();
+    const char *source = runtime_stats::source_to_string(it.first.source);
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < runtime_stats::HISTOGRAM_BUCKETS; i++) {
+      cumulative += hist.get_bucket(i);
+      stream->print(F("esphome_component_runtime_us_bucket{component=\""));
+      stream->print(it.first.name);
+      add_node_label_(stream, node);
+      stream->print(F("\",source=\""));
+      stream->print(source);
+      stream->print(F("\",le=\""));
+      if (i < runtime_stats::HISTOGRAM_BUCKETS - 1) {
+        // Buckets are exclusive on the upper bound, durations are whole microseconds
+        uint32_t le = runtime_stats::LatencyHistogram<uint32_t>::bucket_upper_bound_us(i) - 1;
+        stream->print(std::to_string(le).c_str());
+      } else {
+        stream->print(F("+Inf"));
+      }
+      stream->print(F("\"} "));
+      stream->print(std::to_string(cumulative).c_str());
+      stream->print(F("\n"));
+    }
+    stream->print(F("esphome_component_runtime_us_sum{component=\""));
+    stream->print(it.first.name);
+    add_node_label_(stream, node);
+    stream->print(F("\",source=\""));
+    stream->print(source);
+    stream->print(F("\"} "));
+    stream->print(std::to_string(stats.get_total_time_us()).c_str());
+    stream->print(F("\n"));
+    stream->print(F("esphome_component_runtime_us_count{component=\""));
+    stream->print(it.first.name);
+    add_node_label_(stream, node);
+    stream->print(F("\",source=\""));
+    stream->print(source);
+    stream->print(F("\"} "));
+    stream->print(std::to_string(stats.get_total_count()).c_str());
+    stream->print(F("\n"));
+  }
+}
+#endif
+
 }  // namespace prometheus
 }  // namespace esphome
 #endif
@@ -2,12 +2,17 @@
 #include "esphome/core/defines.h"
 #ifdef USE_NETWORK
 #include <map>
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "esphome/components/web_server_base/web_server_base.h"
 #include "esphome/core/component.h"
 #include "esphome/core/controller.h"
 #include "esphome/core/entity_base.h"
+#ifdef USE_RUNTIME_STATS
+#include "esphome/components/runtime_stats/runtime_stats.h"
+#endif
 #ifdef USE_CLIMATE
 #include "esphome/core/log.h"
 #endif
@@ -15,6 +20,30 @@
 namespace esphome {
 namespace prometheus {
 
+/** Reusable text buffer the exposition is rendered into.
+ *
+ * It mirrors the print() overloads of AsyncResponseStream, so the output is byte-for-byte what streaming
+ * directly would produce, but it can be served again while cached and is sent without copying it into a stream.
+ */
+class ExpositionBuffer {
+ public:
+  void clear() { this->data_.clear(); }
+  bool empty() const { return this->data_.empty(); }
+  const char *c_str() const { return this->data_.c_str(); }
+  size_t size() const { return this->data_.size(); }
+
+  void print(const char *str) { this->data_.append(str); }
+  void print(const std::string &str) { this->data_.append(str); }
+#ifdef USE_ARDUINO
+  void print(const __FlashStringHelper *str);
+#endif
+  void print(float value);
+  void print(int value);
+
+ protected:
+  std::string data_;
+};
+
 class PrometheusHandler : public AsyncWebHandler, public Component {
  public:
   PrometheusHandler(web_server_base::WebServerBase *base) : base_(base) {}
@@ -40,6 +69,13 @@ class PrometheusHandler : public AsyncWebHandler, public Component {
    */
   void add_label_name(EntityBase *obj, const std::string &value) { relabel_map_name_.insert({obj, value}); }
 
+  /** Serve the previously rendered exposition for scrapes arriving within this time.
+   * Defaults to 0, which renders every scrape.
+   *
+   * @param cache_ttl The cache lifetime in milliseconds.
+   */
+  void set_cache_ttl(uint32_t cache_ttl) { this->cache_ttl_ = cache_ttl; }
+
   bool canHandle(AsyncWebServerRequest *request) const override {
     if (request->method() == HTTP_GET) {
       if (request->url() == "/metrics")
@@ -61,135 +97,148 @@ class PrometheusHandler : public AsyncWebHandler, public Component {
   }
 
  protected:
+  /// Render the complete exposition into stream
+  void render_(ExpositionBuffer *stream);
+
   std::string relabel_id_(EntityBase *obj);
   std::string relabel_name_(EntityBase *obj);
-  void add_area_label_(AsyncResponseStream *stream, std::string &area);
-  void add_node_label_(AsyncResponseStream *stream, std::string &node);
-  void add_friendly_name_label_(AsyncResponseStream *stream, std::string &friendly_name);
+  /// Return the static label text of an entity up to the open "name" value, built on first use
+  const std::string &entity_labels_(EntityBase *obj, std::string &area, std::string &node,
+                                    std::string &friendly_name);
+  void add_node_label_(ExpositionBuffer *stream, std::string &node);
 
 #ifdef USE_SENSOR
   /// Return the type for prometheus
-  void sensor_type_(AsyncResponseStream *stream);
+  void sensor_type_(ExpositionBuffer *stream);
   /// Return the sensor state as prometheus data point
-  void sensor_row_(AsyncResponseStream *stream, sensor::Sensor *obj, std::string &area, std::string &node,
+  void sensor_row_(ExpositionBuffer *stream, sensor::Sensor *obj, std::string &area, std::string &node,
                    std::string &friendly_name);
 #endif
 
 #ifdef USE_BINARY_SENSOR
   /// Return the type for prometheus
-  void binary_sensor_type_(AsyncResponseStream *stream);
+  void binary_sensor_type_(ExpositionBuffer *stream);
   /// Return the binary sensor state as prometheus data point
-  void binary_sensor_row_(AsyncResponseStream *stream, binary_sensor::BinarySensor *obj, std::string &area,
+  void binary_sensor_row_(ExpositionBuffer *stream, binary_sensor::BinarySensor *obj, std::string &area,
                           std::string &node, std::string &friendly_name);
 #endif
 
 #ifdef USE_FAN
   /// Return the type for prometheus
-  void fan_type_(AsyncResponseStream *stream);
+  void fan_type_(ExpositionBuffer *stream);
   /// Return the fan state as prometheus data point
-  void fan_row_(AsyncResponseStream *stream, fan::Fan *obj, std::string &area, std::string &node,
+  void fan_row_(ExpositionBuffer *stream, fan::Fan *obj, std::string &area, std::string &node,
                 std::string &friendly_name);
 #endif
 
 #ifdef USE_LIGHT
   /// Return the type for prometheus
-  void light_type_(AsyncResponseStream *stream);
+  void light_type_(ExpositionBuffer *stream);
   /// Return the light values state as prometheus data point
-  void light_row_(AsyncResponseStream *stream, light::LightState *obj, std::string &area, std::string &node,
+  void light_row_(ExpositionBuffer *stream, light::LightState *obj, std::string &area, std::string &node,
                   std::string &friendly_name);
 #endif
 
 #ifdef USE_COVER
   /// Return the type for prometheus
-  void cover_type_(AsyncResponseStream *stream);
+  void cover_type_(ExpositionBuffer *stream);
   /// Return the cover values state as prometheus data point
-  void cover_row_(AsyncResponseStream *stream, cover::Cover *obj, std::string &area, std::string &node,
+  void cover_row_(ExpositionBuffer *stream, cover::Cover *obj, std::string &area, std::string &node,
                   std::string &friendly_name);
 #endif
 
 #ifdef USE_SWITCH
   /// Return the type for prometheus
-  void switch_type_(AsyncResponseStream *stream);
+  void switch_type_(ExpositionBuffer *stream);
   /// Return the switch values state as prometheus data point
-  void switch_row_(AsyncResponseStream *stream, switch_::Switch *obj, std::string &area, std::string &node,
+  void switch_row_(ExpositionBuffer *stream, switch_::Switch *obj, std::string &area, std::string &node,
                    std::string &friendly_name);
 #endif
 
 #ifdef USE_LOCK
   /// Return the type for prometheus
-  void lock_type_(AsyncResponseStream *stream);
+  void lock_type_(ExpositionBuffer *stream);
   /// Return the lock values state as prometheus data point
-  void lock_row_(AsyncResponseStream *stream, lock::Lock *obj, std::string &area, std::string &node,
+  void lock_row_(ExpositionBuffer *stream, lock::Lock *obj, std::string &area, std::string &node,
                  std::string &friendly_name);
 #endif
 
 #ifdef USE_TEXT_SENSOR
   /// Return the type for prometheus
-  void text_sensor_type_(AsyncResponseStream *stream);
+  void text_sensor_type_(ExpositionBuffer *stream);
   /// Return the text sensor values state as prometheus data point
-  void text_sensor_row_(AsyncResponseStream *stream, text_sensor::TextSensor *obj, std::string &area, std::string &node,
+  void text_sensor_row_(ExpositionBuffer *stream, text_sensor::TextSensor *obj, std::string &area, std::string &node,
                         std::string &friendly_name);
 #endif
 
 #ifdef USE_NUMBER
   /// Return the type for prometheus
-  void number_type_(AsyncResponseStream *stream);
+  void number_type_(ExpositionBuffer *stream);
   /// Return the number state as prometheus data point
-  void number_row_(AsyncResponseStream *stream, number::Number *obj, std::string &area, std::string &node,
+  void number_row_(ExpositionBuffer *stream, number::Number *obj, std::string &area, std::string &node,
                    std::string &friendly_name);
 #endif
 
 #ifdef USE_SELECT
   /// Return the type for prometheus
-  void select_type_(AsyncResponseStream *stream);
+  void select_type_(ExpositionBuffer *stream);
   /// Return the select state as prometheus data point
-  void select_row_(AsyncResponseStream *stream, select::Select *obj, std::string &area, std::string &node,
+  void select_row_(ExpositionBuffer *stream, select::Select *obj, std::string &area, std::string &node,
                    std::string &friendly_name);
 #endif
 
 #ifdef USE_MEDIA_PLAYER
   /// Return the type for prometheus
-  void media_player_type_(AsyncResponseStream *stream);
+  void media_player_type_(ExpositionBuffer *stream);
   /// Return the media player state as prometheus data point
-  void media_player_row_(AsyncResponseStream *stream, media_player::MediaPlayer *obj, std::string &area,
+  void media_player_row_(ExpositionBuffer *stream, media_player::MediaPlayer *obj, std::string &area,
                          std::string &node, std::string &friendly_name);
 #endif
 
 #ifdef USE_UPDATE
   /// Return the type for prometheus
-  void update_entity_type_(AsyncResponseStream *stream);
+  void update_entity_type_(ExpositionBuffer *stream);
   /// Return the update state and info as prometheus data point
-  void update_entity_row_(AsyncResponseStream *stream, update::UpdateEntity *obj, std::string &area, std::string &node,
+  void update_entity_row_(ExpositionBuffer *stream, update::UpdateEntity *obj, std::string &area, std::string &node,
                           std::string &friendly_name);
-  void handle_update_state_(AsyncResponseStream *stream, update::UpdateState state);
+  void handle_update_state_(ExpositionBuffer *stream, update::UpdateState state);
 #endif
 
 #ifdef USE_VALVE
   /// Return the type for prometheus
-  void valve_type_(AsyncResponseStream *stream);
+  void valve_type_(ExpositionBuffer *stream);
   /// Return the valve state as prometheus data point
-  void valve_row_(AsyncResponseStream *stream, valve::Valve *obj, std::string &area, std::string &node,
+  void valve_row_(ExpositionBuffer *stream, valve::Valve *obj, std::string &area, std::string &node,
                   std::string &friendly_name);
 #endif
 
 #ifdef USE_CLIMATE
   /// Return the type for prometheus
-  void climate_type_(AsyncResponseStream *stream);
+  void climate_type_(ExpositionBuffer *stream);
   /// Return the climate state as prometheus data point
-  void climate_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area, std::string &node,
+  void climate_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area, std::string &node,
                     std::string &friendly_name);
-  void climate_failed_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area, std::string &node,
+  void climate_failed_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area, std::string &node,
                            std::string &friendly_name, std::string &category, bool is_failed_value);
-  void climate_setting_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area, std::string &node,
+  void climate_setting_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area, std::string &node,
                             std::string &friendly_name, std::string &setting, const LogString *setting_value);
-  void climate_value_row_(AsyncResponseStream *stream, climate::Climate *obj, std::string &area, std::string &node,
+  void climate_value_row_(ExpositionBuffer *stream, climate::Climate *obj, std::string &area, std::string &node,
                           std::string &friendly_name, std::string &category, std::string &climate_value);
 #endif
 
+#ifdef USE_RUNTIME_STATS
+  /// Return the per-component runtime latency histograms as prometheus histograms
+  void runtime_stats_rows_(ExpositionBuffer *stream, std::string &node);
+#endif
+
   web_server_base::WebServerBase *base_;
   bool include_internal_{false};
   std::map<EntityBase *, std::string> relabel_map_id_;
   std::map<EntityBase *, std::string> relabel_map_name_;
+  std::map<EntityBase *, std::string> entity_labels_cache_;
+  std::shared_ptr<ExpositionBuffer> buffer_;
+  uint32_t cache_ttl_{0};
+  uint32_t rendered_at_{0};
 };
 
 }  // namespace prometheus
@@ -8,6 +8,11 @@ namespace remote_base {
 
 static const char *const TAG = "remote_base";
 
+RemoteDecodeStats global_remote_decode_stats;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+/// Frame ids are unique over all receivers; 0 is never used, it means no id.
+static uint32_t last_frame_id = 0;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
 /* RemoteReceiveData */
 
 bool RemoteReceiveData::peek_mark(uint32_t length, uint32_t offset) const {
@@ -109,21 +114,41 @@ void RemoteReceiverBase::register_dumper(RemoteReceiverDumperBase *dumper) {
   }
 }
 
-void RemoteReceiverBase::call_listeners_() {
-  for (auto *listener : this->listeners_)
-    listener->on_receive(RemoteReceiveData(this->temp_, this->tolerance_, this->tolerance_mode_));
+bool RemoteReceiverBase::call_listeners_() {
+  bool success = false;
+  for (auto *listener : this->listeners_) {
+    if (listener->on_receive(this->frame_data_()))
+      success = true;
+  }
+  return success;
 }
 
-void RemoteReceiverBase::call_dumpers_() {
+bool RemoteReceiverBase::call_dumpers_() {
   bool success = false;
   for (auto *dumper : this->dumpers_) {
-    if (dumper->dump(RemoteReceiveData(this->temp_, this->tolerance_, this->tolerance_mode_)))
+    if (dumper->dump(this->frame_data_()))
       success = true;
   }
   if (!success) {
     for (auto *dumper : this->secondary_dumpers_)
-      dumper->dump(RemoteReceiveData(this->temp_, this->tolerance_, this->tolerance_mode_));
+      dumper->dump(this->frame_data_());
   }
+  return success;
+}
+
+void RemoteReceiverBase::call_listeners_dumpers_() {
+  if (++last_frame_id == 0)
+    last_frame_id = 1;
+  this->frame_id_ = last_frame_id;
+  this->frame_count_++;
+  // Listeners and dumpers of the same protocol share the decode result, see decode_frame()
+  bool matched = this->call_listeners_();
+  if (this->call_dumpers_())
+    matched = true;
+  if (matched)
+    this->matched_frame_count_++;
+  ESP_LOGV(TAG, "Frame %" PRIu32 " with %zu timings %s", this->frame_id_, this->temp_.size(),
+           matched ? "recognized" : "not recognized");
 }
 
 void RemoteReceiverBinarySensorBase::dump_config() { LOG_BINARY_SENSOR("", "Remote Receiver Binary Sensor", this); }
@@ -43,10 +43,17 @@ class RemoteTransmitData {
 
 class RemoteReceiveData {
  public:
-  explicit RemoteReceiveData(const RawTimings &data, uint32_t tolerance, ToleranceMode tolerance_mode)
-      : data_(data), index_(0), tolerance_(tolerance), tolerance_mode_(tolerance_mode) {}
+  /** Data of a received frame.
+   *
+   * frame_id identifies the frame, so that decode results can be shared by all listeners and dumpers of a receiver;
+   * 0 means the data is not from a receiver and is always decoded anew.
+   */
+  explicit RemoteReceiveData(const RawTimings &data, uint32_t tolerance, ToleranceMode tolerance_mode,
+                             uint32_t frame_id = 0)
+      : data_(data), index_(0), tolerance_(tolerance), tolerance_mode_(tolerance_mode), frame_id_(frame_id) {}
 
   const RawTimings &get_raw_data() const { return this->data_; }
+  uint32_t get_frame_id() const { return this->frame_id_; }
   uint32_t get_index() const { return index_; }
   int32_t operator[](uint32_t index) const { return this->data_[index]; }
   int32_t size() const { return this->data_.size(); }
@@ -98,6 +105,7 @@ class RemoteReceiveData {
   uint32_t index_;
   uint32_t tolerance_;
   ToleranceMode tolerance_mode_;
+  uint32_t frame_id_;
 };
 
 class RemoteComponentBase {
@@ -179,6 +187,13 @@ class RemoteReceiverDumperBase {
   virtual bool is_secondary() { return false; }
 };
 
+/// Counts of protocol decodes over all receivers, see decode_frame().
+struct RemoteDecodeStats {
+  uint32_t decoded{0};  ///< Frames that were decoded by a protocol.
+  uint32_t reused{0};   ///< Decodes answered with the result another listener or dumper got for the same frame.
+};
+extern RemoteDecodeStats global_remote_decode_stats;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
 class RemoteReceiverBase : public RemoteComponentBase {
  public:
   RemoteReceiverBase(InternalGPIOPin *pin) : RemoteComponentBase(pin) {}
@@ -189,12 +204,19 @@ class RemoteReceiverBase : public RemoteComponentBase {
     this->tolerance_mode_ = tolerance_mode;
   }
 
+  /// The number of frames received.
+  uint32_t get_frame_count() const { return this->frame_count_; }
+  /// The number of received frames at least one listener or dumper recognized.
+  uint32_t get_matched_frame_count() const { return this->matched_frame_count_; }
+
  protected:
-  void call_listeners_();
-  void call_dumpers_();
-  void call_listeners_dumpers_() {
-    this->call_listeners_();
-    this->call_dumpers_();
+  /// Returns true if a listener recognized the frame.
+  bool call_listeners_();
+  /// Returns true if a dumper other than the secondary ones recognized the frame.
+  bool call_dumpers_();
+  void call_listeners_dumpers_();
+  RemoteReceiveData frame_data_() const {
+    return RemoteReceiveData(this->temp_, this->tolerance_, this->tolerance_mode_, this->frame_id_);
   }
 
   std::vector<RemoteReceiverListener *> listeners_;
@@ -203,6 +225,9 @@ class RemoteReceiverBase : public RemoteComponentBase {
   RawTimings temp_;
   uint32_t tolerance_{25};
   ToleranceMode tolerance_mode_{TOLERANCE_MODE_PERCENTAGE};
+  uint32_t frame_id_{0};
+  uint32_t frame_count_{0};
+  uint32_t matched_frame_count_{0};
 };
 
 class RemoteReceiverBinarySensorBase : public binary_sensor::BinarySensorInitiallyOff,
@@ -225,14 +250,31 @@ template<typename T> class RemoteProtocol {
   virtual void dump(const ProtocolData &data) = 0;
 };
 
+/** Decode a frame with protocol T.
+ *
+ * Binary sensors, triggers and the dumper of a protocol all decode the same frame; the result of the first one is
+ * kept and returned to the others, so each frame is decoded at most once per protocol.
+ */
+template<typename T> const optional<typename T::ProtocolData> &decode_frame(RemoteReceiveData src) {
+  static uint32_t frame_id = 0;
+  static optional<typename T::ProtocolData> result;
+  if (src.get_frame_id() != 0 && src.get_frame_id() == frame_id) {
+    global_remote_decode_stats.reused++;
+    return result;
+  }
+  result = T().decode(src);
+  frame_id = src.get_frame_id();
+  global_remote_decode_stats.decoded++;
+  return result;
+}
+
 template<typename T> class RemoteReceiverBinarySensor : public RemoteReceiverBinarySensorBase {
  public:
   RemoteReceiverBinarySensor() : RemoteReceiverBinarySensorBase() {}
 
  protected:
   bool matches(RemoteReceiveData src) override {
-    auto proto = T();
-    auto res = proto.decode(src);
+    const auto &res = decode_frame<T>(src);
     return res.has_value() && *res == this->data_;
   }
 
@@ -247,8 +289,7 @@ template<typename T>
 class RemoteReceiverTrigger : public Trigger<typename T::ProtocolData>, public RemoteReceiverListener {
  protected:
   bool on_receive(RemoteReceiveData src) override {
-    auto proto = T();
-    auto res = proto.decode(src);
+    const auto &res = decode_frame<T>(src);
     if (res.has_value()) {
       this->trigger(*res);
       return true;
@@ -289,11 +330,10 @@ template<typename... Ts> class RemoteTransmitterActionBase : public RemoteTransm
 template<typename T> class RemoteReceiverDumper : public RemoteReceiverDumperBase {
  public:
   bool dump(RemoteReceiveData src) override {
-    auto proto = T();
-    auto decoded = proto.decode(src);
+    const auto &decoded = decode_frame<T>(src);
     if (!decoded.has_value())
       return false;
-    proto.dump(*decoded);
+    T().dump(*decoded);
     return true;
   }
 };
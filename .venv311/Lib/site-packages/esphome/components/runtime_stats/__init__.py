@@ -3,23 +3,41 @@ Runtime statistics component for ESPHome.
 """
 
 import esphome.codegen as cg
+from esphome.components import api
 import esphome.config_validation as cv
 from esphome.const import CONF_ID
 
 CODEOWNERS = ["@bdraco"]
 
+CONF_API_ID = "api_id"
+CONF_API_SERVICE = "api_service"
 CONF_LOG_INTERVAL = "log_interval"
+CONF_SERVICE_ID = "service_id"
 
 runtime_stats_ns = cg.esphome_ns.namespace("runtime_stats")
 RuntimeStatsCollector = runtime_stats_ns.class_("RuntimeStatsCollector")
-
-CONFIG_SCHEMA = cv.Schema(
-    {
-        cv.GenerateID(): cv.declare_id(RuntimeStatsCollector),
-        cv.Optional(
-            CONF_LOG_INTERVAL, default="60s"
-        ): cv.positive_time_period_milliseconds,
-    }
+RuntimeStatsDumpService = runtime_stats_ns.class_("RuntimeStatsDumpService")
+
+
+def _validate_api_service(config):
+    if config[CONF_API_SERVICE] and CONF_API_ID not in config:
+        raise cv.Invalid(f"'{CONF_API_SERVICE}' requires the 'api' component")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(RuntimeStatsCollector),
+            cv.GenerateID(CONF_SERVICE_ID): cv.declare_id(RuntimeStatsDumpService),
+            cv.OnlyWith(CONF_API_ID, "api"): cv.use_id(api.APIServer),
+            cv.Optional(
+                CONF_LOG_INTERVAL, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_API_SERVICE, default=False): cv.boolean,
+        }
+    ),
+    _validate_api_service,
 )
 
 
@@ -32,3 +50,10 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
 
     cg.add(var.set_log_interval(config[CONF_LOG_INTERVAL]))
+
+    if config[CONF_API_SERVICE]:
+        # Expose a "runtime_stats_dump" native API action that logs the latency histograms
+        cg.add_define("USE_API_SERVICES")
+        api_server = await cg.get_variable(config[CONF_API_ID])
+        service = cg.new_Pvariable(config[CONF_SERVICE_ID], var)
+        cg.add(api_server.register_user_service(service))
@@ -4,29 +4,57 @@
 
 #include "esphome/core/component.h"
 #include <algorithm>
+#include <cinttypes>
+#include <cstdio>
 
 namespace esphome {
 
 namespace runtime_stats {
 
+const char *source_to_string(BlockingSource source) {
+  switch (source) {
+    case BlockingSource::LOOP:
+      return "loop";
+    case BlockingSource::SCHEDULER:
+      return "scheduler";
+    case BlockingSource::DEFER:
+      return "defer";
+    default:
+      return "unknown";
+  }
+}
+
+/// Formats a percentile as "<1024us", or as ">=262144us" when it falls in the overflow bucket.
+template<typename T> static void format_percentile(char *buf, size_t size, const LatencyHistogram<T> &hist,
+                                                   uint16_t permille) {
+  uint32_t bound = hist.percentile_us(permille);
+  if (bound == UINT32_MAX) {
+    snprintf(buf, size, ">=%" PRIu32 "us", LatencyHistogram<T>::bucket_upper_bound_us(HISTOGRAM_BUCKETS - 2));
+  } else {
+    snprintf(buf, size, "<%" PRIu32 "us", bound);
+  }
+}
+
 RuntimeStatsCollector::RuntimeStatsCollector() : log_interval_(60000), next_log_time_(0) {
   global_runtime_stats = this;
 }
 
-void RuntimeStatsCollector::record_component_time(Component *component, uint32_t duration_ms, uint32_t current_time) {
+void RuntimeStatsCollector::record_component_time(Component *component, BlockingSource source, uint32_t duration_us,
+                                                  uint32_t current_time) {
   if (component == nullptr)
     return;
 
   // Check if we have cached the name for this component
+  const char *name;
   auto name_it = this->component_names_cache_.find(component);
   if (name_it == this->component_names_cache_.end()) {
     // First time seeing this component, cache its name
-    const char *source = component->get_component_source();
-    this->component_names_cache_[component] = source;
-    this->component_stats_[source].record_time(duration_ms);
+    name = component->get_component_source();
+    this->component_names_cache_[component] = name;
   } else {
-    this->component_stats_[name_it->second].record_time(duration_ms);
+    name = name_it->second;
   }
+  this->component_stats_[ComponentStatKey{name, source}].record_time(duration_us);
 
   if (this->next_log_time_ == 0) {
     this->next_log_time_ = current_time + this->log_interval_;
@@ -54,12 +82,16 @@ void RuntimeStatsCollector::log_stats_() {
 
   // Log top components by period runtime
   for (const auto &it : stats_to_display) {
-    const char *source = it.name;
     const ComponentRuntimeStats *stats = it.stats;
+    const LatencyHistogram<uint16_t> &hist = stats->get_period_histogram();
 
-    ESP_LOGI(TAG, "  %s: count=%" PRIu32 ", avg=%.2fms, max=%" PRIu32 "ms, total=%" PRIu32 "ms", source,
-             stats->get_period_count(), stats->get_period_avg_time_ms(), stats->get_period_max_time_ms(),
-             stats->get_period_time_ms());
+    char p50[16], p99[16];
+    format_percentile(p50, sizeof(p50), hist, 500);
+    format_percentile(p99, sizeof(p99), hist, 990);
+
+    ESP_LOGI(TAG, "  %s [%s]: count=%" PRIu32 ", avg=%.1fus, p50%s, p99%s, max=%" PRIu32 "us, total=%" PRIu32 "ms",
+             it.key.name, source_to_string(it.key.source), stats->get_period_count(), stats->get_period_avg_time_us(),
+             p50, p99, stats->get_period_max_time_us(), stats->get_period_time_ms());
   }
 
   // Log total stats since boot
@@ -68,16 +100,48 @@ void RuntimeStatsCollector::log_stats_() {
   // Re-sort by total runtime for all-time stats
   std::sort(stats_to_display.begin(), stats_to_display.end(),
             [](const ComponentStatPair &a, const ComponentStatPair &b) {
-              return a.stats->get_total_time_ms() > b.stats->get_total_time_ms();
+              return a.stats->get_total_time_us() > b.stats->get_total_time_us();
             });
 
   for (const auto &it : stats_to_display) {
-    const char *source = it.name;
     const ComponentRuntimeStats *stats = it.stats;
+    const LatencyHistogram<uint32_t> &hist = stats->get_total_histogram();
+
+    char p50[16], p99[16];
+    format_percentile(p50, sizeof(p50), hist, 500);
+    format_percentile(p99, sizeof(p99), hist, 990);
 
-    ESP_LOGI(TAG, "  %s: count=%" PRIu32 ", avg=%.2fms, max=%" PRIu32 "ms, total=%" PRIu32 "ms", source,
-             stats->get_total_count(), stats->get_total_avg_time_ms(), stats->get_total_max_time_ms(),
-             stats->get_total_time_ms());
+    ESP_LOGI(TAG, "  %s [%s]: count=%" PRIu32 ", avg=%.1fus, p50%s, p99%s, max=%" PRIu32 "us, total=%" PRIu32 "ms",
+             it.key.name, source_to_string(it.key.source), stats->get_total_count(), stats->get_total_avg_time_us(),
+             p50, p99, stats->get_total_max_time_us(), stats->get_total_time_ms());
+  }
+}
+
+void RuntimeStatsCollector::dump_histograms() {
+  ESP_LOGI(TAG, "Runtime histograms since boot (bucket upper bound us: count)");
+  for (const auto &it : this->component_stats_) {
+    const LatencyHistogram<uint32_t> &hist = it.second.get_total_histogram();
+    // "<16:123 <32:45 ... >=262144:1" - one line per component/source, empty buckets skipped
+    char buf[256];
+    size_t pos = 0;
+    for (uint8_t i = 0; i < HISTOGRAM_BUCKETS && pos < sizeof(buf); i++) {
+      uint32_t count = hist.get_bucket(i);
+      if (count == 0)
+        continue;
+      int written;
+      if (i < HISTOGRAM_BUCKETS - 1) {
+        written = snprintf(buf + pos, sizeof(buf) - pos, " <%" PRIu32 ":%" PRIu32,
+                           LatencyHistogram<uint32_t>::bucket_upper_bound_us(i), count);
+      } else {
+        written = snprintf(buf + pos, sizeof(buf) - pos, " >=%" PRIu32 ":%" PRIu32,
+                           LatencyHistogram<uint32_t>::bucket_upper_bound_us(i - 1), count);
+      }
+      if (written < 0)
+        break;
+      pos += written;
+    }
+    buf[std::min(pos, sizeof(buf) - 1)] = '\0';
+    ESP_LOGI(TAG, "  %s [%s]:%s", it.first.name, source_to_string(it.first.source), buf);
   }
 }
 
@@ -8,83 +8,169 @@
 #include <vector>
 #include <cstdint>
 #include <cstring>
+#include <limits>
+#include "esphome/core/component.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 
-namespace esphome {
+#ifdef USE_API_SERVICES
+#include "esphome/components/api/user_services.h"
+#endif
 
-class Component;  // Forward declaration
+namespace esphome {
 
 namespace runtime_stats {
 
 static const char *const TAG = "runtime_stats";
 
+/// Number of buckets in each latency histogram.
+static constexpr uint8_t HISTOGRAM_BUCKETS = 16;
+/// Upper bound (exclusive) of the first histogram bucket in microseconds. Each following bucket doubles it.
+static constexpr uint32_t HISTOGRAM_FIRST_BOUND_US = 16;
+
+/** Fixed-size, log2-scaled latency histogram.
+ *
+ * Bucket 0 holds durations below 16 µs, bucket i (1..14) holds [16 << (i-1), 16 << i) µs and the last bucket
+ * collects everything from 262 ms upwards. Recording is a count-leading-zeros and an increment, so it is
+ * cheap enough to run after every loop() and scheduler callback.
+ *
+ * @tparam T Counter type. Period histograms use uint16_t (saturating) to keep per-component RAM low.
+ */
+template<typename T> class LatencyHistogram {
+ public:
+  static uint8_t bucket_for(uint32_t duration_us) {
+    if (duration_us < HISTOGRAM_FIRST_BOUND_US)
+      return 0;
+    // floor(log2(duration_us)) - log2(HISTOGRAM_FIRST_BOUND_US) + 1
+    uint8_t bucket = 31 - __builtin_clz(duration_us) - 3;
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+  }
+  /// Exclusive upper bound of a bucket in microseconds, UINT32_MAX for the overflow bucket.
+  static uint32_t bucket_upper_bound_us(uint8_t bucket) {
+    return bucket < HISTOGRAM_BUCKETS - 1 ? HISTOGRAM_FIRST_BOUND_US << bucket : UINT32_MAX;
+  }
+
+  void record(uint32_t duration_us) {
+    T &bucket = this->buckets_[bucket_for(duration_us)];
+    if (bucket != std::numeric_limits<T>::max())
+      bucket++;
+  }
+  void reset() { memset(this->buckets_, 0, sizeof(this->buckets_)); }
+  T get_bucket(uint8_t bucket) const { return this->buckets_[bucket]; }
+
+  /** Estimate a percentile from the bucket counts.
+   *
+   * @param permille The percentile in 1/1000 units (990 = p99).
+   * @return The upper bound of the bucket containing the percentile, in microseconds, or 0 if empty.
+   */
+  uint32_t percentile_us(uint16_t permille) const {
+    uint32_t total = 0;
+    for (T count : this->buckets_)
+      total += count;
+    if (total == 0)
+      return 0;
+    uint32_t target = (static_cast<uint64_t>(total) * permille + 999) / 1000;
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+      seen += this->buckets_[i];
+      if (seen >= target)
+        return bucket_upper_bound_us(i);
+    }
+    return UINT32_MAX;
+  }
+
+ protected:
+  T buckets_[HISTOGRAM_BUCKETS]{};
+};
+
 class ComponentRuntimeStats {
  public:
-  ComponentRuntimeStats()
-      : period_count_(0),
-        period_time_ms_(0),
-        period_max_time_ms_(0),
-        total_count_(0),
-        total_time_ms_(0),
-        total_max_time_ms_(0) {}
-
-  void record_time(uint32_t duration_ms) {
+  void record_time(uint32_t duration_us) {
     // Update period counters
     this->period_count_++;
-    this->period_time_ms_ += duration_ms;
-    if (duration_ms > this->period_max_time_ms_)
-      this->period_max_time_ms_ = duration_ms;
+    this->period_time_us_ += duration_us;
+    if (duration_us > this->period_max_time_us_)
+      this->period_max_time_us_ = duration_us;
+    this->period_histogram_.record(duration_us);
 
     // Update total counters
     this->total_count_++;
-    this->total_time_ms_ += duration_ms;
-    if (duration_ms > this->total_max_time_ms_)
-      this->total_max_time_ms_ = duration_ms;
+    this->total_time_us_ += duration_us;
+    if (duration_us > this->total_max_time_us_)
+      this->total_max_time_us_ = duration_us;
+    this->total_histogram_.record(duration_us);
   }
 
   void reset_period_stats() {
     this->period_count_ = 0;
-    this->period_time_ms_ = 0;
-    this->period_max_time_ms_ = 0;
+    this->period_time_us_ = 0;
+    this->period_max_time_us_ = 0;
+    this->period_histogram_.reset();
   }
 
   // Period stats (reset each logging interval)
   uint32_t get_period_count() const { return this->period_count_; }
-  uint32_t get_period_time_ms() const { return this->period_time_ms_; }
-  uint32_t get_period_max_time_ms() const { return this->period_max_time_ms_; }
-  float get_period_avg_time_ms() const {
-    return this->period_count_ > 0 ? this->period_time_ms_ / static_cast<float>(this->period_count_) : 0.0f;
+  uint64_t get_period_time_us() const { return this->period_time_us_; }
+  uint32_t get_period_max_time_us() const { return this->period_max_time_us_; }
+  float get_period_avg_time_us() const {
+    return this->period_count_ > 0 ? this->period_time_us_ / static_cast<float>(this->period_count_) : 0.0f;
   }
+  const LatencyHistogram<uint16_t> &get_period_histogram() const { return this->period_histogram_; }
+  uint32_t get_period_time_ms() const { return this->period_time_us_ / 1000; }
+  uint32_t get_period_max_time_ms() const { return this->period_max_time_us_ / 1000; }
+  float get_period_avg_time_ms() const { return this->get_period_avg_time_us() / 1000.0f; }
 
   // Total stats (persistent until reboot)
   uint32_t get_total_count() const { return this->total_count_; }
-  uint32_t get_total_time_ms() const { return this->total_time_ms_; }
-  uint32_t get_total_max_time_ms() const { return this->total_max_time_ms_; }
-  float get_total_avg_time_ms() const {
-    return this->total_count_ > 0 ? this->total_time_ms_ / static_cast<float>(this->total_count_) : 0.0f;
+  uint64_t get_total_time_us() const { return this->total_time_us_; }
+  uint32_t get_total_max_time_us() const { return this->total_max_time_us_; }
+  float get_total_avg_time_us() const {
+    return this->total_count_ > 0 ? this->total_time_us_ / static_cast<float>(this->total_count_) : 0.0f;
   }
+  const LatencyHistogram<uint32_t> &get_total_histogram() const { return this->total_histogram_; }
+  uint32_t get_total_time_ms() const { return this->total_time_us_ / 1000; }
+  uint32_t get_total_max_time_ms() const { return this->total_max_time_us_ / 1000; }
+  float get_total_avg_time_ms() const { return this->get_total_avg_time_us() / 1000.0f; }
 
  protected:
   // Period stats (reset each logging interval)
-  uint32_t period_count_;
-  uint32_t period_time_ms_;
-  uint32_t period_max_time_ms_;
+  uint32_t period_count_{0};
+  uint32_t period_max_time_us_{0};
+  uint64_t period_time_us_{0};
+  LatencyHistogram<uint16_t> period_histogram_;
 
   // Total stats (persistent until reboot)
-  uint32_t total_count_;
-  uint32_t total_time_ms_;
-  uint32_t total_max_time_ms_;
+  uint32_t total_count_{0};
+  uint32_t total_max_time_us_{0};
+  uint64_t total_time_us_{0};
+  LatencyHistogram<uint32_t> total_histogram_;
 };
 
+/// Stats are kept separately per component and per kind of work (loop, scheduler callback, defer).
+struct ComponentStatKey {
+  const char *name;
+  BlockingSource source;
+
+  // Without comparing string contents, std::map would compare pointer addresses,
+  // causing identical component names at different addresses to be treated as different keys
+  bool operator<(const ComponentStatKey &other) const {
+    int cmp = std::strcmp(this->name, other.name);
+    if (cmp != 0)
+      return cmp < 0;
+    return this->source < other.source;
+  }
+};
+
+const char *source_to_string(BlockingSource source);
+
 // For sorting components by run time
 struct ComponentStatPair {
-  const char *name;
+  ComponentStatKey key;
   const ComponentRuntimeStats *stats;
 
   bool operator>(const ComponentStatPair &other) const {
     // Sort by period time as that's what we're displaying in the logs
-    return stats->get_period_time_ms() > other.stats->get_period_time_ms();
+    return stats->get_period_time_us() > other.stats->get_period_time_us();
   }
 };
 
@@ -95,11 +181,19 @@ class RuntimeStatsCollector {
   void set_log_interval(uint32_t log_interval) { this->log_interval_ = log_interval; }
   uint32_t get_log_interval() const { return this->log_interval_; }
 
-  void record_component_time(Component *component, uint32_t duration_ms, uint32_t current_time);
+  void record_component_time(Component *component, BlockingSource source, uint32_t duration_us,
+                             uint32_t current_time);
 
   // Process any pending stats printing (should be called after component loop)
   void process_pending_stats(uint32_t current_time);
 
+  /// Log the full per-component histograms now, without touching the period counters.
+  void dump_histograms();
+
+  const std::map<ComponentStatKey, ComponentRuntimeStats> &get_component_stats() const {
+    return this->component_stats_;
+  }
+
  protected:
   void log_stats_();
 
@@ -109,19 +203,26 @@ class RuntimeStatsCollector {
     }
   }
 
-  // Use const char* keys for efficiency
-  // Custom comparator for const char* keys in map
-  // Without this, std::map would compare pointer addresses instead of string contents,
-  // causing identical component names at different addresses to be treated as different keys
-  struct CStrCompare {
-    bool operator()(const char *a, const char *b) const { return std::strcmp(a, b) < 0; }
-  };
-  std::map<const char *, ComponentRuntimeStats, CStrCompare> component_stats_;
+  std::map<ComponentStatKey, ComponentRuntimeStats> component_stats_;
   std::map<Component *, const char *> component_names_cache_;
   uint32_t log_interval_;
   uint32_t next_log_time_;
 };
 
+#ifdef USE_API_SERVICES
+/// Native API diagnostic service ("runtime_stats_dump") that logs the full latency histograms on demand.
+class RuntimeStatsDumpService : public api::UserServiceBase<> {
+ public:
+  RuntimeStatsDumpService(RuntimeStatsCollector *parent)
+      : api::UserServiceBase<>("runtime_stats_dump", {}), parent_(parent) {}
+
+ protected:
+  void execute() override { this->parent_->dump_histograms(); }
+
+  RuntimeStatsCollector *parent_;
+};
+#endif
+
 }  // namespace runtime_stats
 
 extern runtime_stats::RuntimeStatsCollector
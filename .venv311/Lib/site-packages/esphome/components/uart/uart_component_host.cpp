@@ -285,7 +285,8 @@ void HostUartComponent::flush() {
   if (this->file_descriptor_ == -1) {
     return;
   }
-  tcflush(this->file_descriptor_, TCIOFLUSH);
+  // Wait until everything is sent, like flush() on the other platforms; tcflush() would discard pending data
+  tcdrain(this->file_descriptor_);
   ESP_LOGV(TAG, "    Flushing");
 }
 
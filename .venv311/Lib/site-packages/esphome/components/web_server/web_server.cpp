@@ -403,6 +403,35 @@ static void set_json_icon_state_value(JsonObject &root, EntityBase *obj, const s
   root["state"] = state;
 }
 
+// The common entity payloads are streamed into a stack buffer of this size instead of a heap-backed
+// JsonDocument. Payloads that don't fit (e.g. a select with many options) fall back to json::build_json().
+static constexpr size_t ENTITY_JSON_BUFFER_SIZE = 512;
+
+// Begin the object with the members set_json_id() adds, in the same order
+static void begin_entity_json(json::JsonWriter &writer, EntityBase *obj, const char *prefix,
+                              JsonDetail start_config) {
+  writer.begin_object();
+  writer.add("id", prefix, obj->get_object_id());
+  if (start_config == DETAIL_ALL) {
+    const StringRef &name = obj->get_name();
+    writer.add("name", name.c_str(), name.size());
+    StringRef icon = obj->get_icon_ref();
+    writer.add("icon", icon.c_str(), icon.size());
+    writer.add("entity_category", static_cast<uint32_t>(obj->get_entity_category()));
+    if (obj->is_disabled_by_default())
+      writer.add("is_disabled_by_default", true);
+  }
+}
+
+// Close the object and copy it into data; false if it overflowed and the caller has to fall back to build_json()
+static bool end_entity_json(json::JsonWriter &writer, std::string &data) {
+  writer.end_object();
+  if (writer.overflowed())
+    return false;
+  data.assign(writer.c_str(), writer.size());
+  return true;
+}
+
 // Helper to get request detail parameter
 static JsonDetail get_request_detail(AsyncWebServerRequest *request) {
   auto *param = request->getParam("detail");
@@ -435,6 +464,30 @@ std::string WebServer::sensor_all_json_generator(WebServer *web_server, void *so
   return web_server->sensor_json((sensor::Sensor *) (source), ((sensor::Sensor *) (source))->state, DETAIL_ALL);
 }
 std::string WebServer::sensor_json(sensor::Sensor *obj, float value, JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "sensor-", start_config);
+  writer.add("value", value);
+  StringRef uom = obj->get_unit_of_measurement_ref();
+  writer.begin_string("state");
+  if (std::isnan(value)) {
+    writer.append_string("NA");
+  } else {
+    writer.append_accuracy(value, obj->get_accuracy_decimals());
+    if (!uom.empty()) {
+      writer.append_string(" ", 1);
+      writer.append_string(uom.c_str(), uom.size());
+    }
+  }
+  writer.end_string();
+  if (start_config == DETAIL_ALL) {
+    this->add_sorting_info_(writer, obj);
+    if (!uom.empty())
+      writer.add("uom", uom.c_str(), uom.size());
+  }
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     std::string state;
     if (std::isnan(value)) {
@@ -483,6 +536,16 @@ std::string WebServer::text_sensor_all_json_generator(WebServer *web_server, voi
 }
 std::string WebServer::text_sensor_json(text_sensor::TextSensor *obj, const std::string &value,
                                         JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "text_sensor-", start_config);
+  writer.add("value", value);
+  writer.add("state", value);
+  if (start_config == DETAIL_ALL)
+    this->add_sorting_info_(writer, obj);
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     set_json_icon_state_value(root, obj, "text_sensor-" + obj->get_object_id(), value, value, start_config);
     if (start_config == DETAIL_ALL) {
@@ -530,6 +593,18 @@ std::string WebServer::switch_all_json_generator(WebServer *web_server, void *so
   return web_server->switch_json((switch_::Switch *) (source), ((switch_::Switch *) (source))->state, DETAIL_ALL);
 }
 std::string WebServer::switch_json(switch_::Switch *obj, bool value, JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "switch-", start_config);
+  writer.add("value", value);
+  writer.add("state", value ? "ON" : "OFF");
+  if (start_config == DETAIL_ALL) {
+    writer.add("assumed_state", obj->assumed_state());
+    this->add_sorting_info_(writer, obj);
+  }
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     set_json_icon_state_value(root, obj, "switch-" + obj->get_object_id(), value ? "ON" : "OFF", value, start_config);
     if (start_config == DETAIL_ALL) {
@@ -604,6 +679,16 @@ std::string WebServer::binary_sensor_all_json_generator(WebServer *web_server, v
                                         ((binary_sensor::BinarySensor *) (source))->state, DETAIL_ALL);
 }
 std::string WebServer::binary_sensor_json(binary_sensor::BinarySensor *obj, bool value, JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "binary_sensor-", start_config);
+  writer.add("value", value);
+  writer.add("state", value ? "ON" : "OFF");
+  if (start_config == DETAIL_ALL)
+    this->add_sorting_info_(writer, obj);
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     set_json_icon_state_value(root, obj, "binary_sensor-" + obj->get_object_id(), value ? "ON" : "OFF", value,
                               start_config);
@@ -871,6 +956,44 @@ std::string WebServer::number_all_json_generator(WebServer *web_server, void *so
   return web_server->number_json((number::Number *) (source), ((number::Number *) (source))->state, DETAIL_ALL);
 }
 std::string WebServer::number_json(number::Number *obj, float value, JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "number-", start_config);
+  const int8_t accuracy = step_to_accuracy_decimals(obj->traits.get_step());
+  StringRef uom = obj->traits.get_unit_of_measurement_ref();
+  if (start_config == DETAIL_ALL) {
+    writer.begin_string("min_value");
+    writer.append_accuracy(obj->traits.get_min_value(), accuracy);
+    writer.end_string();
+    writer.begin_string("max_value");
+    writer.append_accuracy(obj->traits.get_max_value(), accuracy);
+    writer.end_string();
+    writer.begin_string("step");
+    writer.append_accuracy(obj->traits.get_step(), accuracy);
+    writer.end_string();
+    writer.add("mode", static_cast<int32_t>(obj->traits.get_mode()));
+    if (!uom.empty())
+      writer.add("uom", uom.c_str(), uom.size());
+    this->add_sorting_info_(writer, obj);
+  }
+  if (std::isnan(value)) {
+    writer.add("value", "\"NaN\"");
+    writer.add("state", "NA");
+  } else {
+    writer.begin_string("value");
+    writer.append_accuracy(value, accuracy);
+    writer.end_string();
+    writer.begin_string("state");
+    writer.append_accuracy(value, accuracy);
+    if (!uom.empty()) {
+      writer.append_string(" ", 1);
+      writer.append_string(uom.c_str(), uom.size());
+    }
+    writer.end_string();
+  }
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     set_json_id(root, obj, "number-" + obj->get_object_id(), start_config);
     if (start_config == DETAIL_ALL) {
@@ -1163,6 +1286,21 @@ std::string WebServer::select_all_json_generator(WebServer *web_server, void *so
   return web_server->select_json((select::Select *) (source), ((select::Select *) (source))->state, DETAIL_ALL);
 }
 std::string WebServer::select_json(select::Select *obj, const std::string &value, JsonDetail start_config) {
+  char buf[ENTITY_JSON_BUFFER_SIZE];
+  json::JsonWriter writer(buf, sizeof(buf));
+  begin_entity_json(writer, obj, "select-", start_config);
+  writer.add("value", value);
+  writer.add("state", value);
+  if (start_config == DETAIL_ALL) {
+    writer.begin_array("option");
+    for (auto &option : obj->traits.get_options())
+      writer.add_element(option);
+    writer.end_array();
+    this->add_sorting_info_(writer, obj);
+  }
+  std::string data;
+  if (end_entity_json(writer, data))
+    return data;
   return json::build_json([this, obj, value, start_config](JsonObject root) {
     set_json_icon_state_value(root, obj, "select-" + obj->get_object_id(), value, value, start_config);
     if (start_config == DETAIL_ALL) {
@@ -1866,6 +2004,18 @@ void WebServer::handleRequest(AsyncWebServerRequest *request) {
 
 bool WebServer::isRequestHandlerTrivial() const { return false; }
 
+void WebServer::add_sorting_info_(json::JsonWriter &writer, EntityBase *entity) {
+#ifdef USE_WEBSERVER_SORTING
+  auto entity_it = this->sorting_entitys_.find(entity);
+  if (entity_it != this->sorting_entitys_.end()) {
+    writer.add("sorting_weight", entity_it->second.weight);
+    auto group_it = this->sorting_groups_.find(entity_it->second.group_id);
+    if (group_it != this->sorting_groups_.end())
+      writer.add("sorting_group", group_it->second.name);
+  }
+#endif
+}
+
 void WebServer::add_sorting_info_(JsonObject &root, EntityBase *entity) {
 #ifdef USE_WEBSERVER_SORTING
   if (this->sorting_entitys_.find(entity) != this->sorting_entitys_.end()) {
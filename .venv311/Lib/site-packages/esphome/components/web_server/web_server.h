@@ -4,6 +4,7 @@
 
 #include "esphome/components/web_server_base/web_server_base.h"
 #ifdef USE_WEBSERVER
+#include "esphome/components/json/json_writer.h"
 #include "esphome/core/component.h"
 #include "esphome/core/controller.h"
 #include "esphome/core/entity_base.h"
@@ -498,6 +499,7 @@ class WebServer : public Controller, public Component, public AsyncWebHandler {
 
  protected:
   void add_sorting_info_(JsonObject &root, EntityBase *entity);
+  void add_sorting_info_(json::JsonWriter &writer, EntityBase *entity);
 
 #ifdef USE_LIGHT
   // Helper to parse and apply a float parameter with optional scaling
@@ -25,6 +25,8 @@ namespace wled {
 enum Protocol { WLED_NOTIFIER = 0, WARLS = 1, DRGB = 2, DRGBW = 3, DNRGB = 4 };
 
 const int DEFAULT_BLANK_TIME = 1000;
+// LEDs converted at once before they are written to the light
+static const uint16_t WRITE_CHUNK = 64;
 
 static const char *const TAG = "wled_light_effect";
 
@@ -211,19 +213,7 @@ bool WLEDLightEffect::parse_drgb_frame_(light::AddressableLight &it, const uint8
     return false;
   }
 
-  auto count = size / 3;
-  auto max_leds = it.size();
-
-  for (uint16_t led = 0; led < count; ++led, payload += 3) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
-
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b));
-    }
-  }
-
+  this->write_leds_(it, 0, payload, size / 3, 3);
   return true;
 }
 
@@ -233,20 +223,7 @@ bool WLEDLightEffect::parse_drgbw_frame_(light::AddressableLight &it, const uint
     return false;
   }
 
-  auto count = size / 4;
-  auto max_leds = it.size();
-
-  for (uint16_t led = 0; led < count; ++led, payload += 4) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
-    uint8_t w = payload[3];
-
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b, w));
-    }
-  }
-
+  this->write_leds_(it, 0, payload, size / 4, 4);
   return true;
 }
 
@@ -265,20 +242,26 @@ bool WLEDLightEffect::parse_dnrgb_frame_(light::AddressableLight &it, const uint
     return false;
   }
 
-  auto count = size / 3;
-  auto max_leds = it.size();
-
-  for (; count > 0; count--, payload += 3, led++) {
-    uint8_t r = payload[0];
-    uint8_t g = payload[1];
-    uint8_t b = payload[2];
+  this->write_leds_(it, led, payload, size / 3, 3);
+  return true;
+}
 
-    if (led < max_leds) {
-      it[led].set(Color(r, g, b));
+void WLEDLightEffect::write_leds_(light::AddressableLight &it, uint16_t led, const uint8_t *payload, uint16_t count,
+                                  uint8_t channels) {
+  if (led >= it.size())
+    return;
+  count = std::min<int32_t>(count, it.size() - led);
+
+  Color colors[WRITE_CHUNK];
+  while (count > 0) {
+    uint16_t chunk = std::min(count, WRITE_CHUNK);
+    for (uint16_t i = 0; i < chunk; i++, payload += channels) {
+      colors[i] = Color(payload[0], payload[1], payload[2], channels == 4 ? payload[3] : 0);
     }
+    it.write_colors(led, colors, chunk);
+    led += chunk;
+    count -= chunk;
   }
-
-  return true;
 }
 
 }  // namespace wled
@@ -32,6 +32,9 @@ class WLEDLightEffect : public light::AddressableLightEffect {
   bool parse_drgb_frame_(light::AddressableLight &it, const uint8_t *payload, uint16_t size);
   bool parse_drgbw_frame_(light::AddressableLight &it, const uint8_t *payload, uint16_t size);
   bool parse_dnrgb_frame_(light::AddressableLight &it, const uint8_t *payload, uint16_t size);
+  /// Write count LEDs from RGB or RGBW data, starting at led.
+  void write_leds_(light::AddressableLight &it, uint16_t led, const uint8_t *payload, uint16_t count,
+                   uint8_t channels);
 
   uint16_t port_{0};
   std::unique_ptr<UDP> udp_;
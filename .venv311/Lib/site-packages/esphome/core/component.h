@@ -5,6 +5,7 @@
 #include <functional>
 #include <string>
 
+#include "esphome/core/defines.h"
 #include "esphome/core/optional.h"
 
 namespace esphome {
@@ -461,9 +462,17 @@ class PollingComponent : public Component {
   uint32_t update_interval_;
 };
 
+/// What kind of work a WarnIfComponentBlockingGuard is timing, used to split runtime stats by origin.
+enum class BlockingSource : uint8_t {
+  LOOP = 0,   ///< Component::loop() called from Application::loop()
+  SCHEDULER,  ///< set_timeout()/set_interval() callback
+  DEFER,      ///< defer() callback
+};
+
 class WarnIfComponentBlockingGuard {
  public:
-  WarnIfComponentBlockingGuard(Component *component, uint32_t start_time);
+  WarnIfComponentBlockingGuard(Component *component, uint32_t start_time,
+                               BlockingSource source = BlockingSource::LOOP);
 
   // Finish the timing operation and return the current time
   uint32_t finish();
@@ -473,6 +482,10 @@ class WarnIfComponentBlockingGuard {
  protected:
   uint32_t started_;
   Component *component_;
+#ifdef USE_RUNTIME_STATS
+  uint32_t started_us_;
+  BlockingSource source_;
+#endif
 };
 
 // Function to clear setup priority overrides after all components are set up
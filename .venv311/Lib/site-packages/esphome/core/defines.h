@@ -116,6 +116,7 @@
 #define USE_API_SERVICES
 #define USE_MD5
 #define USE_MQTT
+#define USE_MQTT_PUBLISH_QUEUE
 #define USE_NETWORK
 #define USE_ONLINE_IMAGE_BMP_SUPPORT
 #define USE_ONLINE_IMAGE_PNG_SUPPORT
@@ -144,6 +145,8 @@
 
 // ESP32-specific feature flags
 #ifdef USE_ESP32
+#define USE_OTA_INFLATE
+#define USE_OTA_PIPELINE
 #define USE_ESPHOME_TASK_LOG_BUFFER
 
 #define USE_BLUETOOTH_PROXY
@@ -178,6 +181,7 @@
 #endif
 
 #ifdef USE_ESP_IDF
+#define USE_OTA_DELTA
 #define USE_MICRO_WAKE_WORD
 #define USE_MICRO_WAKE_WORD_VAD
 #if defined(USE_ESP32_VARIANT_ESP32C6) || defined(USE_ESP32_VARIANT_ESP32H2)
@@ -228,6 +232,7 @@
 
 #ifdef USE_LIBRETINY
 #define USE_CAPTIVE_PORTAL
+#define USE_OTA_INFLATE
 #define USE_SOCKET_IMPL_LWIP_SOCKETS
 #define USE_SOCKET_SELECT_SUPPORT
 #define USE_WEBSERVER
@@ -238,6 +243,9 @@
 #ifdef USE_HOST
 #define USE_SOCKET_IMPL_BSD_SOCKETS
 #define USE_SOCKET_SELECT_SUPPORT
+#define USE_OTA_DELTA
+#define USE_OTA_INFLATE
+#define USE_OTA_PIPELINE
 #endif
 
 // Disabled feature flags
@@ -140,6 +140,15 @@ uint32_t fnv1_hash(const std::string &str) {
   return hash;
 }
 
+uint32_t fnv1_hash(const uint8_t *data, size_t len) {
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < len; i++) {
+    hash *= 16777619UL;
+    hash ^= data[i];
+  }
+  return hash;
+}
+
 float random_float() { return static_cast<float>(random_uint32()) / static_cast<float>(UINT32_MAX); }
 
 // Strings
@@ -156,6 +156,8 @@ uint16_t crc16be(const uint8_t *data, uint16_t len, uint16_t crc = 0, uint16_t p
 
 /// Calculate a FNV-1 hash of \p str.
 uint32_t fnv1_hash(const std::string &str);
+/// Calculate a FNV-1 hash of \p data with size \p len.
+uint32_t fnv1_hash(const uint8_t *data, size_t len);
 
 /// Return a random 32-bit unsigned integer.
 uint32_t random_uint32();
@@ -317,7 +317,7 @@ void HOT Scheduler::call(uint32_t now) {
     // Execute callback without holding lock to prevent deadlocks
     // if the callback tries to call defer() again
     if (!this->should_skip_item_(item.get())) {
-      this->execute_item_(item.get(), now);
+      this->execute_item_(item.get(), now, BlockingSource::DEFER);
     }
   }
 #endif /* not ESPHOME_THREAD_SINGLE */
@@ -522,9 +522,9 @@ void HOT Scheduler::pop_raw_() {
 }
 
 // Helper to execute a scheduler item
-void HOT Scheduler::execute_item_(SchedulerItem *item, uint32_t now) {
+void HOT Scheduler::execute_item_(SchedulerItem *item, uint32_t now, BlockingSource source) {
   App.set_current_component(item->component);
-  WarnIfComponentBlockingGuard guard{item->component, now};
+  WarnIfComponentBlockingGuard guard{item->component, now, source};
   item->callback();
   guard.finish();
 }
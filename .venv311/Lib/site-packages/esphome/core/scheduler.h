@@ -237,7 +237,7 @@ class Scheduler {
   }
 
   // Helper to execute a scheduler item
-  void execute_item_(SchedulerItem *item, uint32_t now);
+  void execute_item_(SchedulerItem *item, uint32_t now, BlockingSource source = BlockingSource::SCHEDULER);
 
   // Helper to check if item should be skipped
   bool should_skip_item_(const SchedulerItem *item) const {
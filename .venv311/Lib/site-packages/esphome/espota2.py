@@ -5,10 +5,12 @@ import hashlib
 import io
 import logging
 import random
+import shutil
 import socket
 import sys
 import time
 
+from esphome import ota_delta
 from esphome.core import EsphomeError
 from esphome.helpers import resolve_ip_address
 
@@ -23,6 +25,7 @@ RESPONSE_RECEIVE_OK = 0x44
 RESPONSE_UPDATE_END_OK = 0x45
 RESPONSE_SUPPORTS_COMPRESSION = 0x46
 RESPONSE_CHUNK_OK = 0x47
+RESPONSE_SUPPORTS_DELTA = 0x48
 
 RESPONSE_ERROR_MAGIC = 0x80
 RESPONSE_ERROR_UPDATE_PREPARE = 0x81
@@ -36,6 +39,7 @@ RESPONSE_ERROR_ESP8266_NOT_ENOUGH_SPACE = 0x88
 RESPONSE_ERROR_ESP32_NOT_ENOUGH_SPACE = 0x89
 RESPONSE_ERROR_NO_UPDATE_PARTITION = 0x8A
 RESPONSE_ERROR_MD5_MISMATCH = 0x8B
+RESPONSE_ERROR_DELTA_BASE = 0x8D
 RESPONSE_ERROR_UNKNOWN = 0xFF
 
 OTA_VERSION_1_0 = 1
@@ -44,6 +48,7 @@ OTA_VERSION_2_0 = 2
 MAGIC_BYTES = [0x6C, 0x26, 0xF7, 0x5C, 0x45]
 
 FEATURE_SUPPORTS_COMPRESSION = 0x01
+FEATURE_SUPPORTS_DELTA = 0x02
 
 
 UPLOAD_BLOCK_SIZE = 8192
@@ -80,6 +85,10 @@ class OTAError(EsphomeError):
     pass
 
 
+class DeltaBaseError(OTAError):
+    """The device doesn't run the firmware a delta update was made against."""
+
+
 def recv_decode(sock, amount, decode=True):
     data = sock.recv(amount)
     if not decode:
@@ -99,7 +108,7 @@ def receive_exactly(sock, amount, msg, expect, decode=True):
         check_error(data, expect)
     except OTAError as err:
         sock.close()
-        raise OTAError(f"Error {msg}: {err}") from err
+        raise type(err)(f"Error {msg}: {err}") from err
 
     while len(data) < amount:
         try:
@@ -168,6 +177,10 @@ def check_error(data, expect):
             "Error: Application MD5 code mismatch. Please try again "
             "or flash over USB with a good quality cable."
         )
+    if dat == RESPONSE_ERROR_DELTA_BASE:
+        raise DeltaBaseError(
+            "Error: The device doesn't run the firmware this delta update was made against"
+        )
     if dat == RESPONSE_ERROR_UNKNOWN:
         raise OTAError("Unknown error from ESP")
     if not isinstance(expect, (list, tuple)):
@@ -190,8 +203,35 @@ def send_check(sock, data, msg):
         raise OTAError(f"Error sending {msg}: {err}") from err
 
 
+def delta_base_path(filename: str) -> str:
+    """Where the last upload of filename is kept, to make delta updates against."""
+    return f"{filename}.delta-base"
+
+
+def make_delta(filename: str, file_contents: bytes) -> bytes | None:
+    """Patch the last uploaded firmware into file_contents, if that is smaller."""
+    try:
+        with open(delta_base_path(filename), "rb") as base_handle:
+            base = base_handle.read()
+    except OSError:
+        return None
+    patch = ota_delta.make_patch(base, file_contents)
+    if len(patch) >= len(file_contents):
+        return None
+    try:
+        ota_delta.apply_patch(base, patch)
+    except ota_delta.PatchError as err:
+        _LOGGER.warning("Not using a delta update: %s", err)
+        return None
+    return patch
+
+
 def perform_ota(
-    sock: socket.socket, password: str, file_handle: io.IOBase, filename: str
+    sock: socket.socket,
+    password: str,
+    file_handle: io.IOBase,
+    filename: str,
+    delta: bytes | None = None,
 ) -> None:
     file_contents = file_handle.read()
     file_size = len(file_contents)
@@ -210,12 +250,21 @@ def perform_ota(
         )
 
     # Features
-    send_check(sock, FEATURE_SUPPORTS_COMPRESSION, "features")
+    requested_features = FEATURE_SUPPORTS_COMPRESSION
+    if delta is not None:
+        requested_features |= FEATURE_SUPPORTS_DELTA
+    send_check(sock, requested_features, "features")
     features = receive_exactly(
-        sock, 1, "features", [RESPONSE_HEADER_OK, RESPONSE_SUPPORTS_COMPRESSION]
+        sock,
+        1,
+        "features",
+        [RESPONSE_HEADER_OK, RESPONSE_SUPPORTS_COMPRESSION, RESPONSE_SUPPORTS_DELTA],
     )[0]
 
-    if features == RESPONSE_SUPPORTS_COMPRESSION:
+    if features == RESPONSE_SUPPORTS_DELTA:
+        upload_contents = delta
+        _LOGGER.info("Sending a delta update of %s bytes", len(upload_contents))
+    elif features == RESPONSE_SUPPORTS_COMPRESSION:
         upload_contents = gzip.compress(file_contents, compresslevel=9)
         _LOGGER.info("Compressed to %s bytes", len(upload_contents))
     else:
@@ -257,9 +306,16 @@ def perform_ota(
         (upload_size >> 0) & 0xFF,
     ]
     send_check(sock, upload_size_encoded, "binary size")
+    if features == RESPONSE_SUPPORTS_DELTA:
+        # The device checks the header against its running firmware before preparing
+        send_check(sock, upload_contents[: ota_delta.HEADER_SIZE], "delta header")
+        upload_contents = upload_contents[ota_delta.HEADER_SIZE :]
+        # The device verifies the patched image, not the patch
+        upload_md5 = hashlib.md5(file_contents).hexdigest()
+    else:
+        upload_md5 = hashlib.md5(upload_contents).hexdigest()
     receive_exactly(sock, 1, "binary size", RESPONSE_UPDATE_PREPARE_OK)
 
-    upload_md5 = hashlib.md5(upload_contents).hexdigest()
     _LOGGER.debug("MD5 of upload is %s", upload_md5)
 
     send_check(sock, upload_md5, "file checksum")
@@ -289,7 +345,7 @@ def perform_ota(
             sys.stderr.write("\n")
             raise OTAError(f"Error sending data: {err}") from err
 
-        progress.update(offset / upload_size)
+        progress.update(offset / len(upload_contents))
     progress.done()
 
     # Enable nodelay for last checks
@@ -308,7 +364,7 @@ def perform_ota(
     time.sleep(1)
 
 
-def run_ota_impl_(remote_host, remote_port, password, filename):
+def run_ota_impl_(remote_host, remote_port, password, filename, use_delta=True):
     try:
         res = resolve_ip_address(remote_host, remote_port)
     except EsphomeError as err:
@@ -336,14 +392,27 @@ def run_ota_impl_(remote_host, remote_port, password, filename):
 
         _LOGGER.info("Connected to %s", sa[0])
         with open(filename, "rb") as file_handle:
+            delta = make_delta(filename, file_handle.read()) if use_delta else None
+            file_handle.seek(0)
             try:
-                perform_ota(sock, password, file_handle, filename)
+                perform_ota(sock, password, file_handle, filename, delta)
+            except DeltaBaseError as err:
+                _LOGGER.warning("%s, sending the full firmware", err)
+                sock.close()
+                return run_ota_impl_(
+                    remote_host, remote_port, password, filename, use_delta=False
+                )
             except OTAError as err:
                 _LOGGER.error(str(err))
                 return 1
             finally:
                 sock.close()
 
+        # The device runs this firmware now, the next upload can be a delta against it
+        try:
+            shutil.copyfile(filename, delta_base_path(filename))
+        except OSError as err:
+            _LOGGER.debug("Could not keep a copy for delta updates: %s", err)
         return 0
 
     _LOGGER.error("Connection failed.")
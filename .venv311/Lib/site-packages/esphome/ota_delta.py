@@ -0,0 +1,223 @@
+"""Binary patches for delta OTA updates.
+
+The format is read by ota::DeltaPatcher on the device. A patch starts with a 32 byte
+header (magic, format version, new and old image size, MD5 of the old image) followed
+by bsdiff style records, all numbers as LEB128 varints:
+
+- diff length, extra length and a zigzag encoded seek;
+- the diff: pairs of a zero run and a literal count plus the literals, covering diff
+  length bytes. A new byte is the old byte at the current position plus its literal
+  (mod 256), zero runs copy old bytes unchanged;
+- extra length bytes inserted as they are;
+- the old position then moves by the seek.
+
+Firmware changes mostly move code and shift addresses, so matches are extended across
+small differences and the differing bytes end up as short literal runs in the diff.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import struct
+
+MAGIC = b"ESPD"
+VERSION = 1
+HEADER_SIZE = 32
+
+# Length of the seeds looked up in the old image, and the spacing of indexed positions
+_SEED = 8
+_STRIDE = 4
+# Matches shorter than this cost more in records than they save
+_MIN_MATCH = 24
+# Extending a match stops when fewer than half of the bytes in this window are equal
+_WINDOW = 32
+
+
+class PatchError(Exception):
+    pass
+
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def _zigzag(value: int) -> int:
+    return (value << 1) ^ (value >> 63)
+
+
+def _extend_forward(old: bytes, new: bytes, old_pos: int, new_pos: int) -> int:
+    """Length of an approximate match, ending at its last equal byte."""
+    limit = min(len(old) - old_pos, len(new) - new_pos)
+    length = 0
+    best = 0
+    misses = 0
+    window = []
+    while length < limit:
+        equal = old[old_pos + length] == new[new_pos + length]
+        window.append(equal)
+        if not equal:
+            misses += 1
+        if len(window) > _WINDOW and not window.pop(0):
+            misses -= 1
+        if misses * 2 > _WINDOW:
+            break
+        length += 1
+        if equal:
+            best = length
+    return best
+
+
+def _encode_diff(
+    old: bytes, new: bytes, old_pos: int, new_pos: int, length: int
+) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < length:
+        start = i
+        while i < length and old[old_pos + i] == new[new_pos + i]:
+            i += 1
+        zeros = i - start
+        start = i
+        # Literals continue over short equal runs, a new pair costs at least two bytes
+        while i < length:
+            if old[old_pos + i] != new[new_pos + i]:
+                i += 1
+                continue
+            run = i
+            while (
+                run < length
+                and run - i < 3
+                and old[old_pos + run] == new[new_pos + run]
+            ):
+                run += 1
+            if run - i >= 3 or run == length:
+                break
+            i = run
+        out += _varint(zeros) + _varint(i - start)
+        out += bytes(
+            (new[new_pos + j] - old[old_pos + j]) & 0xFF for j in range(start, i)
+        )
+    return bytes(out)
+
+
+def _find_matches(old: bytes, new: bytes) -> list[tuple[int, int, int]]:
+    """Non-overlapping (new_pos, old_pos, length) matches in increasing new order."""
+    index: dict[bytes, int] = {}
+    for pos in range(0, len(old) - _SEED + 1, _STRIDE):
+        index.setdefault(old[pos : pos + _SEED], pos)
+
+    matches = []
+    new_pos = 0
+    offset = 0  # old - new position of the last match, usually still right
+    while new_pos + _SEED <= len(new):
+        seed = new[new_pos : new_pos + _SEED]
+        old_pos = new_pos + offset
+        if (
+            not 0 <= old_pos <= len(old) - _SEED
+            or old[old_pos : old_pos + _SEED] != seed
+        ):
+            old_pos = index.get(seed)
+            if old_pos is None:
+                new_pos += 1
+                continue
+        # Seeds are only indexed at every _STRIDE bytes, so also extend backwards
+        back = 0
+        prev_end = matches[-1][0] + matches[-1][2] if matches else 0
+        while (
+            back < old_pos
+            and new_pos - back > prev_end
+            and old[old_pos - back - 1] == new[new_pos - back - 1]
+        ):
+            back += 1
+        length = back + _extend_forward(old, new, old_pos, new_pos)
+        if length < _MIN_MATCH:
+            new_pos += 1
+            continue
+        matches.append((new_pos - back, old_pos - back, length))
+        offset = old_pos - new_pos
+        new_pos = new_pos - back + length
+    return matches
+
+
+def make_patch(old: bytes, new: bytes) -> bytes:
+    """Make a patch that turns old into new."""
+    out = bytearray(MAGIC)
+    out += struct.pack("<B3xII", VERSION, len(new), len(old))
+    out += hashlib.md5(old).digest()
+
+    old_pos = 0
+    new_pos = 0
+    matches = _find_matches(old, new) + [(len(new), None, 0)]
+    for match_new, match_old, length in matches:
+        # Records are diff, extra, seek: the gap before a match becomes the extra of
+        # the previous record
+        extra = new[new_pos:match_new]
+        if match_old is None and not extra:
+            break
+        seek = 0 if match_old is None else match_old - old_pos
+        out += _varint(0) + _varint(len(extra)) + _varint(_zigzag(seek)) + extra
+        if match_old is None:
+            break
+        old_pos = match_old
+        diff = _encode_diff(old, new, old_pos, match_new, length)
+        out += _varint(length) + _varint(0) + _varint(0) + diff
+        old_pos += length
+        new_pos = match_new + length
+    return bytes(out)
+
+
+def _read_varint(data: bytes, pos: int) -> tuple[int, int]:
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        # Like the device, at most 5 bytes for a 32 bit value
+        if shift == 28 and byte & 0xF0:
+            raise PatchError("Patch number exceeds 32 bits")
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def apply_patch(old: bytes, patch: bytes) -> bytes:
+    """Apply a patch the way the device does, to check it before uploading."""
+    if patch[:4] != MAGIC or patch[4] != VERSION:
+        raise PatchError("Not a delta patch")
+    new_size, old_size = struct.unpack_from("<II", patch, 8)
+    if old_size != len(old) or hashlib.md5(old).digest() != patch[16:32]:
+        raise PatchError("Patch was made for a different image")
+    out = bytearray()
+    pos = HEADER_SIZE
+    old_pos = 0
+    while pos < len(patch):
+        diff_len, pos = _read_varint(patch, pos)
+        extra_len, pos = _read_varint(patch, pos)
+        seek, pos = _read_varint(patch, pos)
+        left = diff_len
+        while left:
+            zeros, pos = _read_varint(patch, pos)
+            count, pos = _read_varint(patch, pos)
+            out += old[old_pos : old_pos + zeros]
+            old_pos += zeros
+            out += bytes(
+                (old[old_pos + i] + patch[pos + i]) & 0xFF for i in range(count)
+            )
+            old_pos += count
+            pos += count
+            left -= zeros + count
+        out += patch[pos : pos + extra_len]
+        pos += extra_len
+        old_pos += (seek >> 1) ^ -(seek & 1)
+    if pos != len(patch) or len(out) != new_size:
+        raise PatchError("Patch is corrupt")
+    return bytes(out)
@@ -0,0 +1,11 @@
+// Defines shared by all host tests, the test's own defines.h is appended to this file.
+#pragma once
+#include "esphome/core/macros.h"
+#define ESPHOME_BOARD "host"
+#define ESPHOME_VARIANT "HOST"
+#define ESPHOME_THREAD_MULTI_ATOMICS
+#define ESPHOME_COMPONENT_COUNT 8
+#define ESPHOME_ENTITY_COUNT 8
+#define USE_ESPHOME_HOST_MAC_ADDRESS {0x98, 0x35, 0x69, 0xab, 0xf6, 0x79}
+#define USE_SOCKET_IMPL_BSD_SOCKETS
+#define USE_SOCKET_SELECT_SUPPORT
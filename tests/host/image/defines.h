@@ -0,0 +1,2 @@
+#define USE_DISPLAY
+#define USE_IMAGE_COMPRESSION
@@ -0,0 +1,191 @@
+// Compressed images are drawn in spans of opaque pixels with draw_native_pixels_at() where the display supports it.
+// Draws RLE images on a display with an RGB565 buffer that takes native spans and on one that only has
+// draw_pixel_at(), like before, and compares the buffers and the time.
+
+#include "esphome/components/display/display.h"
+#include "esphome/components/image/image.h"
+#include "esphome/core/helpers.h"
+#include "test_helpers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace esphome;
+
+namespace {
+
+const int WIDTH = 320;
+const int HEIGHT = 240;
+
+/// A colour display with a big-endian RGB565 buffer, converting colours like mipi_spi.
+class TestDisplay : public display::Display {
+ public:
+  explicit TestDisplay(bool native) : native_(native), buffer_(WIDTH * HEIGHT) {}
+
+  void draw_pixel_at(int x, int y, Color color) override {
+    this->pixel_calls++;
+    if (!this->get_clipping().inside(x, y) || x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+      return;
+    this->buffer_[y * WIDTH + x] = (color.r & 0xF8) | color.g >> 5 | (color.g & 0x1C) << 11 | (color.b & 0xF8) << 5;
+  }
+
+  bool draw_native_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, display::ColorBitness bitness,
+                             bool big_endian, display::DisplayRotation rotation) override {
+    if (!this->native_ || bitness != display::COLOR_BITNESS_565 || !big_endian ||
+        rotation != display::DISPLAY_ROTATION_0_DEGREES)
+      return false;
+    this->native_calls++;
+    // Clip the rectangle, then copy what is left row by row
+    int x0 = std::max(x_start, 0), y0 = std::max(y_start, 0);
+    int x1 = std::min(x_start + w, WIDTH), y1 = std::min(y_start + h, HEIGHT);
+    auto clipping = this->get_clipping();
+    if (clipping.is_set()) {
+      x0 = std::max<int>(x0, clipping.x);
+      y0 = std::max<int>(y0, clipping.y);
+      x1 = std::min<int>(x1, clipping.x2());
+      y1 = std::min<int>(y1, clipping.y2());
+    }
+    for (int y = y0; y < y1; y++) {
+      if (x0 < x1)
+        memcpy(&this->buffer_[y * WIDTH + x0], ptr + ((y - y_start) * w + (x0 - x_start)) * 2, (x1 - x0) * 2);
+    }
+    return true;
+  }
+
+  void update() override {}
+  display::DisplayType get_display_type() override { return display::DISPLAY_TYPE_COLOR; }
+  void clear_buffer() { std::fill(this->buffer_.begin(), this->buffer_.end(), 0x1234); }
+  const std::vector<uint16_t> &buffer() const { return this->buffer_; }
+
+  uint32_t pixel_calls{0};
+  uint32_t native_calls{0};
+
+ protected:
+  int get_width_internal() override { return WIDTH; }
+  int get_height_internal() override { return HEIGHT; }
+
+  bool native_;
+  std::vector<uint16_t> buffer_;
+};
+
+/// Encode pixel data as IMAGE_COMPRESSION_RLE: the row offset table, then runs of 2 or more equal pixels and
+/// literal packets for the rest.
+std::vector<uint8_t> rle_encode(const std::vector<uint8_t> &pixels, int width, int height, size_t pixel_size) {
+  std::vector<uint8_t> out(height * sizeof(uint32_t));
+  for (int y = 0; y < height; y++) {
+    const uint32_t offset = out.size();
+    memcpy(&out[y * sizeof(uint32_t)], &offset, sizeof(offset));
+    const uint8_t *row = &pixels[y * width * pixel_size];
+    auto same = [&](int a, int b) { return memcmp(row + a * pixel_size, row + b * pixel_size, pixel_size) == 0; };
+    int x = 0;
+    while (x < width) {
+      int run = 1;
+      while (x + run < width && run < 128 && same(x, x + run))
+        run++;
+      if (run >= 2) {
+        out.push_back(0x80 | (run - 1));
+        out.insert(out.end(), row + x * pixel_size, row + (x + 1) * pixel_size);
+        x += run;
+        continue;
+      }
+      int literal = 1;
+      while (x + literal < width && literal < 128 && !(x + literal + 1 < width && same(x + literal, x + literal + 1)))
+        literal++;
+      out.push_back(literal - 1);
+      out.insert(out.end(), row + x * pixel_size, row + (x + literal) * pixel_size);
+      x += literal;
+    }
+  }
+  return out;
+}
+
+/// A dashboard-like picture: flat background and panels, a gradient bar and some noisy "text".
+/// With alpha, the panels have rounded, transparent corners and a half-transparent shadow.
+std::vector<uint8_t> make_pixels(bool alpha) {
+  const size_t pixel_size = alpha ? 3 : 2;
+  std::vector<uint8_t> pixels(WIDTH * HEIGHT * pixel_size);
+  uint32_t seed = 1;
+  for (int y = 0; y < HEIGHT; y++) {
+    for (int x = 0; x < WIDTH; x++) {
+      uint16_t color = 0x18E3;
+      uint8_t a = 0xFF;
+      const bool panel = (x % 160) >= 10 && (x % 160) < 150 && (y % 120) >= 10 && (y % 120) < 110;
+      if (panel) {
+        color = 0x3A6B;
+        if ((y % 120) >= 40 && (y % 120) < 50)
+          color = ((x * 31 / WIDTH) << 11) | ((y * 63 / HEIGHT) << 5) | 0x08;
+        seed = seed * 1103515245 + 12345;
+        if ((y % 120) >= 70 && (y % 120) < 80 && (seed >> 16) % 3 == 0)
+          color = 0xFFFF;
+        const int cx = x % 160, cy = y % 120;
+        if ((cx < 12 || cx > 147) && (cy < 12 || cy > 107))
+          a = 0;
+      } else if (alpha) {
+        a = (x + y) % 160 < 20 ? 0x60 : 0;
+      }
+      uint8_t *p = &pixels[(y * WIDTH + x) * pixel_size];
+      p[0] = color >> 8;
+      p[1] = color;
+      if (alpha)
+        p[2] = a;
+    }
+  }
+  return pixels;
+}
+
+void check_image(const char *name, const image::Image &source, bool clip) {
+  image::Image img = source;
+  TestDisplay spans(true);
+  TestDisplay pixels(false);
+  for (TestDisplay *display : {&spans, &pixels}) {
+    display->clear_buffer();
+    if (clip)
+      display->start_clipping(display::Rect(37, 21, 200, 150));
+    img.draw(-5, 3, display, display::COLOR_ON, display::COLOR_OFF);
+    if (clip)
+      display->end_clipping();
+  }
+  EXPECT_TRUE(spans.buffer() == pixels.buffer());
+  EXPECT_TRUE(spans.native_calls > 0 && spans.pixel_calls == 0);
+  EXPECT_TRUE(pixels.native_calls == 0 && pixels.pixel_calls > 0);
+
+  const uint32_t iterations = 200;
+  double spans_ns = esphome::test::bench_ns(iterations, [&] { img.draw(0, 0, &spans, Color(), Color()); });
+  double pixels_ns = esphome::test::bench_ns(iterations, [&] { img.draw(0, 0, &pixels, Color(), Color()); });
+  printf("%-28s per pixel %7.1f us, spans %7.1f us (%" PRIu32 " spans per draw)\n", name, pixels_ns / 1000,
+         spans_ns / 1000, spans.native_calls / (iterations + 1));
+}
+
+}  // namespace
+
+void setup() {
+  const std::vector<uint8_t> opaque = make_pixels(false);
+  const std::vector<uint8_t> opaque_rle = rle_encode(opaque, WIDTH, HEIGHT, 2);
+  image::Image opaque_img(opaque_rle.data(), WIDTH, HEIGHT, image::IMAGE_TYPE_RGB565, image::TRANSPARENCY_OPAQUE,
+                          image::IMAGE_COMPRESSION_RLE);
+  const std::vector<uint8_t> alpha = make_pixels(true);
+  const std::vector<uint8_t> alpha_rle = rle_encode(alpha, WIDTH, HEIGHT, 3);
+  image::Image alpha_img(alpha_rle.data(), WIDTH, HEIGHT, image::IMAGE_TYPE_RGB565,
+                         image::TRANSPARENCY_ALPHA_CHANNEL, image::IMAGE_COMPRESSION_RLE);
+
+  // The decoder sees the same pixels as the encoder got
+  for (int y = 0; y < HEIGHT; y += 7) {
+    for (int x = 0; x < WIDTH; x += 3) {
+      const uint8_t *p = &opaque[(y * WIDTH + x) * 2];
+      const Color color = opaque_img.get_pixel(x, y);
+      const uint16_t rgb565 = (color.r & 0xF8) << 8 | (color.g & 0xFC) << 3 | color.b >> 3;
+      EXPECT_TRUE(rgb565 == encode_uint16(p[0], p[1]));
+    }
+  }
+
+  printf("RLE %dx%d RGB565: %zu bytes opaque, %zu bytes with alpha\n", WIDTH, HEIGHT, opaque_rle.size(),
+         alpha_rle.size());
+  check_image("opaque", opaque_img, false);
+  check_image("opaque, clipped", opaque_img, true);
+  check_image("alpha", alpha_img, false);
+  check_image("alpha, clipped", alpha_img, true);
+  exit(esphome::test::finish("image"));
+}
+
+void loop() {}
@@ -0,0 +1 @@
+#define USE_JSON
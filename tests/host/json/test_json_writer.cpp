@@ -0,0 +1,235 @@
+// JsonWriter must produce the same text as build_json() for the web_server entity payloads, without allocating.
+// Renders 200 entities both ways (state events and the DETAIL_ALL payloads sent on connect) and compares the
+// output byte for byte, the heap use and the time.
+
+#include "esphome/components/json/json_util.h"
+#include "esphome/components/json/json_writer.h"
+#include "esphome/core/helpers.h"
+#include "test_helpers.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+namespace {
+
+// Heap use while counting is enabled; operator new ends up in malloc() as well
+bool counting = false;
+size_t allocations = 0;
+size_t allocated_bytes = 0;
+
+void count(size_t size) {
+  if (counting) {
+    allocations++;
+    allocated_bytes += size;
+  }
+}
+
+}  // namespace
+
+extern "C" void *malloc(size_t size) {
+  count(size);
+  return __libc_malloc(size);
+}
+extern "C" void *calloc(size_t count_, size_t size) {
+  count(count_ * size);
+  return __libc_calloc(count_, size);
+}
+extern "C" void *realloc(void *ptr, size_t size) {
+  count(size);
+  return __libc_realloc(ptr, size);
+}
+extern "C" void free(void *ptr) { __libc_free(ptr); }
+
+namespace {
+
+using esphome::json::JsonWriter;
+
+enum class Kind { SENSOR, BINARY_SENSOR, SELECT };
+
+// What web_server reads from a sensor, binary sensor or select
+struct Entity {
+  Kind kind;
+  std::string object_id;
+  std::string name;
+  std::string icon;
+  float value;
+  int8_t accuracy;
+  std::string uom;
+  std::vector<std::string> options;
+};
+
+// Same members in the same order as WebServer::*_json() with build_json()
+std::string render_arduinojson(const Entity &e, bool all) {
+  return esphome::json::build_json([&](JsonObject root) {
+    const char *prefix = e.kind == Kind::SENSOR ? "sensor-" : e.kind == Kind::SELECT ? "select-" : "binary_sensor-";
+    root["id"] = prefix + e.object_id;
+    if (all) {
+      root["name"] = e.name;
+      root["icon"] = e.icon;
+      root["entity_category"] = 0;
+    }
+    switch (e.kind) {
+      case Kind::SENSOR: {
+        root["value"] = e.value;
+        std::string state = "NA";
+        if (!std::isnan(e.value)) {
+          state = esphome::value_accuracy_to_string(e.value, e.accuracy);
+          if (!e.uom.empty())
+            state += " " + e.uom;
+        }
+        root["state"] = state;
+        if (all && !e.uom.empty())
+          root["uom"] = e.uom;
+        break;
+      }
+      case Kind::BINARY_SENSOR:
+        root["value"] = e.value != 0;
+        root["state"] = e.value != 0 ? "ON" : "OFF";
+        break;
+      case Kind::SELECT: {
+        const std::string &option = e.options[static_cast<size_t>(e.value)];
+        root["value"] = option;
+        root["state"] = option;
+        if (all) {
+          JsonArray opt = root["option"].to<JsonArray>();
+          for (auto &o : e.options)
+            opt.add(o);
+        }
+        break;
+      }
+    }
+  });
+}
+
+// Same as the JsonWriter fast paths in web_server.cpp
+std::string render_writer(const Entity &e, bool all) {
+  char buf[512];
+  JsonWriter writer(buf, sizeof(buf));
+  writer.begin_object();
+  const char *prefix = e.kind == Kind::SENSOR ? "sensor-" : e.kind == Kind::SELECT ? "select-" : "binary_sensor-";
+  writer.add("id", prefix, e.object_id);
+  if (all) {
+    writer.add("name", e.name);
+    writer.add("icon", e.icon);
+    writer.add("entity_category", static_cast<uint32_t>(0));
+  }
+  switch (e.kind) {
+    case Kind::SENSOR:
+      writer.add("value", e.value);
+      writer.begin_string("state");
+      if (std::isnan(e.value)) {
+        writer.append_string("NA");
+      } else {
+        writer.append_accuracy(e.value, e.accuracy);
+        if (!e.uom.empty()) {
+          writer.append_string(" ", 1);
+          writer.append_string(e.uom);
+        }
+      }
+      writer.end_string();
+      if (all && !e.uom.empty())
+        writer.add("uom", e.uom);
+      break;
+    case Kind::BINARY_SENSOR:
+      writer.add("value", e.value != 0);
+      writer.add("state", e.value != 0 ? "ON" : "OFF");
+      break;
+    case Kind::SELECT: {
+      const std::string &option = e.options[static_cast<size_t>(e.value)];
+      writer.add("value", option);
+      writer.add("state", option);
+      if (all) {
+        writer.begin_array("option");
+        for (auto &o : e.options)
+          writer.add_element(o);
+        writer.end_array();
+      }
+      break;
+    }
+  }
+  writer.end_object();
+  if (writer.overflowed())
+    return "<overflow>";
+  return std::string(writer.c_str(), writer.size());
+}
+
+std::vector<Entity> make_entities() {
+  static const float VALUES[] = {0.0f, 23.4f, -7.25f, 1013.25f, 1e7f, 12345678.0f, 0.000012f, 99.99f, NAN, 3.0f};
+  static const char *const UNITS[] = {"°C", "%", "hPa", "", "µg/m³"};
+  std::vector<Entity> entities;
+  for (int i = 0; i < 200; i++) {
+    Entity e;
+    e.kind = static_cast<Kind>(i % 3);
+    e.object_id = "entity_" + std::to_string(i);
+    e.name = "Entity " + std::to_string(i);
+    e.icon = i % 4 == 0 ? "" : "mdi:thermometer";
+    e.value = VALUES[i % 10];
+    e.accuracy = static_cast<int8_t>(i % 4) - 1;
+    e.uom = UNITS[i % 5];
+    if (e.kind == Kind::SELECT) {
+      e.options = {"Off", "Low", "Medium", "High"};
+      e.value = static_cast<float>(i % 4);
+    } else if (e.kind == Kind::BINARY_SENSOR) {
+      e.value = i % 2;
+    }
+    entities.push_back(e);
+  }
+  // Strings that need escaping
+  entities[0].name = "Quote \" backslash \\ slash / tab \t newline \n";
+  entities[1].name = std::string("bell \a escape \x1b null ") + '\0' + " end";
+  entities[2].options = {"\"quoted\"", "line\r\nbreak", "\b\f"};
+  entities[2].value = 1;
+  return entities;
+}
+
+void test_same_output(const std::vector<Entity> &entities) {
+  for (bool all : {false, true}) {
+    for (const Entity &e : entities)
+      EXPECT_STREQ(render_writer(e, all), render_arduinojson(e, all));
+  }
+}
+
+void bench(const std::vector<Entity> &entities, bool all) {
+  const uint32_t rounds = 200;
+  size_t bytes = 0;
+  auto measure = [&](std::string (*render)(const Entity &, bool), size_t *count, size_t *heap) {
+    allocations = allocated_bytes = 0;
+    counting = true;
+    for (const Entity &e : entities)
+      bytes += render(e, all).size();
+    counting = false;
+    *count = allocations;
+    *heap = allocated_bytes;
+    return esphome::test::bench_ns(rounds, [&] {
+             for (const Entity &e : entities)
+               bytes += render(e, all).size();
+           }) /
+           1000.0;
+  };
+  size_t aj_count, aj_heap, w_count, w_heap;
+  double aj_us = measure(render_arduinojson, &aj_count, &aj_heap);
+  double w_us = measure(render_writer, &w_count, &w_heap);
+  printf("%s, %zu entities: build_json %.0f us, %zu allocations, %zu bytes; JsonWriter %.0f us, %zu allocations, "
+         "%zu bytes\n",
+         all ? "DETAIL_ALL" : "DETAIL_STATE", entities.size(), aj_us, aj_count, aj_heap, w_us, w_count, w_heap);
+  // Only the returned std::string may allocate (small ones don't at all)
+  EXPECT_TRUE(w_count <= entities.size());
+}
+
+}  // namespace
+
+void setup() {
+  auto entities = make_entities();
+  test_same_output(entities);
+  bench(entities, false);
+  bench(entities, true);
+  exit(esphome::test::finish("json_writer"));
+}
+
+void loop() {}
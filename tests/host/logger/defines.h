@@ -0,0 +1 @@
+#define USE_LOGGER_BINARY_LOG
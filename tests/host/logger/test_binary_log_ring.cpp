@@ -0,0 +1,122 @@
+// Deferred formatting must produce the same text as formatting eagerly, without reading past any argument.
+
+#include "esphome/components/logger/binary_log_ring.h"
+#include "esphome/core/log.h"
+#include "test_helpers.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+
+using esphome::logger::BinaryLogRing;
+
+namespace {
+
+bool __attribute__((format(printf, 2, 3))) push(BinaryLogRing &ring, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  bool ok = ring.push(ESPHOME_LOG_LEVEL_DEBUG, "test", __LINE__, nullptr, format, args);
+  va_end(args);
+  return ok;
+}
+
+// Drain one record, like the logger's main loop does
+std::string pop(BinaryLogRing &ring) {
+  BinaryLogRing::Record *record;
+  if (!ring.borrow_record_main_loop(&record))
+    return "<empty>";
+  char buffer[256];
+  BinaryLogRing::format_record(*record, buffer, sizeof(buffer));
+  ring.release_record_main_loop();
+  return buffer;
+}
+
+#define EXPECT_FORMAT(ring, format, ...) \
+  do { \
+    char expected[256]; \
+    snprintf(expected, sizeof(expected), format, __VA_ARGS__); \
+    EXPECT_TRUE(push(ring, format, __VA_ARGS__)); \
+    EXPECT_STREQ(pop(ring), expected); \
+  } while (0)
+
+void test_conversions() {
+  BinaryLogRing ring(4);
+  EXPECT_FORMAT(ring, "%d %i %u %x %X %o", -5, 7, 4000000000u, 0xbeef, 0xBEEF, 8);
+  EXPECT_FORMAT(ring, "%ld %lu %lld %llu", -1L, 2UL, -3LL, 18446744073709551615ULL);
+  EXPECT_FORMAT(ring, "%zu %hhu %hd %jd %td", sizeof(ring), 200, -300, (intmax_t) -4, (ptrdiff_t) 5);
+  EXPECT_FORMAT(ring, "%.2f %e %g %5.1f|%-6.2f|", 23.456, 1e-7, 0.5, 3.14159, 2.5);
+  EXPECT_FORMAT(ring, "%c%c %p", 'o', 'k', (void *) 0x1234);
+  EXPECT_FORMAT(ring, "%s=%s %-8s| %8s|", "key", "value", "left", "right");
+  EXPECT_FORMAT(ring, "%*d|%-*d|%.*f", 6, 42, 4, 7, 3, 1.0 / 3);
+  EXPECT_FORMAT(ring, "100%% %s", "done");
+  EXPECT_FORMAT(ring, "%.3s %.0s| %.s| %.*s %.*s", "abcdef", "gone", "gone", 2, "xyz", -1, "all");
+}
+
+// A "%.*s" or "%.Ns" argument may point into a buffer without a terminator. Put the slice right in front of
+// a page that can't be read, so reading one byte too many crashes the test.
+void test_unterminated_slice() {
+  const size_t page = sysconf(_SC_PAGESIZE);
+  auto *mapping = static_cast<char *>(mmap(nullptr, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  EXPECT_TRUE(mapping != MAP_FAILED);
+  if (mapping == MAP_FAILED)
+    return;
+  mprotect(mapping + page, page, PROT_NONE);
+  char *slice = mapping + page - 5;
+  memcpy(slice, "hello", 5);
+
+  BinaryLogRing ring(4);
+  EXPECT_TRUE(push(ring, "[%.*s]", 5, slice));
+  EXPECT_STREQ(pop(ring), "[hello]");
+  EXPECT_TRUE(push(ring, "[%.5s]", slice));
+  EXPECT_STREQ(pop(ring), "[hello]");
+  EXPECT_TRUE(push(ring, "[%-7.*s]", 3, slice + 2));
+  EXPECT_STREQ(pop(ring), "[llo    ]");
+  munmap(mapping, page * 2);
+}
+
+void test_rejected() {
+  BinaryLogRing ring(2);
+  // Too long for the argument area, and conversions that can't be deferred: the logger formats these eagerly
+  std::string long_string(BinaryLogRing::MAX_ARGS_SIZE, 'x');
+  EXPECT_TRUE(!push(ring, "%s", long_string.c_str()));
+  EXPECT_TRUE(push(ring, "%.10s", long_string.c_str()));
+  EXPECT_STREQ(pop(ring), "xxxxxxxxxx");
+  EXPECT_TRUE(!push(ring, "%ls", L"wide"));
+
+  EXPECT_TRUE(push(ring, "%d", 1));
+  EXPECT_TRUE(push(ring, "%d", 2));
+  EXPECT_TRUE(!push(ring, "%d", 3));
+  EXPECT_STREQ(pop(ring), "1");
+  EXPECT_STREQ(pop(ring), "2");
+  EXPECT_STREQ(pop(ring), "<empty>");
+}
+
+void bench() {
+  BinaryLogRing ring(64);
+  char buffer[256];
+  const uint32_t iterations = 1000000;
+  double eager = esphome::test::bench_ns(iterations, [&] {
+    snprintf(buffer, sizeof(buffer), "Got %d bytes from %s in %.1f ms", 1234, "http://example.com/image.jpg", 12.5);
+  });
+  double deferred = esphome::test::bench_ns(iterations, [&] {
+    push(ring, "Got %d bytes from %s in %.1f ms", 1234, "http://example.com/image.jpg", 12.5);
+    BinaryLogRing::Record *record;
+    if (ring.borrow_record_main_loop(&record))
+      ring.release_record_main_loop();
+  });
+  printf("log call: snprintf %.0f ns, ring capture %.0f ns\n", eager, deferred);
+}
+
+}  // namespace
+
+void setup() {
+  test_conversions();
+  test_unterminated_slice();
+  test_rejected();
+  bench();
+  exit(esphome::test::finish("binary_log_ring"));
+}
+
+void loop() {}
@@ -0,0 +1,3 @@
+#define USE_SENSOR
+#define ESPHOME_ENTITY_SENSOR_COUNT 32
+#define USE_UART
@@ -0,0 +1,257 @@
+// Modbus polling over the host UART: the controllers of two devices on one bus talk through a pty to simulated
+// Modbus RTU slaves, which answer with the timing of a 9600 baud line. Checks the decoded values and the cycle
+// metrics, and compares the requests and the cycle time without and with max_register_gap.
+//
+// Creating the register ranges changes the offsets of the sensors, so each configuration runs in a freshly forked
+// device with new components, which sends its results back through a pipe.
+
+#include "esphome/components/modbus/modbus.h"
+#include "esphome/components/modbus_controller/modbus_controller.h"
+#include "esphome/components/modbus_controller/sensor/modbus_sensor.h"
+#include "esphome/components/uart/uart_component_host.h"
+#include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "test_helpers.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace esphome;
+using modbus_controller::ModbusRegisterType;
+using modbus_controller::ModbusSensor;
+using modbus_controller::SensorValueType;
+
+namespace {
+
+const uint32_t BAUD_RATE = 9600;
+// 10 bits per byte with start and stop bit
+const double BYTE_MS = 10000.0 / BAUD_RATE;
+// Time the slave takes between the end of the request and the start of its response
+const double TURNAROUND_MS = 2.0;
+const uint8_t ADDRESSES[] = {1, 2};
+const int DEVICES = sizeof(ADDRESSES);
+const int CYCLES = 3;
+// Holding registers read by 1 register sensors, and the first register of a 2 register one
+const uint16_t WORD_REGISTERS[] = {0, 1, 3, 6, 7, 10, 20, 22};
+const uint16_t DWORD_REGISTER = 40;
+const int SENSORS = sizeof(WORD_REGISTERS) / sizeof(WORD_REGISTERS[0]) + 1;
+
+/// The content of a holding register of a slave. Small enough for the 2 register values to be exact as a float.
+uint16_t register_value(uint8_t address, uint16_t reg) { return address * 100 + reg; }
+
+/// Modbus RTU slaves for all ADDRESSES on the master side of the pty, answering "read holding registers".
+class SimulatedSlaves {
+ public:
+  explicit SimulatedSlaves(int fd) : fd_(fd), thread_([this] { this->run_(); }) {}
+  ~SimulatedSlaves() {
+    this->stop_ = true;
+    this->thread_.join();
+  }
+
+  std::atomic<uint32_t> requests{0};
+
+ protected:
+  void run_() {
+    std::vector<uint8_t> frame;
+    while (!this->stop_) {
+      struct pollfd pfd = {this->fd_, POLLIN, 0};
+      if (poll(&pfd, 1, 10) <= 0)
+        continue;
+      uint8_t buf[64];
+      ssize_t len = read(this->fd_, buf, sizeof(buf));
+      if (len <= 0)
+        continue;
+      frame.insert(frame.end(), buf, buf + len);
+      // All requests of the controller are 8 bytes: address, function, start, count and CRC
+      while (frame.size() >= 8) {
+        this->answer_(frame.data());
+        frame.erase(frame.begin(), frame.begin() + 8);
+      }
+    }
+  }
+
+  void answer_(const uint8_t *request) {
+    const uint16_t crc = crc16(request, 6);
+    if (request[6] != (crc & 0xFF) || request[7] != (crc >> 8) || request[1] != 0x03)
+      return;
+    if (std::find(std::begin(ADDRESSES), std::end(ADDRESSES), request[0]) == std::end(ADDRESSES))
+      return;
+    this->requests++;
+    const uint16_t start = encode_uint16(request[2], request[3]);
+    const uint16_t count = encode_uint16(request[4], request[5]);
+    std::vector<uint8_t> response = {request[0], 0x03, static_cast<uint8_t>(count * 2)};
+    for (uint16_t reg = start; reg < start + count; reg++) {
+      const uint16_t value = register_value(request[0], reg);
+      response.push_back(value >> 8);
+      response.push_back(value);
+    }
+    const uint16_t response_crc = crc16(response.data(), response.size());
+    response.push_back(response_crc);
+    response.push_back(response_crc >> 8);
+    // The request and the response go over the line one after the other; the pty itself takes no time
+    const double ms = (8 + response.size()) * BYTE_MS + TURNAROUND_MS;
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(ms * 1000)));
+    if (write(this->fd_, response.data(), response.size()) != static_cast<ssize_t>(response.size()))
+      return;
+  }
+
+  int fd_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+struct BusResult {
+  bool started;
+  bool values_ok;
+  uint32_t requests;
+  double cycle_ms;  // Mean time from update() until all sensors published, over CYCLES cycles
+  uint32_t last_cycle_duration[DEVICES];
+  uint32_t max_cycle_duration[DEVICES];
+  uint16_t last_cycle_commands[DEVICES];
+  uint32_t last_cycle_bytes[DEVICES];
+};
+
+/// Poll both devices CYCLES times on a bus with the given max_register_gap.
+BusResult run_bus(uint8_t max_register_gap) {
+  BusResult result{};
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    return result;
+  SimulatedSlaves slaves(master);
+
+  App.pre_setup("modbus-test", "", "", "", false);
+  auto *uart = new uart::HostUartComponent();  // NOLINT(cppcoreguidelines-owning-memory)
+  uart->set_name(ptsname(master));
+  uart->set_baud_rate(BAUD_RATE);
+  uart->set_data_bits(8);
+  uart->set_parity(uart::UART_CONFIG_PARITY_NONE);
+  uart->set_stop_bits(1);
+  App.register_component(uart);
+  auto *bus = new modbus::Modbus();  // NOLINT(cppcoreguidelines-owning-memory)
+  bus->set_uart_parent(uart);
+  bus->set_role(modbus::ModbusRole::CLIENT);
+  App.register_component(bus);
+
+  modbus_controller::ModbusController *controllers[DEVICES];
+  std::vector<float> states(DEVICES * SENSORS, NAN);
+  std::vector<float> expected(DEVICES * SENSORS);
+  for (int d = 0; d < DEVICES; d++) {
+    auto *controller = new modbus_controller::ModbusController();  // NOLINT(cppcoreguidelines-owning-memory)
+    controller->set_parent(bus);
+    controller->set_address(ADDRESSES[d]);
+    controller->set_max_register_gap(max_register_gap);
+    // Cycles are started by the test
+    controller->set_update_interval(SCHEDULER_DONT_RUN);
+    bus->register_device(controller);
+    for (int s = 0; s < SENSORS; s++) {
+      const bool dword = s == SENSORS - 1;
+      const uint16_t reg = dword ? DWORD_REGISTER : WORD_REGISTERS[s];
+      auto *sensor =  // NOLINT(cppcoreguidelines-owning-memory)
+          new ModbusSensor(ModbusRegisterType::HOLDING, reg, 0, 0xFFFFFFFF,
+                           dword ? SensorValueType::U_DWORD : SensorValueType::U_WORD, dword ? 2 : 1, 0, false);
+      expected[d * SENSORS + s] = dword ? static_cast<float>(uint32_t(register_value(ADDRESSES[d], reg)) << 16 |
+                                                             register_value(ADDRESSES[d], reg + 1))
+                                        : register_value(ADDRESSES[d], reg);
+      sensor->add_on_state_callback([&states, d, s](float state) { states[d * SENSORS + s] = state; });
+      controller->add_sensor_item(sensor);
+    }
+    App.register_component(controller);
+    controllers[d] = controller;
+  }
+  App.setup();
+  result.started = !uart->is_failed();
+
+  result.values_ok = result.started;
+  double total_ms = 0;
+  for (int cycle = 0; cycle < CYCLES && result.started; cycle++) {
+    std::fill(states.begin(), states.end(), NAN);
+    auto start = std::chrono::steady_clock::now();
+    for (auto *controller : controllers)
+      controller->update();
+    while (std::any_of(states.begin(), states.end(), [](float state) { return std::isnan(state); }) &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+      App.loop();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    total_ms += elapsed.count();
+    result.values_ok &= states == expected;
+    // The cycle of each controller ends in the loop after its last response
+    App.loop();
+  }
+  result.cycle_ms = total_ms / CYCLES;
+  result.requests = slaves.requests;
+  for (int d = 0; d < DEVICES; d++) {
+    result.last_cycle_duration[d] = controllers[d]->get_last_cycle_duration();
+    result.max_cycle_duration[d] = controllers[d]->get_max_cycle_duration();
+    result.last_cycle_commands[d] = controllers[d]->get_last_cycle_commands();
+    result.last_cycle_bytes[d] = controllers[d]->get_last_cycle_bytes();
+  }
+  return result;
+}
+
+/// Run run_bus() in a forked device.
+BusResult run_device(uint8_t max_register_gap) {
+  BusResult result{};
+  int pipe_fds[2];
+  if (pipe(pipe_fds) != 0)
+    return result;
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(pipe_fds[0]);
+    alarm(60);
+    result = run_bus(max_register_gap);
+    _exit(write(pipe_fds[1], &result, sizeof(result)) == sizeof(result) ? 0 : 1);
+  }
+  close(pipe_fds[1]);
+  if (read(pipe_fds[0], &result, sizeof(result)) != sizeof(result))
+    result = BusResult{};
+  close(pipe_fds[0]);
+  waitpid(pid, nullptr, 0);
+  return result;
+}
+
+void check_bus(const char *name, const BusResult &result, uint16_t commands, uint32_t bytes) {
+  EXPECT_TRUE(result.started);
+  EXPECT_TRUE(result.values_ok);
+  EXPECT_TRUE(result.requests == CYCLES * DEVICES * commands);
+  for (int d = 0; d < DEVICES; d++) {
+    EXPECT_TRUE(result.last_cycle_commands[d] == commands);
+    EXPECT_TRUE(result.last_cycle_bytes[d] == bytes);
+    EXPECT_TRUE(result.last_cycle_duration[d] > 0 && result.last_cycle_duration[d] <= result.cycle_ms + 1);
+    EXPECT_TRUE(result.max_cycle_duration[d] >= result.last_cycle_duration[d]);
+  }
+  // The next request goes out as soon as a response is in, whichever device it is for: the cycle takes little more
+  // than the time on the line. Sending one command per loop pass would add a loop interval (16 ms) to each.
+  const double line_ms = DEVICES * (commands * (8 + 5 + TURNAROUND_MS / BYTE_MS) + bytes) * BYTE_MS;
+  EXPECT_TRUE(result.cycle_ms < 1.5 * line_ms);
+  printf("%-20s %u requests per device, %2" PRIu32 " data bytes, cycle %5.1f ms (%5.1f ms on the line), device "
+         "cycles %" PRIu32 " and %" PRIu32 " ms\n",
+         name, result.last_cycle_commands[0], result.last_cycle_bytes[0], result.cycle_ms, line_ms,
+         result.last_cycle_duration[0], result.last_cycle_duration[1]);
+}
+
+}  // namespace
+
+void setup() {
+  // Registers 0-1, 3, 6-7, 10, 20, 22 and 40-41: 7 requests for 10 registers
+  const BusResult contiguous = run_device(0);
+  check_bus("max_register_gap: 0", contiguous, 7, 20);
+  // 0-10, 20-22 and 40-41, reading the 5 registers in between: 3 requests for 16 registers
+  const BusResult merged = run_device(4);
+  check_bus("max_register_gap: 4", merged, 3, 32);
+  EXPECT_TRUE(merged.cycle_ms < contiguous.cycle_ms);
+  exit(esphome::test::finish("modbus"));
+}
+
+void loop() {}
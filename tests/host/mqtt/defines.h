@@ -0,0 +1,3 @@
+#define USE_MQTT
+#define USE_MQTT_PUBLISH_QUEUE
+#define USE_NETWORK
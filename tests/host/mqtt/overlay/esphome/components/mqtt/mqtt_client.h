@@ -0,0 +1,16 @@
+#pragma once
+// Test double of MQTTClientComponent for the host tests: the core only asks it whether it is connected, the queue is
+// tested against a broker stand-in without a client.
+
+namespace esphome {
+namespace mqtt {
+
+class MQTTClientComponent {
+ public:
+  bool is_connected() const { return false; }
+};
+
+inline MQTTClientComponent *global_mqtt_client = nullptr;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,17 @@
+#pragma once
+// Test double of MQTTComponent for the host tests: only what the publish queue calls, counting the requests to send
+// the state again.
+#include <cstdint>
+
+namespace esphome {
+namespace mqtt {
+
+class MQTTComponent {
+ public:
+  void schedule_resend_state() { this->resend_requests++; }
+
+  uint32_t resend_requests{0};
+};
+
+}  // namespace mqtt
+}  // namespace esphome
@@ -0,0 +1,240 @@
+// The MQTT publish queue against a broker stand-in that, like a client whose send buffer is full, only takes a few
+// messages per loop. Sensors publishing far faster than that must end up with their latest state at the broker,
+// without the queue growing; every message is either sent, replaced by a newer one to its topic or dropped.
+// Also checks eviction for messages with a higher QoS, the batch window, the order under backpressure and timestamps
+// that roll over.
+//
+// The minimum interval per entity is computed by MQTTComponent, which builds JSON and so does not build on the host;
+// it is not covered here.
+
+#include "esphome/components/mqtt/mqtt_backend.h"
+#include "esphome/components/mqtt/mqtt_component.h"
+#include "esphome/components/mqtt/mqtt_publish_queue.h"
+#include "esphome/core/helpers.h"
+#include "test_helpers.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using mqtt::MQTTComponent;
+using mqtt::MQTTMessage;
+using mqtt::MQTTPublishQueue;
+
+namespace {
+
+/// The broker behind a client connection: takes up to window messages, then refuses more until loop() ran.
+class TestBroker : public mqtt::MQTTBackend {
+ public:
+  explicit TestBroker(size_t window) : window_(window) {}
+
+  using MQTTBackend::publish;
+  bool publish(const char *topic, const char *payload, size_t length, uint8_t qos, bool retain) override {
+    if (this->in_flight_ >= this->window_) {
+      this->refused++;
+      return false;
+    }
+    this->in_flight_++;
+    this->received.push_back(topic);
+    this->last_payload[topic] = std::string(payload, length);
+    return true;
+  }
+  void loop() override { this->in_flight_ = 0; }
+
+  void set_keep_alive(uint16_t keep_alive) override {}
+  void set_client_id(const char *client_id) override {}
+  void set_clean_session(bool clean_session) override {}
+  void set_credentials(const char *username, const char *password) override {}
+  void set_will(const char *topic, uint8_t qos, bool retain, const char *payload) override {}
+  void set_server(network::IPAddress ip, uint16_t port) override {}
+  void set_server(const char *host, uint16_t port) override {}
+  void set_on_connect(std::function<on_connect_callback_t> &&callback) override {}
+  void set_on_disconnect(std::function<on_disconnect_callback_t> &&callback) override {}
+  void set_on_subscribe(std::function<on_subscribe_callback_t> &&callback) override {}
+  void set_on_unsubscribe(std::function<on_unsubscribe_callback_t> &&callback) override {}
+  void set_on_message(std::function<on_message_callback_t> &&callback) override {}
+  void set_on_publish(std::function<on_publish_user_callback_t> &&callback) override {}
+  bool connected() const override { return true; }
+  void connect() override {}
+  void disconnect() override {}
+  bool subscribe(const char *topic, uint8_t qos) override { return true; }
+  bool unsubscribe(const char *topic) override { return true; }
+
+  /// Topics in the order they arrived
+  std::vector<std::string> received;
+  std::map<std::string, std::string> last_payload;
+  uint32_t refused{0};
+
+ protected:
+  size_t window_;
+  size_t in_flight_{0};
+};
+
+MQTTMessage message(const std::string &topic, const std::string &payload, uint8_t qos = 0) {
+  return MQTTMessage{topic, payload, qos, true};
+}
+
+/// Flush like MQTTClientComponent::loop() does, then let the broker take the next messages.
+void flush(MQTTPublishQueue &queue, TestBroker &broker, uint32_t now) {
+  queue.flush(now, [&broker](const MQTTMessage &m) { return broker.publish(m); });
+  broker.loop();
+}
+
+std::string topic(int i) { return "sensor/s" + to_string(i) + "/state"; }
+
+void check_coalescing() {
+  const int sensors = 50;
+  const uint32_t duration_ms = 10000;
+  MQTTPublishQueue queue;
+  queue.set_max_length(64);
+  TestBroker broker(4);
+  std::vector<MQTTComponent> owners(sensors);
+
+  // Every sensor publishes every millisecond, there is one loop per millisecond
+  uint32_t published = 0;
+  size_t max_size = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t now = 0; now < duration_ms; now++) {
+    for (int i = 0; i < sensors; i++) {
+      EXPECT_TRUE(queue.push(message(topic(i), to_string(now)), now, &owners[i]));
+      published++;
+    }
+    max_size = std::max(max_size, queue.size());
+    flush(queue, broker, now);
+  }
+  uint32_t now = duration_ms;
+  while (queue.size() > 0 && now < 2 * duration_ms)
+    flush(queue, broker, now++);
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+  // The broker has the last state of each sensor, and the queue never held more than one message per sensor
+  for (int i = 0; i < sensors; i++)
+    EXPECT_STREQ(broker.last_payload[topic(i)], to_string(duration_ms - 1));
+  EXPECT_TRUE(max_size == sensors);
+  EXPECT_TRUE(queue.size() == 0);
+  // Nothing lost without being replaced by a newer state
+  EXPECT_TRUE(queue.get_dropped_count() == 0);
+  EXPECT_TRUE(broker.received.size() + queue.get_coalesced_count() == published);
+  // The broker was kept busy: it took 4 messages in every loop but the last
+  EXPECT_TRUE(broker.received.size() > (now - 1) * 4 && broker.received.size() <= now * 4);
+  for (const auto &owner : owners)
+    EXPECT_TRUE(owner.resend_requests == 0);
+
+  printf("%d sensors every ms for %" PRIu32 " s, broker takes 4 per loop: %" PRIu32 " published, %zu sent, %" PRIu32
+         " coalesced, %zu max queued, %.0f ns per message\n",
+         sensors, duration_ms / 1000, published, broker.received.size(), queue.get_coalesced_count(), max_size,
+         elapsed.count() * 1e6 / published);
+}
+
+void check_eviction() {
+  MQTTPublishQueue queue;
+  queue.set_max_length(4);
+  TestBroker broker(4);
+  MQTTComponent light, sensor, alarm;
+
+  // Full with a QoS 0 message of no component, two of the light and a QoS 1 message
+  EXPECT_TRUE(queue.push(message("birth", "online"), 0, nullptr));
+  EXPECT_TRUE(queue.push(message("light/state", "ON"), 0, &light));
+  EXPECT_TRUE(queue.push(message("light/brightness", "128"), 0, &light));
+  EXPECT_TRUE(queue.push(message("sensor/state", "21.5", 1), 0, &sensor));
+
+  // A new QoS 0 message is dropped, the component finds out from the return value
+  EXPECT_TRUE(!queue.push(message("sensor/other", "1"), 0, &sensor));
+  EXPECT_TRUE(queue.get_dropped_count() == 1 && queue.size() == 4);
+
+  // A QoS 1 message replaces the oldest QoS 0 message of a component, which sends its state again later
+  EXPECT_TRUE(queue.push(message("alarm/state", "triggered", 1), 0, &alarm));
+  EXPECT_TRUE(queue.get_dropped_count() == 2 && queue.size() == 4);
+  EXPECT_TRUE(light.resend_requests == 1);
+  EXPECT_TRUE(queue.push(message("alarm/other", "1", 2), 0, &alarm));
+  EXPECT_TRUE(light.resend_requests == 2);
+
+  // Only the message without a component and the QoS 1 messages are left, nothing more to replace
+  EXPECT_TRUE(!queue.push(message("alarm/third", "1", 1), 0, &alarm));
+  EXPECT_TRUE(queue.get_dropped_count() == 4 && queue.size() == 4);
+  // An update of a queued topic still gets in
+  EXPECT_TRUE(queue.push(message("sensor/state", "22.0", 1), 0, &sensor));
+
+  flush(queue, broker, 0);
+  const std::vector<std::string> expected = {"birth", "sensor/state", "alarm/state", "alarm/other"};
+  EXPECT_TRUE(broker.received == expected);
+  EXPECT_STREQ(broker.last_payload["sensor/state"], "22.0");
+  EXPECT_TRUE(sensor.resend_requests == 0 && alarm.resend_requests == 0);
+}
+
+void check_batch_window() {
+  MQTTPublishQueue queue;
+  queue.set_batch_window(50);
+  TestBroker broker(16);
+  MQTTComponent owner;
+
+  // Due at 0, 30 and 200: sent at 50 together, and at 250
+  EXPECT_TRUE(queue.push(message("a", "1"), 0, &owner));
+  EXPECT_TRUE(queue.push(message("b", "1"), 30, &owner));
+  EXPECT_TRUE(queue.push(message("c", "1"), 200, &owner));
+  flush(queue, broker, 49);
+  EXPECT_TRUE(broker.received.empty());
+  flush(queue, broker, 50);
+  EXPECT_TRUE(broker.received.size() == 2 && queue.size() == 1);
+  flush(queue, broker, 249);
+  EXPECT_TRUE(broker.received.size() == 2);
+  flush(queue, broker, 250);
+  EXPECT_TRUE(broker.received.size() == 3 && queue.size() == 0);
+}
+
+void check_backpressure() {
+  MQTTPublishQueue queue;
+  TestBroker broker(2);
+  MQTTComponent owner;
+  for (int i = 0; i < 5; i++)
+    EXPECT_TRUE(queue.push(message(topic(i), "1"), 0, &owner));
+
+  // Two go out, the rest keeps its order; a newer state keeps the place of the one it replaces
+  flush(queue, broker, 0);
+  EXPECT_TRUE(broker.received.size() == 2 && queue.size() == 3);
+  EXPECT_TRUE(broker.refused == 1);
+  EXPECT_TRUE(queue.push(message(topic(4), "2"), 0, &owner));
+  EXPECT_TRUE(queue.push(message(topic(0), "2"), 0, &owner));
+  flush(queue, broker, 1);
+  flush(queue, broker, 2);
+  const std::vector<std::string> expected = {topic(0), topic(1), topic(2), topic(3), topic(4), topic(0)};
+  EXPECT_TRUE(broker.received == expected);
+  EXPECT_STREQ(broker.last_payload[topic(4)], "2");
+  EXPECT_TRUE(queue.size() == 0);
+}
+
+void check_rollover() {
+  MQTTPublishQueue queue;
+  TestBroker broker(16);
+  MQTTComponent owner;
+  const uint32_t now = 0xFFFFFFF0;
+
+  // Due after millis() rolled over
+  EXPECT_TRUE(queue.push(message("later", "1"), now + 0x20, &owner));
+  flush(queue, broker, now);
+  flush(queue, broker, 0x0F);
+  EXPECT_TRUE(broker.received.empty());
+  flush(queue, broker, 0x10);
+  EXPECT_TRUE(broker.received.size() == 1);
+
+  // Due before, flushed after it rolled over
+  EXPECT_TRUE(queue.push(message("earlier", "1"), now, &owner));
+  flush(queue, broker, 0x05);
+  EXPECT_TRUE(broker.received.size() == 2 && queue.size() == 0);
+}
+
+}  // namespace
+
+void setup() {
+  check_coalescing();
+  check_eviction();
+  check_batch_window();
+  check_backpressure();
+  check_rollover();
+  exit(esphome::test::finish("mqtt"));
+}
+
+void loop() {}
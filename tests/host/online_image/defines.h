@@ -0,0 +1,3 @@
+#define USE_DISPLAY
+#define USE_ONLINE_IMAGE_BMP_SUPPORT
+#define USE_ONLINE_IMAGE_CACHE
@@ -0,0 +1,139 @@
+#pragma once
+// Test double of http_request for the host tests: requests are answered from responses set by the test, like from
+// a local server, and the request headers and the amount of body read are kept for the checks.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace http_request {
+
+struct Header {
+  std::string name;
+  std::string value;
+};
+
+class HttpRequestComponent;
+
+class HttpContainer : public Parented<HttpRequestComponent> {
+ public:
+  virtual ~HttpContainer() = default;
+  size_t content_length;
+  int status_code;
+  uint32_t duration_ms;
+
+  virtual int read(uint8_t *buf, size_t max_len) = 0;
+  virtual void end() = 0;
+
+  size_t get_bytes_read() const { return this->bytes_read_; }
+
+  std::string get_response_header(const std::string &header_name) {
+    auto it = this->response_headers_.find(str_lower_case(header_name));
+    if (it == this->response_headers_.end() || it->second.empty())
+      return "";
+    return it->second.front();
+  }
+
+ protected:
+  size_t bytes_read_{0};
+  std::map<std::string, std::list<std::string>> response_headers_{};
+};
+
+/// A response of the test server; body is read in pieces of at most chunk bytes, like from a socket.
+/// Without a Content-Length the length reads as SIZE_MAX, like (size_t) -1 from the Arduino client.
+struct TestResponse {
+  int status_code{200};
+  std::vector<uint8_t> body;
+  std::map<std::string, std::string> headers;
+  size_t chunk{1460};
+  bool send_content_length{true};
+};
+
+class TestContainer : public HttpContainer {
+ public:
+  TestContainer(const TestResponse &response, const std::set<std::string> &collect_headers) : response_(response) {
+    this->status_code = response.status_code;
+    this->content_length = response.send_content_length ? response.body.size() : SIZE_MAX;
+    this->duration_ms = 0;
+    for (const auto &header : response.headers) {
+      if (collect_headers.count(header.first) != 0)
+        this->response_headers_[header.first].push_back(header.second);
+    }
+  }
+
+  int read(uint8_t *buf, size_t max_len) override;
+  void end() override {}
+
+ protected:
+  TestResponse response_;
+};
+
+class HttpRequestComponent : public Component {
+ public:
+  void set_timeout(uint16_t timeout) { this->timeout_ = timeout; }
+  uint16_t get_timeout() const { return this->timeout_; }
+
+  /// Answer requests with this response until another is set.
+  void set_response(TestResponse response) { this->response_ = std::move(response); }
+  /// Answer with HTTP 304 when If-None-Match matches the ETag of the response.
+  void set_honor_etag(bool honor) { this->honor_etag_ = honor; }
+
+  std::shared_ptr<HttpContainer> get(const std::string &url, const std::list<Header> &request_headers,
+                                     const std::set<std::string> &collect_headers) {
+    this->requests++;
+    this->last_request_headers.clear();
+    for (const auto &header : request_headers)
+      this->last_request_headers[str_lower_case(header.name)] = header.value;
+    std::set<std::string> lower_case_collect_headers;
+    for (const std::string &collect_header : collect_headers)
+      lower_case_collect_headers.insert(str_lower_case(collect_header));
+
+    auto etag = this->response_.headers.find("etag");
+    auto if_none_match = this->last_request_headers.find("if-none-match");
+    if (this->honor_etag_ && etag != this->response_.headers.end() &&
+        if_none_match != this->last_request_headers.end() && if_none_match->second == etag->second) {
+      TestResponse not_modified;
+      not_modified.status_code = 304;
+      not_modified.headers = this->response_.headers;
+      auto container = std::make_shared<TestContainer>(not_modified, lower_case_collect_headers);
+      container->set_parent(this);
+      return container;
+    }
+    this->full_responses++;
+    auto container = std::make_shared<TestContainer>(this->response_, lower_case_collect_headers);
+    container->set_parent(this);
+    return container;
+  }
+
+  uint32_t requests{0};
+  uint32_t full_responses{0};
+  /// Body bytes read by the clients, over all responses
+  size_t bytes_served{0};
+  std::map<std::string, std::string> last_request_headers;
+
+ protected:
+  TestResponse response_;
+  bool honor_etag_{true};
+  uint16_t timeout_{4500};
+};
+
+inline int TestContainer::read(uint8_t *buf, size_t max_len) {
+  size_t len = std::min({max_len, this->response_.chunk, this->response_.body.size() - this->bytes_read_});
+  memcpy(buf, this->response_.body.data() + this->bytes_read_, len);
+  this->bytes_read_ += len;
+  this->parent_->bytes_served += len;
+  return len;
+}
+
+}  // namespace http_request
+}  // namespace esphome
@@ -0,0 +1,299 @@
+// Startup with the online_image cache. A cold start downloads and decodes the image, a warm start after a reboot
+// restores it from the cache file with one read, and the first update is then answered with 304 instead of the
+// image. The image is saved one sector per loop and only counts as cached once all of it is written.
+// With format AUTO, a local server answers with a mix of images, mislabeled images, error pages and short or empty
+// bodies: images are decoded like with their fixed format, the rest fails without allocating the image buffer.
+
+#include "esphome/components/host/preferences.h"
+#include "esphome/components/online_image/online_image.h"
+#include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "test_helpers.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace esphome;
+using http_request::HttpRequestComponent;
+using http_request::TestResponse;
+using online_image::ImageFormat;
+
+namespace {
+
+const int SIZE = 240;
+const size_t BUFFER_SIZE = SIZE * SIZE * 2;
+const char *const URL = "http://192.168.1.10/snapshot.bmp";
+const uint32_t CACHE_KEY = 0x5EED;
+
+class TestImage : public online_image::OnlineImage {
+ public:
+  explicit TestImage(ImageFormat format = ImageFormat::BMP)
+      : OnlineImage(URL, SIZE, SIZE, format, image::IMAGE_TYPE_RGB565, image::TRANSPARENCY_OPAQUE, 16384, false) {}
+  using OnlineImage::buffer_;
+  using OnlineImage::cache_filename_;
+  using OnlineImage::cache_saving_;
+  using OnlineImage::detect_format_;
+};
+
+/// A 24 bit BMP with gradients and some noise, so every row differs.
+std::vector<uint8_t> make_bmp(int width, int height) {
+  const uint32_t row_bytes = (width * 3 + 3) & ~3;
+  const uint32_t data_size = row_bytes * height;
+  std::vector<uint8_t> bmp(54 + data_size);
+  auto put32 = [&](size_t pos, uint32_t value) {
+    for (int i = 0; i < 4; i++)
+      bmp[pos + i] = value >> (i * 8);
+  };
+  bmp[0] = 'B';
+  bmp[1] = 'M';
+  put32(2, bmp.size());
+  put32(10, 54);
+  put32(14, 40);
+  put32(18, width);
+  put32(22, height);
+  bmp[26] = 1;
+  bmp[28] = 24;
+  put32(34, data_size);
+  uint32_t seed = 1;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      seed = seed * 1103515245 + 12345;
+      uint8_t *p = &bmp[54 + y * row_bytes + x * 3];
+      p[0] = x;
+      p[1] = y;
+      p[2] = (seed >> 16) & 0x3F;
+    }
+  }
+  return bmp;
+}
+
+/// Start like after a reboot: preferences read from the file, a new image, and its setup().
+TestImage *boot(HttpRequestComponent *server) {
+  global_preferences = new host::HostPreferences();  // NOLINT(cppcoreguidelines-owning-memory)
+  auto *image = new TestImage();                     // NOLINT(cppcoreguidelines-owning-memory)
+  image->set_parent(server);
+  image->set_cache_key(CACHE_KEY);
+  image->setup();
+  return image;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+enum class Result { PENDING, FINISHED, FAILED };
+
+/// Update the image and run its loop until the download finished or failed, or for at most max_ms.
+Result download(TestImage *image, uint32_t max_ms = 1000) {
+  Result result = Result::PENDING;
+  image->add_on_finished_callback([&result](bool cached) { result = Result::FINISHED; });
+  image->add_on_error_callback([&result]() { result = Result::FAILED; });
+  auto start = std::chrono::steady_clock::now();
+  image->update();
+  while (result == Result::PENDING && elapsed_ms(start) < max_ms)
+    image->loop();
+  return result;
+}
+
+void check_cache() {
+  HttpRequestComponent server;
+  TestResponse response;
+  response.body = make_bmp(SIZE, SIZE);
+  response.headers = {{"etag", "\"v1\""}, {"content-type", "image/bmp"}};
+  server.set_response(response);
+
+  // Cold start: nothing cached, the image is there once it is downloaded and decoded
+  auto start = std::chrono::steady_clock::now();
+  TestImage *cold = boot(&server);
+  int finished = 0;
+  bool finished_cached = false;
+  cold->add_on_finished_callback([&](bool cached) {
+    finished++;
+    finished_cached = cached;
+  });
+  EXPECT_TRUE(cold->get_data_start() == nullptr);
+  cold->update();
+  for (int i = 0; i < 1000 && finished == 0; i++)
+    cold->loop();
+  const double cold_ms = elapsed_ms(start);
+  EXPECT_TRUE(finished == 1 && !finished_cached);
+  EXPECT_TRUE(cold->get_data_start() != nullptr);
+  EXPECT_TRUE(cold->get_cache_hits() == 0 && cold->get_cache_misses() == 2);
+  const std::vector<uint8_t> decoded(cold->get_data_start(), cold->get_data_start() + BUFFER_SIZE);
+
+  // The image is written over the next loops, at most a sector in each
+  const std::string cache_file = cold->cache_filename_();
+  int loops = 0;
+  uintmax_t written = 0;
+  while (cold->cache_saving_ && loops < 100) {
+    cold->loop();
+    loops++;
+    const uintmax_t size = std::filesystem::file_size(cache_file);
+    EXPECT_TRUE(size > written && size - written <= 4096);
+    written = size;
+  }
+  EXPECT_TRUE(loops == (BUFFER_SIZE + 4095) / 4096);
+  EXPECT_TRUE(written == BUFFER_SIZE);
+  EXPECT_TRUE(global_preferences->sync());
+
+  // Warm start: restored in setup(), before any request
+  start = std::chrono::steady_clock::now();
+  TestImage *warm = boot(&server);
+  const double warm_ms = elapsed_ms(start);
+  EXPECT_TRUE(warm->get_data_start() != nullptr);
+  EXPECT_TRUE(warm->get_cache_hits() == 1 && warm->get_cache_misses() == 0);
+  EXPECT_TRUE(warm->get_data_start() != nullptr &&
+              std::equal(decoded.begin(), decoded.end(), warm->get_data_start()));
+  EXPECT_TRUE(warm_ms < cold_ms);
+
+  // The restored ETag goes with the first update, the server has nothing new
+  finished = 0;
+  warm->add_on_finished_callback([&](bool cached) {
+    finished++;
+    finished_cached = cached;
+  });
+  warm->update();
+  EXPECT_STREQ(server.last_request_headers["if-none-match"], "\"v1\"");
+  EXPECT_TRUE(finished == 1 && finished_cached);
+  EXPECT_TRUE(server.full_responses == 1);
+  EXPECT_TRUE(warm->get_cache_hits() == 2);
+
+  // A reboot before a save is complete finds no usable cache
+  response.body = make_bmp(SIZE, SIZE);
+  response.body[100] ^= 0xFF;
+  response.headers["etag"] = "\"v2\"";
+  server.set_response(response);
+  finished = 0;
+  warm->update();
+  for (int i = 0; i < 1000 && finished == 0; i++)
+    warm->loop();
+  EXPECT_TRUE(finished == 1 && !finished_cached && warm->cache_saving_);
+  for (int i = 0; i < 5; i++)
+    warm->loop();
+  EXPECT_TRUE(global_preferences->sync());
+  TestImage *interrupted = boot(&server);
+  EXPECT_TRUE(interrupted->get_data_start() == nullptr);
+  EXPECT_TRUE(interrupted->get_cache_misses() == 1);
+
+  printf("%dx%d RGB565 image: cold start %.2f ms (download and decode), warm start %.2f ms (restore)\n", SIZE, SIZE,
+         cold_ms, warm_ms);
+}
+
+void check_detect_format() {
+  const uint8_t png[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  const uint8_t jpeg[] = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J', 'F'};
+  const uint8_t bmp[] = {'B', 'M', 0x36, 0x10, 0x0E, 0x00, 0x00, 0x00};
+  const uint8_t other[] = {'G', 'I', 'F', '8', '9', 'a', 0x01, 0x00};
+  // The data decides, whatever the server claims
+  EXPECT_TRUE(TestImage::detect_format_(png, sizeof(png), "") == ImageFormat::PNG);
+  EXPECT_TRUE(TestImage::detect_format_(jpeg, sizeof(jpeg), "image/png") == ImageFormat::JPEG);
+  EXPECT_TRUE(TestImage::detect_format_(bmp, sizeof(bmp), "application/octet-stream") == ImageFormat::BMP);
+  // Too short for the PNG signature
+  EXPECT_TRUE(TestImage::detect_format_(png, 4, "") == ImageFormat::AUTO);
+  EXPECT_TRUE(TestImage::detect_format_(bmp, 2, "") == ImageFormat::BMP);
+  // Unknown data goes by an image Content-Type, parameters and case ignored
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "Image/PNG; charset=binary") == ImageFormat::PNG);
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "image/jpg") == ImageFormat::JPEG);
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "image/x-ms-bmp") == ImageFormat::BMP);
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "image/gif") == ImageFormat::AUTO);
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "application/octet-stream") == ImageFormat::AUTO);
+  EXPECT_TRUE(TestImage::detect_format_(other, sizeof(other), "") == ImageFormat::AUTO);
+}
+
+void check_auto_format() {
+  HttpRequestComponent server;
+  server.set_honor_etag(false);
+  server.set_timeout(100);
+  const std::vector<uint8_t> bmp = make_bmp(SIZE, SIZE);
+
+  // The same image with its format configured, to compare the pixels with
+  TestResponse response;
+  response.body = bmp;
+  response.headers = {{"content-type", "image/bmp"}};
+  server.set_response(response);
+  TestImage reference(ImageFormat::BMP);
+  reference.set_parent(&server);
+  EXPECT_TRUE(download(&reference) == Result::FINISHED);
+  EXPECT_TRUE(reference.get_data_start() != nullptr);
+  if (reference.get_data_start() == nullptr)
+    return;
+  const std::vector<uint8_t> decoded(reference.get_data_start(), reference.get_data_start() + BUFFER_SIZE);
+
+  struct Case {
+    const char *name;
+    TestResponse response;
+    Result result;
+    // Body bytes read before a response that is not decoded is rejected
+    size_t sniffed;
+  };
+  auto with = [&](const std::vector<uint8_t> &body, const char *content_type, size_t chunk = 1460,
+                  bool send_content_length = true) {
+    TestResponse r;
+    r.body = body;
+    if (content_type != nullptr)
+      r.headers["content-type"] = content_type;
+    r.chunk = chunk;
+    r.send_content_length = send_content_length;
+    return r;
+  };
+  const std::string html = "<html><body>502 Bad Gateway</body></html>";
+  const std::string json = "{\"error\": \"camera offline\"}";
+  std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  png.resize(2000);
+  const std::vector<Case> cases = {
+      {"BMP, image/bmp", with(bmp, "image/bmp"), Result::FINISHED, 0},
+      {"BMP, octet-stream, 3 byte reads", with(bmp, "application/octet-stream", 3), Result::FINISHED, 0},
+      {"BMP, no Content-Type", with(bmp, nullptr), Result::FINISHED, 0},
+      {"HTML error page", with(std::vector<uint8_t>(html.begin(), html.end()), "text/html; charset=utf-8"),
+       Result::FAILED, 0},
+      {"JSON error", with(std::vector<uint8_t>(json.begin(), json.end()), "application/json"), Result::FAILED, 0},
+      {"PNG, not compiled in", with(png, "application/octet-stream"), Result::FAILED, 8},
+      {"empty body", with({}, "image/bmp"), Result::FAILED, 0},
+      {"short body, no Content-Length", with({'G', 'I', 'F'}, nullptr, 1460, false), Result::FAILED, 3},
+  };
+
+  for (const Case &c : cases) {
+    server.set_response(c.response);
+    const size_t served = server.bytes_served;
+    TestImage image(ImageFormat::AUTO);
+    image.set_parent(&server);
+    auto start = std::chrono::steady_clock::now();
+    const Result result = download(&image);
+    const double ms = elapsed_ms(start);
+    const size_t read = server.bytes_served - served;
+    printf("  AUTO %-36s %-8s after %4zu bytes, %6.2f ms\n", c.name, result == Result::FINISHED ? "decoded" : "rejected",
+           read, ms);
+    EXPECT_TRUE(result == c.result);
+    if (c.result == Result::FINISHED) {
+      EXPECT_TRUE(read == bmp.size());
+      EXPECT_TRUE(image.get_data_start() != nullptr &&
+                  std::equal(decoded.begin(), decoded.end(), image.get_data_start()));
+    } else {
+      // Nothing allocated for a response that is not a usable image, error pages are not even read
+      EXPECT_TRUE(image.get_data_start() == nullptr && image.buffer_ == nullptr);
+      EXPECT_TRUE(read == c.sniffed);
+    }
+    // A body that ends early without a Content-Length is only given up on after the http_request timeout
+    if (!c.response.send_content_length)
+      EXPECT_TRUE(ms >= server.get_timeout() - 1);
+  }
+}
+
+}  // namespace
+
+void setup() {
+  const std::string home = std::filesystem::temp_directory_path() / ("esphome-online-image-" + to_string(getpid()));
+  setenv("HOME", home.c_str(), 1);
+  App.pre_setup("online-image-test", "", "", "", false);
+  check_cache();
+  check_detect_format();
+  check_auto_format();
+  std::filesystem::remove_all(home);
+  exit(esphome::test::finish("online_image"));
+}
+
+void loop() {}
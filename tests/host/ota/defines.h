@@ -0,0 +1,6 @@
+#define USE_MD5
+#define USE_NETWORK
+#define USE_OTA
+#define USE_OTA_DELTA
+#define USE_OTA_VERSION 2
+#define USE_OTA_INFLATE
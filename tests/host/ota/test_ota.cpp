@@ -0,0 +1,242 @@
+// OTA updates end to end: the CLI's uploader (espota2.py) connects over loopback to the ESPHome OTA component of a
+// host device, which writes the update file from the data it receives and, for delta updates, from its running
+// image file. Each upload runs against a freshly forked device, a completed update "reboots" it by exiting.
+// Compressed and uncompressed uploads are also timed over a link slowed down to the speed of a WiFi OTA transfer.
+
+#include "esphome/components/esphome/ota/ota_esphome.h"
+#include "esphome/components/ota/ota_backend_host.h"
+#include "esphome/components/ota/ota_delta.h"
+#include "esphome/core/application.h"
+#include "test_helpers.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+
+namespace {
+
+const uint16_t PORT = 28232;
+// Large enough for the patch search and the transfer to matter, small enough for a quick test
+const size_t IMAGE_SIZE = 768 * 1024;
+const size_t FIRMWARE_SIZE = 1024 * 1024;
+// Makes the client's sendall() take as long as on a link of 250 KB/s
+const char *const SLOW_LINK = "import socket, time; base = socket.socket; "
+                              "socket.socket = type('Link', (base,), {'sendall': lambda s, data, *args: "
+                              "(time.sleep(len(data) / 250000), base.sendall(s, data, *args))[1]}); ";
+
+std::string dir;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+std::vector<uint8_t> read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void write_file(const std::string &path, const std::vector<uint8_t> &data) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+/// Start a device that runs the image in running_path and writes updates to output_path; returns its pid.
+pid_t start_device(const std::string &running_path, const std::string &output_path) {
+  int ready[2];
+  if (pipe(ready) != 0)
+    return -1;
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid != 0) {
+    close(ready[1]);
+    char byte;
+    if (read(ready[0], &byte, 1) != 1)
+      pid = -1;
+    close(ready[0]);
+    return pid;
+  }
+  close(ready[0]);
+  alarm(60);
+  ota::set_host_ota_backend(output_path, 0);
+  ota::set_host_ota_running_image(running_path);
+  App.pre_setup("ota-test", "", "", "", false);
+  auto *component = new ESPHomeOTAComponent();  // NOLINT(cppcoreguidelines-owning-memory)
+  component->set_port(PORT);
+  App.register_component(component);
+  App.setup();
+  if (write(ready[1], "", 1) != 1)
+    _exit(1);
+  while (true)
+    App.loop();
+}
+
+struct Upload {
+  int client_status;
+  int device_status;
+  std::string log;
+  double seconds;
+};
+
+/// Upload firmware_path with espota2 to a device running running_path; python runs before the upload.
+Upload upload(const std::string &firmware_path, const std::string &running_path, const std::string &output_path,
+              const std::string &python = "") {
+  Upload result{-1, -1, "", 0};
+  std::filesystem::remove(output_path);
+  auto start = std::chrono::steady_clock::now();
+  pid_t device = start_device(running_path, output_path);
+  if (device < 0)
+    return result;
+  const std::string command = "python3 -c \"import logging, sys; sys.path.insert(0, '" ESPHOME_PYTHON_PATH "'); "
+                              "logging.basicConfig(level=logging.INFO); from esphome import espota2; " +
+                              python + "sys.exit(espota2.run_ota('127.0.0.1', " + to_string(PORT) + ", '', '" +
+                              firmware_path + "'))\" 2>&1";
+  FILE *client = popen(command.c_str(), "r");
+  char buf[256];
+  while (fgets(buf, sizeof(buf), client) != nullptr)
+    result.log += buf;
+  result.client_status = pclose(client);
+  // A device that did not complete an update keeps waiting for one
+  int status = 0;
+  if (result.client_status != 0)
+    kill(device, SIGTERM);
+  waitpid(device, &status, 0);
+  result.device_status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.seconds = elapsed.count();
+  if (result.client_status != 0)
+    printf("%s", result.log.c_str());
+  return result;
+}
+
+bool contains(const std::string &haystack, const char *needle) { return haystack.find(needle) != std::string::npos; }
+
+/// The next firmware: some code grows, addresses after it shift, and data at the end changes.
+std::vector<uint8_t> next_firmware(const std::vector<uint8_t> &old) {
+  std::vector<uint8_t> image(old);
+  std::vector<uint8_t> code(3000);
+  for (size_t i = 0; i < code.size(); i++)
+    code[i] = old[200000 + i * 7 % 5000];
+  image.insert(image.begin() + 100000, code.begin(), code.end());
+  for (size_t pos = 150000; pos + 4 < image.size(); pos += 4096)
+    image[pos + 1] += 0x0C;
+  image.resize(image.size() - 1000);
+  for (size_t pos = image.size() - 20000; pos < image.size(); pos += 97)
+    image[pos] ^= 0x5A;
+  return image;
+}
+
+void check_uploads() {
+  // Real machine code: the first part of this test program
+  std::vector<uint8_t> first = read_file("/proc/self/exe");
+  EXPECT_TRUE(first.size() > IMAGE_SIZE);
+  first.resize(IMAGE_SIZE);
+  const std::vector<uint8_t> second = next_firmware(first);
+
+  const std::string firmware = dir + "/firmware.bin";
+  const std::string running = dir + "/running.bin";
+  const std::string output = dir + "/update.bin";
+
+  // Without a copy of what the device runs the CLI sends the full image, and keeps one afterwards
+  write_file(firmware, first);
+  write_file(running, std::vector<uint8_t>(4096, 0xFF));
+  Upload full = upload(firmware, running, output);
+  EXPECT_TRUE(full.client_status == 0 && full.device_status == 0);
+  EXPECT_TRUE(!contains(full.log, "delta update"));
+  EXPECT_TRUE(read_file(output) == first);
+  EXPECT_TRUE(read_file(firmware + ".delta-base") == first);
+
+  // The device runs the first image now, the second goes as a patch against it
+  std::filesystem::copy_file(output, running, std::filesystem::copy_options::overwrite_existing);
+  write_file(firmware, second);
+  Upload delta = upload(firmware, running, output);
+  EXPECT_TRUE(delta.client_status == 0 && delta.device_status == 0);
+  EXPECT_TRUE(contains(delta.log, "Sending a delta update"));
+  EXPECT_TRUE(read_file(output) == second);
+
+  // The device was flashed with something else in between: it rejects the patch and gets the full image
+  std::vector<uint8_t> other(second);
+  other[10] ^= 1;
+  write_file(running, other);
+  write_file(firmware, first);
+  Upload fallback = upload(firmware, running, output);
+  EXPECT_TRUE(fallback.client_status == 0 && fallback.device_status == 0);
+  EXPECT_TRUE(contains(fallback.log, "sending the full firmware"));
+  EXPECT_TRUE(read_file(output) == first);
+
+  printf("%zu byte image over loopback: full %.2f s, delta %.2f s, delta rejected %.2f s\n", first.size(),
+         full.seconds, delta.seconds, fallback.seconds);
+}
+
+void check_compression() {
+  std::vector<uint8_t> image = read_file("/proc/self/exe");
+  EXPECT_TRUE(image.size() > FIRMWARE_SIZE);
+  image.resize(FIRMWARE_SIZE);
+  const std::string firmware = dir + "/compressed.bin";
+  const std::string output = dir + "/update.bin";
+  write_file(firmware, image);
+
+  // Without a running image the device takes no deltas and offers to inflate
+  Upload compressed = upload(firmware, "", output, SLOW_LINK);
+  EXPECT_TRUE(compressed.client_status == 0 && compressed.device_status == 0);
+  EXPECT_TRUE(read_file(output) == image);
+  size_t compressed_size = 0;
+  const size_t pos = compressed.log.find("Compressed to ");
+  EXPECT_TRUE(pos != std::string::npos);
+  sscanf(compressed.log.c_str() + pos, "Compressed to %zu", &compressed_size);
+
+  // A client that does not ask for compression sends the image as it is
+  Upload raw = upload(firmware, "", output, std::string(SLOW_LINK) + "espota2.FEATURE_SUPPORTS_COMPRESSION = 0; ");
+  EXPECT_TRUE(raw.client_status == 0 && raw.device_status == 0);
+  EXPECT_TRUE(!contains(raw.log, "Compressed to"));
+  EXPECT_TRUE(read_file(output) == image);
+  EXPECT_TRUE(compressed.seconds < raw.seconds);
+
+  printf("%zu byte image at 250 KB/s: uncompressed %.2f s, compressed to %zu bytes %.2f s\n", image.size(),
+         raw.seconds, compressed_size, compressed.seconds);
+}
+
+/// Feed a patch that starts with the given bytes to a patcher of a 100 byte image.
+ota::OTAResponseTypes feed_patch(std::vector<uint8_t> data) {
+  const std::string running = dir + "/running.bin";
+  write_file(running, std::vector<uint8_t>(100, 0x42));
+  ota::HostOTABackend backend(dir + "/update.bin", running, 0);
+  ota::DeltaHeader header{100, 100, {}};
+  ota::DeltaPatcher patcher(&backend, header);
+  EXPECT_TRUE(backend.begin(header.new_size) == ota::OTA_RESPONSE_OK);
+  ota::OTAResponseTypes error = patcher.feed(data.data(), data.size());
+  if (error == ota::OTA_RESPONSE_OK)
+    error = patcher.finish();
+  backend.abort();
+  return error;
+}
+
+void check_varints() {
+  // One record with a diff of 100 bytes that copies the old image: a zero run of 100 and no literals
+  EXPECT_TRUE(feed_patch({100, 0, 0, 100, 0}) == ota::OTA_RESPONSE_OK);
+  // The same diff length in the longest encoding of a 32 bit value
+  EXPECT_TRUE(feed_patch({0xE4, 0x80, 0x80, 0x80, 0x00, 0, 0, 100, 0}) == ota::OTA_RESPONSE_OK);
+  // 2^32 + 100 must not be read as 100
+  EXPECT_TRUE(feed_patch({0xE4, 0x80, 0x80, 0x80, 0x10, 0, 0, 100, 0}) == ota::OTA_RESPONSE_ERROR_UPDATE_END);
+  // Nor a sixth byte as part of 100
+  EXPECT_TRUE(feed_patch({0xE4, 0x80, 0x80, 0x80, 0x80, 0x00, 0, 0, 100, 0}) == ota::OTA_RESPONSE_ERROR_UPDATE_END);
+}
+
+}  // namespace
+
+void setup() {
+  dir = std::filesystem::temp_directory_path() / ("esphome-ota-test-" + to_string(getpid()));
+  std::filesystem::create_directories(dir);
+  check_varints();
+  check_uploads();
+  check_compression();
+  std::filesystem::remove_all(dir);
+  exit(esphome::test::finish("ota"));
+}
+
+void loop() {}
@@ -0,0 +1 @@
+// No component defines; the LibreTiny backend is included by the test itself
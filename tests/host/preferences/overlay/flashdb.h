@@ -0,0 +1,209 @@
+#pragma once
+// Test double of FlashDB's key-value database for the host tests. Only the calls made by the LibreTiny preferences
+// are provided; they work on a simulated flash that counts sector erases, programmed bytes and reads.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#define LT_E(...) (printf(__VA_ARGS__), putchar('\n'))
+#define LT_I(...) (printf(__VA_ARGS__), putchar('\n'))
+
+/** Flash with a log-structured key-value store like FlashDB's.
+ *
+ * A set appends a record to the current sector and marks the previous record of the key deleted. When no sector has
+ * room left except the one kept free for garbage collection, the live records of the sector with the least live data
+ * are moved into it and that sector is erased.
+ */
+class SimulatedFlash {
+ public:
+  static constexpr size_t SECTOR_SIZE = 4096;
+  static constexpr size_t SECTOR_COUNT = 8;
+  static constexpr size_t RECORD_HEADER = 28;
+
+  struct Record {
+    std::string key;
+    std::vector<uint8_t> value;
+  };
+
+  /// Calls of set(); records_programmed also counts the records moved by garbage collection
+  uint32_t writes{0};
+  uint32_t erases{0};
+  uint32_t records_programmed{0};
+  uint32_t bytes_programmed{0};
+  uint32_t reads{0};
+
+  static size_t record_size(const std::string &key, size_t len) { return (RECORD_HEADER + key.size() + len + 3) & ~3; }
+
+  const Record *find(const std::string &key) const {
+    for (const auto &sector : this->sectors_) {
+      auto it = sector.live.find(key);
+      if (it != sector.live.end())
+        return &it->second;
+    }
+    return nullptr;
+  }
+
+  bool set(const std::string &key, const uint8_t *data, size_t len) {
+    this->writes++;
+    const size_t size = record_size(key, len);
+    if (this->sectors_[this->current_].used + size > SECTOR_SIZE && !this->advance_())
+      return false;
+    for (auto &sector : this->sectors_)
+      sector.live.erase(key);
+    this->program_(this->current_, Record{key, std::vector<uint8_t>(data, data + len)});
+    return true;
+  }
+
+  void erase_all() {
+    for (size_t i = 0; i < SECTOR_COUNT; i++)
+      this->erase_(i);
+    this->current_ = 0;
+  }
+
+ protected:
+  struct Sector {
+    size_t used{0};
+    std::map<std::string, Record> live;
+  };
+
+  size_t live_bytes_(size_t index) const {
+    size_t bytes = 0;
+    for (const auto &it : this->sectors_[index].live)
+      bytes += record_size(it.first, it.second.value.size());
+    return bytes;
+  }
+
+  void program_(size_t index, Record record) {
+    Sector &sector = this->sectors_[index];
+    const size_t size = record_size(record.key, record.value.size());
+    sector.used += size;
+    this->records_programmed++;
+    this->bytes_programmed += size;
+    std::string key = record.key;
+    sector.live[key] = std::move(record);
+  }
+
+  void erase_(size_t index) {
+    this->sectors_[index] = Sector{};
+    this->erases++;
+  }
+
+  /// Move to an empty sector, collecting garbage when only the reserved one is left.
+  bool advance_() {
+    std::vector<size_t> empty;
+    for (size_t i = 0; i < SECTOR_COUNT; i++) {
+      if (i != this->current_ && this->sectors_[i].used == 0)
+        empty.push_back(i);
+    }
+    if (empty.size() > 1) {
+      this->current_ = empty[0];
+      return true;
+    }
+    if (empty.empty())
+      return false;
+
+    size_t victim = SECTOR_COUNT;
+    for (size_t i = 0; i < SECTOR_COUNT; i++) {
+      if (this->sectors_[i].used == 0)
+        continue;
+      if (victim == SECTOR_COUNT || this->live_bytes_(i) < this->live_bytes_(victim))
+        victim = i;
+    }
+    const size_t spare = empty[0];
+    for (auto &it : this->sectors_[victim].live)
+      this->program_(spare, it.second);
+    this->erase_(victim);
+    this->current_ = spare;
+    return this->sectors_[spare].used < SECTOR_SIZE;
+  }
+
+  Sector sectors_[SECTOR_COUNT];
+  size_t current_{0};
+};
+
+/// The simulated flash of a database name; it outlives the database objects, like flash outlives a reboot.
+inline SimulatedFlash &simulated_flash(const std::string &name) {
+  static std::map<std::string, SimulatedFlash> flashes;
+  return flashes[name];
+}
+
+typedef enum {
+  FDB_NO_ERR,
+  FDB_ERASE_ERR,
+  FDB_READ_ERR,
+  FDB_WRITE_ERR,
+  FDB_PART_NOT_FOUND,
+  FDB_KV_NAME_ERR,
+  FDB_KV_NAME_EXIST,
+  FDB_SAVED_FULL,
+  FDB_INIT_FAILED,
+} fdb_err_t;
+
+struct fdb_default_kv;
+
+struct fdb_kvdb {
+  SimulatedFlash *flash;
+};
+typedef struct fdb_kvdb *fdb_kvdb_t;
+
+struct fdb_blob {
+  void *buf;
+  size_t size;
+  struct {
+    size_t len;
+  } saved;
+};
+typedef struct fdb_blob *fdb_blob_t;
+
+struct fdb_kv {
+  size_t value_len;
+};
+typedef struct fdb_kv *fdb_kv_t;
+
+inline fdb_err_t fdb_kvdb_init(fdb_kvdb_t db, const char *name, const char *path, struct fdb_default_kv *default_kv,
+                               void *user_data) {
+  db->flash = &simulated_flash(name);
+  return FDB_NO_ERR;
+}
+
+inline fdb_err_t fdb_kvdb_deinit(fdb_kvdb_t db) { return FDB_NO_ERR; }
+
+inline fdb_blob_t fdb_blob_make(fdb_blob_t blob, const void *value_buf, size_t buf_len) {
+  blob->buf = const_cast<void *>(value_buf);
+  blob->size = buf_len;
+  return blob;
+}
+
+inline size_t fdb_kv_get_blob(fdb_kvdb_t db, const char *key, fdb_blob_t blob) {
+  db->flash->reads++;
+  const SimulatedFlash::Record *record = db->flash->find(key);
+  if (record == nullptr)
+    return 0;
+  size_t len = std::min(blob->size, record->value.size());
+  memcpy(blob->buf, record->value.data(), len);
+  blob->saved.len = record->value.size();
+  return len;
+}
+
+inline fdb_kv_t fdb_kv_get_obj(fdb_kvdb_t db, const char *key, fdb_kv_t kv) {
+  db->flash->reads++;
+  const SimulatedFlash::Record *record = db->flash->find(key);
+  if (record == nullptr)
+    return nullptr;
+  kv->value_len = record->value.size();
+  return kv;
+}
+
+inline fdb_err_t fdb_kv_set_blob(fdb_kvdb_t db, const char *key, fdb_blob_t blob) {
+  return db->flash->set(key, static_cast<const uint8_t *>(blob->buf), blob->size) ? FDB_NO_ERR : FDB_SAVED_FULL;
+}
+
+inline fdb_err_t fdb_kv_set_default(fdb_kvdb_t db) {
+  db->flash->erase_all();
+  return FDB_NO_ERR;
+}
@@ -0,0 +1,217 @@
+// Preference saves that do not change the stored data must not reach flash. Runs a day of typical saves (a light
+// toggled many times per minute, a counter, restore_value globals that rarely change) through the LibreTiny backend
+// on a simulated flash and through the host backend's append-only file, and counts what was written and erased.
+
+#include "esphome/core/application.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/host/preferences.h"
+#include "test_helpers.h"
+
+#include <cstdlib>
+#include <filesystem>
+
+// The LibreTiny backend is built against the simulated FlashDB in overlay/flashdb.h; its global_preferences is
+// renamed so it does not clash with the one of the host platform.
+namespace esphome {
+extern ESPPreferences *libretiny_global_preferences;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+}  // namespace esphome
+#define USE_LIBRETINY
+#define global_preferences libretiny_global_preferences
+#include "esphome/components/libretiny/preferences.cpp"
+#undef global_preferences
+#undef USE_LIBRETINY
+
+using namespace esphome;
+
+namespace {
+
+// Saved once per flash_write_interval (60 s by default) for a day
+const int SYNCS = 24 * 60;
+const int GLOBALS = 10;
+
+// Without padding, so equal states have equal bytes
+struct LightState {
+  float state;
+  float brightness;
+  float red, green, blue;
+};
+
+class LibreTinyPreferences : public libretiny::LibreTinyPreferences {
+ public:
+  using libretiny::LibreTinyPreferences::writes_avoided_;
+};
+
+class HostPreferences : public host::HostPreferences {
+ public:
+  using host::HostPreferences::filename_;
+  using host::HostPreferences::writes_avoided_;
+};
+
+/// What the components save between two syncs in minute m; save is called with the type and the value.
+template<typename F> void save_minute(int m, F &&save) {
+  // The light is toggled 20 times, but only ends up in a different state every 10 minutes
+  for (int i = 0; i < 20; i++)
+    save(1, LightState{(m / 10 + i) % 2 == 1 ? 1.0f : 0.0f, 0.8f, 1.0f, 0.5f, 0.0f});
+  save(2, static_cast<uint32_t>(m));
+  for (uint32_t i = 0; i < GLOBALS; i++)
+    save(100 + i, static_cast<int32_t>(1000 + i));
+}
+
+bool light_on_after(int syncs) { return ((syncs - 1) / 10 + 19) % 2 == 1; }
+
+/// Number of keys whose value differs from the previous minute (all of them in the first).
+uint32_t changed_in_minute(int m) {
+  if (m == 0)
+    return 2 + GLOBALS;
+  return m % 10 == 0 ? 2 : 1;
+}
+
+void check_libretiny() {
+  SimulatedFlash &flash = simulated_flash("esphome");
+  SimulatedFlash &naive = simulated_flash("naive");
+  const uint32_t keys = 2 + GLOBALS;
+
+  auto *prefs = new LibreTinyPreferences();
+  prefs->open();
+  std::map<uint32_t, ESPPreferenceObject> objects;
+  // Without change detection every pending save is written; same flash, same workload
+  struct fdb_kvdb naive_db;
+  fdb_kvdb_init(&naive_db, "naive", "kvs", nullptr, nullptr);
+  std::map<uint32_t, std::vector<uint8_t>> naive_pending;
+
+  for (int m = 0; m < SYNCS; m++) {
+    save_minute(m, [&](uint32_t type, const auto &value) {
+      if (objects.count(type) == 0)
+        objects[type] = prefs->make_preference(sizeof(value), type);
+      EXPECT_TRUE(objects[type].save(&value));
+      auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+      naive_pending[type].assign(bytes, bytes + sizeof(value));
+    });
+    EXPECT_TRUE(prefs->sync());
+    for (auto &it : naive_pending) {
+      struct fdb_blob blob;
+      fdb_kv_set_blob(&naive_db, to_string(it.first).c_str(), fdb_blob_make(&blob, it.second.data(), it.second.size()));
+    }
+    naive_pending.clear();
+  }
+
+  // Every key once when it is new, then the counter and the light when they changed
+  uint32_t expected_writes = 0;
+  for (int m = 0; m < SYNCS; m++)
+    expected_writes += changed_in_minute(m);
+  EXPECT_TRUE(flash.writes == expected_writes);
+  EXPECT_TRUE(prefs->writes_avoided_ == (keys * SYNCS) - expected_writes);
+  // Flash is only read for keys that were never loaded nor written, to find out they do not exist yet
+  EXPECT_TRUE(flash.reads == keys);
+  EXPECT_TRUE(naive.writes == keys * SYNCS);
+  EXPECT_TRUE(flash.erases < naive.erases);
+
+  printf("simulated flash over %d syncs of %" PRIu32 " keys:\n", SYNCS, keys);
+  printf("  change detection  %4" PRIu32 " writes, %6" PRIu32 " bytes, %3" PRIu32 " erases, %2" PRIu32 " reads\n",
+         flash.writes, flash.bytes_programmed, flash.erases, flash.reads);
+  printf("  every save        %4" PRIu32 " writes, %6" PRIu32 " bytes, %3" PRIu32 " erases\n", naive.writes,
+         naive.bytes_programmed, naive.erases);
+
+  // Reboot: the hashes are gone, the flash keeps its data
+  libretiny::s_pending_save.clear();
+  libretiny::s_stored_hash.clear();
+  prefs = new LibreTinyPreferences();
+  prefs->open();
+  const uint32_t writes = flash.writes;
+  const uint32_t reads = flash.reads;
+
+  ESPPreferenceObject light_pref = prefs->make_preference(sizeof(LightState), 1);
+  LightState light{};
+  EXPECT_TRUE(light_pref.load(&light));
+  EXPECT_TRUE((light.state == 1.0f) == light_on_after(SYNCS));
+  EXPECT_TRUE(flash.reads == reads + 1);
+
+  // A loaded key is compared by its hash; a key that was not loaded is read from flash once
+  ESPPreferenceObject counter_pref = prefs->make_preference(sizeof(uint32_t), 2);
+  uint32_t counter = SYNCS - 1;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(light_pref.save(&light));
+    EXPECT_TRUE(counter_pref.save(&counter));
+    EXPECT_TRUE(prefs->sync());
+  }
+  EXPECT_TRUE(flash.writes == writes);
+  EXPECT_TRUE(flash.reads == reads + 1 + 2);
+  EXPECT_TRUE(prefs->writes_avoided_ == 6);
+
+  counter++;
+  EXPECT_TRUE(counter_pref.save(&counter));
+  EXPECT_TRUE(prefs->sync());
+  EXPECT_TRUE(flash.writes == writes + 1);
+  uint32_t loaded = 0;
+  EXPECT_TRUE(counter_pref.load(&loaded) && loaded == counter);
+}
+
+void check_host() {
+  const std::string home = std::filesystem::temp_directory_path() / ("esphome-prefs-test-" + to_string(getpid()));
+  setenv("HOME", home.c_str(), 1);
+  App.pre_setup("prefs-test", "", "", "", false);
+  const uint32_t keys = 2 + GLOBALS;
+
+  HostPreferences prefs;
+  // Each sync appends the changed records, unless it compacts the file to the live records
+  const size_t int_record = sizeof(uint32_t) + 1 + sizeof(uint32_t);
+  const size_t light_record = sizeof(uint32_t) + 1 + sizeof(LightState);
+  const size_t live_size = light_record + (keys - 1) * int_record;
+  uintmax_t size = 0;
+  uint32_t compactions = 0, expected_avoided = 0;
+  for (int m = 0; m < SYNCS; m++) {
+    save_minute(m, [&](uint32_t type, const auto &value) {
+      EXPECT_TRUE(prefs.save(type, reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+    });
+    EXPECT_TRUE(prefs.sync());
+    const uintmax_t new_size = std::filesystem::file_size(prefs.filename_);
+    if (new_size < size) {
+      EXPECT_TRUE(new_size == live_size);
+      compactions++;
+    } else if (m == 0) {
+      EXPECT_TRUE(new_size == live_size);
+    } else {
+      EXPECT_TRUE(new_size - size == (m % 10 == 0 ? light_record + int_record : int_record));
+      expected_avoided += keys - changed_in_minute(m);
+    }
+    size = new_size;
+  }
+  EXPECT_TRUE(compactions > 0);
+  EXPECT_TRUE(prefs.writes_avoided_ == expected_avoided);
+  printf("host file: %zu bytes live, %" PRIu32 " compactions in %d syncs\n", live_size, compactions, SYNCS);
+
+  // A new instance reads the latest value of every key from the file
+  HostPreferences reloaded;
+  LightState light{};
+  EXPECT_TRUE(reloaded.load(1, reinterpret_cast<uint8_t *>(&light), sizeof(light)));
+  EXPECT_TRUE((light.state == 1.0f) == light_on_after(SYNCS));
+  uint32_t counter = 0;
+  EXPECT_TRUE(reloaded.load(2, reinterpret_cast<uint8_t *>(&counter), sizeof(counter)));
+  EXPECT_TRUE(counter == SYNCS - 1);
+
+  // Unchanged saves leave the file alone
+  EXPECT_TRUE(reloaded.sync());
+  size = std::filesystem::file_size(prefs.filename_);
+  save_minute(SYNCS - 1, [&](uint32_t type, const auto &value) {
+    EXPECT_TRUE(reloaded.save(type, reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+  });
+  EXPECT_TRUE(reloaded.sync());
+  EXPECT_TRUE(std::filesystem::file_size(prefs.filename_) == size);
+
+  EXPECT_TRUE(reloaded.reset());
+  EXPECT_TRUE(reloaded.sync());
+  EXPECT_TRUE(std::filesystem::file_size(prefs.filename_) == 0);
+  std::filesystem::remove_all(home);
+}
+
+}  // namespace
+
+void setup() {
+  check_libretiny();
+  check_host();
+  exit(esphome::test::finish("preferences"));
+}
+
+void loop() {}
@@ -0,0 +1,15 @@
+#define USE_NETWORK
+#define USE_AREAS
+#define ESPHOME_AREA_COUNT 1
+#define USE_SENSOR
+#define ESPHOME_ENTITY_SENSOR_COUNT 64
+#define USE_BINARY_SENSOR
+#define ESPHOME_ENTITY_BINARY_SENSOR_COUNT 64
+#define USE_SWITCH
+#define ESPHOME_ENTITY_SWITCH_COUNT 16
+#define USE_TEXT_SENSOR
+#define ESPHOME_ENTITY_TEXT_SENSOR_COUNT 16
+#define USE_NUMBER
+#define ESPHOME_ENTITY_NUMBER_COUNT 16
+#define USE_SELECT
+#define ESPHOME_ENTITY_SELECT_COUNT 16
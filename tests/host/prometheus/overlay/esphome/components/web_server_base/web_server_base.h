@@ -0,0 +1,140 @@
+#pragma once
+// Test double of web_server_base for the host tests: the request and response classes of web_server_idf, reduced
+// to what a handler uses, with the response body kept in the request instead of being sent.
+#include "esphome/core/defines.h"
+#ifdef USE_NETWORK
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+namespace web_server_idf {
+
+#define F(string_literal) (string_literal)
+
+enum http_method { HTTP_DELETE = 0, HTTP_GET = 1, HTTP_HEAD = 2, HTTP_POST = 3 };
+
+class AsyncWebServerRequest;
+
+class AsyncWebServerResponse {
+ public:
+  AsyncWebServerResponse(const AsyncWebServerRequest *req) : req_(req) {}
+  virtual ~AsyncWebServerResponse() {}
+
+  virtual const char *get_content_data() const = 0;
+  virtual size_t get_content_size() const = 0;
+
+ protected:
+  const AsyncWebServerRequest *req_;
+};
+
+class AsyncWebServerResponseProgmem : public AsyncWebServerResponse {
+ public:
+  AsyncWebServerResponseProgmem(const AsyncWebServerRequest *req, const uint8_t *data, const size_t size)
+      : AsyncWebServerResponse(req), data_(data), size_(size) {}
+
+  const char *get_content_data() const override { return reinterpret_cast<const char *>(this->data_); };
+  size_t get_content_size() const override { return this->size_; };
+
+ protected:
+  const uint8_t *data_;
+  const size_t size_;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse {
+ public:
+  AsyncResponseStream(const AsyncWebServerRequest *req) : AsyncWebServerResponse(req) {}
+
+  const char *get_content_data() const override { return this->content_.c_str(); };
+  size_t get_content_size() const override { return this->content_.size(); };
+
+  void print(const char *str) { this->content_.append(str); }
+  void print(const std::string &str) { this->content_.append(str); }
+  // Same formatting as web_server_idf
+  void print(float value) { this->print(to_string(value)); }
+
+ protected:
+  std::string content_;
+};
+
+class AsyncWebServerRequest {
+ public:
+  AsyncWebServerRequest(http_method method, std::string url) : method_(method), url_(std::move(url)) {}
+
+  http_method method() const { return this->method_; }
+  std::string url() const { return this->url_; }
+
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  AsyncWebServerResponse *beginResponse(int code, const char *content_type, const uint8_t *data,
+                                        const size_t data_size) {
+    this->code_ = code;
+    this->content_type_ = content_type;
+    return new AsyncWebServerResponseProgmem(this, data, data_size);  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  AsyncResponseStream *beginResponseStream(const char *content_type) {
+    this->code_ = 200;
+    this->content_type_ = content_type;
+    return new AsyncResponseStream(this);  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+  /// Like web_server_idf, the body is sent (here: copied) before send() returns
+  void send(AsyncWebServerResponse *response) {
+    this->body_.assign(response->get_content_data(), response->get_content_size());
+    delete response;  // NOLINT(cppcoreguidelines-owning-memory)
+  }
+
+  int code() const { return this->code_; }
+  const std::string &content_type() const { return this->content_type_; }
+  const std::string &body() const { return this->body_; }
+
+ protected:
+  http_method method_;
+  std::string url_;
+  int code_{0};
+  std::string content_type_;
+  std::string body_;
+};
+
+class AsyncWebHandler {
+ public:
+  virtual ~AsyncWebHandler() {}
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  virtual bool canHandle(AsyncWebServerRequest *request) const { return false; }
+  // NOLINTNEXTLINE(readability-identifier-naming)
+  virtual void handleRequest(AsyncWebServerRequest *request) {}
+};
+
+}  // namespace web_server_idf
+
+using namespace esphome::web_server_idf;  // NOLINT(google-global-names-in-headers)
+
+namespace web_server_base {
+
+class WebServerBase : public Component {
+ public:
+  void init() { this->initialized_++; }
+  void add_handler(AsyncWebHandler *handler) { this->handlers_.push_back(handler); }
+
+  /// Dispatch a request to the first handler that accepts it, like AsyncWebServer; false if none did.
+  bool handle(AsyncWebServerRequest *request) {
+    for (auto *handler : this->handlers_) {
+      if (handler->canHandle(request)) {
+        handler->handleRequest(request);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ protected:
+  int initialized_{0};
+  std::vector<AsyncWebHandler *> handlers_;
+};
+
+}  // namespace web_server_base
+}  // namespace esphome
+#endif
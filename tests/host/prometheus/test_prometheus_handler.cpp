@@ -0,0 +1,382 @@
+// The /metrics exposition rendered from the label cache into a reusable buffer must be byte for byte what the
+// previous renderer streamed into an AsyncResponseStream. Renders a set of entities both ways, with and without
+// area, friendly name, relabels, internal entities and missing states, then compares the output and the time.
+
+#include "esphome/components/prometheus/prometheus_handler.h"
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "test_helpers.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace esphome;
+using esphome::web_server_idf::AsyncResponseStream;
+using esphome::web_server_idf::AsyncWebServerRequest;
+using esphome::web_server_idf::HTTP_GET;
+using esphome::web_server_idf::HTTP_POST;
+
+namespace {
+
+/// The renderer before the label cache: every row prints its labels one by one into the response stream.
+class LegacyRenderer {
+ public:
+  bool include_internal{false};
+  std::map<EntityBase *, std::string> relabel_map_id;
+  std::map<EntityBase *, std::string> relabel_map_name;
+
+  std::string render() {
+    AsyncWebServerRequest req(HTTP_GET, "/metrics");
+    AsyncResponseStream *stream = req.beginResponseStream("text/plain; version=0.0.4; charset=utf-8");
+    std::string area = App.get_area();
+    std::string node = App.get_name();
+    std::string friendly_name = App.get_friendly_name();
+
+    stream->print(F("#TYPE esphome_sensor_value gauge\n"));
+    stream->print(F("#TYPE esphome_sensor_failed gauge\n"));
+    for (auto *obj : App.get_sensors()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      if (!std::isnan(obj->state)) {
+        this->open_row_(stream, "esphome_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 0\n"));
+        this->open_row_(stream, "esphome_sensor_value", obj, area, node, friendly_name);
+        stream->print(F("\",unit=\""));
+        stream->print(obj->get_unit_of_measurement().c_str());
+        stream->print(F("\"} "));
+        stream->print(value_accuracy_to_string(obj->state, obj->get_accuracy_decimals()).c_str());
+        stream->print(F("\n"));
+      } else {
+        this->open_row_(stream, "esphome_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 1\n"));
+      }
+    }
+
+    stream->print(F("#TYPE esphome_binary_sensor_value gauge\n"));
+    stream->print(F("#TYPE esphome_binary_sensor_failed gauge\n"));
+    for (auto *obj : App.get_binary_sensors()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      if (obj->has_state()) {
+        this->open_row_(stream, "esphome_binary_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 0\n"));
+        this->open_row_(stream, "esphome_binary_sensor_value", obj, area, node, friendly_name);
+        stream->print(F("\"} "));
+        stream->print(obj->state);
+        stream->print(F("\n"));
+      } else {
+        this->open_row_(stream, "esphome_binary_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 1\n"));
+      }
+    }
+
+    stream->print(F("#TYPE esphome_switch_value gauge\n"));
+    stream->print(F("#TYPE esphome_switch_failed gauge\n"));
+    for (auto *obj : App.get_switches()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      this->open_row_(stream, "esphome_switch_failed", obj, area, node, friendly_name);
+      stream->print(F("\"} 0\n"));
+      this->open_row_(stream, "esphome_switch_value", obj, area, node, friendly_name);
+      stream->print(F("\"} "));
+      stream->print(obj->state);
+      stream->print(F("\n"));
+    }
+
+    stream->print(F("#TYPE esphome_text_sensor_value gauge\n"));
+    stream->print(F("#TYPE esphome_text_sensor_failed gauge\n"));
+    for (auto *obj : App.get_text_sensors()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      if (obj->has_state()) {
+        this->open_row_(stream, "esphome_text_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 0\n"));
+        this->open_row_(stream, "esphome_text_sensor_value", obj, area, node, friendly_name);
+        stream->print(F("\",value=\""));
+        stream->print(obj->state.c_str());
+        stream->print(F("\"} "));
+        stream->print(F("1.0"));
+        stream->print(F("\n"));
+      } else {
+        this->open_row_(stream, "esphome_text_sensor_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 1\n"));
+      }
+    }
+
+    stream->print(F("#TYPE esphome_number_value gauge\n"));
+    stream->print(F("#TYPE esphome_number_failed gauge\n"));
+    for (auto *obj : App.get_numbers()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      if (!std::isnan(obj->state)) {
+        this->open_row_(stream, "esphome_number_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 0\n"));
+        this->open_row_(stream, "esphome_number_value", obj, area, node, friendly_name);
+        stream->print(F("\"} "));
+        stream->print(obj->state);
+        stream->print(F("\n"));
+      } else {
+        this->open_row_(stream, "esphome_number_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 1\n"));
+      }
+    }
+
+    stream->print(F("#TYPE esphome_select_value gauge\n"));
+    stream->print(F("#TYPE esphome_select_failed gauge\n"));
+    for (auto *obj : App.get_selects()) {
+      if (obj->is_internal() && !this->include_internal)
+        continue;
+      if (obj->has_state()) {
+        this->open_row_(stream, "esphome_select_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 0\n"));
+        this->open_row_(stream, "esphome_select_value", obj, area, node, friendly_name);
+        stream->print(F("\",value=\""));
+        stream->print(obj->state.c_str());
+        stream->print(F("\"} "));
+        stream->print(F("1.0"));
+        stream->print(F("\n"));
+      } else {
+        this->open_row_(stream, "esphome_select_failed", obj, area, node, friendly_name);
+        stream->print(F("\"} 1\n"));
+      }
+    }
+
+    req.send(stream);
+    return req.body();
+  }
+
+ protected:
+  // The label sequence every row of the previous renderer repeated
+  void open_row_(AsyncResponseStream *stream, const char *metric, EntityBase *obj, std::string &area,
+                 std::string &node, std::string &friendly_name) {
+    stream->print(metric);
+    stream->print(F("{id=\""));
+    auto id = this->relabel_map_id.find(obj);
+    stream->print((id == this->relabel_map_id.end() ? obj->get_object_id() : id->second).c_str());
+    if (!area.empty()) {
+      stream->print(F("\",area=\""));
+      stream->print(area.c_str());
+    }
+    if (!node.empty()) {
+      stream->print(F("\",node=\""));
+      stream->print(node.c_str());
+    }
+    if (!friendly_name.empty()) {
+      stream->print(F("\",friendly_name=\""));
+      stream->print(friendly_name.c_str());
+    }
+    stream->print(F("\",name=\""));
+    auto name = this->relabel_map_name.find(obj);
+    stream->print((name == this->relabel_map_name.end() ? obj->get_name() : name->second).c_str());
+  }
+};
+
+class TestSwitch : public switch_::Switch {
+ protected:
+  void write_state(bool state) override { this->publish_state(state); }
+};
+
+class TestNumber : public number::Number {
+ protected:
+  void control(float value) override { this->publish_state(value); }
+};
+
+class TestSelect : public select::Select {
+ protected:
+  void control(const std::string &value) override { this->publish_state(value); }
+};
+
+/// Keeps the names alive, EntityBase only stores the pointer.
+const char *name_for(const char *kind, int i) {
+  static std::vector<std::unique_ptr<std::string>> names;
+  names.push_back(std::make_unique<std::string>(std::string(kind) + " " + to_string(i)));
+  return names.back()->c_str();
+}
+
+template<typename T> T *make_entity(const char *kind, int i) {
+  auto *obj = new T();  // NOLINT(cppcoreguidelines-owning-memory)
+  obj->set_name(name_for(kind, i));
+  // Every seventh entity is internal
+  obj->set_internal(i % 7 == 3);
+  return obj;
+}
+
+std::vector<sensor::Sensor *> sensors;
+std::vector<binary_sensor::BinarySensor *> binary_sensors;
+std::vector<TestSwitch *> switches;
+std::vector<text_sensor::TextSensor *> text_sensors;
+std::vector<TestNumber *> numbers;
+std::vector<TestSelect *> selects;
+
+void create_entities() {
+  static const char *const UNITS[] = {"°C", "%", "", "W"};
+  for (int i = 0; i < 48; i++) {
+    auto *obj = make_entity<sensor::Sensor>("Sensor", i);
+    obj->set_unit_of_measurement(UNITS[i % 4]);
+    obj->set_accuracy_decimals(i % 3);
+    App.register_sensor(obj);
+    sensors.push_back(obj);
+  }
+  for (int i = 0; i < 32; i++) {
+    auto *obj = make_entity<binary_sensor::BinarySensor>("Binary sensor", i);
+    App.register_binary_sensor(obj);
+    binary_sensors.push_back(obj);
+  }
+  for (int i = 0; i < 8; i++) {
+    auto *obj = make_entity<TestSwitch>("Switch", i);
+    App.register_switch(obj);
+    switches.push_back(obj);
+  }
+  for (int i = 0; i < 8; i++) {
+    auto *obj = make_entity<text_sensor::TextSensor>("Text sensor", i);
+    App.register_text_sensor(obj);
+    text_sensors.push_back(obj);
+  }
+  for (int i = 0; i < 8; i++) {
+    auto *obj = make_entity<TestNumber>("Number", i);
+    App.register_number(obj);
+    numbers.push_back(obj);
+  }
+  for (int i = 0; i < 8; i++) {
+    auto *obj = make_entity<TestSelect>("Select", i);
+    obj->traits.set_options({"off", "low", "high"});
+    App.register_select(obj);
+    selects.push_back(obj);
+  }
+}
+
+/// Publish new states; round changes the values, a few entities of each kind are left without a state.
+void publish_states(int round) {
+  for (size_t i = 0; i < sensors.size(); i++) {
+    if (i % 5 != 1)
+      sensors[i]->publish_state(i * 1.37f + round * 0.5f - 20.0f);
+  }
+  for (size_t i = 0; i < binary_sensors.size(); i++) {
+    if (i % 5 != 1)
+      binary_sensors[i]->publish_state((i + round) % 2 == 0);
+  }
+  for (size_t i = 0; i < switches.size(); i++)
+    switches[i]->publish_state((i + round) % 3 == 0);
+  for (size_t i = 0; i < text_sensors.size(); i++) {
+    if (i % 5 != 1)
+      text_sensors[i]->publish_state("state " + to_string(static_cast<int>(i) + round));
+  }
+  for (size_t i = 0; i < numbers.size(); i++) {
+    if (i % 5 != 1)
+      numbers[i]->publish_state(i * 12.5f - round);
+  }
+  for (size_t i = 0; i < selects.size(); i++) {
+    if (i % 5 != 1)
+      selects[i]->publish_state((i + round) % 2 == 0 ? "low" : "high");
+  }
+}
+
+std::string scrape(web_server_base::WebServerBase *base, const char *url = "/metrics") {
+  AsyncWebServerRequest req(HTTP_GET, url);
+  if (!base->handle(&req))
+    return "<not handled>";
+  EXPECT_TRUE(req.code() == 200);
+  EXPECT_STREQ(req.content_type(), "text/plain; version=0.0.4; charset=utf-8");
+  return req.body();
+}
+
+/// Render with a fresh handler and renderer and compare them over two rounds of state updates.
+void check_equal(bool include_internal, bool relabel) {
+  web_server_base::WebServerBase base;
+  prometheus::PrometheusHandler handler(&base);
+  handler.set_include_internal(include_internal);
+  handler.setup();
+  LegacyRenderer legacy;
+  legacy.include_internal = include_internal;
+  if (relabel) {
+    handler.add_label_id(sensors[0], "outdoor_temperature");
+    legacy.relabel_map_id[sensors[0]] = "outdoor_temperature";
+    handler.add_label_name(sensors[2], "Outdoor humidity");
+    legacy.relabel_map_name[sensors[2]] = "Outdoor humidity";
+    handler.add_label_id(selects[3], "fan_mode");
+    legacy.relabel_map_id[selects[3]] = "fan_mode";
+    handler.add_label_name(selects[3], "Fan mode");
+    legacy.relabel_map_name[selects[3]] = "Fan mode";
+  }
+
+  for (int round = 0; round < 2; round++) {
+    std::string expected = legacy.render();
+    std::string actual = scrape(&base);
+    EXPECT_TRUE(expected.size() > 1000);
+    EXPECT_STREQ(actual, expected);
+    publish_states(round + 1);
+  }
+  publish_states(0);
+}
+
+void check_cache() {
+  web_server_base::WebServerBase base;
+  prometheus::PrometheusHandler handler(&base);
+  handler.set_cache_ttl(50);
+  handler.setup();
+  LegacyRenderer legacy;
+
+  EXPECT_STREQ(scrape(&base, "/other"), "<not handled>");
+  AsyncWebServerRequest post(HTTP_POST, "/metrics");
+  EXPECT_TRUE(!base.handle(&post));
+
+  std::string first = scrape(&base);
+  EXPECT_STREQ(first, legacy.render());
+  // Within the TTL the previous exposition is served even though the states changed
+  publish_states(1);
+  EXPECT_STREQ(scrape(&base), first);
+  delay(60);
+  EXPECT_STREQ(scrape(&base), legacy.render());
+  publish_states(0);
+}
+
+void benchmark() {
+  web_server_base::WebServerBase base;
+  prometheus::PrometheusHandler handler(&base);
+  handler.setup();
+  web_server_base::WebServerBase cached_base;
+  prometheus::PrometheusHandler cached(&cached_base);
+  cached.set_cache_ttl(60000);
+  cached.setup();
+  LegacyRenderer legacy;
+
+  const size_t size = legacy.render().size();
+  const uint32_t iterations = 2000;
+  double legacy_ns = esphome::test::bench_ns(iterations, [&] { legacy.render(); });
+  double handler_ns = esphome::test::bench_ns(iterations, [&] { scrape(&base); });
+  double cached_ns = esphome::test::bench_ns(iterations, [&] { scrape(&cached_base); });
+  printf("exposition of %zu bytes, %zu entities, us per scrape:\n", size,
+         sensors.size() + binary_sensors.size() + switches.size() + text_sensors.size() + numbers.size() +
+             selects.size());
+  printf("  stream renderer  %8.1f (%.1f MB/s)\n", legacy_ns / 1000, size * 1000.0 / legacy_ns);
+  printf("  label cache      %8.1f (%.1f MB/s)\n", handler_ns / 1000, size * 1000.0 / handler_ns);
+  printf("  cached (ttl)     %8.1f (%.1f MB/s)\n", cached_ns / 1000, size * 1000.0 / cached_ns);
+}
+
+}  // namespace
+
+void setup() {
+  create_entities();
+  publish_states(0);
+
+  // Without area and friendly name
+  App.pre_setup("test-node", "", "", "", false);
+  check_equal(false, false);
+  check_equal(true, true);
+
+  static Area area;
+  area.set_name("Living room");
+  App.register_area(&area);
+  App.pre_setup("test-node", "Test Node", "", "", false);
+  check_equal(false, false);
+  check_equal(false, true);
+  check_equal(true, true);
+
+  check_cache();
+  benchmark();
+  exit(esphome::test::finish("prometheus"));
+}
+
+void loop() {}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace esphome::test {
+
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+/// Mean time of one call of fn in nanoseconds, over iterations calls.
+template<typename F> double bench_ns(uint32_t iterations, F &&fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; i++)
+    fn();
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / iterations;
+}
+
+/// Print the result and return the exit status for the test.
+inline int finish(const char *name) {
+  if (failures() == 0) {
+    printf("%s: OK\n", name);
+    return 0;
+  }
+  printf("%s: %d check(s) failed\n", name, failures());
+  return 1;
+}
+
+}  // namespace esphome::test
+
+#define EXPECT_TRUE(cond) \
+  do { \
+    if (!(cond)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      esphome::test::failures()++; \
+    } \
+  } while (0)
+
+#define EXPECT_STREQ(actual, expected) \
+  do { \
+    const std::string actual_ = (actual); \
+    const std::string expected_ = (expected); \
+    if (actual_ != expected_) { \
+      printf("%s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, #actual, actual_.c_str(), \
+             expected_.c_str()); \
+      esphome::test::failures()++; \
+    } \
+  } while (0)